@@ -40,6 +40,11 @@ template <typename T>
 std::pair<typename FIELD_MAG<T>::type, typename FIELD_MAG<T>::type>
 robustMinMax(const std::vector<T>& data, typename FIELD_MAG<T>::type rangeEPS = 1e-12);
 
+// The adjustments that robustMinMax() makes to the min/max of the finite values, for when those were computed some
+// other way. Pass min = +inf and max = -inf if there were no finite values.
+template <typename S>
+std::pair<S, S> robustifyMinMax(S minVal, S maxVal, S rangeEPS = 1e-12);
+
 
 // Map data in to the range [0,1]
 template <typename T>
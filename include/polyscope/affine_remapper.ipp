@@ -60,32 +60,34 @@ template <typename T>
 std::pair<typename FIELD_MAG<T>::type, typename FIELD_MAG<T>::type> robustMinMax(const std::vector<T>& data,
                                                                                  typename FIELD_MAG<T>::type rangeEPS) {
 
-  if (data.size() == 0) {
-    return std::make_pair(-1.0, 1.0);
-  }
-
   // Compute max and min of data for mapping
   typename FIELD_MAG<T>::type minVal = std::numeric_limits<typename FIELD_MAG<T>::type>::infinity();
   typename FIELD_MAG<T>::type maxVal = -std::numeric_limits<typename FIELD_MAG<T>::type>::infinity();
-  bool anyFinite = false;
   for (const T& x : data) {
     if (std::isfinite(FIELD_BIGNESS(x))) {
       minVal = std::min(minVal, FIELD_BIGNESS(x));
       maxVal = std::max(maxVal, FIELD_BIGNESS(x));
-      anyFinite = true;
     }
   }
-  if (!anyFinite) {
+
+  return robustifyMinMax(minVal, maxVal, rangeEPS);
+}
+
+template <typename S>
+std::pair<S, S> robustifyMinMax(S minVal, S maxVal, S rangeEPS) {
+
+  // no finite values (or no values at all)
+  if (!(minVal <= maxVal)) {
     return std::make_pair(-1.0, 1.0);
   }
-  typename FIELD_MAG<T>::type maxMag = std::max(std::abs(minVal), std::abs(maxVal));
+  S maxMag = std::max(std::abs(minVal), std::abs(maxVal));
 
   // Hack to do less ugly things when constants (or near-constant) are passed in
   if (maxMag < rangeEPS) {
     maxVal = rangeEPS;
     minVal = -rangeEPS;
   } else if ((maxVal - minVal) / maxMag < rangeEPS) {
-    typename FIELD_MAG<T>::type mid = (minVal + maxVal) / 2.0;
+    S mid = (minVal + maxVal) / 2.0;
     maxVal = mid + maxMag * rangeEPS;
     minVal = mid - maxMag * rangeEPS;
   }
@@ -0,0 +1,106 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace polyscope {
+namespace benchmark {
+
+// == Camera path replay
+//
+// Interactive sessions are too variable to compare frame rates across versions or machines. Instead, record a camera
+// path once, then replay it for a fixed number of frames: every frame moves the camera to the next point along the path
+// and forces a full redraw of the scene, without the UI. The result reports frame time statistics, a breakdown by
+// rendering pass, and render device memory, and can be written out as JSON. Works with any backend, including the
+// headless EGL one.
+//
+// Pass times are measured by waiting for the render device to finish between passes, so they include device time, but
+// the replay runs somewhat slower than an unmeasured session would.
+
+// A sequence of camera keyframes (extrinsics and field of view). Between keyframes, the camera is interpolated the same
+// way as when flying the view.
+class CameraPath {
+
+public:
+  // Add the current view as a keyframe
+  void addKeyframe();
+  void addKeyframe(const glm::mat4& viewMat, float fov);
+
+  // Add a keyframe from the output of view::getViewAsJson()
+  void addKeyframeFromJson(std::string viewJson);
+
+  void clear();
+  size_t nKeyframes() const { return keyframes.size(); }
+
+  // Move the camera to the point `t` in [0,1] along the path
+  void applyAt(double t) const;
+
+  // A circle of keyframes around the scene bounding box, looking at its center, for replays which should not depend on
+  // a recorded path
+  static CameraPath orbitAroundScene(size_t nKeyframes = 16);
+
+  // Serialize as a JSON list of keyframes
+  std::string toJson() const;
+  static CameraPath fromJson(std::string jsonData);
+  void saveToFile(std::string filename) const;
+  static CameraPath loadFromFile(std::string filename);
+
+private:
+  struct Keyframe {
+    glm::mat4 viewMat;
+    float fov;
+  };
+  std::vector<Keyframe> keyframes;
+};
+
+// Statistics of a set of timings, in milliseconds
+struct TimingSummary {
+  double minMs = 0.;
+  double medianMs = 0.;
+  double p99Ms = 0.;
+  double meanMs = 0.;
+  double maxMs = 0.;
+};
+TimingSummary summarizeTimings(std::vector<double> timesMs);
+
+struct ReplayResult {
+  size_t nFrames = 0;
+  int bufferWidth = 0;
+  int bufferHeight = 0;
+  std::string backend;
+
+  std::vector<double> frameMs; // time for each frame, in order
+  TimingSummary frameTime;
+
+  // Per-pass timings (e.g. "scene", "composite", "present"), in the order the passes run. A pass which only runs on
+  // some frames is only summarized over those frames.
+  std::vector<std::pair<std::string, TimingSummary>> passes;
+
+  // Render device memory, if the driver reports it (otherwise 0). Not all drivers report the total.
+  bool haveDeviceMemory = false;
+  size_t deviceMemoryTotalBytes = 0;
+  size_t deviceMemoryAvailableBytes = 0;
+};
+
+// Replay a camera path for nFrames frames, after nWarmupFrames untimed frames at its start. Vsync is turned off while
+// replaying, so frame times are not bound to the display's refresh rate. The view and vsync are restored afterwards.
+ReplayResult replayCameraPath(const CameraPath& path, size_t nFrames, size_t nWarmupFrames = 5);
+
+// Write a replay result as JSON, including the individual frame times
+std::string replayResultToJson(const ReplayResult& result);
+void writeReplayReport(const ReplayResult& result, std::string filename);
+
+// == Internal hooks, called by draw()
+
+// Mark the start and end of a rendering pass. Does nothing unless a replay is running.
+void beginPass(const char* name);
+void endPass();
+
+} // namespace benchmark
+} // namespace polyscope
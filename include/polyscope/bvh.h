@@ -0,0 +1,69 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace polyscope {
+
+// A bounding volume hierarchy over a set of primitives, each given by its axis-aligned bounding box. It only knows
+// about the boxes, callers supply the actual primitive tests in the queries below.
+class BVH {
+
+public:
+  // Build over primitives with bounds [primMin[i], primMax[i]] (the arrays must have the same length). Primitives with
+  // empty or NaN bounds are never returned by queries.
+  void build(const std::vector<glm::vec3>& primMin, const std::vector<glm::vec3>& primMax);
+
+  size_t nPrimitives() const { return nPrims; }
+  bool empty() const { return nodes.empty(); }
+
+  // Find the nearest primitive hit by the ray origin + t * dir, with t in (0, tMax). `dir` does not need to be
+  // normalized.
+  //
+  // The callback intersectPrimitive(iPrim, tMax) should return the t value at which the ray hits primitive iPrim, or
+  // any value >= tMax if it misses or the hit is no closer than tMax. Boxes are visited roughly front to back, and ones
+  // farther than the closest hit so far are skipped.
+  //
+  // Returns the index of the nearest hit primitive and sets tMax to its t value, or returns INVALID_PRIM if nothing was
+  // hit.
+  template <typename F>
+  size_t intersectRay(glm::vec3 origin, glm::vec3 dir, float& tMax, F intersectPrimitive) const;
+
+  // Call visitPrimitive(iPrim) for every primitive whose box might overlap the region described by the callbacks:
+  // boxInRegion(boxMin, boxMax) should return 0 if the box is entirely outside the region, 1 if it might be partially
+  // inside, and 2 if it is entirely inside (in which case all primitives below it are visited without further tests).
+  template <typename B, typename F>
+  void visitRegion(B boxInRegion, F visitPrimitive) const;
+
+  static const size_t INVALID_PRIM = std::numeric_limits<size_t>::max();
+
+private:
+  struct Node {
+    glm::vec3 boundMin;
+    glm::vec3 boundMax;
+    uint32_t start;       // first entry in primOrder, for leaves
+    uint32_t count;       // number of primitives, 0 for interior nodes
+    uint32_t secondChild; // for interior nodes, the first child is always the next node
+  };
+
+  size_t nPrims = 0;
+  std::vector<Node> nodes;
+  std::vector<uint32_t> primOrder;
+
+  // Lay out the subtree over primOrder[start, end) depth-first starting at the end of `nodes`, returns its root
+  uint32_t buildNode(const std::vector<glm::vec3>& primMin, const std::vector<glm::vec3>& primMax,
+                     const std::vector<glm::vec3>& centers, uint32_t start, uint32_t end);
+
+  // Returns t of the ray's entry in to the box, or infinity if it misses or enters after tMax
+  static float intersectBox(const Node& node, glm::vec3 origin, glm::vec3 invDir, float tMax);
+};
+
+} // namespace polyscope
+
+#include "polyscope/bvh.ipp"
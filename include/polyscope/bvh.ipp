@@ -0,0 +1,104 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <algorithm>
+
+namespace polyscope {
+
+inline float BVH::intersectBox(const Node& node, glm::vec3 origin, glm::vec3 invDir, float tMax) {
+  float tEnter = 0.;
+  float tExit = tMax;
+  for (int i = 0; i < 3; i++) {
+    float t0 = (node.boundMin[i] - origin[i]) * invDir[i];
+    float t1 = (node.boundMax[i] - origin[i]) * invDir[i];
+    if (t0 > t1) std::swap(t0, t1);
+    // (written so that NaNs from 0 * inf don't cut the interval)
+    tEnter = t0 > tEnter ? t0 : tEnter;
+    tExit = t1 < tExit ? t1 : tExit;
+  }
+  return tEnter <= tExit ? tEnter : std::numeric_limits<float>::infinity();
+}
+
+template <typename F>
+size_t BVH::intersectRay(glm::vec3 origin, glm::vec3 dir, float& tMax, F intersectPrimitive) const {
+
+  size_t bestPrim = INVALID_PRIM;
+  if (nodes.empty()) return bestPrim;
+
+  glm::vec3 invDir{1.f / dir.x, 1.f / dir.y, 1.f / dir.z};
+
+  // Stack of (node, entry t) to visit
+  std::vector<std::pair<uint32_t, float>> stack;
+  stack.reserve(64);
+  float tRoot = intersectBox(nodes[0], origin, invDir, tMax);
+  if (tRoot < tMax) stack.emplace_back(0, tRoot);
+
+  while (!stack.empty()) {
+    uint32_t iNode = stack.back().first;
+    float tEnter = stack.back().second;
+    stack.pop_back();
+    if (tEnter >= tMax) continue; // we found something closer since this was pushed
+
+    const Node& node = nodes[iNode];
+    if (node.count > 0) {
+      for (uint32_t i = node.start; i < node.start + node.count; i++) {
+        uint32_t iPrim = primOrder[i];
+        float t = intersectPrimitive(static_cast<size_t>(iPrim), tMax);
+        if (t < tMax) {
+          tMax = t;
+          bestPrim = iPrim;
+        }
+      }
+      continue;
+    }
+
+    // Push the farther child first, so the nearer one gets visited next
+    uint32_t iA = iNode + 1;
+    uint32_t iB = node.secondChild;
+    float tA = intersectBox(nodes[iA], origin, invDir, tMax);
+    float tB = intersectBox(nodes[iB], origin, invDir, tMax);
+    if (tA > tB) {
+      std::swap(iA, iB);
+      std::swap(tA, tB);
+    }
+    if (tB < tMax) stack.emplace_back(iB, tB);
+    if (tA < tMax) stack.emplace_back(iA, tA);
+  }
+
+  return bestPrim;
+}
+
+template <typename B, typename F>
+void BVH::visitRegion(B boxInRegion, F visitPrimitive) const {
+  if (nodes.empty()) return;
+
+  // Stack of (node, known to be entirely inside)
+  std::vector<std::pair<uint32_t, bool>> stack;
+  stack.reserve(64);
+  stack.emplace_back(0, false);
+
+  while (!stack.empty()) {
+    uint32_t iNode = stack.back().first;
+    bool inside = stack.back().second;
+    stack.pop_back();
+
+    const Node& node = nodes[iNode];
+    if (!inside) {
+      int status = boxInRegion(node.boundMin, node.boundMax);
+      if (status == 0) continue;
+      inside = status == 2;
+    }
+
+    if (node.count > 0) {
+      for (uint32_t i = node.start; i < node.start + node.count; i++) {
+        visitPrimitive(static_cast<size_t>(primOrder[i]));
+      }
+    } else {
+      stack.emplace_back(node.secondChild, inside);
+      stack.emplace_back(iNode + 1, inside);
+    }
+  }
+}
+
+} // namespace polyscope
@@ -4,7 +4,9 @@
 
 #include "polyscope/affine_remapper.h"
 #include "polyscope/color_management.h"
+#include "polyscope/curve_network_lod.h"
 #include "polyscope/curve_network_quantity.h"
+#include "polyscope/element_mask.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/render/engine.h"
 #include "polyscope/standardize_data_array.h"
@@ -43,12 +45,20 @@ public:
   // Construct a new curve network structure
   CurveNetwork(std::string name, std::vector<glm::vec3> nodes, std::vector<std::array<size_t, 2>> edges);
 
+  // Construct a curve network which shares its node positions with another buffer (see ManagedBuffer::shareFrom())
+  CurveNetwork(std::string name, render::ManagedBuffer<glm::vec3>& sharedNodes,
+               std::vector<std::array<size_t, 2>> edges);
+
   // === Overloads
 
   // Build the imgui display
   virtual void buildCustomUI() override;
   virtual void buildCustomOptionsUI() override;
   virtual void buildPickUI(size_t localPickID) override;
+  virtual bool queryRay(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayHit& hitOut) override;
+  virtual bool selectInScreenRegion(const ScreenRegion& region, std::vector<size_t>& localIndsOut) override;
+  virtual bool filterScalarQuantityElements(Quantity& q, ElementFilter filter, uint64_t& versionOut,
+                                            std::vector<char>* includeOut) override;
 
   virtual void draw() override;
   virtual void drawDelayed() override;
@@ -58,6 +68,7 @@ public:
   virtual std::string typeName() override;
 
   virtual void refresh() override;
+  virtual void sharedBufferUpdated(const std::string& bufferName) override;
 
   // === Geometry members
 
@@ -109,6 +120,17 @@ public:
   size_t nNodes() { return nodePositions.size(); }
   size_t nEdges() { return edgeTailInds.size(); }
 
+  // The indices of the nodes which project in to the screen region from the current view
+  std::vector<size_t> selectNodesInScreenRegion(const ScreenRegion& region);
+
+  // === Per-element masks
+  // Highlight, outline, or hide individual nodes and edges, e.g. to show a selection (see ElementMask)
+  void setNodeMask(const std::vector<size_t>& inds, ElementMaskMode mode);
+  void setEdgeMask(const std::vector<size_t>& inds, ElementMaskMode mode);
+  void clearNodeMask();
+  void clearEdgeMask();
+  ElementMask& getNodeMask();
+  ElementMask& getEdgeMask();
 
   // Misc data
   static const std::string structureTypeName;
@@ -116,10 +138,12 @@ public:
   // Small utilities
   void setCurveNetworkNodeUniforms(render::ShaderProgram& p);
   void setCurveNetworkEdgeUniforms(render::ShaderProgram& p);
-  void fillEdgeGeometryBuffers(render::ShaderProgram& program);
-  void fillNodeGeometryBuffers(render::ShaderProgram& program);
-  std::vector<std::string> addCurveNetworkNodeRules(std::vector<std::string> initRules);
-  std::vector<std::string> addCurveNetworkEdgeRules(std::vector<std::string> initRules);
+  // (fullDetail=true ignores the level of detail, for picking)
+  void fillEdgeGeometryBuffers(render::ShaderProgram& program, bool fullDetail = false);
+  void fillNodeGeometryBuffers(render::ShaderProgram& program, bool fullDetail = false);
+  // (withShade=false leaves off the rules which only change the color, for pick and depth programs)
+  std::vector<std::string> addCurveNetworkNodeRules(std::vector<std::string> initRules, bool withShade = true);
+  std::vector<std::string> addCurveNetworkEdgeRules(std::vector<std::string> initRules, bool withShade = true);
 
   // === Mutate
   template <class V>
@@ -150,6 +174,39 @@ public:
   CurveNetwork* setMaterial(std::string name);
   std::string getMaterial();
 
+  // Draw the nodes with a depth pre-pass, to only shade the front-most ones (see options::impostorDepthPrepass, which
+  // enables it for all structures)
+  CurveNetwork* setDepthPrepass(bool newVal);
+  bool getDepthPrepass();
+
+  // === Level of detail
+  // Large networks are drawn simplified to suit their size on screen (see options::curveNetworkLODPixelError)
+  CurveNetwork* setLevelOfDetail(bool newVal);
+  bool getLevelOfDetail();
+  bool usesLevelOfDetail();    // enabled, large enough, and not disabled by element masks
+  size_t getCurrentLODLevel(); // 0 is full detail
+
+  // Whether the background build of the simplified levels has finished (until then, the network is drawn at full
+  // detail, or at the levels built before). If waitForBuild, blocks until it has.
+  bool isLevelOfDetailReady(bool waitForBuild = false);
+
+  // Per-node or per-edge data as it should be bound in this network's draw programs, following the nodes and edges
+  // which are drawn at the current level of detail
+  template <typename T>
+  std::shared_ptr<render::AttributeBuffer> getNodeDrawAttributeBuffer(render::ManagedBuffer<T>& nodeData);
+  template <typename T>
+  std::shared_ptr<render::AttributeBuffer> getEdgeTailDrawAttributeBuffer(render::ManagedBuffer<T>& nodeData);
+  template <typename T>
+  std::shared_ptr<render::AttributeBuffer> getEdgeTipDrawAttributeBuffer(render::ManagedBuffer<T>& nodeData);
+  template <typename T>
+  std::shared_ptr<render::AttributeBuffer> getEdgeDrawAttributeBuffer(render::ManagedBuffer<T>& edgeData);
+
+  // Gather the buffers returned above again, when the level changes (see CurveNetworkQuantity::updateLODViews())
+  template <typename T>
+  void updateNodeDrawAttributeBuffers(render::ManagedBuffer<T>& nodeData);
+  template <typename T>
+  void updateEdgeDrawAttributeBuffers(render::ManagedBuffer<T>& edgeData);
+
 
 private:
   // Storage for the managed buffers above. You should generally interact with these through the managed buffers, not
@@ -159,12 +216,41 @@ private:
   std::vector<uint32_t> edgeTipIndsData;
   std::vector<glm::vec3> edgeCentersData;
 
+  void initializeEdges(const std::vector<std::array<size_t, 2>>& edges); // at construction
   void computeEdgeCenters();
 
+  // Built lazily by selectNodesInScreenRegion()
+  PointRegionIndex nodeRegionIndex;
+
+  ElementMask nodeMask;
+  ElementMask edgeMask;
+  void setMask(ElementMask& mask, size_t maskSize, const std::vector<size_t>& inds, ElementMaskMode mode);
+  void clearMask(ElementMask& mask);
+
   // === Visualization parameters
   PersistentValue<glm::vec3> color;
   PersistentValue<ScaledValue<float>> radius;
   PersistentValue<std::string> material;
+  PersistentValue<bool> depthPrepass;
+  PersistentValue<bool> levelOfDetail;
+
+  // Level of detail. When lodActive, the draw programs use the nodes and edges of lodLevel, copied to the buffers
+  // below (at level 0 these hold the original edges). The hierarchy is built in the background.
+  CurveNetworkLOD lod;
+  bool lodActive = false;
+  size_t lodLevel = 0;
+  uint64_t lodLevelKey = 0; // the key of the hierarchy that lodLevel was copied from
+  std::vector<uint32_t> lodNodeIndsData;
+  std::vector<uint32_t> lodEdgeTailIndsData;
+  std::vector<uint32_t> lodEdgeTipIndsData;
+  std::vector<uint32_t> lodEdgeIndsData;
+  render::ManagedBuffer<uint32_t> lodNodeInds;
+  render::ManagedBuffer<uint32_t> lodEdgeTailInds;
+  render::ManagedBuffer<uint32_t> lodEdgeTipInds;
+  render::ManagedBuffer<uint32_t> lodEdgeInds; // the original edge that each drawn edge stands for
+  void updateLevelOfDetail();  // called each frame
+  void refreshDrawPrograms();  // like refresh(), but keeps the pick programs (which always use full detail)
+  float lodMaxWorldError();    // the allowed error in object space, from the current view
 
   // Drawing related things
   // if nullptr, prepare() (resp. preparePick()) needs to be called
@@ -172,12 +258,15 @@ private:
   std::shared_ptr<render::ShaderProgram> nodeProgram;
   std::shared_ptr<render::ShaderProgram> edgePickProgram;
   std::shared_ptr<render::ShaderProgram> nodePickProgram;
+  std::shared_ptr<render::ShaderProgram> nodeDepthProgram;
 
   // === Helpers
 
   // Do setup work related to drawing, including allocating openGL data
   void prepare();
   void preparePick();
+  void prepareDepth();
+  bool usesDepthPrepass();
 
   void recomputeGeometryIfPopulated();
   float computeRadiusMultiplierUniform();
@@ -209,6 +298,12 @@ CurveNetwork* registerCurveNetwork(std::string name, const P& points, const E& e
 template <class P, class E>
 CurveNetwork* registerCurveNetwork2D(std::string name, const P& points, const E& edges);
 
+// Add a curve network whose nodes use the positions of another structure rather than a copy of them, e.g. the edges of
+// a mesh with registerCurveNetwork("edges", mesh->vertexPositions, edges). Both share one copy of the positions on the
+// host and on the device, and updating the positions through either structure updates both.
+template <class E>
+CurveNetwork* registerCurveNetwork(std::string name, render::ManagedBuffer<glm::vec3>& sharedNodes, const E& edges);
+
 
 // Shorthand to add a curve network, automatically constructing the connectivity of a line
 template <class P>
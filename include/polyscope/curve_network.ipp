@@ -18,6 +18,17 @@ CurveNetwork* registerCurveNetwork(std::string name, const P& nodes, const E& ed
   }
   return s;
 }
+template <class E>
+CurveNetwork* registerCurveNetwork(std::string name, render::ManagedBuffer<glm::vec3>& sharedNodes, const E& edges) {
+  checkInitialized();
+
+  CurveNetwork* s = new CurveNetwork(name, sharedNodes, standardizeVectorArray<std::array<size_t, 2>, 2>(edges));
+  bool success = registerStructure(s);
+  if (!success) {
+    safeDelete(s);
+  }
+  return s;
+}
 template <class P, class E>
 CurveNetwork* registerCurveNetwork2D(std::string name, const P& nodes, const E& edges) {
   checkInitialized();
@@ -188,6 +199,44 @@ void CurveNetwork::updateNodePositions2D(const V& newPositions2D) {
   updateNodePositions(positions3D);
 }
 
+template <typename T>
+std::shared_ptr<render::AttributeBuffer>
+CurveNetwork::getNodeDrawAttributeBuffer(render::ManagedBuffer<T>& nodeData) {
+  if (lodActive) return nodeData.getIndexedRenderAttributeBuffer(lodNodeInds);
+  return nodeData.getRenderAttributeBuffer();
+}
+
+template <typename T>
+std::shared_ptr<render::AttributeBuffer>
+CurveNetwork::getEdgeTailDrawAttributeBuffer(render::ManagedBuffer<T>& nodeData) {
+  return nodeData.getIndexedRenderAttributeBuffer(lodActive ? lodEdgeTailInds : edgeTailInds);
+}
+
+template <typename T>
+std::shared_ptr<render::AttributeBuffer>
+CurveNetwork::getEdgeTipDrawAttributeBuffer(render::ManagedBuffer<T>& nodeData) {
+  return nodeData.getIndexedRenderAttributeBuffer(lodActive ? lodEdgeTipInds : edgeTipInds);
+}
+
+template <typename T>
+std::shared_ptr<render::AttributeBuffer>
+CurveNetwork::getEdgeDrawAttributeBuffer(render::ManagedBuffer<T>& edgeData) {
+  if (lodActive) return edgeData.getIndexedRenderAttributeBuffer(lodEdgeInds);
+  return edgeData.getRenderAttributeBuffer();
+}
+
+template <typename T>
+void CurveNetwork::updateNodeDrawAttributeBuffers(render::ManagedBuffer<T>& nodeData) {
+  nodeData.updateIndexedView(lodNodeInds);
+  nodeData.updateIndexedView(lodEdgeTailInds);
+  nodeData.updateIndexedView(lodEdgeTipInds);
+}
+
+template <typename T>
+void CurveNetwork::updateEdgeDrawAttributeBuffers(render::ManagedBuffer<T>& edgeData) {
+  edgeData.updateIndexedView(lodEdgeInds);
+}
+
 // Shorthand to get a curve network from polyscope
 inline CurveNetwork* getCurveNetwork(std::string name) {
   return dynamic_cast<CurveNetwork*>(getStructure(CurveNetwork::structureTypeName, name));
@@ -40,6 +40,7 @@ public:
   CurveNetworkNodeColorQuantity(std::string name, std::vector<glm::vec3> values_, CurveNetwork& network_);
 
   virtual void createProgram() override;
+  virtual void updateLODViews() override;
 
   void buildNodeInfoGUI(size_t vInd) override;
 };
@@ -53,6 +54,7 @@ public:
   CurveNetworkEdgeColorQuantity(std::string name, std::vector<glm::vec3> values_, CurveNetwork& network_);
 
   virtual void createProgram() override;
+  virtual void updateLODViews() override;
 
   void buildEdgeInfoGUI(size_t eInd) override;
 
@@ -0,0 +1,78 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace polyscope {
+
+// A hierarchy of simplified copies of a curve network, so dense networks can be drawn at a level of detail which suits
+// their size on screen.
+//
+// The network is split into chains: maximal runs of edges whose interior nodes have exactly two edges (a closed loop
+// is a chain which starts and ends at the same node). Chain endpoints are always kept. Every interior node of a chain
+// gets an error, which is its distance from the simplified chain at the point it is removed, computed as in
+// Douglas-Peucker simplification and clamped to never exceed the error of the nodes removed after it, so the levels
+// are nested. Level k keeps the nodes with error above its tolerance, and joins consecutive kept nodes of each chain
+// with a single edge. Level 0 is the original network.
+//
+// At every level, the spheres of nodes where two edges meet nearly straight are skipped, since the cylinders of the
+// two edges hide them.
+class CurveNetworkLOD {
+
+public:
+  struct Level {
+    float tolerance = 0.;               // how far the edges of this level may be from the original curves
+    std::vector<uint32_t> nodeInds;     // the nodes to draw spheres for
+    std::vector<uint32_t> edgeTailInds; // the edges to draw, as node indices (empty at level 0, use the originals)
+    std::vector<uint32_t> edgeTipInds;
+    std::vector<uint32_t> edgeInds; // for each drawn edge, the first original edge that it replaces
+  };
+
+  ~CurveNetworkLOD();
+
+  // Build the levels, with a key which identifies the data (e.g. the data version of the positions)
+  void build(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& edgeTailInds,
+             const std::vector<uint32_t>& edgeTipInds, uint64_t key);
+
+  // Start building the levels in the background instead. The levels built before stay in use until the new ones are
+  // picked up by isReady(). If a background build is already running, this waits for it to finish first.
+  void buildAsync(std::vector<glm::vec3> positions, std::vector<uint32_t> edgeTailInds,
+                  std::vector<uint32_t> edgeTipInds, uint64_t key);
+  bool isBuilding() const { return pendingBuild.valid(); }
+
+  // Picks up the result of a finished background build. True if there are levels (if waitForBuild, blocks until a
+  // running build has finished).
+  bool isReady(bool waitForBuild = false);
+
+  // True if the levels were last built with this key
+  bool isCurrent(uint64_t key) const;
+  uint64_t getKey() const { return currentKey; }
+
+  void clear();
+
+  size_t nLevels() const { return levels.size(); }
+  const Level& getLevel(size_t iLevel) const;
+
+  // The coarsest level whose tolerance is at most maxError
+  size_t levelForError(float maxError) const;
+
+  // The error of each node, in the sense above: infinite for chain endpoints, and for nodes which are not in any
+  // chain.
+  const std::vector<float>& getNodeErrors() const { return nodeErrors; }
+
+private:
+  uint64_t currentKey = 0;
+  bool haveKey = false;
+  std::vector<float> nodeErrors;
+  std::vector<Level> levels;
+  std::future<std::shared_ptr<CurveNetworkLOD>> pendingBuild;
+};
+
+} // namespace polyscope
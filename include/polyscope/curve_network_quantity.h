@@ -19,6 +19,9 @@ public:
   // Build GUI info an element
   virtual void buildNodeInfoGUI(size_t vInd);
   virtual void buildEdgeInfoGUI(size_t fInd);
+
+  // Gather the per-node and per-edge data drawn at the level of detail again, after the level changes
+  virtual void updateLODViews();
 };
 
 
@@ -18,6 +18,7 @@ public:
   virtual void draw() override;
   virtual void buildCustomUI() override;
   virtual std::string niceName() override;
+  virtual render::ManagedBuffer<float>* getScalarValues() override { return &values; }
   virtual void refresh() override;
 
 protected:
@@ -40,6 +41,7 @@ public:
                                  DataType dataType_ = DataType::STANDARD);
 
   virtual void createProgram() override;
+  virtual void updateLODViews() override;
 
   void buildNodeInfoGUI(size_t nInd) override;
 };
@@ -55,6 +57,7 @@ public:
                                  DataType dataType_ = DataType::STANDARD);
 
   virtual void createProgram() override;
+  virtual void updateLODViews() override;
 
   void buildEdgeInfoGUI(size_t edgeInd) override;
 
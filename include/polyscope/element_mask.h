@@ -0,0 +1,73 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "polyscope/render/engine.h"
+#include "polyscope/types.h"
+
+namespace polyscope {
+
+// A per-element display mode for a structure, for showing things like selections and search results without adding a
+// quantity. Each element is drawn normally, highlighted, outlined, or hidden (see ElementMaskMode).
+//
+// The modes live on the render device as one byte per drawn primitive in an R8 texture, which the structure's shaders
+// read through the ELEMENT_MASK_* rules. Changing the modes of a few elements only uploads the bytes near them, so
+// updating a small selection on a very large structure is cheap. The mask is indexed by texel, which is the position
+// of the primitive in draw order; structures translate their own element indices (see e.g. PointCloud::setPointMask()).
+class ElementMask {
+
+public:
+  ElementMask() = default;
+
+  // Texels are laid out in rows of this many
+  static const uint32_t textureWidth = 4096;
+
+  // Number of texels. Resizing resets all of them to ElementMaskMode::None.
+  void resize(size_t newSize);
+  size_t size() const { return modes.size(); }
+
+  // == Host-side values
+  void set(size_t texel, ElementMaskMode mode);
+  void setRange(size_t texelStart, size_t count, ElementMaskMode mode);
+  ElementMaskMode get(size_t texel) const;
+
+  // Incremented whenever any texel changes, for caching data derived from the mask
+  uint64_t getVersion() const { return version; }
+
+  // Reset every texel to ElementMaskMode::None, and deactivate the mask
+  void clear();
+
+  // The mask becomes active the first time any texel is set to a mode other than None, and stays active until clear().
+  // Structures only add the mask shader rules while it is active, so an unused mask costs nothing to draw.
+  bool isActive() const { return active; }
+
+  // The color used for highlighted and outlined elements
+  glm::vec3 color{1.0, 0.45, 0.1};
+
+  // == Render device
+  void update();                               // upload the texels which changed, call once before drawing
+  void setTextures(render::ShaderProgram& p);  // for programs with the ELEMENT_MASK_PROPAGATE_* rules
+  void setUniforms(render::ShaderProgram& p);  // for programs with the ELEMENT_MASK_SHADE_* rules
+  size_t getLastUploadBytes() const { return lastUploadBytes; } // bytes sent by the last update() which sent any
+
+private:
+  std::vector<uint8_t> modes;
+  std::vector<uint32_t> changedTexels; // since the last upload, may contain repeats
+  bool active = false;
+  uint64_t version = 0;
+  bool fullUploadNeeded = true;
+  size_t lastUploadBytes = 0;
+  std::shared_ptr<render::TextureBuffer> texture;
+
+  void ensureTextureAllocated();
+  void uploadAll();
+};
+
+} // namespace polyscope
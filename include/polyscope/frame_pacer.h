@@ -0,0 +1,68 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace polyscope {
+namespace frame_pacer {
+
+// == Frame pacing
+//
+// Limits the main loop to options::maxFPS without busy-waiting. Between frames, the pacer first gives the idle time to
+// any queued background work (see addIdleCallback()), then sleeps until shortly before the next frame is due, and
+// spins for only the last fraction of a millisecond. The spin margin adapts to how late the operating system's sleeps
+// have been waking up.
+//
+// When vsync is on and the display swap is observed to block, the swap already limits the frame rate. In that case
+// the pacer only sleeps when options::maxFPS is well below the display refresh rate, and then wakes up just after a
+// vertical blank, so each frame is shown for a whole number of refreshes rather than drifting between them.
+//
+// show() always paces its frames. frameTick() only does when options::paceFrameTick is set.
+
+// Timings of recent frames, all in seconds
+struct FrameStats {
+  size_t nFrames = 0;                 // number of frames the statistics are computed over
+  double lastFrameSeconds = 0.;       // start-to-start time of the most recent frame
+  double averageFrameSeconds = 0.;    // start-to-start
+  double maxFrameSeconds = 0.;        // start-to-start
+  double averageWorkSeconds = 0.;     // processing events and drawing, not counting the buffer swap
+  double averageSwapSeconds = 0.;     // in the buffer swap, which includes waiting for vsync
+  double averageIdleWorkSeconds = 0.; // in idle callbacks
+  double averageSleepSeconds = 0.;    // sleeping or spinning until the next frame
+  bool vsyncPaced = false;            // whether the pacer is currently leaving the pacing to the display swap
+};
+
+// Statistics over the most recent frames (up to 120)
+FrameStats getFrameStats();
+void resetFrameStats();
+
+// When vsync is pacing, the number of display refreshes each frame is shown for: the fewest which keep the frame rate
+// at or below maxFPS (at least 1)
+size_t refreshesPerFrame(double maxFPS, double refreshRate);
+
+// == Idle work
+
+// Register a callback which is run in the idle time between frames. It is passed the number of seconds left before the
+// next frame is due, and should return quickly, doing at most about that much work. Return true if there is more work
+// to do, in which case it will be called again if time remains, or false to let the pacer go to sleep. Callbacks run on
+// the main thread, with the render context current. Returns an id for removeIdleCallback().
+//
+// Uploads deferred by options::deferDeviceUploads are also applied in the idle time, ahead of any callbacks. There is
+// no idle time when options::maxFPS is -1.
+size_t addIdleCallback(std::function<bool(double secondsAvailable)> callback);
+void removeIdleCallback(size_t id);
+
+// == Internal hooks, called by the main loop
+
+// Run idle work, then wait until the next frame should start. Returns immediately if options::maxFPS is -1.
+void waitForNextFrame();
+
+// Mark the start of a frame, the start of its buffer swap, and the end of its buffer swap
+void beginFrame();
+void beginSwap();
+void endFrame();
+
+} // namespace frame_pacer
+} // namespace polyscope
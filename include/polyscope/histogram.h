@@ -4,6 +4,7 @@
 
 #include "polyscope/render/color_maps.h"
 #include "polyscope/render/engine.h"
+#include "polyscope/render/managed_buffer.h"
 
 #include <vector>
 
@@ -11,6 +12,7 @@
 namespace polyscope {
 
 // A histogram that shows up in ImGUI
+// (render resources are only allocated the first time buildUI() is called)
 class Histogram {
 public:
   Histogram();                           // must call buildHistogram() with data after
@@ -19,6 +21,17 @@ public:
   ~Histogram();
 
   void buildHistogram(const std::vector<float>& values);
+
+  // If the values are already on the render device and the engine supports it, the range and bin counts are computed
+  // there. Otherwise, this is the same as the version above.
+  void buildHistogram(render::ManagedBuffer<float>& values);
+
+  // Use bin counts which were computed elsewhere (e.g. with computeHistogramCounts()), over a range which has already
+  // been adjusted with robustifyMinMax()
+  void buildHistogram(const std::vector<double>& binCounts, std::pair<double, double> range);
+  size_t getBinCount() const { return rawHistBinCount; }
+  std::pair<double, double> getDataRange() const { return dataRange; }
+
   void updateColormap(const std::string& newColormap);
 
   // Width = -1 means set automatically
@@ -30,6 +43,7 @@ private:
   // = Helpers
 
   // Manage the actual histogram
+  void buildCurve(const std::vector<double>& binCounts); // from counts over dataRange
   void fillBuffers();
   size_t rawHistBinCount = 51;
 
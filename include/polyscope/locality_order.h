@@ -0,0 +1,29 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+namespace polyscope {
+
+// == Orderings which improve memory locality when drawing
+//
+// Each returns a permutation `order`, where order[i] is the index of the input element which should be placed i'th.
+
+// Sort points along a Morton (Z-order) curve through their bounding box, so points which are close in space are close
+// in the order.
+std::vector<uint32_t> computeMortonOrder(const std::vector<glm::vec3>& points);
+
+// Order the triangles of a mesh (given as 3 in-range vertex indices each) for drawing, following Sander et al. 2007,
+// "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw". Triangles are first ordered with Tipsify, which
+// walks the mesh so consecutive triangles share vertices, then the resulting runs are split in to clusters, and the
+// clusters are sorted so those facing outward from the center of the mesh are drawn first, which lets depth testing
+// reject more of the fragments behind them.
+std::vector<uint32_t> computeTriangleDrawOrder(const std::vector<glm::vec3>& vertexPositions,
+                                               const std::vector<uint32_t>& triangleVertexInds);
+
+} // namespace polyscope
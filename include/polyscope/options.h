@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <tuple>
@@ -31,6 +32,11 @@ extern bool errorsThrowExceptions;
 // Don't let the main loop run at more than this speed. (-1 disables) (default: 60)
 extern int maxFPS;
 
+// If true, frameTick() also waits so that it returns at most maxFPS times per second, sleeping rather than spinning
+// and using the wait for idle work (see frame_pacer.h). Otherwise it returns as soon as the frame is drawn.
+// (default: false)
+extern bool paceFrameTick;
+
 // If enable or disable swap synchronization (limits render ray to display refresh rate). (default: true)
 // NOTE: some platforms may ignore the setting.
 extern bool enableVSync;
@@ -60,6 +66,70 @@ extern bool giveFocusOnShow;
 // If true, hide the polyscope window when a show() command finishes (default: true)
 extern bool hideWindowAfterShow;
 
+// Maximum number of threads used for internal data-parallel computations like bounding boxes and data ranges. Values
+// <= 0 mean use all hardware threads, 1 means do everything on the calling thread. (default: -1)
+extern int maxWorkerThreads;
+
+// If true, use compute programs on the render device for some data preprocessing (like histograms, and expanding
+// indexed buffers), when the rendering backend supports it. Otherwise, always use the CPU. (default: true)
+extern bool enableComputeTier;
+
+// If true, resolve clicks and screen-to-world position lookups by casting rays against CPU-side acceleration
+// structures, rather than rendering the pick buffer and reading back from the render device. Only the main geometry of
+// point clouds, curve networks, surface meshes, and volume meshes can be hit, and slice planes are not accounted
+// for. (default: false)
+extern bool pickWithRayQueries;
+
+// If true, outline the element under the mouse and show its info in a tooltip, updated every frame. Hovering reads from
+// a pick buffer which is kept between frames and only re-rendered when the scene or camera changes. (default: false)
+extern bool enableHoverHighlight;
+
+// If true, host-to-device uploads from updated buffers are queued and applied at the start of each frame, at most
+// maxUploadBytesPerFrame bytes or maxUploadMillisecondsPerFrame per frame, rather than immediately. Each structure is
+// always updated all at once, and visible structures are updated first. Useful when updating many buffers at once
+// would otherwise stall a single frame. (defaults: false, 64 MB, 4 ms)
+extern bool deferDeviceUploads;
+extern size_t maxUploadBytesPerFrame;
+extern float maxUploadMillisecondsPerFrame;
+
+// Surface texture quantities larger than virtualTextureThreshold texels in either dimension are drawn with virtual
+// texturing: only the pages of the texture (and of its mip levels) needed for the current view are kept on the GPU, in
+// a cache of virtualTextureCachePages pages of 128x128 texels, and at most virtualTexturePageUploadsPerFrame pages are
+// uploaded per frame. (defaults: 8192, 256, 16)
+extern size_t virtualTextureThreshold;
+extern size_t virtualTextureCachePages;
+extern size_t virtualTexturePageUploadsPerFrame;
+
+// If true, point clouds and triangle meshes are reordered for memory locality when they are registered: points along a
+// Morton curve, and mesh triangles for vertex reuse and low overdraw. Only the order things are drawn in changes; all
+// indices, quantities, and picking still refer to the elements in the order they were given. Read at registration
+// time. (default: false)
+extern bool reorderForLocality;
+
+// If true, sphere impostors (point clouds in sphere mode, and curve network nodes) are drawn in two passes: a cheap
+// pass which only computes their depth, then the usual shading pass, which then shades only the front-most fragment at
+// each pixel. This helps dense scenes with a lot of overdraw. Can also be enabled per structure. Ignored when
+// transparency is enabled. (default: false)
+extern bool impostorDepthPrepass;
+
+// Volume grids with at least volumeGridMipMinCells cells build a pyramid of downsampled copies of their scalar
+// quantities in the background. While the view or a slice plane is moving, they are drawn from a coarser level, such
+// that a cell covers about volumeGridInteractiveCellPixels pixels on screen. Once nothing has moved for
+// volumeGridRefineDelay seconds, the grid is drawn at full resolution again (or at the finest level whose cells cover
+// at least a pixel). Picking always uses the full resolution. Can be disabled per grid. (defaults: 262144, 4., 0.25)
+extern size_t volumeGridMipMinCells;
+extern float volumeGridInteractiveCellPixels;
+extern float volumeGridRefineDelay;
+
+// Curve networks with at least curveNetworkLODMinEdges edges are drawn at a level of detail which suits their size on
+// screen: runs of edges are merged into simplified polylines which stay within curveNetworkLODPixelError pixels of the
+// original curves, edges thinner than curveNetworkLinePixelRadius pixels are drawn as flat lines rather than ray-cast
+// tubes, and node spheres which are hidden by the edges meeting there are skipped. Picking always uses the full
+// network. Can be disabled per network. (defaults: 65536, 0.5, 0.5)
+extern size_t curveNetworkLODMinEdges;
+extern float curveNetworkLODPixelError;
+extern float curveNetworkLinePixelRadius;
+
 // === Scene options
 
 // Behavior of the ground plane
@@ -76,6 +146,15 @@ extern bool screenshotTransparency;     // controls whether screenshots taken by
 extern std::string screenshotExtension; // sets the extension used for automatically-numbered screenshots (e.g. by
                                         // clicking the GUI button)
 
+// === Remote view options (see remote_view.h)
+
+// Limit on the outgoing data rate to each browser, image quality is lowered to fit in it. (-1 means no limit, only
+// reduce quality when the connection itself can't keep up) (default: -1)
+extern int64_t remoteViewMaxBytesPerSecond;
+
+// JPEG quality of the streamed image when the connection keeps up, in [1,100] (default: 90)
+extern int remoteViewMaxQuality;
+
 // === Rendering parameters
 
 // SSAA scaling in pixel multiples
@@ -85,6 +164,13 @@ extern int ssaaFactor;
 extern TransparencyMode transparencyMode;
 extern int transparencyRenderPasses;
 
+// Eye-dome lighting: shade the final image by depth differences between neighboring pixels, which outlines shapes and
+// gives depth cues to geometry without normals, like point clouds drawn in pixel mode. Only applies when transparency
+// is disabled. The radius is in pixels. (defaults: false, 1., 1.5)
+extern bool eyeDomeLighting;
+extern float eyeDomeLightingStrength;
+extern float eyeDomeLightingRadius;
+
 // === Advanced ImGui configuration
 
 // If false, Polyscope will not create any ImGui UIs at all, but will still set up ImGui and invoke its render steps
@@ -0,0 +1,27 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace polyscope {
+
+// == Simple fork-join parallelism for data-parallel loops over large buffers
+
+// The number of worker threads that will be used for parallel loops, as determined by options::maxWorkerThreads and
+// the hardware. Always at least 1.
+size_t workerThreadCount();
+
+// The number of chunks that parallelForChunks() will split a range of size N in to. Each chunk has at least
+// minChunkSize elements (except when N < minChunkSize, in which case there is a single chunk).
+size_t parallelChunkCount(size_t N, size_t minChunkSize);
+
+// Split the range [0,N) in to parallelChunkCount() contiguous chunks, and call func(iStart, iEnd, iChunk) on each of
+// them. Chunks are processed concurrently on separate threads, and this function returns once all are done. Chunks are
+// ordered, so chunk iChunk always covers indices before chunk iChunk+1.
+//
+// func must be safe to call concurrently, and must not call any Polyscope or rendering functions. It should not throw.
+void parallelForChunks(size_t N, size_t minChunkSize, const std::function<void(size_t, size_t, size_t)>& func);
+
+} // namespace polyscope
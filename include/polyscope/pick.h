@@ -24,6 +24,13 @@ std::pair<Structure*, size_t> pickAtScreenCoords(glm::vec2 screenCoords); // tak
 std::pair<Structure*, size_t> pickAtBufferCoords(int xPos, int yPos);     // takes indices into the buffer
 std::pair<Structure*, size_t> evaluatePickQuery(int xPos, int yPos);      // old, badly named. takes buffer coordinates.
 
+// == Ray queries
+// Cast a ray against all enabled structures on the CPU, and return the nearest hit (see Structure::queryRay()). Unlike
+// the queries above, this does not need the scene to have been rendered. If `waitForBuild` is false, structures whose
+// acceleration structures are still being built are skipped rather than waited on.
+RayHit queryRay(glm::vec3 origin, glm::vec3 direction, bool waitForBuild = true); // takes a world-space ray
+RayHit queryRayAtScreenCoords(glm::vec2 screenCoords, bool waitForBuild = true);  // casts the ray through a pixel
+
 
 // == Stateful picking: track and update a current selection
 
@@ -36,6 +43,24 @@ void resetSelectionIfStructure(Structure* s); // If something from this structur
                                               // (useful if a structure is being deleted)
 
 
+// == Hover: track the element under the mouse (see options::enableHoverHighlight)
+// Hover queries are resolved from a pick buffer which is kept between frames, and only re-rendered when something
+// which is drawn in to it has changed: the geometry or size of a structure, the visibility or transform of a structure
+// or slice plane, or the camera. Each query reads back a small window of pixels around the cursor, and takes the
+// nearest element in it, so points and thin lines are easy to hover. The read is asynchronous, and only happens when
+// the cursor or the pick buffer have changed; the hover is updated once the pixels arrive (usually on the next update).
+void updateHover(glm::vec2 screenCoords); // takes screen coordinates
+std::pair<Structure*, size_t> getHover(); // same meaning as getSelection()
+bool haveHover();
+void resetHover();
+void drawHoverHighlight(); // outline the hovered element in to the active buffer
+
+// True if the kept pick buffer matches the current scene and view, so hover queries and the highlight can use it
+bool pickBufferIsCurrent();
+
+// Mark the kept pick buffer as out of date. Called when the geometry of a structure changes, i.e. when the buffers of a
+// structure are updated, when it is refreshed or (un)registered, and by setters for parameters like the point radius.
+void markPickBufferStale();
 // == Helpers
 
 // Convert between global pick indexing for the whole program, and local per-structure pick indexing
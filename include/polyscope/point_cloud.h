@@ -4,6 +4,7 @@
 
 #include "polyscope/affine_remapper.h"
 #include "polyscope/color_management.h"
+#include "polyscope/element_mask.h"
 #include "polyscope/persistent_value.h"
 #include "polyscope/point_cloud_quantity.h"
 #include "polyscope/polyscope.h"
@@ -44,12 +45,19 @@ public:
   // Construct a new point cloud structure
   PointCloud(std::string name, std::vector<glm::vec3> points);
 
+  // Construct a point cloud which shares its positions with another buffer (see ManagedBuffer::shareFrom())
+  PointCloud(std::string name, render::ManagedBuffer<glm::vec3>& sharedPoints);
+
   // === Overrides
 
   // Build the imgui display
   virtual void buildCustomUI() override;
   virtual void buildCustomOptionsUI() override;
   virtual void buildPickUI(size_t localPickID) override;
+  virtual bool queryRay(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayHit& hitOut) override;
+  virtual bool selectInScreenRegion(const ScreenRegion& region, std::vector<size_t>& localIndsOut) override;
+  virtual bool filterScalarQuantityElements(Quantity& q, ElementFilter filter, uint64_t& versionOut,
+                                            std::vector<char>* includeOut) override;
 
   // Standard structure overrides
   virtual void draw() override;
@@ -62,6 +70,10 @@ public:
   // === Geometry members
   render::ManagedBuffer<glm::vec3> points;
 
+  // The order the points are drawn in, if they were reordered for locality at registration (see
+  // options::reorderForLocality). Empty if they are drawn in index order.
+  render::ManagedBuffer<uint32_t> drawOrder;
+
   // === Quantities
 
   // Scalars
@@ -116,6 +128,16 @@ public:
   size_t nPoints();
   glm::vec3 getPointPosition(size_t iPt);
 
+  // The indices of the points whose centers project in to the screen region from the current view
+  std::vector<size_t> selectPointsInScreenRegion(const ScreenRegion& region);
+
+  // === Per-point masks
+  // Highlight, outline, or hide individual points, e.g. to show a selection (see ElementMask). Changing a few points
+  // at a time is cheap, even on very large clouds. Outlined points are drawn like highlighted ones in quad mode.
+  void setPointMask(const std::vector<size_t>& inds, ElementMaskMode mode);
+  void clearPointMask();
+  ElementMask& getPointMask();
+
   // Misc data
   static const std::string structureTypeName;
 
@@ -128,6 +150,11 @@ public:
   PointCloud* setPointRenderMode(PointRenderMode newVal);
   PointRenderMode getPointRenderMode();
 
+  // set the size of the points in pixel mode, where they are drawn as GL points of a fixed size on screen rather than
+  // with a radius in the scene. Points larger than a couple of pixels are drawn as round, shaded splats.
+  PointCloud* setPointPixelSize(float newVal);
+  float getPointPixelSize();
+
   // set the base color of the points
   PointCloud* setPointColor(glm::vec3 newVal);
   glm::vec3 getPointColor();
@@ -140,10 +167,20 @@ public:
   PointCloud* setMaterial(std::string name);
   std::string getMaterial();
 
+  // Draw with a depth pre-pass in sphere mode, to only shade the front-most points (see options::impostorDepthPrepass,
+  // which enables it for all structures)
+  PointCloud* setDepthPrepass(bool newVal);
+  bool getDepthPrepass();
+
   // Rendering helpers used by quantities
   void setPointCloudUniforms(render::ShaderProgram& p);
   void setPointProgramGeometryAttributes(render::ShaderProgram& p);
-  std::vector<std::string> addPointCloudRules(std::vector<std::string> initRules, bool withPointCloud = true);
+  // The render buffer to use for per-point data in programs which draw the points, gathered in to draw order if needed
+  template <typename T>
+  std::shared_ptr<render::AttributeBuffer> getPointRenderAttributeBuffer(render::ManagedBuffer<T>& perPointData);
+  // (withShade=false leaves off the rules which only change the color, for pick and depth programs)
+  std::vector<std::string> addPointCloudRules(std::vector<std::string> initRules, bool withPointCloud = true,
+                                              bool withShade = true);
   std::string getShaderNameForRenderMode();
 
   // === ~DANGER~ experimental/unsupported functions
@@ -152,22 +189,38 @@ public:
 private:
   // Storage for the managed buffers above. You should generally interact with this directly through them.
   std::vector<glm::vec3> pointsData;
+  std::vector<uint32_t> drawOrderData;
+
+  // Built lazily by selectPointsInScreenRegion()
+  PointRegionIndex pointRegionIndex;
+
+  // The mask is indexed in draw order; drawRank is the inverse of drawOrder, built lazily if the points were reordered
+  ElementMask pointMask;
+  std::vector<uint32_t> drawRank;
 
   // === Visualization parameters
   PersistentValue<std::string> pointRenderMode;
   PersistentValue<glm::vec3> pointColor;
   PersistentValue<ScaledValue<float>> pointRadius;
+  PersistentValue<float> pointPixelSize;
   PersistentValue<std::string> material;
+  PersistentValue<bool> depthPrepass;
 
   // Drawing related things
   // if nullptr, prepare() (resp. preparePick()) needs to be called
   std::shared_ptr<render::ShaderProgram> program;
   std::shared_ptr<render::ShaderProgram> pickProgram;
+  std::shared_ptr<render::ShaderProgram> depthProgram;
 
   // === Helpers
+  void initializePoints(); // draw order and bounds, once the positions are set at construction
+
   // Do setup work related to drawing, including allocating openGL data
   void ensureRenderProgramPrepared();
   void ensurePickProgramPrepared();
+  void ensureDepthProgramPrepared();
+  bool usesDepthPrepass();
+  bool usesPointRadiusAttribute(); // per-point radii from a quantity (not in pixel mode, which has a fixed size)
 
   // === Quantity adder implementations
   PointCloudScalarQuantity* addScalarQuantityImpl(std::string name, const std::vector<float>& data, DataType type);
@@ -200,6 +253,11 @@ PointCloud* registerPointCloud(std::string name, const T& points);
 template <class T>
 PointCloud* registerPointCloud2D(std::string name, const T& points);
 
+// Add a point cloud which uses the positions of another structure rather than a copy of them, e.g. the vertices of a
+// mesh with registerPointCloud("vertices", mesh->vertexPositions). Both share one copy of the positions on the host and
+// on the device, and updating the positions through either structure updates both.
+PointCloud* registerPointCloud(std::string name, render::ManagedBuffer<glm::vec3>& sharedPoints);
+
 // Shorthand to get a point cloud from polyscope
 inline PointCloud* getPointCloud(std::string name = "");
 inline bool hasPointCloud(std::string name = "");
@@ -17,6 +17,16 @@ PointCloud* registerPointCloud(std::string name, const T& points) {
   }
   return s;
 }
+inline PointCloud* registerPointCloud(std::string name, render::ManagedBuffer<glm::vec3>& sharedPoints) {
+  checkInitialized();
+
+  PointCloud* s = new PointCloud(name, sharedPoints);
+  bool success = registerStructure(s);
+  if (!success) {
+    safeDelete(s);
+  }
+  return s;
+}
 template <class T>
 PointCloud* registerPointCloud2D(std::string name, const T& points) {
   checkInitialized();
@@ -52,6 +62,13 @@ void PointCloud::updatePointPositions2D(const V& newPositions2D) {
   updatePointPositions(positions3D);
 }
 
+template <typename T>
+std::shared_ptr<render::AttributeBuffer>
+PointCloud::getPointRenderAttributeBuffer(render::ManagedBuffer<T>& perPointData) {
+  if (drawOrder.size() == 0) return perPointData.getRenderAttributeBuffer();
+  return perPointData.getIndexedRenderAttributeBuffer(drawOrder);
+}
+
 
 // Shorthand to get a point cloud from polyscope
 inline PointCloud* getPointCloud(std::string name) {
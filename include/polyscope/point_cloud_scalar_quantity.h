@@ -25,6 +25,7 @@ public:
   virtual void refresh() override;
 
   virtual std::string niceName() override;
+  virtual render::ManagedBuffer<float>* getScalarValues() override { return &values; }
 
 protected:
   void createProgram();
@@ -48,8 +48,15 @@ public:
   // A decorated name for the quantity that will be used in headers. For instance, for surface scalar named "value" we
   // return "value (scalar)"
   virtual std::string niceName();
+
+  // The values of a scalar quantity, or null for other kinds of quantities (used by scene statistics)
+  virtual render::ManagedBuffer<float>* getScalarValues();
   std::string uniquePrefix();
 
+  // Quantity uploads are applied along with the parent structure's
+  virtual render::ManagedBufferRegistry* getUploadGroup() override;
+  virtual bool isUploadVisible() override;
+
   // === Member variables ===
   Structure& parent;      // the parent structure with which this quantity is associated
   const std::string name; // a name for this quantity, which must be unique amongst quantities on `parent`
@@ -7,8 +7,11 @@
 
 namespace polyscope {
 
-// forward declaration
+// forward declarations
 void requestRedraw();
+namespace pick {
+void markPickBufferStale();
+}
 
 // === Structure-specific Quantities
 
@@ -35,7 +38,9 @@ QuantityS<S>* QuantityS<S>::setEnabled(bool newEnabled) {
   enabled = newEnabled;
 
   // Dominating quantities need to update themselves as their parent's dominating quantity
+  // (which can change what the parent draws in to the pick buffer)
   if (dominates) {
+    pick::markPickBufferStale();
     if (newEnabled == true) {
       parent.setDominantQuantity(this);
     } else {
@@ -0,0 +1,103 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "polyscope/bvh.h"
+
+namespace polyscope {
+
+// forward declarations
+class Structure;
+
+// The result of casting a ray against the scene, or a single structure.
+struct RayHit {
+  Structure* structure = nullptr; // nullptr if nothing was hit
+  size_t localIndex = 0;          // the element which was hit, using the same indexing as picking
+  float t = std::numeric_limits<float>::infinity(); // the hit is at origin + t * direction
+  glm::vec3 position{0., 0., 0.};                   // world-space location of the hit
+
+  bool hit() const { return structure != nullptr; }
+};
+
+// The primitives a structure is drawn with, in its object space, for ray queries.
+struct RayQueryGeometry {
+  std::vector<glm::vec3> positions;
+  std::vector<std::array<uint32_t, 3>> triangles; // indices in to positions
+  std::vector<std::array<uint32_t, 2>> cylinders; // indices in to positions, with the radius below
+  std::vector<uint32_t> spheres;                  // indices in to positions, with the radius below
+  float radius = 0.;
+};
+
+// A CPU acceleration structure for casting rays against a structure, so that picking and other queries don't need a
+// render pass and a blocking readback.
+//
+// The BVH is built on a worker thread, from a copy of the geometry. Structures hand in their geometry along with a key
+// which identifies it (e.g. the data versions of the buffers it came from), and only rebuild when the key changes.
+// Setting new geometry never waits for a build which is still running: the older build is superseded, and its result
+// dropped.
+class RayQueryAccel {
+
+public:
+  RayQueryAccel() = default;
+  ~RayQueryAccel();
+  RayQueryAccel(const RayQueryAccel&) = delete;
+  RayQueryAccel& operator=(const RayQueryAccel&) = delete;
+
+  enum class PrimitiveType { Triangle, Cylinder, Sphere };
+
+  struct Hit {
+    PrimitiveType type;
+    size_t index; // index in to the corresponding primitive list of RayQueryGeometry
+    float t;
+    // For triangles, the barycentric coordinates of the hit. For cylinders, x holds the coordinate along the cylinder
+    // from the first to the second point.
+    glm::vec3 bary;
+  };
+
+  // Helper to include a float parameter (like a radius) in a key
+  static uint64_t keyFromFloat(float val);
+
+  // True if the geometry was last set with this key
+  bool isCurrent(const std::vector<uint64_t>& key) const;
+
+  // Set new geometry and start building the acceleration structure for it in the background
+  void setGeometry(RayQueryGeometry geometry, std::vector<uint64_t> key);
+
+  void clear();
+
+  // Cast the ray origin + t * dir (in object space), `dir` does not need to be normalized. If the acceleration
+  // structure is still being built, either waits for it or reports no hit according to `waitForBuild`.
+  bool intersect(glm::vec3 origin, glm::vec3 dir, bool waitForBuild, Hit& hitOut);
+
+private:
+  struct Built {
+    RayQueryGeometry geometry;
+    BVH bvh; // over triangles, then cylinders, then spheres
+  };
+  // (returns null if `stop` returns true before the BVH is built)
+  static std::shared_ptr<Built> build(RayQueryGeometry geometry, std::function<bool()> stop);
+
+  typedef std::pair<uint64_t, std::future<std::shared_ptr<Built>>> PendingBuild; // (generation, result)
+
+  std::vector<uint64_t> currentKey;
+  bool haveKey = false;
+  std::shared_ptr<Built> built;
+  std::shared_ptr<std::atomic<uint64_t>> latestGeneration = std::make_shared<std::atomic<uint64_t>>(0);
+  std::vector<PendingBuild> pendingBuilds; // the last one is the latest
+  void collectBuilds(bool waitForBuild);
+  void waitForAllBuilds();
+};
+
+} // namespace polyscope
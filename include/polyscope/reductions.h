@@ -0,0 +1,41 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace polyscope {
+
+// == Fast reductions over large arrays of vectors
+//
+// These are used for things like structure bounding boxes and vector length ranges, which get recomputed every time
+// data is registered or updated. They use SIMD instructions where available, and split large arrays across worker
+// threads (see parallel.h). NaN entries are skipped, as in the simple loops they replace.
+
+// Axis-aligned bounding box of the points, as (min, max). If there are no points, min is +inf and max is -inf.
+std::tuple<glm::vec3, glm::vec3> computeBoundingBox(const std::vector<glm::vec3>& points);
+
+// The largest distance from `center` to any of the points (0 if there are no points)
+float computeMaxDistance(const std::vector<glm::vec3>& points, glm::vec3 center);
+
+// The largest length of any of the vectors (0 if there are no vectors)
+float computeMaxNorm(const std::vector<glm::vec3>& vectors);
+float computeMaxNorm(const std::vector<glm::vec2>& vectors);
+
+// Range of the finite values, as (min, max). If there are no finite values, min is +inf and max is -inf.
+std::pair<float, float> computeFiniteRange(const std::vector<float>& values);
+
+// Number of values in each of nBins equal bins over [low, high]. Values outside of the range (including infinite ones)
+// are counted in the first or last bin, and NaN values are skipped.
+std::vector<double> computeHistogramCounts(const std::vector<float>& values, double low, double high, size_t nBins);
+
+// Computes the bounding box and length scale in the manner used by all structures: the length scale is twice the
+// radius of the points about the center of the bounding box.
+void computeBoundingBoxAndLengthScale(const std::vector<glm::vec3>& points,
+                                      std::tuple<glm::vec3, glm::vec3>& boundingBox, float& lengthScale);
+
+} // namespace polyscope
@@ -0,0 +1,51 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include "polyscope/screen_region.h"
+#include "polyscope/structure.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace polyscope {
+namespace region_selection {
+
+// When a mode other than Off is set, left-dragging in the viewport draws a box or lasso instead of rotating the
+// camera, and selects the elements of the enabled structures inside it. The selection is updated live while dragging.
+enum class RegionSelectionMode { Off = 0, Box, Lasso };
+
+void setMode(RegionSelectionMode newMode);
+RegionSelectionMode getMode();
+
+// Select the elements of all enabled structures which project in to the region from the current view (see
+// Structure::selectInScreenRegion()). The result holds a list of local pick indices for each structure which had any
+// elements selected.
+std::vector<std::pair<Structure*, std::vector<size_t>>> selectInScreenRegion(const ScreenRegion& region);
+
+// The result of the last region drawn in the UI (or set below)
+const std::vector<std::pair<Structure*, std::vector<size_t>>>& getSelection();
+void setSelection(std::vector<std::pair<Structure*, std::vector<size_t>>> newSelection);
+void clearSelection();
+
+// Incremented whenever the selection changes, for caching data derived from it
+uint64_t getSelectionVersion();
+
+// One flag for each of the local pick indices [0, nIndices) of a structure, set for those which are selected
+std::vector<char> getSelectionFlags(Structure* s, size_t nIndices);
+
+// Remove any entries in the selection for this structure. Called when structures are deleted.
+void resetSelectionIfStructure(Structure* s);
+
+// == Internal helpers
+
+// Handle mouse input for the current mode. Returns true if the left mouse button was used, in which case the caller
+// should not also use it for camera motion or picking. Called every frame; when the mouse is captured by the UI, it
+// only ends a drag whose button was released.
+bool processInput(bool mouseCaptured);
+
+void buildRegionSelectionGui();
+
+} // namespace region_selection
+} // namespace polyscope
@@ -0,0 +1,46 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace polyscope {
+namespace remote {
+
+// == Remote viewing
+//
+// Serves the Polyscope window to a web browser. This is mainly meant for running with the headless (EGL) backend on a
+// remote machine: start the server, forward the port (e.g. `ssh -L 8765:localhost:8765 ...`), and open
+// http://localhost:8765 in a browser.
+//
+// The display is streamed over a WebSocket as JPEG tiles, and only tiles which changed since the last frame are sent.
+// When the connection can't keep up, frames are downsampled and compressed more heavily, and sharpened again once the
+// view settles. Mouse and keyboard input from the browser is passed to ImGui just like input from a local window, and
+// with headless backends the display is resized to match the browser window.
+//
+// Frames are only produced while Polyscope's main loop is running, i.e. during show() or frameTick(). Only supported on
+// POSIX platforms.
+
+// Start serving on the given port, or pick a free port if `port` is 0. Returns the port in use. By default, only
+// connections from the local machine are accepted.
+int start(int port = 8765, std::string bindAddress = "127.0.0.1");
+
+// Stop serving and disconnect all clients (also happens in polyscope::shutdown())
+void stop();
+
+bool isRunning();
+
+// Number of browsers currently connected
+size_t clientCount();
+
+// == Internal hooks, called by the main loop
+
+// Pass input events received from clients to ImGui, must be called before the ImGui frame starts
+void processInput();
+
+// Read back the display buffer and send changed regions to clients, must be called after drawing
+void sendFrame();
+
+} // namespace remote
+} // namespace polyscope
@@ -10,6 +10,7 @@
 #include "polyscope/render/color_maps.h"
 #include "polyscope/render/ground_plane.h"
 #include "polyscope/render/materials.h"
+#include "polyscope/render/upload_scheduler.h"
 #include "polyscope/types.h"
 #include "polyscope/view.h"
 
@@ -37,7 +38,7 @@ enum class DrawMode {
 };
 
 enum class FilterMode { Nearest = 0, Linear };
-enum class TextureFormat { RGB8 = 0, RGBA8, RG16F, RGB16F, RGBA16F, RGBA32F, RGB32F, R32F, R16F, DEPTH24 };
+enum class TextureFormat { RGB8 = 0, RGBA8, RG16F, RGB16F, RGBA16F, RGBA32F, RGB32F, R32F, R16F, DEPTH24, R8 };
 enum class RenderBufferType { Color, ColorAlpha, Depth, Float4 };
 enum class DepthMode { Less, LEqual, LEqualReadOnly, Greater, Disable, PassReadOnly };
 enum class BlendMode { AlphaOver, OverNoWrite, AlphaUnder, Zero, WeightedAdd, Add, Source, Disable };
@@ -169,6 +170,14 @@ public:
   virtual void setData(const std::vector<std::array<glm::vec3, 3>>& data) = 0;
   virtual void setData(const std::vector<std::array<glm::vec3, 4>>& data) = 0;
 
+  // Overwrite a rectangular region of a 2D texture, leaving the rest unchanged. The data is tightly packed, row by row,
+  // with one float per channel of the texture format.
+  virtual void setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX, unsigned int regionY,
+                               const float* data);
+  // (same, with one byte per channel, for 8-bit formats)
+  virtual void setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX, unsigned int regionY,
+                               const unsigned char* data);
+
   unsigned int getSizeX() const { return sizeX; }
   unsigned int getSizeY() const { return sizeY; }
   unsigned int getSizeZ() const { return sizeZ; }
@@ -264,15 +273,34 @@ public:
   // Query pixel
   virtual std::array<float, 4> readFloat4(int xPos, int yPos) = 0;
   virtual float readDepth(int xPos, int yPos) = 0;
+  // Read the float4 pixels in the sizeX x sizeY block starting at (xStart, yStart), row by row, clamped to the buffer
+  virtual std::vector<float> readFloat4Region(int xStart, int yStart, int sizeX, int sizeY) = 0;
   virtual void blitTo(FrameBuffer* other) = 0;
   virtual std::vector<unsigned char> readBuffer() = 0;
 
+  // Asynchronous version of readBuffer(). beginAsyncReadBuffer() starts copying out the current contents, and
+  // finishAsyncReadBuffer() returns true and fills `out` once the copy is available. If `wait` is false it returns
+  // false immediately when the copy is still in flight. Only one read can be pending at a time, starting a new one
+  // discards the old one. The default implementation just reads synchronously.
+  virtual void beginAsyncReadBuffer();
+  virtual bool finishAsyncReadBuffer(std::vector<unsigned char>& out, bool wait = false);
+  bool asyncReadBufferPending() const { return asyncReadPending; }
+
+  // Asynchronous version of readFloat4Region(), used the same way as the functions above. It is independent of them,
+  // so a read of each kind can be pending at the same time.
+  virtual void beginAsyncReadFloat4Region(int xStart, int yStart, int sizeX, int sizeY);
+  virtual bool finishAsyncReadFloat4Region(std::vector<float>& out, bool wait = false);
+
   virtual uint32_t getNativeBufferID() = 0;
   uint64_t getUniqueID() const { return uniqueID; }
 
 protected:
   unsigned int sizeX, sizeY;
   uint64_t uniqueID;
+  bool asyncReadPending = false;
+  std::vector<unsigned char> asyncReadData; // used by the default synchronous implementation
+  bool asyncRegionReadPending = false;
+  std::vector<float> asyncRegionReadData; // used by the default synchronous implementation
 
   // Viewport
   bool viewportSet = false;
@@ -306,7 +334,7 @@ struct ShaderSpecTexture {
 
 
 // Types which represents shaders and the values they require
-enum class ShaderStageType { Vertex, Geometry, /* Compute,*/ Fragment };
+enum class ShaderStageType { Vertex, Geometry, Compute, Fragment };
 struct ShaderStageSpecification {
   const ShaderStageType stage;
   const std::vector<ShaderSpecUniform> uniforms;
@@ -446,6 +474,13 @@ public:
   virtual void checkError(bool fatal = false) = 0;
   void buildEngineGui();
 
+  // Block until the render device has finished all work submitted so far, e.g. for timing. (default: does nothing)
+  virtual void finishDeviceWork();
+
+  // Memory on the render device, in bytes, when the driver reports it; returns false otherwise. Some drivers only
+  // report the available memory, in which case the total is 0. (default: returns false)
+  virtual bool getDeviceMemoryInfo(size_t& totalBytesOut, size_t& availableBytesOut);
+
   virtual void clearDisplay();
   virtual void bindDisplay();
   virtual void swapDisplayBuffers() = 0;
@@ -463,12 +498,24 @@ public:
   void updateMinDepthTexture();
   void renderBackground(); // respects background setting
 
+  // Draw an outline and tint over the pixels of the pick buffer whose pick color is `pickColor`, in to the active
+  // buffer. Used to highlight the hovered element without redrawing the scene.
+  void drawPickHighlight(glm::vec3 pickColor);
+
   // Manage render state
   virtual void setDepthMode(DepthMode newMode) = 0;
   virtual void setBlendMode(BlendMode newMode) = 0;
   virtual void setColorMask(std::array<bool, 4> mask = {true, true, true, true}) = 0;
   virtual void setBackfaceCull(bool newVal = false) = 0;
 
+  // Depth pre-pass for impostor programs (see options::impostorDepthPrepass). Draw the depth-only programs after
+  // beginDepthPrepass(), then the regular programs after beginDepthPrepassShading(), which only shades the front-most
+  // fragments, then call endDepthPrepass() to restore the usual state.
+  bool depthPrepassAllowed(); // only with opaque rendering
+  void beginDepthPrepass();
+  void beginDepthPrepassShading();
+  void endDepthPrepass();
+
   void setCurrentViewport(glm::vec4 viewport);
   glm::vec4 getCurrentViewport();
   void setCurrentPixelScaling(float scale);
@@ -500,6 +547,7 @@ public:
   virtual bool getWindowResizable() = 0;
   virtual std::tuple<int, int> getWindowPos() = 0;
   virtual bool windowRequestsClose() = 0;
+  virtual double getDisplayRefreshRate(); // in Hz, of the display the window is on, or 0 if unknown (the default)
   virtual void pollEvents() = 0;
   virtual bool isKeyPressed(char c) = 0; // for lowercase a-z and 0-9 only
   virtual int getKeyCode(char c) = 0;    // for lowercase a-z and 0-9 only
@@ -544,6 +592,16 @@ public:
                                                                unsigned int sizeY_, unsigned int sizeZ_,
                                                                const float* data) = 0; // 3d
 
+  // wrap native buffers which were created externally (e.g. an openGL buffer or texture name from this context or a
+  // shared context), so they can be used like buffers created above. The wrapped object is never deleted by
+  // Polyscope, the caller is responsible for keeping it alive while it is in use. dataSize is the number of entries in
+  // the attribute buffer. Not all backends support this; the default implementation throws.
+  virtual std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer(RenderDataType dataType_, int arrayCount_,
+                                                                     uint32_t nativeID, int64_t dataSize);
+  virtual std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer(TextureFormat format, int dim, uint32_t nativeID,
+                                                                 unsigned int sizeX_, unsigned int sizeY_,
+                                                                 unsigned int sizeZ_);
+
   // create render buffers
   virtual std::shared_ptr<RenderBuffer> generateRenderBuffer(RenderBufferType type, unsigned int sizeX_,
                                                              unsigned int sizeY_) = 0;
@@ -555,6 +613,33 @@ public:
   requestShader(const std::string& programName, const std::vector<std::string>& customRules,
                 ShaderReplacementDefaults defaults = ShaderReplacementDefaults::SceneObject) = 0;
 
+  // === Optional compute tier
+  // Some backends can run compute programs directly on device buffers (e.g. openGL, when the context supports 4.3 or
+  // newer). When available, this is used to offload data-parallel preprocessing like scalar ranges, histograms, and
+  // indexed-view gathers. Each of the functions below returns false without doing anything if the operation is not
+  // supported for the given inputs, in which case the caller should fall back on a CPU implementation.
+  bool computeTierAvailable(); // supported by the backend and allowed by options::enableComputeTier
+
+  // Min and max of the finite values in a buffer of floats. Outputs are left as +inf/-inf if there are no finite
+  // values.
+  virtual bool computeRange(AttributeBuffer& values, float& minOut, float& maxOut);
+
+  // Count a buffer of floats in to nBins evenly-spaced bins over [rangeMin, rangeMax]. Values outside of the range are
+  // counted in the first/last bin, NaNs are skipped.
+  virtual bool computeHistogram(AttributeBuffer& values, float rangeMin, float rangeMax, size_t nBins,
+                                std::vector<uint32_t>& countsOut);
+
+  // Set target[i] = source[indices[i]], (re)allocating target to have the same size as indices. The source and target
+  // must have the same type, and indices must be a buffer of uint32s.
+  virtual bool computeGather(AttributeBuffer& source, AttributeBuffer& indices, AttributeBuffer& target);
+
+  // === Deferred uploads
+  // Uploads queued by ManagedBuffers when options::deferDeviceUploads is set. serviceDeferredUploads() is called once
+  // per frame before rendering, and applies them under the per-frame budget from the options (or all of them, if the
+  // option has been turned off).
+  UploadScheduler uploadScheduler;
+  void serviceDeferredUploads();
+
   // === The frame buffers used in the rendering pipeline
   // The size of these buffers is always kept in sync with the screen size
   std::shared_ptr<FrameBuffer> displayBuffer, displayBufferAlt;
@@ -566,12 +651,13 @@ public:
   // Main buffers for rendering
   // sceneDepthMin is an optional texture copy of the depth buffe used for some effects
   std::shared_ptr<TextureBuffer> sceneColor, sceneColorFinal, sceneDepth, sceneDepthMin;
-  std::shared_ptr<RenderBuffer> pickColorBuffer, pickDepthBuffer;
+  std::shared_ptr<TextureBuffer> pickColorBuffer;
+  std::shared_ptr<RenderBuffer> pickDepthBuffer;
   TextureBuffer& getFinalSceneColorTexture();
 
   // General-use programs used by the engine
   std::shared_ptr<ShaderProgram> renderTexturePlain, renderTextureDot3, renderTextureMap3, renderTextureSphereBG;
-  std::shared_ptr<ShaderProgram> compositePeel, mapLight, copyDepth;
+  std::shared_ptr<ShaderProgram> compositePeel, mapLight, copyDepth, pickHighlight;
 
   // Manage transparency and culling
   void setTransparencyMode(TransparencyMode newMode);
@@ -622,6 +708,9 @@ public:
 
   bool useAltDisplayBuffer = false; // if true, push final render results offscreen to the alt buffer instead
 
+  bool loadAllTexturePages = false; // if true, virtual textures load every page the view needs before drawing, rather
+                                    // than a few per frame. Used internally for screenshots.
+
   // Internal windowing and engine details
   ImFontAtlas* globalFontAtlas = nullptr;
   ImFont* regularFont = nullptr;
@@ -641,10 +730,12 @@ protected:
   int slicePlaneCount = 0;
   bool frontFaceCCW = true;
   std::vector<FrameBuffer*> renderFramebufferStack; // supports push/popBindFramebufferForRendering
+  bool computeTierSupported = false;                // set by backends during initialization
 
   // Cached lazy seettings for the resolve and relight program
   int currLightingSampleLevel = -1;
   TransparencyMode currLightingTransparencyMode = TransparencyMode::None;
+  bool currLightingEyeDome = false;
 
   // Helpers
   void configureImGui();
@@ -118,6 +118,10 @@ public:
   // reflecting updates to the render buffer.
   void markHostBufferUpdated();
 
+  // A counter which is incremented whenever the values in the buffer change (through any of the functions which mark
+  // it as updated). Useful for caching data derived from the buffer.
+  uint64_t getDataVersion() const { return sharedSource ? sharedSource->dataVersion : dataVersion; }
+
   // Get the value at index `i`. It may be dynamically fetched from either the cpu-side `data` member or the render
   // buffer, depending on where the data currently lives.
   // If the data lives only on the device-side render buffer, this function is expensive, so don't call it in a
@@ -148,6 +152,13 @@ public:
   // NOTE: This class follows the policy that once the render buffer is allocated, it is always immediately kept
   // updated to reflect any external changes.
 
+  // True if the device-side attribute buffer has been allocated (so getting it is free)
+  bool hasRenderAttributeBuffer();
+
+  // True if new values are waiting in a deferred upload (see options::deferDeviceUploads). The device-side buffers
+  // still hold the old values until it is applied, so they must not be used for device-side processing.
+  bool hasPendingDeferredUpload();
+
   // Get a reference to the underlying GPU-side attribute buffer
   // Once this reference is created, it will always be immediately updated to reflect any external changes to the
   // data. (note that if you write to this buffer externally, you MUST call markRenderAttributeBufferUpdated()
@@ -158,6 +169,42 @@ public:
   // to the buffer from getRenderBuffer() above.
   void markRenderAttributeBufferUpdated();
 
+  // Use an externally-owned native buffer (e.g. an openGL buffer object from the same or a shared context) as the
+  // device-side storage for this buffer, so that it can be drawn directly from external GPU data without a round trip
+  // through the host. The buffer must hold `count` tightly-packed entries in the same format Polyscope would upload
+  // (note that double data is stored as float). The host-side `data` is cleared, and will only be read back from the
+  // device if something asks for it, such as getValue() or an indexed view.
+  //
+  // Polyscope never deletes the external buffer, it must be kept alive as long as it is in use. If you write new
+  // values to it, call markRenderAttributeBufferUpdated() as usual.
+  void setExternalRenderAttributeBuffer(uint32_t nativeID, size_t count);
+
+  // ========================================================================
+  // == Sharing values between buffers
+  // ========================================================================
+
+  // Use the values of another buffer, rather than holding a copy of them. This is useful when several structures are
+  // built on the same geometry, e.g. a point cloud of the vertices of a mesh: there is then a single copy of the values
+  // on the host and a single render buffer on the device. This buffer's own `data` is released, and everything else
+  // (getPopulatedHostBufferRef(), getRenderAttributeBuffer(), indexed views...) is forwarded to the other buffer.
+  // NOTE: this means that code which may run on a sharing buffer must read the values through
+  // getPopulatedHostBufferRef(), not directly from `data`.
+  //
+  // Updates made through any of the buffers are seen by all of them, with a single upload. The registries of the other
+  // buffers are told about the update through ManagedBufferRegistry::sharedBufferUpdated(). If the buffer which holds
+  // the values is deleted, they stay alive as long as some buffer is still sharing them: one of the sharing buffers
+  // takes them over, and the others share from it instead.
+  //
+  // Only attribute buffers whose values are set externally (not computed) can be shared, and they must have the same
+  // size.
+  void shareFrom(ManagedBuffer<T>& source);
+
+  // True if this buffer uses the values of another buffer (see shareFrom())
+  bool isSharing() const { return sharedSource != nullptr; }
+
+  // The number of other buffers which use the values of this buffer
+  size_t sharingBufferCount() const { return sharingBuffers.size(); }
+
   // ========================================================================
   // == Indexed views
   // ========================================================================
@@ -174,8 +221,17 @@ public:
   //
   // Internally, these indexed views are cached. It is safe to call this function many times, after the first the
   // same view will be returned repeatedly at no additional cost.
+  //
+  // When the data is already on the device and the engine's compute tier is available, the views are gathered directly
+  // on the device. Otherwise they are gathered on the host. If the data only lives on the device (e.g. after
+  // markRenderAttributeBufferUpdated() or with external storage), that means reading all of it back to the host each
+  // time it changes. The host copy is kept until the next change, so other views of the same data reuse it.
   std::shared_ptr<render::AttributeBuffer> getIndexedRenderAttributeBuffer(ManagedBuffer<uint32_t>& indices);
 
+  // The views are gathered again whenever the data changes, but not when the indices do. After updating the indices,
+  // call this to gather the view for them again (it does nothing if there is no such view).
+  void updateIndexedView(ManagedBuffer<uint32_t>& indices);
+
   // ========================================================================
   // == Direct access to the GPU (device-side) render texture buffer
   // ========================================================================
@@ -186,11 +242,24 @@ public:
   std::shared_ptr<render::TextureBuffer> getRenderTextureBuffer();
   void markRenderTextureBufferUpdated();
 
+  // Use an externally-owned native texture as the device-side storage, as above. Its size must match the size set by
+  // setTextureSize(). NOTE: copying texture data back to the host is not supported yet, so any host-side access to the
+  // values will fail after this is called.
+  void setExternalRenderTextureBuffer(uint32_t nativeID);
+
 
 protected:
   // == Internal members
 
   bool hostBufferIsPopulated; // true if the host buffer contains currently-valid data
+  uint64_t dataVersion = 0;
+
+  // == Internal representation of shared values
+  // At most one level deep: a buffer which holds values shared by others never shares from another buffer itself.
+  ManagedBuffer<T>* sharedSource = nullptr;       // the buffer whose values this one uses, if any
+  std::vector<ManagedBuffer<T>*> sharingBuffers; // the buffers which use the values of this one
+  void notifySharingBuffers();                   // tell the registries of all buffers sharing values with this one
+  void handOverSharedValues();                   // pass the values to a sharing buffer, before this one is deleted
 
   std::shared_ptr<render::AttributeBuffer> renderAttributeBuffer;
   std::shared_ptr<render::TextureBuffer> renderTextureBuffer;
@@ -212,9 +281,12 @@ protected:
       existingIndexedViews;
   void updateIndexedViews();
   void removeDeletedIndexedViews();
+  void gatherIndexedView(ManagedBuffer<uint32_t>& indices, render::AttributeBuffer& viewBuffer);
 
   // == Internal helper functions
 
+  void uploadHostBufferToDevice(); // copy `data` to the render buffers and indexed views, if there are any
+  void cancelDeferredUpload();
   void invalidateHostBuffer();
   bool deviceBufferTypeIsTexture();
   void checkDeviceBufferTypeIs(DeviceBufferType targetType);
@@ -222,11 +294,6 @@ protected:
 
   enum class CanonicalDataSource { HostData = 0, NeedsCompute, RenderBuffer };
   CanonicalDataSource currentCanonicalDataSource();
-
-  // Manage the program which copies indexed data from the renderBuffer to the indexed views
-  void ensureHaveBufferIndexCopyProgram();
-  void invokeBufferIndexCopyProgram();
-  std::shared_ptr<render::ShaderProgram> bufferIndexCopyProgram;
 };
 
 
@@ -273,6 +340,19 @@ public:
   template <typename T>
   void addManagedBuffer(ManagedBuffer<T>* buffer);
 
+  // Called when the values of one of this registry's buffers were updated through another buffer which shares them
+  // (see ManagedBuffer::shareFrom()), so that anything derived from them can be updated too.
+  virtual void sharedBufferUpdated(const std::string& bufferName) {}
+
+  // Used when device uploads are deferred (see UploadScheduler). Uploads for all buffers with the same upload group
+  // are applied together, and groups with any visible buffers are applied first.
+  virtual ManagedBufferRegistry* getUploadGroup() { return this; }
+  virtual bool isUploadVisible() { return true; }
+
+  // Whether the buffers are drawn in to the pick buffer, so that it must be re-rendered when they change (see
+  // pick::markPickBufferStale())
+  virtual bool buffersAffectPicking() { return false; }
+
   // clang-format off
   ManagedBufferMap<float>        managedBufferMap_float;
   ManagedBufferMap<double>       managedBufferMap_double;
@@ -17,6 +17,7 @@ namespace backend_openGL_mock {
 class GLAttributeBuffer : public AttributeBuffer {
 public:
   GLAttributeBuffer(RenderDataType dataType_, int arrayCount_);
+  GLAttributeBuffer(RenderDataType dataType_, int arrayCount_, int64_t dataSize_); // wrap a fake external buffer
   virtual ~GLAttributeBuffer();
 
   void bind();
@@ -65,8 +66,14 @@ public:
 
   uint32_t getNativeBufferID() override;
 
+  // The mock keeps a copy of the data, so it can be read back and used by the mock compute tier
+  const std::vector<unsigned char>& getStoredBytes() const { return storedBytes; }
+  void setStoredBytes(const std::vector<unsigned char>& bytes, int64_t newDataSize);
+
 protected:
 private:
+  std::vector<unsigned char> storedBytes; // (empty for fake external buffers, which read back as zeros)
+
   void checkType(RenderDataType targetType);
   void checkArray(int arrayCount);
 
@@ -97,6 +104,9 @@ public:
   GLTextureBuffer(TextureFormat format, unsigned int sizeX_, unsigned int sizeY_, unsigned int sizeZ_,
                   const float* data);
 
+  // wrap a fake external texture
+  GLTextureBuffer(TextureFormat format, int dim_, unsigned int sizeX_, unsigned int sizeY_, unsigned int sizeZ_);
+
   ~GLTextureBuffer() override;
 
 
@@ -125,6 +135,10 @@ public:
   void setData(const std::vector<std::array<glm::vec3, 2>>& data) override;
   void setData(const std::vector<std::array<glm::vec3, 3>>& data) override;
   void setData(const std::vector<std::array<glm::vec3, 4>>& data) override;
+  void setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX, unsigned int regionY,
+                       const float* data) override;
+  void setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX, unsigned int regionY,
+                       const unsigned char* data) override;
 
   void setFilterMode(FilterMode newMode) override;
   void* getNativeHandle() override;
@@ -179,6 +193,7 @@ public:
   std::vector<unsigned char> readBuffer() override;
   std::array<float, 4> readFloat4(int xPos, int yPos) override;
   float readDepth(int xPos, int yPos) override;
+  std::vector<float> readFloat4Region(int xStart, int yStart, int sizeX, int sizeY) override;
   void blitTo(FrameBuffer* other) override;
 
   // Getters
@@ -359,6 +374,12 @@ public:
   void ImGuiNewFrame() override;
   void ImGuiRender() override;
 
+  // Compute tier, done on the host with the stored data of the mock buffers (following the openGL compute programs)
+  bool computeRange(AttributeBuffer& values, float& minOut, float& maxOut) override;
+  bool computeHistogram(AttributeBuffer& values, float rangeMin, float rangeMax, size_t nBins,
+                        std::vector<uint32_t>& countsOut) override;
+  bool computeGather(AttributeBuffer& source, AttributeBuffer& indices, AttributeBuffer& target) override;
+
   // === Factory methods
 
   // create attribute buffers
@@ -380,6 +401,13 @@ public:
                                                        unsigned int sizeZ_,
                                                        const float* data) override; // 3d
 
+  // wrap externally-owned buffers
+  std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer(RenderDataType dataType_, int arrayCount_,
+                                                             uint32_t nativeID, int64_t dataSize) override;
+  std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer(TextureFormat format, int dim, uint32_t nativeID,
+                                                         unsigned int sizeX_, unsigned int sizeY_,
+                                                         unsigned int sizeZ_) override;
+
   // create render buffers
   std::shared_ptr<RenderBuffer> generateRenderBuffer(RenderBufferType type, unsigned int sizeX_,
                                                      unsigned int sizeY_) override;
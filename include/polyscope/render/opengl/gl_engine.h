@@ -44,11 +44,16 @@ typedef GLint TextureLocation;
 class GLAttributeBuffer : public AttributeBuffer {
 public:
   GLAttributeBuffer(RenderDataType dataType_, int arrayCount_);
+  // wrap an existing buffer object which is owned externally (it will not be deleted)
+  GLAttributeBuffer(RenderDataType dataType_, int arrayCount_, VertexBufferHandle externalHandle, int64_t dataSize_);
   virtual ~GLAttributeBuffer();
 
   void bind();
   VertexBufferHandle getHandle() const { return VBOLoc; }
 
+  // Allocate space for newDataSize entries without setting any data (e.g. to be written by a compute program)
+  void allocate(int64_t newDataSize);
+
   void setData(const std::vector<glm::vec2>& data) override;
   void setData(const std::vector<glm::vec3>& data) override;
   void setData(const std::vector<glm::vec4>& data) override;
@@ -95,6 +100,7 @@ public:
 
 protected:
   VertexBufferHandle VBOLoc;
+  bool ownsHandle = true; // if false, the buffer object was created externally and we must not delete it
 
 private:
   void checkType(RenderDataType targetType);
@@ -129,6 +135,10 @@ public:
   GLTextureBuffer(TextureFormat format, unsigned int sizeX_, unsigned int sizeY_, unsigned int sizeZ_,
                   const float* data);
 
+  // wrap an existing texture object which is owned externally (it will not be deleted)
+  GLTextureBuffer(TextureFormat format, int dim_, TextureBufferHandle externalHandle, unsigned int sizeX_,
+                  unsigned int sizeY_, unsigned int sizeZ_);
+
   ~GLTextureBuffer() override;
 
 
@@ -157,6 +167,10 @@ public:
   void setData(const std::vector<std::array<glm::vec3, 2>>& data) override;
   void setData(const std::vector<std::array<glm::vec3, 3>>& data) override;
   void setData(const std::vector<std::array<glm::vec3, 4>>& data) override;
+  void setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX, unsigned int regionY,
+                       const float* data) override;
+  void setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX, unsigned int regionY,
+                       const unsigned char* data) override;
 
   void setFilterMode(FilterMode newMode) override;
   void* getNativeHandle() override;
@@ -173,6 +187,7 @@ public:
 
 protected:
   TextureBufferHandle handle;
+  bool ownsHandle = true; // if false, the texture object was created externally and we must not delete it
 };
 
 class GLRenderBuffer : public RenderBuffer {
@@ -216,13 +231,28 @@ public:
   std::vector<unsigned char> readBuffer() override;
   std::array<float, 4> readFloat4(int xPos, int yPos) override;
   float readDepth(int xPos, int yPos) override;
+  std::vector<float> readFloat4Region(int xStart, int yStart, int sizeX, int sizeY) override;
   void blitTo(FrameBuffer* other) override;
 
+  // Reads in to a pixel pack buffer, guarded by a fence
+  void beginAsyncReadBuffer() override;
+  bool finishAsyncReadBuffer(std::vector<unsigned char>& out, bool wait = false) override;
+  void beginAsyncReadFloat4Region(int xStart, int yStart, int sizeX, int sizeY) override;
+  bool finishAsyncReadFloat4Region(std::vector<float>& out, bool wait = false) override;
+
   // Getters
   FrameBufferHandle getHandle() const { return handle; }
   uint32_t getNativeBufferID() override;
 
   FrameBufferHandle handle;
+
+protected:
+  GLuint asyncReadPBO = 0;
+  GLsync asyncReadFence = nullptr;
+  size_t asyncReadSize = 0;
+  GLuint asyncRegionReadPBO = 0;
+  GLsync asyncRegionReadFence = nullptr; // (null for an empty region, which needs no read)
+  size_t asyncRegionReadSize = 0;        // number of floats
 };
 
 // Classes to keep track of attributes and uniforms
@@ -372,6 +402,8 @@ public:
 
   // High-level control
   void checkError(bool fatal = false) override;
+  void finishDeviceWork() override;
+  bool getDeviceMemoryInfo(size_t& totalBytesOut, size_t& availableBytesOut) override;
 
   std::vector<unsigned char> readDisplayBuffer() override;
 
@@ -403,6 +435,13 @@ public:
                                                        unsigned int sizeZ_,
                                                        const float* data) override; // 3d
 
+  // wrap externally-owned buffers
+  std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer(RenderDataType dataType_, int arrayCount_,
+                                                             uint32_t nativeID, int64_t dataSize) override;
+  std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer(TextureFormat format, int dim, uint32_t nativeID,
+                                                         unsigned int sizeX_, unsigned int sizeY_,
+                                                         unsigned int sizeZ_) override;
+
   // create render buffers
   std::shared_ptr<RenderBuffer> generateRenderBuffer(RenderBufferType type, unsigned int sizeX_,
                                                      unsigned int sizeY_) override;
@@ -426,10 +465,23 @@ public:
 
   virtual void setFrontFaceCCW(bool newVal) override;
 
+  // Optional compute tier (requires openGL 4.3)
+  bool computeRange(AttributeBuffer& values, float& minOut, float& maxOut) override;
+  bool computeHistogram(AttributeBuffer& values, float rangeMin, float rangeMax, size_t nBins,
+                        std::vector<uint32_t>& countsOut) override;
+  bool computeGather(AttributeBuffer& source, AttributeBuffer& indices, AttributeBuffer& target) override;
+
 protected:
   // Helpers
   virtual void createSlicePlaneFliterRule(std::string name) override;
 
+  // Check the context version and load the extra entry points used by the compute tier. Called by the windowing
+  // backends once the context is current.
+  typedef void* (*GLProcLoader)(const char* name);
+  void initializeComputeTier(GLProcLoader loader);
+  std::unordered_map<std::string, ProgramHandle> computeProgramCache;
+  ProgramHandle getComputeProgram(const std::string& name, const ShaderStageSpecification& spec);
+
   // Shader program & rule caches
   std::unordered_map<std::string, std::pair<std::vector<ShaderStageSpecification>, DrawMode>> registeredShaderPrograms;
   std::unordered_map<std::string, ShaderReplacementRule> registeredShaderRules;
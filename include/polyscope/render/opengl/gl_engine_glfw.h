@@ -64,6 +64,7 @@ public:
   bool getWindowResizable() override;
   std::tuple<int, int> getWindowPos() override;
   bool windowRequestsClose() override;
+  double getDisplayRefreshRate() override;
 
   bool isKeyPressed(char c) override; // for lowercase a-z and 0-9 only
   int getKeyCode(char c) override;    // for lowercase a-z and 0-9 only
@@ -0,0 +1,23 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include "polyscope/render/opengl/gl_shaders.h"
+
+namespace polyscope {
+namespace render {
+namespace backend_openGL3 {
+
+// Compute programs for the optional compute tier. These require openGL 4.3, so unlike the other shaders they specify
+// their own GLSL version rather than using the replacement rules.
+
+// All of these use a workgroup size of 256, and loop over the data with a stride of the total number of invocations.
+constexpr unsigned int COMPUTE_WORKGROUP_SIZE = 256;
+
+extern const ShaderStageSpecification COMPUTE_RANGE_SHADER;
+extern const ShaderStageSpecification COMPUTE_HISTOGRAM_SHADER;
+extern const ShaderStageSpecification COMPUTE_GATHER_SHADER;
+
+} // namespace backend_openGL3
+} // namespace render
+} // namespace polyscope
@@ -21,6 +21,7 @@ extern const ShaderReplacementRule CYLINDER_PROPAGATE_BLEND_COLOR;
 extern const ShaderReplacementRule CYLINDER_PROPAGATE_PICK;
 extern const ShaderReplacementRule CYLINDER_CULLPOS_FROM_MID;
 extern const ShaderReplacementRule CYLINDER_VARIABLE_SIZE;
+extern const ShaderReplacementRule CYLINDER_THIN_AS_LINE;
 
 
 } // namespace backend_openGL3
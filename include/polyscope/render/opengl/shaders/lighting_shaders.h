@@ -20,6 +20,7 @@ extern const ShaderReplacementRule DOWNSAMPLE_RESOLVE_4;
 extern const ShaderReplacementRule INVERSE_TONEMAP;
 
 extern const ShaderReplacementRule TRANSPARENCY_RESOLVE_SIMPLE;
+extern const ShaderReplacementRule EYE_DOME_LIGHTING;
 extern const ShaderReplacementRule TRANSPARENCY_STRUCTURE;
 extern const ShaderReplacementRule TRANSPARENCY_PEEL_STRUCTURE;
 extern const ShaderReplacementRule TRANSPARENCY_PEEL_GROUND;
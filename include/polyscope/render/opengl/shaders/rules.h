@@ -39,6 +39,13 @@ extern const ShaderReplacementRule COMPUTE_SHADE_NORMAL_FROM_POSITION;
 extern const ShaderReplacementRule PREMULTIPLY_LIT_COLOR;
 extern const ShaderReplacementRule CULL_POS_FROM_VIEW;
 
+// Per-element masks (see ElementMask)
+extern const ShaderReplacementRule ELEMENT_MASK_PROPAGATE_GEOM;  // read the mask for point and cylinder programs, hide
+extern const ShaderReplacementRule ELEMENT_MASK_PROPAGATE_MESH;  // read the mask for mesh programs, hide
+extern const ShaderReplacementRule ELEMENT_MASK_SHADE_RAYCAST;   // tint and outline raycast spheres and cylinders
+extern const ShaderReplacementRule ELEMENT_MASK_SHADE_FLAT;      // tint point quads
+extern const ShaderReplacementRule ELEMENT_MASK_SHADE_MESH;      // tint and outline mesh triangles
+
 ShaderReplacementRule generateSlicePlaneRule(std::string uniquePostfix);
 ShaderReplacementRule generateVolumeGridSlicePlaneRule(std::string uniquePostfix);
 
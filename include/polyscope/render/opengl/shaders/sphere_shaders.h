@@ -12,10 +12,13 @@ namespace backend_openGL3 {
 extern const ShaderStageSpecification FLEX_SPHERE_VERT_SHADER;
 extern const ShaderStageSpecification FLEX_SPHERE_GEOM_SHADER;
 extern const ShaderStageSpecification FLEX_SPHERE_FRAG_SHADER;
+extern const ShaderStageSpecification FLEX_SPHERE_DEPTH_FRAG_SHADER;
 
 extern const ShaderStageSpecification FLEX_POINTQUAD_VERT_SHADER;
 extern const ShaderStageSpecification FLEX_POINTQUAD_GEOM_SHADER;
 extern const ShaderStageSpecification FLEX_POINTQUAD_FRAG_SHADER;
+extern const ShaderStageSpecification FLEX_POINTPIXEL_GEOM_SHADER;
+extern const ShaderStageSpecification FLEX_POINTPIXEL_FRAG_SHADER;
 
 // Rules specific to spheres
 extern const ShaderReplacementRule SPHERE_PROPAGATE_VALUE;
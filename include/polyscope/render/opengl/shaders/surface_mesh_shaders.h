@@ -18,6 +18,7 @@ extern const ShaderStageSpecification SIMPLE_MESH_FRAG_SHADER;
 
 // Rules specific to meshes
 extern const ShaderReplacementRule MESH_WIREFRAME_FROM_BARY;
+extern const ShaderReplacementRule MESH_WIREFRAME_FROM_BARY_ALL_REAL;
 extern const ShaderReplacementRule MESH_WIREFRAME;
 extern const ShaderReplacementRule MESH_WIREFRAME_ONLY;
 extern const ShaderReplacementRule MESH_BACKFACE_NORMAL_FLIP;
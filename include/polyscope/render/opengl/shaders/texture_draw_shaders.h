@@ -21,6 +21,7 @@ extern const ShaderStageSpecification COMPOSITE_PEEL;
 extern const ShaderStageSpecification DEPTH_COPY;
 extern const ShaderStageSpecification DEPTH_TO_MASK;
 extern const ShaderStageSpecification BLUR_RGB;
+extern const ShaderStageSpecification PICK_HIGHLIGHT;
 
 extern const ShaderStageSpecification SCALAR_TEXTURE_COLORMAP;
 
@@ -40,6 +41,9 @@ extern const ShaderReplacementRule
     TEXTURE_SHADE_COLORALPHA;                               // sample a coloralpha from a texture and use it for shading
 extern const ShaderReplacementRule TEXTURE_PROPAGATE_VALUE; // sample a scalar from a texture and use it for shading
 extern const ShaderReplacementRule TEXTURE_PROPAGATE_COLOR; // sample a color from a texture and use it for shading
+extern const ShaderReplacementRule VIRTUAL_TEXTURE_LOOKUP; // sampleVirtualTexture(), via a page table and page atlas
+extern const ShaderReplacementRule VIRTUAL_TEXTURE_PROPAGATE_VALUE; // sample a scalar from a virtual texture
+extern const ShaderReplacementRule VIRTUAL_TEXTURE_PROPAGATE_COLOR; // sample a color from a virtual texture
 extern const ShaderReplacementRule
     TEXTURE_BILLBOARD_FROM_UNIFORMS; // adjust a texture's billboard position via uniforms
 extern const ShaderReplacementRule SHADE_NORMAL_FROM_TEXTURE;
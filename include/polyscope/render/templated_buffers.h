@@ -19,6 +19,11 @@ namespace render {
 template <typename T>
 std::shared_ptr<AttributeBuffer> generateAttributeBuffer(Engine* engine);
 
+// Wrap an externally-owned native buffer holding dataSize entries of a given template type
+// (see Engine::wrapNativeAttributeBuffer())
+template <typename T>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer(Engine* engine, uint32_t nativeID, int64_t dataSize);
+
 // Get a single data value from a buffer of a templated type
 // (use std::array<T>s to get arraycount repeated attributes)
 template <typename T>
@@ -45,6 +50,12 @@ std::shared_ptr<TextureBuffer> generateTextureBuffer(Engine* engine) {
 template <typename T>
 std::shared_ptr<TextureBuffer> generateTextureBuffer(DeviceBufferType D, Engine* engine);
 
+// Wrap an externally-owned native texture as a texture buffer of a given template type, stored with the same format
+// that generateTextureBuffer() would use (see Engine::wrapNativeTextureBuffer())
+template <typename T>
+std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer(DeviceBufferType D, Engine* engine, uint32_t nativeID,
+                                                       uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+
 // Get a single data value from a texturebuffer of a templated type
 // (use std::array<T>s to get arraycount repeated attributes)
 // openGL doesn't support this anyway...
@@ -0,0 +1,59 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace polyscope {
+namespace render {
+
+// forward declarations
+class ManagedBufferRegistry;
+
+// A queue of host-to-device uploads which are applied across frames under a budget, rather than immediately.
+//
+// When options::deferDeviceUploads is set, ManagedBuffer queues its uploads here instead of doing them in
+// markHostBufferUpdated(), so that e.g. updating many quantities at once doesn't stall a single frame. Uploads are
+// grouped by the structure their buffers belong to (see ManagedBufferRegistry::getUploadGroup()), and a group is always
+// applied all at once, so a structure is drawn with either all of its old data or all of its new data. Groups which
+// are currently visible are applied first.
+class UploadScheduler {
+
+public:
+  // Queue `upload` for the buffer identified by `buffer`. If that buffer is already queued, the new upload replaces the
+  // old one but keeps its place in the queue. `nBytes` is only used for budgeting.
+  void enqueue(const void* buffer, ManagedBufferRegistry* registry, size_t nBytes, std::function<void()> upload);
+
+  // Drop the queued upload for a buffer, if there is one (e.g. because the buffer is being deleted)
+  void cancel(const void* buffer);
+
+  bool isPending(const void* buffer) const;
+  bool empty() const { return entries.empty(); }
+  size_t pendingBytes() const;
+
+  // Apply queued groups in priority order until either budget is used up. At least one group is applied per call, so
+  // the queue always drains eventually, even if a single group is larger than the budget.
+  void service(size_t maxBytes, double maxMilliseconds);
+
+  // Apply everything which is queued
+  void flush();
+
+private:
+  struct Entry {
+    const void* buffer;
+    ManagedBufferRegistry* registry;
+    size_t nBytes;
+    std::function<void()> upload;
+  };
+
+  std::vector<Entry> entries; // in the order they were first queued
+
+  // Re-insert entries which were not applied, ahead of anything queued while applying the others
+  void requeue(std::vector<Entry>& remaining);
+};
+
+} // namespace render
+} // namespace polyscope
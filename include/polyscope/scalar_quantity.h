@@ -10,6 +10,10 @@
 #include "polyscope/render/managed_buffer.h"
 #include "polyscope/scaled_value.h"
 #include "polyscope/standardize_data_array.h"
+#include "polyscope/types.h"
+
+#include <deque>
+#include <future>
 
 namespace polyscope {
 
@@ -52,6 +56,23 @@ public:
   QuantityT* resetMapRange(); // reset to full range
   std::pair<double, double> getDataRange();
 
+  // How the data range, histogram, and colormap range follow the values in updateData() (see ScalarRangeUpdate).
+  // The range is computed in one vectorized pass over the new values, split across worker threads when large.
+  QuantityT* setRangeUpdate(ScalarRangeUpdate val);
+  ScalarRangeUpdate getRangeUpdate();
+
+  // Take the data range over this many of the most recent updates, rather than just the latest one, so that the
+  // colormap range of live data doesn't jump around from frame to frame (default: 1)
+  QuantityT* setRangeUpdateWindow(size_t nUpdates);
+  size_t getRangeUpdateWindow();
+
+  // Compute the range and histogram of updated values on a background thread, so updateData() returns right away. The
+  // new ranges take effect on a later frame (or immediately, in getDataRange() and getMapRange()). If the values are
+  // updated again before the background work finishes, its result is dropped, and the work starts over with the newest
+  // values once it is done.
+  QuantityT* setRangeUpdateAsync(bool val);
+  bool getRangeUpdateAsync();
+
   // Isolines
   QuantityT* setIsolinesEnabled(bool newEnabled);
   bool getIsolinesEnabled();
@@ -71,6 +92,25 @@ protected:
   PersistentValue<float> vizRangeMin;
   PersistentValue<float> vizRangeMax;
   Histogram hist;
+  bool histogramIsStale = true; // if true, hist must be rebuilt from the values before it is next drawn
+
+  // Range tracking in updateData()
+  struct UpdateStats {
+    std::pair<float, float> finiteRange;
+    std::pair<double, double> histRange;
+    std::vector<double> histCounts;
+  };
+  ScalarRangeUpdate rangeUpdate = ScalarRangeUpdate::Off;
+  size_t rangeUpdateWindow = 1;
+  bool rangeUpdateAsync = false;
+  std::deque<std::pair<float, float>> recentRanges; // finite ranges of the most recent updates, oldest first
+  std::future<UpdateStats> pendingUpdateStats;
+  bool pendingUpdateStatsSuperseded = false; // the values were updated again since pendingUpdateStats started
+  void applyRangeUpdate(std::pair<float, float> finiteRange);
+  std::pair<float, float> computeValuesRange(); // finite range of the current values, on the device if possible
+  void startUpdateStats();                         // compute the statistics of the current values in the background
+  void applyPendingUpdateStats(bool waitForStats); // no-op if there is nothing pending
+  std::pair<double, double> defaultMapRange();     // the colormap range resetMapRange() uses
 
   // Parameters
   PersistentValue<std::string> cMap;
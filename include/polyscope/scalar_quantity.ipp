@@ -1,7 +1,13 @@
 // Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
 
 #include "imgui.h"
+#include "polyscope/reductions.h"
 #include "polyscope/utilities.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
 namespace polyscope {
 
 template <typename QuantityT>
@@ -18,7 +24,6 @@ ScalarQuantity<QuantityT>::ScalarQuantity(QuantityT& quantity_, const std::vecto
 
 {
   hist.updateColormap(cMap.get());
-  hist.buildHistogram(values.data);
 
   if (vizRangeMin.holdsDefaultValue()) { // min and max should always have same cache state
     // dynamically compute a viz range from the data min/max
@@ -68,7 +73,14 @@ void ScalarQuantity<QuantityT>::buildScalarUI() {
                         .c_str());
 
 
+  applyPendingUpdateStats(false);
+
   // Draw the histogram of values
+  // (the histogram is built lazily, the first time it is actually shown after the data changes)
+  if (histogramIsStale) {
+    hist.buildHistogram(values);
+    histogramIsStale = false;
+  }
   hist.colormapRange = std::pair<float, float>(vizRangeMin.get(), vizRangeMax.get());
   float windowWidth = ImGui::GetWindowWidth();
   float histWidth = 0.75 * windowWidth;
@@ -165,6 +177,15 @@ void ScalarQuantity<QuantityT>::buildScalarUI() {
 template <typename QuantityT>
 void ScalarQuantity<QuantityT>::buildScalarOptionsUI() {
   if (ImGui::MenuItem("Reset colormap range")) resetMapRange();
+  if (ImGui::BeginMenu("Range on update")) {
+    if (ImGui::MenuItem("Off", NULL, rangeUpdate == ScalarRangeUpdate::Off)) setRangeUpdate(ScalarRangeUpdate::Off);
+    if (ImGui::MenuItem("Fixed", NULL, rangeUpdate == ScalarRangeUpdate::Fixed))
+      setRangeUpdate(ScalarRangeUpdate::Fixed);
+    if (ImGui::MenuItem("Expand only", NULL, rangeUpdate == ScalarRangeUpdate::ExpandOnly))
+      setRangeUpdate(ScalarRangeUpdate::ExpandOnly);
+    if (ImGui::MenuItem("Fit", NULL, rangeUpdate == ScalarRangeUpdate::Fit)) setRangeUpdate(ScalarRangeUpdate::Fit);
+    ImGui::EndMenu();
+  }
   if (ImGui::MenuItem("Enable isolines", NULL, isolinesEnabled.get())) setIsolinesEnabled(!isolinesEnabled.get());
 }
 
@@ -180,6 +201,8 @@ std::vector<std::string> ScalarQuantity<QuantityT>::addScalarRules(std::vector<s
 
 template <typename QuantityT>
 void ScalarQuantity<QuantityT>::setScalarUniforms(render::ShaderProgram& p) {
+  applyPendingUpdateStats(false);
+
   p.setUniform("u_rangeLow", vizRangeMin.get());
   p.setUniform("u_rangeHigh", vizRangeMax.get());
 
@@ -190,22 +213,25 @@ void ScalarQuantity<QuantityT>::setScalarUniforms(render::ShaderProgram& p) {
 }
 
 template <typename QuantityT>
-QuantityT* ScalarQuantity<QuantityT>::resetMapRange() {
+std::pair<double, double> ScalarQuantity<QuantityT>::defaultMapRange() {
   switch (dataType) {
   case DataType::STANDARD:
-    vizRangeMin = dataRange.first;
-    vizRangeMax = dataRange.second;
     break;
   case DataType::SYMMETRIC: {
     double absRange = std::max(std::abs(dataRange.first), std::abs(dataRange.second));
-    vizRangeMin = -absRange;
-    vizRangeMax = absRange;
-  } break;
+    return std::make_pair(-absRange, absRange);
+  }
   case DataType::MAGNITUDE:
-    vizRangeMin = 0.;
-    vizRangeMax = dataRange.second;
-    break;
+    return std::make_pair(0., dataRange.second);
   }
+  return dataRange;
+}
+
+template <typename QuantityT>
+QuantityT* ScalarQuantity<QuantityT>::resetMapRange() {
+  std::pair<double, double> range = defaultMapRange();
+  vizRangeMin = range.first;
+  vizRangeMax = range.second;
 
   vizRangeMin.clearCache();
   vizRangeMax.clearCache();
@@ -218,8 +244,148 @@ template <typename QuantityT>
 template <class V>
 void ScalarQuantity<QuantityT>::updateData(const V& newValues) {
   validateSize(newValues, values.size(), "scalar quantity " + quantity.name);
+
+  // Statistics which are still being computed for the previous values are out of date now. The background work is not
+  // waited for, its result is dropped when it finishes (see applyPendingUpdateStats()).
+  if (pendingUpdateStats.valid()) pendingUpdateStatsSuperseded = true;
+
   values.data = standardizeArray<float, V>(newValues);
   values.markHostBufferUpdated();
+  histogramIsStale = true;
+
+  if (rangeUpdate == ScalarRangeUpdate::Off) return;
+
+  if (!rangeUpdateAsync) {
+    // the histogram is left to be built lazily, as usual
+    applyRangeUpdate(computeValuesRange());
+    return;
+  }
+
+  // (if there is work running already, it starts over with these values once it finishes)
+  if (!pendingUpdateStats.valid()) startUpdateStats();
+}
+
+template <typename QuantityT>
+std::pair<float, float> ScalarQuantity<QuantityT>::computeValuesRange() {
+  // If the new values are on the device already, reduce them there, otherwise on the host
+  float minVal, maxVal;
+  if (values.hasRenderAttributeBuffer() && !values.hasPendingDeferredUpload() &&
+      render::engine->computeTierAvailable() &&
+      render::engine->computeRange(*values.getRenderAttributeBuffer(), minVal, maxVal)) {
+    return {minVal, maxVal};
+  }
+  return computeFiniteRange(values.data);
+}
+
+template <typename QuantityT>
+void ScalarQuantity<QuantityT>::startUpdateStats() {
+  // Work from a copy, the values may be updated again (or released) before this finishes. The copy is made once per
+  // background pass, not once per update.
+  size_t nBins = hist.getBinCount();
+  pendingUpdateStatsSuperseded = false;
+  pendingUpdateStats = std::async(
+      std::launch::async,
+      [nBins](std::vector<float> vals) {
+        UpdateStats stats;
+        stats.finiteRange = computeFiniteRange(vals);
+        stats.histRange = robustifyMinMax<double>(stats.finiteRange.first, stats.finiteRange.second);
+        stats.histCounts = computeHistogramCounts(vals, stats.histRange.first, stats.histRange.second, nBins);
+        return stats;
+      },
+      values.data);
+}
+
+template <typename QuantityT>
+void ScalarQuantity<QuantityT>::applyRangeUpdate(std::pair<float, float> finiteRange) {
+
+  recentRanges.push_back(finiteRange);
+  while (recentRanges.size() > std::max<size_t>(rangeUpdateWindow, 1)) {
+    recentRanges.pop_front();
+  }
+
+  // (ranges with no finite values are (+inf, -inf), which drop out here)
+  float minVal = std::numeric_limits<float>::infinity();
+  float maxVal = -std::numeric_limits<float>::infinity();
+  for (const std::pair<float, float>& r : recentRanges) {
+    minVal = std::min(minVal, r.first);
+    maxVal = std::max(maxVal, r.second);
+  }
+  dataRange = robustifyMinMax<double>(minVal, maxVal, 1e-5);
+
+  std::pair<double, double> newMapRange = defaultMapRange();
+  switch (rangeUpdate) {
+  case ScalarRangeUpdate::Off:
+  case ScalarRangeUpdate::Fixed:
+    break;
+  case ScalarRangeUpdate::ExpandOnly:
+    vizRangeMin = std::min(static_cast<double>(vizRangeMin.get()), newMapRange.first);
+    vizRangeMax = std::max(static_cast<double>(vizRangeMax.get()), newMapRange.second);
+    vizRangeMin.clearCache();
+    vizRangeMax.clearCache();
+    break;
+  case ScalarRangeUpdate::Fit:
+    vizRangeMin = newMapRange.first;
+    vizRangeMax = newMapRange.second;
+    vizRangeMin.clearCache();
+    vizRangeMax.clearCache();
+    break;
+  }
+
+  requestRedraw();
+}
+
+template <typename QuantityT>
+void ScalarQuantity<QuantityT>::applyPendingUpdateStats(bool waitForStats) {
+  if (!pendingUpdateStats.valid()) return;
+  if (!waitForStats && pendingUpdateStats.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+  UpdateStats stats = pendingUpdateStats.get();
+  if (pendingUpdateStatsSuperseded) {
+    pendingUpdateStatsSuperseded = false;
+    if (rangeUpdateAsync && rangeUpdate != ScalarRangeUpdate::Off) {
+      startUpdateStats();
+      applyPendingUpdateStats(waitForStats);
+    }
+    return;
+  }
+
+  applyRangeUpdate(stats.finiteRange);
+  hist.buildHistogram(stats.histCounts, stats.histRange);
+  histogramIsStale = false;
+}
+
+template <typename QuantityT>
+QuantityT* ScalarQuantity<QuantityT>::setRangeUpdate(ScalarRangeUpdate val) {
+  rangeUpdate = val;
+  return &quantity;
+}
+template <typename QuantityT>
+ScalarRangeUpdate ScalarQuantity<QuantityT>::getRangeUpdate() {
+  return rangeUpdate;
+}
+
+template <typename QuantityT>
+QuantityT* ScalarQuantity<QuantityT>::setRangeUpdateWindow(size_t nUpdates) {
+  rangeUpdateWindow = std::max<size_t>(nUpdates, 1);
+  while (recentRanges.size() > rangeUpdateWindow) {
+    recentRanges.pop_front();
+  }
+  return &quantity;
+}
+template <typename QuantityT>
+size_t ScalarQuantity<QuantityT>::getRangeUpdateWindow() {
+  return rangeUpdateWindow;
+}
+
+template <typename QuantityT>
+QuantityT* ScalarQuantity<QuantityT>::setRangeUpdateAsync(bool val) {
+  applyPendingUpdateStats(true);
+  rangeUpdateAsync = val;
+  return &quantity;
+}
+template <typename QuantityT>
+bool ScalarQuantity<QuantityT>::getRangeUpdateAsync() {
+  return rangeUpdateAsync;
 }
 
 
@@ -245,10 +411,12 @@ QuantityT* ScalarQuantity<QuantityT>::setMapRange(std::pair<double, double> val)
 }
 template <typename QuantityT>
 std::pair<double, double> ScalarQuantity<QuantityT>::getMapRange() {
+  applyPendingUpdateStats(true);
   return std::pair<float, float>(vizRangeMin.get(), vizRangeMax.get());
 }
 template <typename QuantityT>
 std::pair<double, double> ScalarQuantity<QuantityT>::getDataRange() {
+  applyPendingUpdateStats(true);
   return dataRange;
 }
 
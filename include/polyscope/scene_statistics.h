@@ -0,0 +1,64 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "polyscope/quantity.h"
+#include "polyscope/types.h"
+
+namespace polyscope {
+namespace scene_statistics {
+
+// == Statistics over the values of scalar quantities, across all registered structures
+//
+// A query picks scalar quantities by structure type, structure name, and quantity name, and the elements to count (see
+// ElementFilter). Values which are not finite are never counted.
+//
+// For each quantity, the finite values which pass the filter are gathered and sorted once, in parallel chunks which
+// are then merged (see parallel.h), and cached until the values change (by the data version of their buffer) or the
+// masks or selection behind the filter do. Queries are answered from the cache without another pass over the data:
+// ranges and threshold counts by binary search, and percentiles by selecting ranks across the sorted values of all the
+// matching quantities. Values which only live on the render device are read back once per change. The cache holds a
+// copy of the values it has seen; clearCache() frees it.
+
+struct ScalarStatisticsQuery {
+  std::string structureType = ""; // only structures of this type, e.g. "Point Cloud" (any type if empty)
+  std::string structureName = ""; // only structures with this name (any name if empty)
+  std::string quantityName = "";  // only quantities with this name (any scalar quantity if empty)
+  ElementFilter filter = ElementFilter::All;
+  std::vector<double> percentiles; // percentiles to compute, in [0, 100]
+  std::vector<double> thresholds;  // count the values greater than each of these
+};
+
+struct ScalarStatistics {
+  size_t nValues = 0;                                 // finite values counted
+  float min = std::numeric_limits<float>::infinity(); // (+inf and -inf if there are no values)
+  float max = -std::numeric_limits<float>::infinity();
+  double mean = 0.;
+  std::vector<float> percentiles;       // one for each in the query, interpolated between ranks (NaN if no values)
+  std::vector<size_t> nAboveThresholds; // one for each in the query
+};
+
+// Statistics over the values of all matching quantities together
+ScalarStatistics computeScalarStatistics(const ScalarStatisticsQuery& query);
+
+// Statistics for each matching quantity separately
+std::vector<std::pair<Quantity*, ScalarStatistics>>
+computeScalarStatisticsPerQuantity(const ScalarStatisticsQuery& query);
+
+// The scalar quantities which a query matches. With ElementFilter::Visible, only quantities of enabled structures
+// match, and with ElementFilter::Selected, only quantities on elements which the structure can select.
+std::vector<Quantity*> findScalarQuantities(const ScalarStatisticsQuery& query);
+
+// == Cache
+void clearCache();
+size_t getCacheValueCount(); // total number of values held
+size_t getCacheBuildCount(); // number of times the values of a quantity were gathered and sorted, since startup
+
+} // namespace scene_statistics
+} // namespace polyscope
@@ -0,0 +1,68 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "polyscope/bvh.h"
+
+namespace polyscope {
+
+// A region of the screen, either an axis-aligned box or a closed lasso polygon, in screen coordinates (pixels, with
+// the origin in the upper left, as for pick::pickAtScreenCoords()).
+class ScreenRegion {
+
+public:
+  static ScreenRegion box(glm::vec2 cornerA, glm::vec2 cornerB);
+  static ScreenRegion lasso(std::vector<glm::vec2> polygon); // implicitly closed, may self-intersect (even-odd rule)
+
+  bool isLasso() const { return !polygon.empty(); }
+  const std::vector<glm::vec2>& getPolygon() const { return polygon; }
+  glm::vec2 getBoundMin() const { return boundMin; }
+  glm::vec2 getBoundMax() const { return boundMax; }
+
+  // Is the point in the region?
+  bool contains(glm::vec2 p) const;
+
+  // Classify a screen-space rectangle against the region: 0 if it is entirely outside, 2 if it is entirely inside, and
+  // 1 otherwise (possibly partially inside).
+  int classifyRect(glm::vec2 rectMin, glm::vec2 rectMax) const;
+
+private:
+  std::vector<glm::vec2> polygon; // empty for boxes
+  glm::vec2 boundMin{0., 0.};
+  glm::vec2 boundMax{0., 0.};
+};
+
+// A spatial index over a set of points, used to quickly find the ones which project in to a screen region. Structures
+// keep one per element type they support selecting, and rebuild it lazily, only when the key (e.g. the data version
+// of the positions buffer) changes. The index is in object space, so camera motion and changes to the object transform
+// don't require a rebuild. It does not keep a copy of the points: select() is passed the same points again, which the
+// structure already holds in a host buffer.
+class PointRegionIndex {
+
+public:
+  // True if the index was last built with this key
+  bool isCurrent(const std::vector<uint64_t>& key) const;
+
+  void build(const std::vector<glm::vec3>& points, std::vector<uint64_t> key);
+  void clear();
+
+  // All points whose projection lies in the region, in increasing order. `points` must be the points the index was
+  // built from. `objectToClip` takes object-space positions
+  // to clip space (projection * view * model), and the screen size is taken from the current view. Points behind the
+  // camera or outside the near/far planes are never selected. Occlusion is not considered: hidden points are selected
+  // too.
+  std::vector<size_t> select(const std::vector<glm::vec3>& points, const ScreenRegion& region,
+                             const glm::mat4& objectToClip) const;
+
+private:
+  BVH bvh;
+  std::vector<uint64_t> currentKey;
+  bool haveKey = false;
+};
+
+} // namespace polyscope
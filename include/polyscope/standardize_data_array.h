@@ -5,6 +5,7 @@
 #include "polyscope/messages.h"
 #include "polyscope/utilities.h"
 
+#include <array>
 #include <type_traits>
 #include <vector>
 
@@ -1183,6 +1184,58 @@ std::vector<O> standardizeVectorArray(const T& inputData) {
   return adaptorF_convertArrayOfVectorToStdVector<O, D, T>(inputData);
 }
 
+// Convert an array of vector types to a flat array of their entries (vector i at [D*i, D*i+D)). Inputs which can be
+// indexed directly are written straight in to the output, others go through standardizeVectorArray().
+// class S: scalar type for output
+// unsigned int D: dimension of inner vector type
+// class T: input array type
+template <class S, unsigned int D, class T,
+    /* condition: input can be called with two integer arguments to get something that can be cast to S */
+    typename C1 = typename std::enable_if<
+        std::is_same<decltype((S)(std::declval<T>())((size_t)0, (size_t)0)), S>::value>::type>
+std::vector<S> adaptorF_convertArrayOfVectorToFlatStdVectorImpl(PreferenceT<2>, const T& inputData) {
+  size_t dataSize = adaptorF_size(inputData);
+  std::vector<S> dataOut(D * dataSize);
+  for (size_t i = 0; i < dataSize; i++) {
+    for (size_t j = 0; j < D; j++) {
+      dataOut[D * i + j] = inputData(i, j);
+    }
+  }
+  return dataOut;
+}
+
+template <class S, unsigned int D, class T,
+    /* condition: input can be bracket-indexed twice to get something that can be cast to S */
+    typename C1 = typename std::enable_if<
+        std::is_same<decltype((S)(std::declval<T>())[(size_t)0][(size_t)0]), S>::value>::type>
+std::vector<S> adaptorF_convertArrayOfVectorToFlatStdVectorImpl(PreferenceT<1>, const T& inputData) {
+  size_t dataSize = adaptorF_size(inputData);
+  std::vector<S> dataOut(D * dataSize);
+  for (size_t i = 0; i < dataSize; i++) {
+    for (size_t j = 0; j < D; j++) {
+      dataOut[D * i + j] = inputData[i][j];
+    }
+  }
+  return dataOut;
+}
+
+template <class S, unsigned int D, class T>
+std::vector<S> adaptorF_convertArrayOfVectorToFlatStdVectorImpl(PreferenceT<0>, const T& inputData) {
+  std::vector<std::array<S, D>> vectors = standardizeVectorArray<std::array<S, D>, D>(inputData);
+  std::vector<S> dataOut(D * vectors.size());
+  for (size_t i = 0; i < vectors.size(); i++) {
+    for (size_t j = 0; j < D; j++) {
+      dataOut[D * i + j] = vectors[i][j];
+    }
+  }
+  return dataOut;
+}
+
+template <class S, unsigned int D, class T>
+std::vector<S> standardizeVectorArrayFlat(const T& inputData) {
+  return adaptorF_convertArrayOfVectorToFlatStdVectorImpl<S, D, T>(PreferenceT<2>{}, inputData);
+}
+
 // Convert a nested array where the inner types have variable length.
 // class S: innermost scalar type for output
 // class T: input nested array type
@@ -10,7 +10,9 @@
 #include "glm/glm.hpp"
 
 #include "polyscope/persistent_value.h"
+#include "polyscope/ray_query.h"
 #include "polyscope/render/engine.h"
+#include "polyscope/screen_region.h"
 #include "polyscope/transformation_gizmo.h"
 #include "polyscope/weak_handle.h"
 
@@ -21,6 +23,7 @@ namespace polyscope {
 
 // forward declarations
 class Group;
+class Quantity;
 
 
 // A 'structure' in Polyscope terms, is an object with which we can associate data in the UI, such as a point cloud,
@@ -56,6 +59,30 @@ public:
   virtual void buildSharedStructureUI();  // Draw any UI elements shared between all instances of the structure
   virtual void buildPickUI(size_t localPickID) = 0; // Draw pick UI elements when index localPickID is selected
 
+  // == Ray queries
+  // Cast the world-space ray rayOrigin + t * rayDir against the structure on the CPU. On a hit, returns true and fills
+  // hitOut with the nearest hit element, using the same local indices as picking. The acceleration structure is
+  // (re)built in the background when the geometry changes; if it is not ready yet, `waitForBuild` decides whether to
+  // wait for it or to report no hit. Structures which don't support ray queries always return false.
+  virtual bool queryRay(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayHit& hitOut);
+
+  // == Region selection
+  // Find the primary elements of the structure (points, vertices, nodes, ...) which project in to a region of the
+  // screen from the current view, using the same local indices as picking. Returns false if the structure doesn't
+  // support region selection.
+  virtual bool selectInScreenRegion(const ScreenRegion& region, std::vector<size_t>& localIndsOut);
+
+  // == Scene statistics
+  // The structure's quantities, not including floating quantities (overridden by QuantityStructure)
+  virtual std::vector<Quantity*> getQuantityList();
+
+  // Which of the values of the scalar quantity `q` are on elements which pass `filter` (see ElementFilter). Sets
+  // versionOut to a counter which changes whenever the answer might, and if includeOut is given, fills it with one flag
+  // per value, or leaves it empty if all of them pass. Returns false if the structure can't apply the filter to the
+  // elements of `q`. By default every element is visible, and selection is not supported.
+  virtual bool filterScalarQuantityElements(Quantity& q, ElementFilter filter, uint64_t& versionOut,
+                                            std::vector<char>* includeOut);
+
   // = Identifying data
   const std::string name; // should be unique amongst registered structures with this type
   std::string uniquePrefix();
@@ -99,6 +126,12 @@ public:
   void addToGroup(std::string groupName);
   void addToGroup(Group& group);
 
+  // Deferred uploads for disabled structures are applied last (see render::UploadScheduler)
+  virtual bool isUploadVisible() override;
+
+  // The buffers of a structure hold its geometry, updating them means re-rendering the pick buffer
+  virtual bool buffersAffectPicking() override;
+
 
   // Options
   Structure* setTransparency(float newVal); // also enables transparency if <1 and transparency is not enabled
@@ -137,6 +170,13 @@ protected:
   std::tuple<glm::vec3, glm::vec3> objectSpaceBoundingBox;
   float objectSpaceLengthScale;
   virtual void updateObjectSpaceBounds() = 0;
+
+  // Used by structures to implement queryRay()
+  RayQueryAccel rayQueryAccel;
+  // Cast a world-space ray against rayQueryAccel, accounting for the object transform. On a hit, fills in the t value
+  // and world position of hitOut and returns the hit primitive.
+  bool queryRayAccel(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayQueryAccel::Hit& primHit,
+                     RayHit& hitOut);
 };
 
 
@@ -204,6 +244,8 @@ public:
 
   void setAllQuantitiesEnabled(bool newEnabled);
 
+  virtual std::vector<Quantity*> getQuantityList() override;
+
   // = Quantities
   std::map<std::string, std::unique_ptr<QuantityType>> quantities;
   QuantityS<S>* dominantQuantity = nullptr; // If non-null, a special quantity of which only one can be drawn for
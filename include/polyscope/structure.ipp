@@ -7,6 +7,7 @@
 #include "polyscope/structure.h"
 
 #include "polyscope/floating_quantity.h"
+#include "polyscope/pick.h"
 
 namespace polyscope {
 
@@ -82,6 +83,7 @@ void QuantityStructure<S>::refresh() {
   for (auto& qp : floatingQuantities) {
     qp.second->refresh();
   }
+  pick::markPickBufferStale();
   requestRedraw();
 }
 
@@ -162,6 +164,15 @@ void QuantityStructure<S>::setAllQuantitiesEnabled(bool newEnabled) {
 }
 
 
+template <typename S>
+std::vector<Quantity*> QuantityStructure<S>::getQuantityList() {
+  std::vector<Quantity*> list;
+  for (auto& x : quantities) {
+    list.push_back(x.second.get());
+  }
+  return list;
+}
+
 template <typename S>
 void QuantityStructure<S>::buildQuantitiesUI() {
   // Build the quantities
@@ -5,6 +5,7 @@
 #include "polyscope/color_quantity.h"
 #include "polyscope/render/engine.h"
 #include "polyscope/surface_mesh.h"
+#include "polyscope/virtual_texture.h"
 
 namespace polyscope {
 
@@ -67,12 +68,28 @@ public:
   SurfaceTextureColorQuantity(std::string name, SurfaceMesh& mesh_, SurfaceParameterizationQuantity& param_,
                               size_t dimX, size_t dimY, std::vector<glm::vec3> values_, ImageOrigin origin_);
 
+  // Colors are read from the source (e.g. a memory-mapped file) instead of a host array, and are always drawn with
+  // virtual texturing. The colors array of the quantity is left empty.
+  SurfaceTextureColorQuantity(std::string name, SurfaceMesh& mesh_, SurfaceParameterizationQuantity& param_,
+                              std::shared_ptr<VirtualTextureSource> source_, ImageOrigin origin_);
+
+  virtual void draw() override;
   virtual void createProgram() override;
 
+  // Is the texture drawn with virtual texturing? (see options::virtualTextureThreshold)
+  bool usesVirtualTexture() const;
+  VirtualTexture* getVirtualTexture() { return virtualTexture.get(); } // null until drawn with virtual texturing
+
 protected:
   SurfaceParameterizationQuantity& param;
   size_t dimX, dimY;
   ImageOrigin imageOrigin;
+
+  // Virtual texturing
+  std::shared_ptr<VirtualTextureSource> externalSource; // only for quantities without a colors array
+  std::unique_ptr<VirtualTexture> virtualTexture;
+  uint64_t virtualTextureDataVersion = 0;
+  void prepareVirtualTexture();
 };
 
 } // namespace polyscope
@@ -8,6 +8,7 @@
 
 #include "polyscope/affine_remapper.h"
 #include "polyscope/color_management.h"
+#include "polyscope/element_mask.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/render/engine.h"
 #include "polyscope/render/managed_buffer.h"
@@ -64,8 +65,8 @@ public:
   SurfaceMesh(std::string name);
 
   // From flattened list
-  SurfaceMesh(std::string name, const std::vector<glm::vec3>& vertexPositions,
-              const std::vector<uint32_t>& faceIndsEntries, const std::vector<uint32_t>& faceIndsStart);
+  SurfaceMesh(std::string name, const std::vector<glm::vec3>& vertexPositions, std::vector<uint32_t> faceIndsEntries,
+              std::vector<uint32_t> faceIndsStart);
 
   // Construct from a nested face list
   SurfaceMesh(std::string name, const std::vector<glm::vec3>& vertexPositions,
@@ -76,6 +77,10 @@ public:
   virtual void buildCustomUI() override;
   virtual void buildCustomOptionsUI() override;
   virtual void buildPickUI(size_t localPickID) override;
+  virtual bool queryRay(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayHit& hitOut) override;
+  virtual bool selectInScreenRegion(const ScreenRegion& region, std::vector<size_t>& localIndsOut) override;
+  virtual bool filterScalarQuantityElements(Quantity& q, ElementFilter filter, uint64_t& versionOut,
+                                            std::vector<char>* includeOut) override;
 
   // Render the the structure on screen
   virtual void draw() override;
@@ -84,6 +89,7 @@ public:
   virtual void updateObjectSpaceBounds() override;
   virtual std::string typeName() override;
   virtual void refresh() override;
+  virtual void sharedBufferUpdated(const std::string& bufferName) override;
 
   // Mesh connectivity
   // (end users probably should not mess with theses)
@@ -107,8 +113,9 @@ public:
   render::ManagedBuffer<uint32_t> triangleAllCornerInds;   // on triangulated mesh, all 3 [3 * 3 * nTriFace]
 
   // internal triangle data for rendering
-  render::ManagedBuffer<glm::vec3> baryCoord;  // on the split, triangulated mesh [3 * nTriFace]
-  render::ManagedBuffer<glm::vec3> edgeIsReal; // on the split, triangulated mesh [3 * nTriFace]
+  // on the split, triangulated mesh [3 * nTriFace], bit k is set if the edge from corner k to k+1 of the triangle is an
+  // edge of the original polygon (stored as a float for the shaders). Only needed for non-triangular meshes.
+  render::ManagedBuffer<float> edgeIsRealMask;
 
   // other internally-computed geometry
   render::ManagedBuffer<glm::vec3> faceNormals;
@@ -144,6 +151,9 @@ public:
   template <class T> SurfaceFaceColorQuantity* addFaceColorQuantity(std::string name, const T& data);
   template <class T> SurfaceTextureColorQuantity* addTextureColorQuantity(std::string name, SurfaceParameterizationQuantity& param, size_t dimX, size_t dimY, const T& colors, ImageOrigin imageOrigin);
   template <class T> SurfaceTextureColorQuantity* addTextureColorQuantity(std::string name, std::string paramName, size_t dimX, size_t dimY, const T& colors, ImageOrigin imageOrigin);
+  // Texture colors from a file of raw float32 RGB texels (dimX * dimY * 3 floats, row by row, no header). The file is
+  // memory-mapped and always drawn with virtual texturing, so it can be much larger than host or GPU memory.
+  SurfaceTextureColorQuantity* addTextureColorQuantityFromFile(std::string name, SurfaceParameterizationQuantity& param, size_t dimX, size_t dimY, std::string filename, ImageOrigin imageOrigin);
   
 	// = Parameterizations (expect vec2 array)
   template <class T> SurfaceCornerParameterizationQuantity* addParameterizationQuantity(std::string name, const T& coords, ParamCoordsType type = ParamCoordsType::UNIT); 
@@ -231,10 +241,32 @@ public:
   size_t nCorners() const { return nCornersCount; }
   size_t nHalfedges() const { return nCornersCount; }
 
+  // The indices of the vertices (resp. faces, by their centers) which project in to the screen region from the current
+  // view
+  std::vector<size_t> selectVerticesInScreenRegion(const ScreenRegion& region);
+  std::vector<size_t> selectFacesInScreenRegion(const ScreenRegion& region);
+
+  // Highlight, outline, or hide individual faces, e.g. to show a selection (see ElementMask). Changing a few faces at a
+  // time is cheap, even on very large meshes. Outlines follow the triangles the faces are drawn with.
+  void setFaceMask(const std::vector<size_t>& inds, ElementMaskMode mode);
+  void clearFaceMask();
+  ElementMask& getFaceMask();
+
+  bool facesAreAllTriangles = true; // set by computeConnectivityData()
+
+  // The order the faces are triangulated and drawn in, if the mesh was reordered for locality at registration (see
+  // options::reorderForLocality). Empty if they are drawn in index order. Only pure-triangle meshes are reordered, so
+  // on other meshes the triangulation always follows the faces.
+  std::vector<uint32_t> faceDrawOrder;
+  std::vector<uint32_t> faceDrawRank; // inverse of faceDrawOrder
+  size_t faceInDrawOrder(size_t i) const { return faceDrawOrder.empty() ? i : faceDrawOrder[i]; }
+  size_t faceTriangleInd(size_t iF) const { return faceDrawRank.empty() ? iF : faceDrawRank[iF]; } // triangle meshes
+
   // = Mesh helpers
   void nestedFacesToFlat(const std::vector<std::vector<size_t>>& nestedInds);
-  void computeConnectivityData(); // call to populate counts and indices
-  void checkTriangular();         // check if the mesh is triangular, print a helpful error if not
+  void computeConnectivityData();     // call to populate counts and indices
+  void computePolygonTriangulation(); // fills the triangulation buffers for general polygon meshes
+  void checkTriangular();             // check if the mesh is triangular, print a helpful error if not
 
   // Force the mesh to act as if the specified elements are in use (aka enable them for picking, etc)
   void markEdgesAsUsed();
@@ -320,12 +352,19 @@ private:
   std::vector<uint32_t> triangleAllCornerIndsData;   // index of the corresponding original corner
 
   // internal triangle data for rendering, defined per corner of the triangulated mesh
-  std::vector<glm::vec3> baryCoordData;  // always triangulated
-  std::vector<glm::vec3> edgeIsRealData; // always triangulated
+  // (barycentric coordinates are not stored, the shaders generate them)
+  std::vector<float> edgeIsRealMaskData; // always triangulated
 
   // other internally-computed geometry
   std::vector<glm::vec3> faceNormalsData;
   std::vector<glm::vec3> faceCentersData;
+
+  // Built lazily by select{Vertices,Faces}InScreenRegion()
+  PointRegionIndex vertexRegionIndex;
+  PointRegionIndex faceRegionIndex;
+
+  // One texel per triangle of the triangulation, in draw order
+  ElementMask faceMask;
   std::vector<float> faceAreasData;
   std::vector<glm::vec3> vertexNormalsData;
   std::vector<float> vertexAreasData;
@@ -360,6 +399,7 @@ private:
 
   /// == Compute indices & geometry data
   void computeTriangleCornerInds();
+  void computeEdgeIsRealMask();
   void computeTriangleAllEdgeInds();
   void computeTriangleAllHalfedgeInds();
   void computeTriangleAllCornerInds();
@@ -440,6 +480,17 @@ SurfaceMesh* registerSurfaceMesh(std::string name, const V& vertexPositions, con
 template <class V, class F>
 SurfaceMesh* registerSurfaceMesh2D(std::string name, const V& vertexPositions, const F& faceIndices);
 
+// Faster paths for large meshes, which skip converting a general nested face list:
+//  - registerSurfaceMeshTriangles() takes an Fx3 array of triangle vertex indices
+//  - registerSurfaceMeshCSR() takes polygons in compressed-row form: faceIndsEntries holds the vertex indices of all
+//    faces concatenated, and face i is faceIndsEntries[faceIndsStart[i]] ... faceIndsEntries[faceIndsStart[i+1]-1]
+//    (so faceIndsStart has length F+1, starting at 0 and ending at the length of faceIndsEntries)
+template <class V, class F>
+SurfaceMesh* registerSurfaceMeshTriangles(std::string name, const V& vertexPositions, const F& triangleIndices);
+template <class V, class E, class S>
+SurfaceMesh* registerSurfaceMeshCSR(std::string name, const V& vertexPositions, const E& faceIndsEntries,
+                                    const S& faceIndsStart);
+
 // register functions that also set perms
 // these are kept mainly for backward compatability, prefer setting perms after registering
 template <class V, class F, class P>
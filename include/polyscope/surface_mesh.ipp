@@ -4,6 +4,7 @@
 #include "polyscope/utilities.h"
 
 #include <stdexcept>
+#include <utility>
 
 namespace polyscope {
 
@@ -18,8 +19,8 @@ SurfaceMesh* registerSurfaceMesh(std::string name, const V& vertexPositions, con
   std::vector<uint32_t>& faceIndsEntries = std::get<0>(nestedListTup);
   std::vector<uint32_t>& faceIndsStart = std::get<1>(nestedListTup);
 
-  SurfaceMesh* s =
-      new SurfaceMesh(name, standardizeVectorArray<glm::vec3, 3>(vertexPositions), faceIndsEntries, faceIndsStart);
+  SurfaceMesh* s = new SurfaceMesh(name, standardizeVectorArray<glm::vec3, 3>(vertexPositions),
+                                   std::move(faceIndsEntries), std::move(faceIndsStart));
 
   bool success = registerStructure(s);
   if (!success) {
@@ -40,6 +41,53 @@ SurfaceMesh* registerSurfaceMesh2D(std::string name, const V& vertexPositions, c
   return registerSurfaceMesh(name, positions3D, faceIndices);
 }
 
+template <class V, class F>
+SurfaceMesh* registerSurfaceMeshTriangles(std::string name, const V& vertexPositions, const F& triangleIndices) {
+  checkInitialized();
+
+  // The triangles are written straight in to the flat face list, the face starts are every third entry
+  std::vector<uint32_t> faceIndsEntries = standardizeVectorArrayFlat<uint32_t, 3>(triangleIndices);
+  std::vector<uint32_t> faceIndsStart(faceIndsEntries.size() / 3 + 1);
+  for (size_t iF = 0; iF < faceIndsStart.size(); iF++) {
+    faceIndsStart[iF] = static_cast<uint32_t>(3 * iF);
+  }
+
+  SurfaceMesh* s = new SurfaceMesh(name, standardizeVectorArray<glm::vec3, 3>(vertexPositions),
+                                   std::move(faceIndsEntries), std::move(faceIndsStart));
+
+  bool success = registerStructure(s);
+  if (!success) {
+    safeDelete(s);
+  }
+
+  return s;
+}
+
+template <class V, class E, class S>
+SurfaceMesh* registerSurfaceMeshCSR(std::string name, const V& vertexPositions, const E& faceIndsEntries,
+                                    const S& faceIndsStart) {
+  checkInitialized();
+
+  std::vector<uint32_t> entries = standardizeArray<uint32_t>(faceIndsEntries);
+  std::vector<uint32_t> starts = standardizeArray<uint32_t>(faceIndsStart);
+
+  // The rest of the validation (face degrees and vertex indices) happens when the mesh is constructed
+  if (starts.empty() || starts.front() != 0 || starts.back() != entries.size()) {
+    exception("registerSurfaceMeshCSR() faceIndsStart for mesh " + name +
+              " must start at 0 and end with the number of face entries");
+  }
+
+  SurfaceMesh* s = new SurfaceMesh(name, standardizeVectorArray<glm::vec3, 3>(vertexPositions), std::move(entries),
+                                   std::move(starts));
+
+  bool success = registerStructure(s);
+  if (!success) {
+    safeDelete(s);
+  }
+
+  return s;
+}
+
 template <class V, class F, class P>
 SurfaceMesh* registerSurfaceMesh(std::string name, const V& vertexPositions, const F& faceIndices,
                                  const std::array<std::pair<P, size_t>, 3>& perms) {
@@ -8,6 +8,7 @@
 #include "polyscope/render/color_maps.h"
 #include "polyscope/render/engine.h"
 #include "polyscope/surface_mesh.h"
+#include "polyscope/virtual_texture.h"
 
 
 namespace polyscope {
@@ -41,6 +42,10 @@ public:
 
   CurveNetwork* createCurveNetworkFromSeams(std::string structureName = "");
 
+  // Request the pages of a virtual texture sampled with these coordinates which are needed to draw the mesh from the
+  // current view (see VirtualTexture::requestPagesForView())
+  void requestVirtualTexturePages(VirtualTexture& texture, ImageOrigin imageOrigin);
+
 protected:
   std::shared_ptr<render::ShaderProgram> program;
 
@@ -10,6 +10,7 @@
 #include "polyscope/render/engine.h"
 #include "polyscope/scalar_quantity.h"
 #include "polyscope/surface_mesh.h"
+#include "polyscope/virtual_texture.h"
 
 namespace polyscope {
 
@@ -26,6 +27,7 @@ public:
   virtual void draw() override;
   virtual void buildCustomUI() override;
   virtual std::string niceName() override;
+  virtual render::ManagedBuffer<float>* getScalarValues() override { return &values; }
   virtual void refresh() override;
 
   virtual std::shared_ptr<render::AttributeBuffer> getAttributeBuffer() = 0;
@@ -123,14 +125,24 @@ public:
                                size_t dimX, size_t dimY, const std::vector<float>& values_, ImageOrigin origin_,
                                DataType dataType_ = DataType::STANDARD);
 
+  virtual void draw() override;
   virtual void createProgram() override;
   virtual std::shared_ptr<render::AttributeBuffer> getAttributeBuffer() override;
 
+  // Is the texture drawn with virtual texturing? (see options::virtualTextureThreshold)
+  bool usesVirtualTexture() const;
+  VirtualTexture* getVirtualTexture() { return virtualTexture.get(); } // null until drawn with virtual texturing
+
 
 protected:
   SurfaceParameterizationQuantity& param;
   size_t dimX, dimY;
   ImageOrigin imageOrigin;
+
+  // Virtual texturing
+  std::unique_ptr<VirtualTexture> virtualTexture;
+  uint64_t virtualTextureDataVersion = 0;
+  void prepareVirtualTexture();
 };
 
 } // namespace polyscope
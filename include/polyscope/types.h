@@ -16,11 +16,13 @@ enum class GroundPlaneMode { None, Tile, TileReflection, ShadowOnly };
 enum class GroundPlaneHeightMode { Automatic = 0, Manual };
 enum class BackFacePolicy { Identical, Different, Custom, Cull };
 
-enum class PointRenderMode { Sphere = 0, Quad };
+enum class PointRenderMode { Sphere = 0, Quad, Pixel };
+enum class ElementMaskMode { None = 0, Highlight, Outline, Hide }; // see ElementMask
 enum class MeshElement { VERTEX = 0, FACE, EDGE, HALFEDGE, CORNER };
 enum class MeshShadeStyle { Smooth = 0, Flat, TriFlat };
 enum class VolumeMeshElement { VERTEX = 0, EDGE, FACE, CELL };
 enum class VolumeCellType { TET = 0, HEX };
+enum class VolumeGridMipReduction { Mean = 0, Min, Max }; // see VolumeGridMipPyramid
 
 enum class ImplicitRenderMode { SphereMarch, FixedStep };
 enum class ImageOrigin { LowerLeft, UpperLeft };
@@ -58,5 +60,18 @@ enum class ManagedBufferType {
 // MAGNITUDE: [0, inf], zero is special (ie, length of a vector)
 enum class DataType { STANDARD = 0, SYMMETRIC, MAGNITUDE };
 
+// How a scalar quantity's ranges follow its values when they are replaced with updateData()
+// Off: nothing is recomputed (the data range stays that of the original values)
+// Fixed: the data range and histogram are updated, the colormap range is kept
+// ExpandOnly: additionally, the colormap range grows to cover the data range, but never shrinks
+// Fit: additionally, the colormap range is reset to the data range
+enum class ScalarRangeUpdate { Off = 0, Fixed, ExpandOnly, Fit };
+
+// Which elements scene statistics are computed over (see scene_statistics.h)
+// All: every element
+// Visible: the elements of enabled structures which are not hidden by an element mask
+// Selected: the elements in the current region selection (see region_selection.h)
+enum class ElementFilter { All = 0, Visible, Selected };
+
 
 }; // namespace polyscope
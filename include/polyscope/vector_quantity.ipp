@@ -1,6 +1,7 @@
 // Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
 
 
+#include "polyscope/reductions.h"
 #include "polyscope/standardize_data_array.h"
 
 namespace polyscope {
@@ -185,11 +186,7 @@ void VectorQuantity<QuantityT>::updateMaxLength() {
   if (this->vectorLengthRangeManuallySet) return; // do nothing if it has already been set manually
 
   vectors.ensureHostBufferPopulated();
-  float maxLength = 0.;
-  for (const glm::vec3& vec : vectors.data) {
-    maxLength = std::max(maxLength, glm::length(vec));
-  }
-  this->vectorLengthRange = maxLength;
+  this->vectorLengthRange = computeMaxNorm(vectors.data);
 }
 
 template <typename QuantityT>
@@ -303,11 +300,7 @@ void TangentVectorQuantity<QuantityT>::updateMaxLength() {
   if (this->vectorLengthRangeManuallySet) return; // do nothing if it has already been set manually
 
   tangentVectors.ensureHostBufferPopulated();
-  float maxLength = 0.;
-  for (const glm::vec2& vec : tangentVectors.data) {
-    maxLength = std::max(maxLength, glm::length(vec));
-  }
-  this->vectorLengthRange = maxLength;
+  this->vectorLengthRange = computeMaxNorm(tangentVectors.data);
 }
 
 template <typename QuantityT>
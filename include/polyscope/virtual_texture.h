@@ -0,0 +1,163 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "polyscope/render/engine.h"
+
+namespace polyscope {
+
+// Where the texels of a virtual texture come from: dimX * dimY texels of nChannels floats each, stored row by row.
+class VirtualTextureSource {
+
+public:
+  ~VirtualTextureSource();
+  VirtualTextureSource(const VirtualTextureSource&) = delete;
+  VirtualTextureSource& operator=(const VirtualTextureSource&) = delete;
+
+  // Read from memory owned by the caller, which must stay valid while the source is in use. Pages are read on the main
+  // thread, since the caller may change the memory between frames.
+  static std::shared_ptr<VirtualTextureSource> fromHostData(const float* texels, size_t dimX, size_t dimY,
+                                                            size_t nChannels);
+
+  // Memory-map a file of raw float32 texels (no header). Pages are read on worker threads, and only the parts of the
+  // file needed for the current view are ever touched.
+  static std::shared_ptr<VirtualTextureSource> fromMappedFile(std::string filename, size_t dimX, size_t dimY,
+                                                              size_t nChannels);
+
+  size_t dimX() const { return sizeX; }
+  size_t dimY() const { return sizeY; }
+  size_t nChannels() const { return channels; }
+  bool readOnWorkerThreads() const { return mappedData != nullptr; }
+
+  const float* texel(size_t x, size_t y) const { return texels + (y * sizeX + x) * channels; }
+
+private:
+  VirtualTextureSource() = default;
+
+  size_t sizeX = 0;
+  size_t sizeY = 0;
+  size_t channels = 0;
+  const float* texels = nullptr;
+
+  // for file sources
+  void* mappedData = nullptr;
+  size_t mappedBytes = 0;
+};
+
+// A texture which is too large to keep on the GPU, drawn from a fixed-size cache of pages.
+//
+// The texture is split in to square pages at each level of a mip pyramid. Each frame, the pages which the current view
+// needs are computed on the CPU from the triangles which sample the texture (see requestPagesForView()), missing pages
+// are generated from the source and uploaded a few at a time, and least-recently-used pages are evicted to make room.
+// A page table texture maps each region of the texture to the finest resident page covering it, so regions whose
+// pages are not loaded yet are drawn from a coarser level rather than left blank. The coarsest level is a single page
+// which is always resident.
+//
+// Shaders sample it with the VIRTUAL_TEXTURE_LOOKUP rule, after calling setTextures() and setUniforms().
+class VirtualTexture {
+
+public:
+  VirtualTexture(std::shared_ptr<VirtualTextureSource> source, size_t cachePages);
+  ~VirtualTexture(); // waits for any loads which are still running
+  VirtualTexture(const VirtualTexture&) = delete;
+  VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+  static const uint32_t pageSize = 128; // in texels, not counting the border
+  static const uint32_t pageBorder = 1; // texels copied from neighboring pages, for filtering across page boundaries
+
+  // == Feedback
+
+  // The triangles which sample the texture, as three corners each, with texture coordinates in [0,1] (measured from
+  // texel row 0). Only needs to be set again when the key changes.
+  bool trianglesAreCurrent(const std::vector<uint64_t>& key) const;
+  void setTriangles(std::vector<glm::vec3> cornerPositions, std::vector<glm::vec2> cornerTCoords,
+                    std::vector<uint64_t> key);
+
+  // Compute the pages needed to draw the triangles from this view. Each visible triangle requests the level where one
+  // texel covers about one pixel, averaged over the triangle, for the pages its texture coordinates overlap (plus
+  // their coarser ancestors). Occlusion is not considered. Cheap to call when the view has not changed.
+  void requestPagesForView(const glm::mat4& objectToClip);
+
+  // == Loading
+
+  // Start loads for missing pages, upload at most maxUploads finished ones to the cache, and update the page table.
+  // Call once per frame, before drawing.
+  void update(size_t maxUploads);
+
+  // Load and upload every requested page which fits in the cache, blocking until done (e.g. before a screenshot)
+  void flush();
+
+  // == Drawing
+  void setTextures(render::ShaderProgram& program);
+  void setUniforms(render::ShaderProgram& program);
+
+  // == Info
+  size_t nLevels() const { return levelCount; }
+  size_t nRequestedPages() const { return requestedPages.size(); }
+  size_t nResidentPages() const { return residentPages.size(); }
+  size_t nLoadingPages() const { return loads.size(); }
+  bool isPageResident(size_t level, size_t pageX, size_t pageY) const;
+
+private:
+  std::shared_ptr<VirtualTextureSource> source;
+  size_t levelCount;
+  std::vector<glm::uvec2> levelPages; // number of pages in each direction at each level
+
+  // The cache of pages on the GPU
+  struct Slot {
+    uint64_t page = 0;
+    bool occupied = false;
+    bool loading = false;
+    uint64_t lastUsedFrame = 0;
+  };
+  std::vector<Slot> slots; // slot 0 always holds the coarsest page
+  size_t slotsX;
+  std::unordered_map<uint64_t, size_t> residentPages; // page -> slot
+  std::shared_ptr<render::TextureBuffer> atlas;
+
+  // Requests from the last feedback pass, coarsest first
+  std::vector<uint64_t> requestedPages;
+  std::unordered_set<uint64_t> requestedSet;
+  uint64_t frame = 0;
+
+  struct Load {
+    uint64_t page;
+    size_t slot;
+    std::future<std::vector<float>> texels;
+  };
+  std::vector<Load> loads;
+
+  // Feedback inputs
+  std::vector<glm::vec3> triCornerPositions;
+  std::vector<glm::vec2> triCornerTCoords;
+  std::vector<uint64_t> trianglesKey;
+  bool haveTriangles = false;
+  glm::mat4 lastObjectToClip;
+  glm::vec2 lastViewportSize{-1., -1.};
+
+  // The page table, one entry per page of the finest level: the atlas location and level of the page to sample from
+  std::shared_ptr<render::TextureBuffer> pageTable;
+  bool pageTableDirty = true;
+
+  // Helpers
+  static uint64_t pageKey(size_t level, size_t pageX, size_t pageY);
+  static void unpackPageKey(uint64_t page, size_t& level, size_t& pageX, size_t& pageY);
+  glm::uvec2 slotOrigin(size_t slot) const;
+  static std::vector<float> generatePage(const VirtualTextureSource& source, uint64_t page);
+  bool findSlot(size_t& slotOut);
+  void uploadPage(uint64_t page, size_t slot, const std::vector<float>& texels);
+  void rebuildPageTable();
+};
+
+} // namespace polyscope
@@ -86,7 +86,11 @@ public:
   // void populateGeometry();
   std::vector<std::string> addGridCubeRules(std::vector<std::string> initRules, bool withShade=true);
   void setVolumeGridUniforms(render::ShaderProgram& p);
-  void setGridCubeUniforms(render::ShaderProgram& p, bool withShade=true);
+  void setGridCubeUniforms(render::ShaderProgram& p, bool withShade=true, size_t mipLevel=0);
+  std::string getGridCubeShaderName(); // depends on getRaycastGridCubes()
+  void setGridCubeGeometryAttributes(render::ShaderProgram& p, size_t mipLevel=0);
+  bool wantsMipLevels(); // whether quantities should build a VolumeGridMipPyramid
+  size_t getDisplayMipLevel(size_t nLevels); // the level to draw this frame, for a pyramid with nLevels levels
   
   // == Helpers for computing with the grid
  
@@ -94,6 +98,8 @@ public:
   uint64_t nCells() const; // total number of cells
   glm::vec3 gridSpacing() const; // space between nodes/cells, in world units
   glm::vec3 gridSpacingReference() const; // space between nodes/cells, on [0,1]^3
+  glm::vec3 gridSpacing(size_t mipLevel) const;          // the same at a mip level (see VolumeGridMipPyramid)
+  glm::vec3 gridSpacingReference(size_t mipLevel) const;
   float minGridSpacing() const; // smallest coordinate of gridSpacing()
 
   // Field data
@@ -141,6 +147,21 @@ public:
   VolumeGrid* setCubeSizeFactor(double newVal);
   double getCubeSizeFactor();
 
+  // Draw the cubes by marching rays through the grid from its bounding box, rather than rasterizing a plane for every
+  // layer of cells. The cost then depends on the pixels covered rather than the grid resolution, which is much cheaper
+  // for large grids.
+  VolumeGrid* setRaycastGridCubes(bool newVal);
+  bool getRaycastGridCubes();
+
+  // While the view or a slice plane is moving, draw the quantities of a large grid from downsampled copies of their
+  // values (see options::volumeGridMipMinCells)
+  VolumeGrid* setUseMipLevels(bool newVal);
+  bool getUseMipLevels();
+
+  // How values are combined in the downsampled copies
+  VolumeGrid* setMipReduction(VolumeGridMipReduction newVal);
+  VolumeGridMipReduction getMipReduction();
+
 private:
   
   // Field data
@@ -159,9 +180,16 @@ private:
   PersistentValue<std::string> material;
   PersistentValue<float> edgeWidth;
   PersistentValue<float> cubeSizeFactor;
+  PersistentValue<bool> raycastGridCubes;
+  PersistentValue<bool> useMipLevels;
+  PersistentValue<VolumeGridMipReduction> mipReduction;
 
   // == Compute indices & geometry data
   void computeGridPlaneReferenceGeometry();
+  // (planes between groups of cellScale cells, as for the cells of a mip level)
+  static void computeGridPlaneGeometry(glm::uvec3 gridCellDim, uint32_t cellScale, std::vector<glm::vec3>& positions,
+                                       std::vector<glm::vec3>& normals, std::vector<int32_t>& axisInds);
+  static std::vector<glm::vec3> computeBoundingBoxInteriorTriangles(); // for getRaycastGridCubes()
   
   // Picking-related
   // Order of indexing: vertices, cells
@@ -180,6 +208,18 @@ private:
   std::shared_ptr<render::ShaderProgram> program;
   std::shared_ptr<render::ShaderProgram> pickProgram;
 
+  // Mip level selection, updated at the start of each draw()
+  size_t targetMipLevel = 0;        // level to draw at, for quantities which have it
+  size_t idleMipLevel = 0;          // level the target settles to once nothing moves
+  bool drewCoarserThanIdle = false; // if so, keep redrawing until the view settles
+  bool haveMipViewState = false;
+  glm::mat4 lastMipModelView;
+  glm::mat4 lastMipProjection;
+  std::vector<glm::mat4> lastMipSlicePlaneTransforms;
+  double lastViewChangeTime = 0.;
+  void updateMipLevelTarget();
+  float nearestCellPixelSize(); // approximate size on screen of the grid cell nearest to the camera
+
   // === Helpers
   
   // Do setup work related to drawing, including allocating openGL data
@@ -80,6 +80,14 @@ inline glm::vec3 VolumeGrid::gridSpacingReference() const {
   return refSpacing;
 }
 
+inline glm::vec3 VolumeGrid::gridSpacing(size_t mipLevel) const {
+  return static_cast<float>(VolumeGridMipPyramid::levelCellScale(mipLevel)) * gridSpacing();
+}
+
+inline glm::vec3 VolumeGrid::gridSpacingReference(size_t mipLevel) const {
+  return static_cast<float>(VolumeGridMipPyramid::levelCellScale(mipLevel)) * gridSpacingReference();
+}
+
 inline float VolumeGrid::minGridSpacing() const {
   glm::vec3 spacing = gridSpacing();
   return std::fmin(std::fmin(spacing[0], spacing[1]), spacing[2]);
@@ -0,0 +1,90 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "polyscope/types.h"
+
+namespace polyscope {
+
+// A pyramid of successively downsampled copies of a scalar field on a volume grid, so large grids can be drawn at a
+// coarser resolution while the view is moving.
+//
+// Each level halves the number of cells along every axis (rounding up), until the longest axis has at most 2 cells, and
+// stores the minimum, maximum, and mean of the values it covers. Cell values are reduced over 2x2x2 blocks of cells.
+// Node values are reduced over the 3x3x3 neighborhood of the fine node at twice the coarse index, with tent-filter
+// weights for the mean. Level 0 is the original data, which is not copied here.
+//
+// Like RayQueryAccel, the levels are built on a worker thread from a copy of the data, along with a key which
+// identifies it (e.g. the data version of the buffer it came from). A new build never waits for the one before it:
+// each build gets a generation number, builds which have been superseded stop early, and their results are dropped.
+class VolumeGridMipPyramid {
+
+public:
+  VolumeGridMipPyramid() = default;
+  ~VolumeGridMipPyramid();
+  VolumeGridMipPyramid(const VolumeGridMipPyramid&) = delete;
+  VolumeGridMipPyramid& operator=(const VolumeGridMipPyramid&) = delete;
+
+  struct Level {
+    glm::uvec3 cellDim;  // cells in the grid at this level
+    glm::uvec3 valueDim; // entries in the value arrays, cellDim for cell data and cellDim + 1 for node data
+    std::vector<float> minValues;
+    std::vector<float> maxValues;
+    std::vector<float> meanValues;
+
+    const std::vector<float>& getValues(VolumeGridMipReduction reduction) const;
+  };
+
+  // Start building the levels for `values`, laid out like the nodes (or cells) of a grid with gridCellDim cells, with x
+  // varying fastest
+  void build(std::vector<float> values, glm::uvec3 gridCellDim, bool nodeValues, uint64_t key);
+
+  // True if the pyramid was last built with this key
+  bool isCurrent(uint64_t key) const;
+
+  void clear();
+
+  // Whether the background build has finished. If waitForBuild, blocks until it has.
+  bool isReady(bool waitForBuild = false);
+
+  // The number of levels, counting level 0. Just 1 until the build has finished.
+  size_t nLevels();
+
+  // Level 1 and up
+  const Level& getLevel(size_t iLevel);
+
+  // The cells in each axis at a level of a pyramid for a grid with gridCellDim cells
+  static glm::uvec3 levelCellDim(glm::uvec3 gridCellDim, size_t iLevel);
+
+  // The cells of the grid along each axis which one cell of a level covers. Where an axis does not divide evenly, the
+  // last cell of the level extends past the end of the grid, and is cut off by its bounds when drawn.
+  static uint32_t levelCellScale(size_t iLevel) { return 1u << iLevel; }
+
+  // Compute the levels directly (level 1 first). If `stop` is given and returns true between two levels, the levels so
+  // far are returned.
+  static std::vector<Level> computeLevels(const std::vector<float>& values, glm::uvec3 gridCellDim, bool nodeValues,
+                                          std::function<bool()> stop = nullptr);
+
+private:
+  typedef std::pair<uint64_t, std::future<std::shared_ptr<std::vector<Level>>>> PendingBuild; // (generation, result)
+
+  uint64_t currentKey = 0;
+  bool haveKey = false;
+  std::shared_ptr<std::vector<Level>> built;
+  std::shared_ptr<std::atomic<uint64_t>> latestGeneration = std::make_shared<std::atomic<uint64_t>>(0);
+  std::vector<PendingBuild> pendingBuilds; // the last one is the latest
+  void collectBuilds(bool waitForBuild);
+  void waitForAllBuilds();
+};
+
+} // namespace polyscope
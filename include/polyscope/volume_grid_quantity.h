@@ -3,7 +3,9 @@
 #pragma once
 
 #include "polyscope/quantity.h"
+#include "polyscope/render/managed_buffer.h"
 #include "polyscope/structure.h"
+#include "polyscope/volume_grid_mip.h"
 
 
 namespace polyscope {
@@ -22,6 +24,23 @@ public:
   // Build GUI info about this element
   virtual void buildNodeInfoGUI(size_t vInd);
   virtual void buildCellInfoGUI(size_t vInd);
+
+  // Downsampled copies of this quantity's values, drawn while the view is moving (see VolumeGridMipPyramid)
+  VolumeGridMipPyramid& getMipPyramid();
+
+protected:
+  VolumeGridMipPyramid mipPyramid;
+  std::vector<std::shared_ptr<render::TextureBuffer>> mipTextures; // by level, created lazily
+
+  // Start rebuilding the pyramid if the values changed since it was last built. Returns true if so, in which case
+  // anything made from the old levels should be discarded.
+  bool updateMipPyramid(render::ManagedBuffer<float>& values, bool nodeValues);
+
+  // The level to draw from this frame, 0 for the original values
+  size_t getDisplayMipLevel();
+
+  // The values of a level (>= 1) as a 3D texture, reduced according to the grid's getMipReduction()
+  std::shared_ptr<render::TextureBuffer> getMipTexture(size_t iLevel);
 };
 
 } // namespace polyscope
@@ -29,6 +29,7 @@ public:
   virtual void buildNodeInfoGUI(size_t ind) override;
 
   virtual std::string niceName() override;
+  virtual render::ManagedBuffer<float>* getScalarValues() override { return &values; }
 
   virtual bool isDrawingGridcubes() override;
 
@@ -59,8 +60,8 @@ public:
 protected:
   // Visualize as a grid of cubes
   PersistentValue<bool> gridcubeVizEnabled;
-  std::shared_ptr<render::ShaderProgram> gridcubeProgram;
-  void createGridcubeProgram();
+  std::vector<std::shared_ptr<render::ShaderProgram>> gridcubePrograms; // by mip level, created lazily
+  void createGridcubeProgram(size_t mipLevel);
 
   // Visualize as isosurface
   // TODO
@@ -68,8 +69,8 @@ protected:
   PersistentValue<float> isosurfaceLevel;
   PersistentValue<glm::vec3> isosurfaceColor;
   PersistentValue<bool> slicePlanesAffectIsosurface;
-  std::shared_ptr<render::ShaderProgram> isosurfaceProgram;
-  void createIsosurfaceProgram();
+  std::vector<std::shared_ptr<render::ShaderProgram>> isosurfacePrograms; // by mip level, created lazily
+  void createIsosurfaceProgram(size_t mipLevel);
 
   // Visualize as raymarched volume
   // TODO
@@ -92,6 +93,7 @@ public:
   virtual void buildCellInfoGUI(size_t ind) override;
 
   virtual std::string niceName() override;
+  virtual render::ManagedBuffer<float>* getScalarValues() override { return &values; }
 
   virtual bool isDrawingGridcubes() override;
 
@@ -106,8 +108,8 @@ public:
 protected:
   // Visualize as a grid of cubes
   PersistentValue<bool> gridcubeVizEnabled;
-  std::shared_ptr<render::ShaderProgram> gridcubeProgram;
-  void createGridcubeProgram();
+  std::vector<std::shared_ptr<render::ShaderProgram>> gridcubePrograms; // by mip level, created lazily
+  void createGridcubeProgram(size_t mipLevel);
 };
 
 } // namespace polyscope
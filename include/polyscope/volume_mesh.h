@@ -53,6 +53,7 @@ public:
   virtual void buildCustomUI() override;
   virtual void buildCustomOptionsUI() override;
   virtual void buildPickUI(size_t localPickID) override;
+  virtual bool queryRay(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayHit& hitOut) override;
 
   // Render the the structure on screen
   virtual void draw() override;
@@ -61,6 +62,7 @@ public:
   virtual void updateObjectSpaceBounds() override;
   virtual std::string typeName() override;
   virtual void refresh() override;
+  virtual void sharedBufferUpdated(const std::string& bufferName) override;
 
   // == Geometric quantities
   // (actually, these are wrappers around the private raw data members, but external users should interact with these
@@ -75,8 +77,9 @@ public:
   render::ManagedBuffer<uint32_t> triangleCellInds;   // on the split, triangulated mesh [3 * nTriFace]
 
   // internal triangle data for rendering
-  render::ManagedBuffer<glm::vec3> baryCoord;  // on the split, triangulated mesh [3 * nTriFace]
-  render::ManagedBuffer<glm::vec3> edgeIsReal; // on the split, triangulated mesh [3 * nTriFace]
+  // on the split, triangulated mesh [3 * nTriFace], bit k is set if the edge from corner k to k+1 of the triangle is an
+  // edge of the original face (stored as a float for the shaders)
+  render::ManagedBuffer<float> edgeIsRealMask;
   render::ManagedBuffer<float> faceType;       // on the split, triangulated mesh [3 * nTriFace]
 
   // other internally-computed geometry
@@ -195,8 +198,8 @@ private:
   std::vector<uint32_t> triangleCellIndsData;   // to the split, triangulated mesh
 
   // internal triangle data for rendering
-  std::vector<glm::vec3> baryCoordData;
-  std::vector<glm::vec3> edgeIsRealData;
+  // (barycentric coordinates are not stored, the shaders generate them)
+  std::vector<float> edgeIsRealMaskData;
   std::vector<float> faceTypeData;
 
   // other internally-computed geometry
@@ -250,6 +253,11 @@ private:
 
   void fillGeometryBuffersFlat(render::ShaderProgram& p);
 
+  // Call func(iC, iF, face, iTri, iData) for each triangle iTri of each cell face, in parallel over ranges of cells.
+  // iData is the triangle's slot in the draw buffers, which hold exterior faces first (see computeConnectivityData()).
+  template <typename Func>
+  void forEachFaceTriangle(Func&& func);
+
   // stencils for looping over cells
   // (each is a list of faces, which is itself a list of 1 or more triangles)
   // clang-format off
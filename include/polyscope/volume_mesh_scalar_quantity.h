@@ -21,6 +21,7 @@ public:
   virtual void draw() override;
   virtual void buildCustomUI() override;
   virtual std::string niceName() override;
+  virtual render::ManagedBuffer<float>* getScalarValues() override { return &values; }
   virtual void refresh() override;
 
 protected:
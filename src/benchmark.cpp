@@ -0,0 +1,336 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/benchmark.h"
+
+#include "polyscope/messages.h"
+#include "polyscope/options.h"
+#include "polyscope/polyscope.h"
+#include "polyscope/render/engine.h"
+#include "polyscope/utilities.h"
+#include "polyscope/view.h"
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace polyscope {
+namespace benchmark {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// State for timing passes while a replay is running
+bool replayRunning = false;
+const char* currentPassName = nullptr;
+Clock::time_point currentPassStart;
+std::vector<std::pair<std::string, std::vector<double>>> passTimes;
+
+double millisecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void recordPassTime(const std::string& name, double ms) {
+  for (std::pair<std::string, std::vector<double>>& entry : passTimes) {
+    if (entry.first == name) {
+      entry.second.push_back(ms);
+      return;
+    }
+  }
+  passTimes.emplace_back(name, std::vector<double>{ms});
+}
+
+// Draw one frame of the scene (without the UI) and show it
+void drawReplayFrame() {
+  requestRedraw();
+  draw(false, false);
+  beginPass("present");
+  render::engine->swapDisplayBuffers();
+  endPass();
+}
+
+json timingSummaryToJson(const TimingSummary& s) {
+  return json{{"min", s.minMs}, {"median", s.medianMs}, {"p99", s.p99Ms}, {"mean", s.meanMs}, {"max", s.maxMs}};
+}
+
+} // namespace
+
+// === Camera paths
+
+void CameraPath::addKeyframe() { addKeyframe(view::getCameraViewMatrix(), view::fov); }
+
+void CameraPath::addKeyframe(const glm::mat4& viewMat, float fov) { keyframes.push_back(Keyframe{viewMat, fov}); }
+
+void CameraPath::addKeyframeFromJson(std::string viewJson) {
+  json j;
+  try {
+    j = json::parse(viewJson);
+  } catch (const std::exception& e) {
+    exception("could not parse camera keyframe: " + std::string(e.what()));
+    return;
+  }
+
+  // (same layout as view::getViewAsJson(), row-major)
+  if (j.find("viewMat") == j.end() || j["viewMat"].size() != 16 || j.find("fov") == j.end()) {
+    exception("camera keyframe must have 'viewMat' (16 entries) and 'fov'");
+    return;
+  }
+  glm::mat4 viewMat;
+  for (int i = 0; i < 4; i++) {
+    for (int k = 0; k < 4; k++) {
+      viewMat[k][i] = j["viewMat"][4 * i + k].get<float>();
+    }
+  }
+  addKeyframe(viewMat, j["fov"].get<float>());
+}
+
+void CameraPath::clear() { keyframes.clear(); }
+
+void CameraPath::applyAt(double t) const {
+  if (keyframes.empty()) {
+    exception("cannot apply an empty camera path");
+    return;
+  }
+
+  view::immediatelyEndFlight();
+
+  // Find the segment and the position within it
+  double s = std::min(std::max(t, 0.), 1.) * (keyframes.size() - 1);
+  size_t iStart = std::min(static_cast<size_t>(std::floor(s)), keyframes.size() - 1);
+  size_t iEnd = std::min(iStart + 1, keyframes.size() - 1);
+  float u = static_cast<float>(s - iStart);
+  const Keyframe& kA = keyframes[iStart];
+  const Keyframe& kB = keyframes[iEnd];
+
+  // Interpolate like view flights do
+  glm::mat3x4 rA, rB;
+  glm::vec3 tA, tB;
+  splitTransform(kA.viewMat, rA, tA);
+  splitTransform(kB.viewMat, rB, tB);
+  glm::dualquat interpR = glm::lerp(glm::dualquat_cast(rA), glm::dualquat_cast(rB), u);
+  glm::vec3 interpT = glm::mix(tA, tB, u);
+
+  view::setCameraViewMatrix(buildTransform(glm::mat3x4_cast(interpR), interpT));
+  view::fov = (1.f - u) * kA.fov + u * kB.fov;
+  requestRedraw();
+}
+
+CameraPath CameraPath::orbitAroundScene(size_t nKeyframes) {
+  CameraPath path;
+  glm::vec3 sceneCenter = state::center();
+  glm::vec3 up = view::getUpVec();
+  glm::vec3 front = view::getFrontVec();
+  glm::vec3 side = glm::cross(up, front);
+  float radius = 1.5f * state::lengthScale;
+  float height = 0.5f * state::lengthScale;
+
+  for (size_t i = 0; i < nKeyframes; i++) {
+    // (the last keyframe closes the circle)
+    float angle = 2.f * glm::pi<float>() * i / std::max<size_t>(nKeyframes - 1, 1);
+    glm::vec3 eye = sceneCenter + radius * (std::cos(angle) * front + std::sin(angle) * side) + height * up;
+    path.addKeyframe(glm::lookAt(eye, sceneCenter, up), view::defaultFov);
+  }
+  return path;
+}
+
+std::string CameraPath::toJson() const {
+  json j = json::array();
+  for (const Keyframe& k : keyframes) {
+    std::array<float, 16> viewMatFlat;
+    for (int i = 0; i < 4; i++) {
+      for (int m = 0; m < 4; m++) {
+        viewMatFlat[4 * i + m] = k.viewMat[m][i];
+      }
+    }
+    j.push_back(json{{"viewMat", viewMatFlat}, {"fov", k.fov}});
+  }
+  return j.dump();
+}
+
+CameraPath CameraPath::fromJson(std::string jsonData) {
+  CameraPath path;
+  json j;
+  try {
+    j = json::parse(jsonData);
+  } catch (const std::exception& e) {
+    exception("could not parse camera path: " + std::string(e.what()));
+    return path;
+  }
+  if (!j.is_array()) {
+    exception("camera path JSON must be a list of keyframes");
+    return path;
+  }
+  for (const json& k : j) {
+    path.addKeyframeFromJson(k.dump());
+  }
+  return path;
+}
+
+void CameraPath::saveToFile(std::string filename) const {
+  std::ofstream out(filename);
+  if (!out) {
+    exception("could not open camera path file for writing: " + filename);
+    return;
+  }
+  out << toJson() << std::endl;
+}
+
+CameraPath CameraPath::loadFromFile(std::string filename) {
+  std::ifstream in(filename);
+  if (!in) {
+    exception("could not open camera path file: " + filename);
+    return CameraPath();
+  }
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  return fromJson(buffer.str());
+}
+
+// === Replay
+
+TimingSummary summarizeTimings(std::vector<double> timesMs) {
+  TimingSummary s;
+  if (timesMs.empty()) return s;
+
+  std::sort(timesMs.begin(), timesMs.end());
+  size_t n = timesMs.size();
+  s.minMs = timesMs.front();
+  s.maxMs = timesMs.back();
+  s.medianMs = (n % 2 == 1) ? timesMs[n / 2] : 0.5 * (timesMs[n / 2 - 1] + timesMs[n / 2]);
+  size_t p99Rank = static_cast<size_t>(std::ceil(0.99 * n)); // nearest-rank percentile
+  s.p99Ms = timesMs[std::max<size_t>(p99Rank, 1) - 1];
+  double sum = 0.;
+  for (double t : timesMs) sum += t;
+  s.meanMs = sum / n;
+  return s;
+}
+
+ReplayResult replayCameraPath(const CameraPath& path, size_t nFrames, size_t nWarmupFrames) {
+  checkInitialized();
+  if (path.nKeyframes() == 0) {
+    exception("cannot replay an empty camera path");
+  }
+  if (replayRunning) {
+    exception("a camera path replay is already running");
+  }
+
+  std::string initialView = view::getViewAsJson();
+  bool initialRedrawRequested = redrawRequested();
+
+  // Don't wait for the display between frames, or every frame would take at least one refresh interval
+  bool initialVSync = options::enableVSync;
+  options::enableVSync = false;
+  render::engine->makeContextCurrent();
+
+  ReplayResult result;
+  result.nFrames = nFrames;
+  result.bufferWidth = view::bufferWidth;
+  result.bufferHeight = view::bufferHeight;
+  result.backend = state::backend;
+  result.frameMs.reserve(nFrames);
+
+  passTimes.clear();
+  try {
+    // Start from a settled state: all uploads applied, programs created
+    processLazyProperties();
+    render::engine->uploadScheduler.flush();
+    for (size_t i = 0; i < nWarmupFrames; i++) {
+      path.applyAt(0.);
+      drawReplayFrame();
+    }
+    render::engine->finishDeviceWork();
+
+    replayRunning = true;
+    for (size_t i = 0; i < nFrames; i++) {
+      path.applyAt(nFrames > 1 ? static_cast<double>(i) / (nFrames - 1) : 0.);
+      Clock::time_point frameStart = Clock::now();
+      drawReplayFrame();
+      render::engine->finishDeviceWork();
+      result.frameMs.push_back(millisecondsSince(frameStart));
+    }
+  } catch (...) {
+    replayRunning = false;
+    currentPassName = nullptr;
+    options::enableVSync = initialVSync;
+    render::engine->makeContextCurrent();
+    throw;
+  }
+  replayRunning = false;
+  currentPassName = nullptr;
+  options::enableVSync = initialVSync;
+  render::engine->makeContextCurrent();
+
+  result.frameTime = summarizeTimings(result.frameMs);
+  for (const std::pair<std::string, std::vector<double>>& entry : passTimes) {
+    result.passes.emplace_back(entry.first, summarizeTimings(entry.second));
+  }
+  passTimes.clear();
+
+  result.haveDeviceMemory =
+      render::engine->getDeviceMemoryInfo(result.deviceMemoryTotalBytes, result.deviceMemoryAvailableBytes);
+
+  // Put the view back the way it was
+  view::setViewFromJson(initialView, false);
+  if (initialRedrawRequested) requestRedraw();
+
+  return result;
+}
+
+std::string replayResultToJson(const ReplayResult& result) {
+  json passes = json::object();
+  for (const std::pair<std::string, TimingSummary>& entry : result.passes) {
+    passes[entry.first] = timingSummaryToJson(entry.second);
+  }
+
+  json deviceMemory = nullptr;
+  if (result.haveDeviceMemory) {
+    deviceMemory = json{{"totalBytes", result.deviceMemoryTotalBytes},
+                        {"availableBytes", result.deviceMemoryAvailableBytes}};
+  }
+
+  json j = {
+      {"nFrames", result.nFrames},
+      {"bufferWidth", result.bufferWidth},
+      {"bufferHeight", result.bufferHeight},
+      {"backend", result.backend},
+      {"frameTimeMs", timingSummaryToJson(result.frameTime)},
+      {"passTimeMs", passes},
+      {"deviceMemory", deviceMemory},
+      {"frameMs", result.frameMs},
+  };
+  return j.dump(2);
+}
+
+void writeReplayReport(const ReplayResult& result, std::string filename) {
+  std::ofstream out(filename);
+  if (!out) {
+    exception("could not open benchmark report file for writing: " + filename);
+    return;
+  }
+  out << replayResultToJson(result) << std::endl;
+}
+
+// === Pass timing
+
+void beginPass(const char* name) {
+  if (!replayRunning) return;
+  render::engine->finishDeviceWork(); // (so earlier work is not counted towards this pass)
+  currentPassName = name;
+  currentPassStart = Clock::now();
+}
+
+void endPass() {
+  if (!replayRunning || currentPassName == nullptr) return;
+  render::engine->finishDeviceWork();
+  recordPassTime(currentPassName, millisecondsSince(currentPassStart));
+  currentPassName = nullptr;
+}
+
+} // namespace benchmark
+} // namespace polyscope
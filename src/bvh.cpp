@@ -0,0 +1,96 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/bvh.h"
+
+#include "polyscope/messages.h"
+#include "polyscope/utilities.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace polyscope {
+
+namespace {
+const uint32_t bvhLeafSize = 4;
+const float floatInf = std::numeric_limits<float>::infinity();
+} // namespace
+
+void BVH::build(const std::vector<glm::vec3>& primMin, const std::vector<glm::vec3>& primMax) {
+
+  if (primMin.size() != primMax.size()) {
+    exception("BVH::build() bound arrays must have the same size");
+  }
+  if (primMin.size() >= std::numeric_limits<uint32_t>::max()) {
+    exception("BVH::build() too many primitives");
+  }
+
+  nPrims = primMin.size();
+  nodes.clear();
+  primOrder.clear();
+
+  // Only keep primitives with sensible bounds, this also keeps NaNs out of the splits
+  std::vector<glm::vec3> centers(nPrims);
+  for (uint32_t i = 0; i < nPrims; i++) {
+    bool valid = true;
+    for (int j = 0; j < 3; j++) {
+      if (!(primMin[i][j] <= primMax[i][j])) valid = false;
+    }
+    if (!valid) continue;
+    primOrder.push_back(i);
+    centers[i] = 0.5f * (primMin[i] + primMax[i]);
+  }
+  if (primOrder.empty()) return;
+
+  nodes.reserve(2 * primOrder.size() / bvhLeafSize + 1);
+  buildNode(primMin, primMax, centers, 0, static_cast<uint32_t>(primOrder.size()));
+}
+
+uint32_t BVH::buildNode(const std::vector<glm::vec3>& primMin, const std::vector<glm::vec3>& primMax,
+                        const std::vector<glm::vec3>& centers, uint32_t start, uint32_t end) {
+
+  uint32_t iNode = static_cast<uint32_t>(nodes.size());
+  nodes.emplace_back();
+
+  // Bounds of the primitives and of their centers
+  glm::vec3 bMin{floatInf, floatInf, floatInf};
+  glm::vec3 bMax = -bMin;
+  glm::vec3 cMin = bMin;
+  glm::vec3 cMax = bMax;
+  for (uint32_t i = start; i < end; i++) {
+    uint32_t iPrim = primOrder[i];
+    bMin = componentwiseMin(bMin, primMin[iPrim]);
+    bMax = componentwiseMax(bMax, primMax[iPrim]);
+    cMin = componentwiseMin(cMin, centers[iPrim]);
+    cMax = componentwiseMax(cMax, centers[iPrim]);
+  }
+  nodes[iNode].boundMin = bMin;
+  nodes[iNode].boundMax = bMax;
+  nodes[iNode].start = start;
+  nodes[iNode].count = 0;
+  nodes[iNode].secondChild = 0;
+
+  glm::vec3 cExtent = cMax - cMin;
+  int axis = 0;
+  if (cExtent.y > cExtent[axis]) axis = 1;
+  if (cExtent.z > cExtent[axis]) axis = 2;
+
+  // Make a leaf if the range is small, or if all the centers coincide so no split would help
+  uint32_t count = end - start;
+  if (count <= bvhLeafSize || !(cExtent[axis] > 0.)) {
+    nodes[iNode].count = count;
+    return iNode;
+  }
+
+  // Median split along the longest axis. Since the split is always balanced, the recursion depth is logarithmic.
+  uint32_t mid = start + count / 2;
+  std::nth_element(primOrder.begin() + start, primOrder.begin() + mid, primOrder.begin() + end,
+                   [&](uint32_t a, uint32_t b) { return centers[a][axis] < centers[b][axis]; });
+
+  buildNode(primMin, primMax, centers, start, mid); // lands at iNode + 1
+  uint32_t iSecond = buildNode(primMin, primMax, centers, mid, end);
+  nodes[iNode].secondChild = iSecond; // (don't hold a reference across the calls above, they may reallocate)
+
+  return iNode;
+}
+
+} // namespace polyscope
@@ -229,7 +229,6 @@ void CameraView::fillCameraWidgetGeometry(render::ShaderProgram* nodeProgram, re
 
     std::vector<glm::vec3> positions;
     std::vector<glm::vec3> normals;
-    std::vector<glm::vec3> bcoord;
     std::vector<glm::vec3> cullPos;
 
     auto addPolygon = [&](std::vector<glm::vec3> vertices) {
@@ -252,11 +251,6 @@ void CameraView::fillCameraWidgetGeometry(render::ShaderProgram* nodeProgram, re
         normals.push_back(faceN);
         normals.push_back(faceN);
 
-        // Bary coords
-        bcoord.push_back(glm::vec3{1., 0., 0.});
-        bcoord.push_back(glm::vec3{0., 1., 0.});
-        bcoord.push_back(glm::vec3{0., 0., 1.});
-
         // Cull position
         cullPos.push_back(root);
         cullPos.push_back(root);
@@ -278,7 +272,6 @@ void CameraView::fillCameraWidgetGeometry(render::ShaderProgram* nodeProgram, re
       // // this is not actually used, but it only gets optimized out on some platforms, not all
       pickFrameProgram->setAttribute("a_vertexNormals", normals);
     }
-    pickFrameProgram->setAttribute("a_barycoord", bcoord);
 
     size_t nFaces = 7;
     std::vector<glm::vec3> faceColor(3 * nFaces, pickColor);
@@ -311,6 +304,7 @@ void CameraView::geometryChanged() {
   if (pickFrameProgram) {
     fillCameraWidgetGeometry(nullptr, nullptr, pickFrameProgram.get());
   }
+  pick::markPickBufferStale();
 
   requestRedraw();
   QuantityStructure<CameraView>::refresh();
@@ -376,6 +370,7 @@ void CameraView::buildCustomOptionsUI() {
 
   if (ImGui::SliderFloat("widget thickness", &widgetThickness.get(), 0, 0.2, "%.5f")) {
     widgetThickness.manuallyChanged();
+    pick::markPickBufferStale();
     requestRedraw();
   }
 
@@ -438,6 +433,7 @@ float CameraView::getWidgetFocalLength() { return widgetFocalLength.get().asAbso
 
 CameraView* CameraView::setWidgetThickness(float newVal) {
   widgetThickness = newVal;
+  pick::markPickBufferStale();
   polyscope::requestRedraw();
   return this;
 }
@@ -4,12 +4,16 @@
 
 #include "polyscope/pick.h"
 #include "polyscope/polyscope.h"
+#include "polyscope/reductions.h"
+#include "polyscope/region_selection.h"
 #include "polyscope/render/engine.h"
 
 #include "imgui.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <numeric>
 
 namespace polyscope {
 
@@ -27,9 +31,26 @@ CurveNetwork::CurveNetwork(std::string name, std::vector<glm::vec3> nodes_, std:
       nodePositionsData(std::move(nodes_)), 
       color(uniquePrefix() + "#color", getNextUniqueColor()), 
       radius(uniquePrefix() + "#radius", relativeValue(0.005)),
-      material(uniquePrefix() + "#material", "clay")
+      material(uniquePrefix() + "#material", "clay"),
+      depthPrepass(uniquePrefix() + "#depthPrepass", false),
+      levelOfDetail(uniquePrefix() + "#levelOfDetail", true),
+      lodNodeInds(this, uniquePrefix() + "lodNodeInds", lodNodeIndsData),
+      lodEdgeTailInds(this, uniquePrefix() + "lodEdgeTailInds", lodEdgeTailIndsData),
+      lodEdgeTipInds(this, uniquePrefix() + "lodEdgeTipInds", lodEdgeTipIndsData),
+      lodEdgeInds(this, uniquePrefix() + "lodEdgeInds", lodEdgeIndsData)
 // clang-format on
 {
+  initializeEdges(edges_);
+}
+
+CurveNetwork::CurveNetwork(std::string name, render::ManagedBuffer<glm::vec3>& sharedNodes,
+                           std::vector<std::array<size_t, 2>> edges_)
+    : CurveNetwork(name, std::vector<glm::vec3>(), std::vector<std::array<size_t, 2>>()) {
+  nodePositions.shareFrom(sharedNodes);
+  initializeEdges(edges_);
+}
+
+void CurveNetwork::initializeEdges(const std::vector<std::array<size_t, 2>>& edges_) {
 
   // Copy interleaved data in to tip and tails buffers below
   edgeTailIndsData.resize(edges_.size());
@@ -86,6 +107,7 @@ void CurveNetwork::setCurveNetworkNodeUniforms(render::ShaderProgram& p) {
   p.setUniform("u_invProjMatrix", glm::value_ptr(Pinv));
   p.setUniform("u_viewport", render::engine->getCurrentViewport());
   p.setUniform("u_pointRadius", computeRadiusMultiplierUniform());
+  nodeMask.setUniforms(p);
 }
 
 void CurveNetwork::setCurveNetworkEdgeUniforms(render::ShaderProgram& p) {
@@ -94,6 +116,11 @@ void CurveNetwork::setCurveNetworkEdgeUniforms(render::ShaderProgram& p) {
   p.setUniform("u_invProjMatrix", glm::value_ptr(Pinv));
   p.setUniform("u_viewport", render::engine->getCurrentViewport());
   p.setUniform("u_radius", computeRadiusMultiplierUniform());
+  if (p.hasUniform("u_lineMaxPixelRadius")) {
+    float lineMaxPixelRadius = options::curveNetworkLinePixelRadius * render::engine->getCurrentPixelScaling();
+    p.setUniform("u_lineMaxPixelRadius", lineMaxPixelRadius);
+  }
+  edgeMask.setUniforms(p);
 }
 
 void CurveNetwork::draw() {
@@ -101,6 +128,24 @@ void CurveNetwork::draw() {
     return;
   }
 
+  nodeMask.update();
+  edgeMask.update();
+  updateLevelOfDetail();
+
+  // Lay down the depth of the nodes first, so that the shading below (by this class or the quantities) only runs for
+  // the front-most node fragments
+  bool prepass = usesDepthPrepass();
+  if (prepass) {
+    if (nodeDepthProgram == nullptr) {
+      prepareDepth();
+    }
+    setStructureUniforms(*nodeDepthProgram);
+    setCurveNetworkNodeUniforms(*nodeDepthProgram);
+    render::engine->beginDepthPrepass();
+    nodeDepthProgram->draw();
+    render::engine->beginDepthPrepassShading();
+  }
+
   // If there is no dominant quantity, then this class is responsible for drawing points
   if (dominantQuantity == nullptr) {
 
@@ -134,6 +179,10 @@ void CurveNetwork::draw() {
   for (auto& x : floatingQuantities) {
     x.second->draw();
   }
+
+  if (prepass) {
+    render::engine->endDepthPrepass();
+  }
 }
 
 void CurveNetwork::drawDelayed() {
@@ -154,6 +203,9 @@ void CurveNetwork::drawPick() {
     return;
   }
 
+  nodeMask.update();
+  edgeMask.update();
+
   // Ensure we have prepared buffers
   if (edgePickProgram == nullptr || nodePickProgram == nullptr) {
     preparePick();
@@ -170,7 +222,7 @@ void CurveNetwork::drawPick() {
   nodePickProgram->draw();
 }
 
-std::vector<std::string> CurveNetwork::addCurveNetworkNodeRules(std::vector<std::string> initRules) {
+std::vector<std::string> CurveNetwork::addCurveNetworkNodeRules(std::vector<std::string> initRules, bool withShade) {
   initRules = addStructureRules(initRules);
 
   if (nodeRadiusQuantityName != "") {
@@ -179,9 +231,13 @@ std::vector<std::string> CurveNetwork::addCurveNetworkNodeRules(std::vector<std:
   if (wantsCullPosition()) {
     initRules.push_back("SPHERE_CULLPOS_FROM_CENTER");
   }
+  if (nodeMask.isActive()) {
+    initRules.push_back("ELEMENT_MASK_PROPAGATE_GEOM");
+    if (withShade) initRules.push_back("ELEMENT_MASK_SHADE_RAYCAST");
+  }
   return initRules;
 }
-std::vector<std::string> CurveNetwork::addCurveNetworkEdgeRules(std::vector<std::string> initRules) {
+std::vector<std::string> CurveNetwork::addCurveNetworkEdgeRules(std::vector<std::string> initRules, bool withShade) {
   initRules = addStructureRules(initRules);
 
   // use node radius to blend cylinder radius
@@ -192,6 +248,13 @@ std::vector<std::string> CurveNetwork::addCurveNetworkEdgeRules(std::vector<std:
   if (wantsCullPosition()) {
     initRules.push_back("CYLINDER_CULLPOS_FROM_MID");
   }
+  if (edgeMask.isActive()) {
+    initRules.push_back("ELEMENT_MASK_PROPAGATE_GEOM");
+    if (withShade) initRules.push_back("ELEMENT_MASK_SHADE_RAYCAST");
+  }
+  if (withShade && lodActive) {
+    initRules.push_back("CYLINDER_THIN_AS_LINE");
+  }
   return initRules;
 }
 
@@ -244,7 +307,7 @@ void CurveNetwork::preparePick() {
 
   { // Set up node picking program
     nodePickProgram =
-        render::engine->requestShader("RAYCAST_SPHERE", addCurveNetworkNodeRules({"SPHERE_PROPAGATE_COLOR"}),
+        render::engine->requestShader("RAYCAST_SPHERE", addCurveNetworkNodeRules({"SPHERE_PROPAGATE_COLOR"}, false),
                                       render::ShaderReplacementDefaults::Pick);
 
     // Fill color buffer with packed point indices
@@ -258,12 +321,12 @@ void CurveNetwork::preparePick() {
     // Store data in buffers
     nodePickProgram->setAttribute("a_color", pickColors);
 
-    fillNodeGeometryBuffers(*nodePickProgram);
+    fillNodeGeometryBuffers(*nodePickProgram, true);
   }
 
   { // Set up edge picking program
     edgePickProgram =
-        render::engine->requestShader("RAYCAST_CYLINDER", addCurveNetworkEdgeRules({"CYLINDER_PROPAGATE_PICK"}),
+        render::engine->requestShader("RAYCAST_CYLINDER", addCurveNetworkEdgeRules({"CYLINDER_PROPAGATE_PICK"}, false),
                                       render::ShaderReplacementDefaults::Pick);
 
     // Fill color buffer with packed node/edge indices
@@ -287,32 +350,145 @@ void CurveNetwork::preparePick() {
     edgePickProgram->setAttribute("a_color_tip", edgePickTip);
     edgePickProgram->setAttribute("a_color_edge", edgePickEdge);
 
-    fillEdgeGeometryBuffers(*edgePickProgram);
+    fillEdgeGeometryBuffers(*edgePickProgram, true);
   }
 }
 
-void CurveNetwork::fillNodeGeometryBuffers(render::ShaderProgram& program) {
-  program.setAttribute("a_position", nodePositions.getRenderAttributeBuffer());
+void CurveNetwork::prepareDepth() {
+  // (no shading rules, the program only writes depth)
+  nodeDepthProgram = render::engine->requestShader("RAYCAST_SPHERE_DEPTH", addCurveNetworkNodeRules({}, false));
+  fillNodeGeometryBuffers(*nodeDepthProgram);
+}
+
+bool CurveNetwork::usesDepthPrepass() {
+  return (depthPrepass.get() || options::impostorDepthPrepass) && render::engine->depthPrepassAllowed();
+}
+
+void CurveNetwork::fillNodeGeometryBuffers(render::ShaderProgram& program, bool fullDetail) {
+  bool lodNodes = lodActive && !fullDetail;
+  auto nodeBuffer = [&](render::ManagedBuffer<float>& nodeData) {
+    return lodNodes ? nodeData.getIndexedRenderAttributeBuffer(lodNodeInds) : nodeData.getRenderAttributeBuffer();
+  };
+
+  program.setAttribute("a_position", lodNodes ? nodePositions.getIndexedRenderAttributeBuffer(lodNodeInds)
+                                              : nodePositions.getRenderAttributeBuffer());
 
   if (nodeRadiusQuantityName != "") {
     CurveNetworkNodeScalarQuantity& nodeRadQ = resolveNodeRadiusQuantity();
-    program.setAttribute("a_pointRadius", nodeRadQ.values.getRenderAttributeBuffer());
+    program.setAttribute("a_pointRadius", nodeBuffer(nodeRadQ.values));
   }
+  nodeMask.setTextures(program);
 }
 
-void CurveNetwork::fillEdgeGeometryBuffers(render::ShaderProgram& program) {
-  program.setAttribute("a_position_tail", nodePositions.getIndexedRenderAttributeBuffer(edgeTailInds));
-  program.setAttribute("a_position_tip", nodePositions.getIndexedRenderAttributeBuffer(edgeTipInds));
+void CurveNetwork::fillEdgeGeometryBuffers(render::ShaderProgram& program, bool fullDetail) {
+  bool lodEdges = lodActive && !fullDetail;
+  render::ManagedBuffer<uint32_t>& tailInds = lodEdges ? lodEdgeTailInds : edgeTailInds;
+  render::ManagedBuffer<uint32_t>& tipInds = lodEdges ? lodEdgeTipInds : edgeTipInds;
+
+  program.setAttribute("a_position_tail", nodePositions.getIndexedRenderAttributeBuffer(tailInds));
+  program.setAttribute("a_position_tip", nodePositions.getIndexedRenderAttributeBuffer(tipInds));
 
   if (nodeRadiusQuantityName != "") {
     CurveNetworkNodeScalarQuantity& nodeRadQ = resolveNodeRadiusQuantity();
-    program.setAttribute("a_tailRadius", nodeRadQ.values.getIndexedRenderAttributeBuffer(edgeTailInds));
-    program.setAttribute("a_tipRadius", nodeRadQ.values.getIndexedRenderAttributeBuffer(edgeTipInds));
+    program.setAttribute("a_tailRadius", nodeRadQ.values.getIndexedRenderAttributeBuffer(tailInds));
+    program.setAttribute("a_tipRadius", nodeRadQ.values.getIndexedRenderAttributeBuffer(tipInds));
+  }
+  edgeMask.setTextures(program);
+}
+
+void CurveNetwork::updateLevelOfDetail() {
+  if (!usesLevelOfDetail()) {
+    if (lodActive) {
+      lodActive = false;
+      refreshDrawPrograms();
+    }
+    return;
+  }
+
+  // Rebuild the hierarchy in the background if the geometry changed. At most one build runs at a time, so while the
+  // positions keep changing the hierarchy is rebuilt as often as a build takes, not on every update. Until a build
+  // finishes, the levels built before stay in use: they only hold indices, so they are still valid for the new
+  // positions, just less accurate.
+  uint64_t key = nodePositions.getDataVersion();
+  bool haveLevels = lod.isReady();
+  if (!lod.isCurrent(key) && !lod.isBuilding()) {
+    edgeTailInds.ensureHostBufferPopulated();
+    edgeTipInds.ensureHostBufferPopulated();
+    lod.buildAsync(nodePositions.getPopulatedHostBufferRef(), edgeTailInds.data, edgeTipInds.data, key);
+  }
+  if (!haveLevels) return;
+
+  size_t targetLevel = lod.levelForError(lodMaxWorldError());
+  if (lodActive && lod.isCurrent(lodLevelKey) && targetLevel == lodLevel) return;
+
+  // Switch levels by copying the new one to the index buffers
+  lodLevel = targetLevel;
+  lodLevelKey = lod.getKey();
+  const CurveNetworkLOD::Level& level = lod.getLevel(lodLevel);
+  lodNodeInds.data = level.nodeInds;
+  if (lodLevel > 0) {
+    lodEdgeTailInds.data = level.edgeTailInds;
+    lodEdgeTipInds.data = level.edgeTipInds;
+    lodEdgeInds.data = level.edgeInds;
+  } else {
+    edgeTailInds.ensureHostBufferPopulated();
+    edgeTipInds.ensureHostBufferPopulated();
+    lodEdgeTailInds.data = edgeTailInds.data;
+    lodEdgeTipInds.data = edgeTipInds.data;
+    lodEdgeInds.data.resize(nEdges());
+    for (size_t iE = 0; iE < nEdges(); iE++) lodEdgeInds.data[iE] = iE;
+  }
+  lodNodeInds.markHostBufferUpdated();
+  lodEdgeTailInds.markHostBufferUpdated();
+  lodEdgeTipInds.markHostBufferUpdated();
+  lodEdgeInds.markHostBufferUpdated();
+
+  if (!lodActive) {
+    // The draw programs bind the index buffers from now on, they are rebuilt lazily
+    lodActive = true;
+    refreshDrawPrograms();
+    return;
+  }
+
+  // Otherwise the programs keep drawing from the same views, which just need to be gathered again
+  updateNodeDrawAttributeBuffers(nodePositions);
+  for (auto& q : quantities) {
+    q.second->updateLODViews();
+  }
+}
+
+void CurveNetwork::refreshDrawPrograms() {
+  nodeProgram.reset();
+  edgeProgram.reset();
+  nodeDepthProgram.reset();
+  for (auto& q : quantities) {
+    q.second->refresh();
+  }
+  requestRedraw();
+}
+
+bool CurveNetwork::isLevelOfDetailReady(bool waitForBuild) { return lod.isReady(waitForBuild); }
+
+float CurveNetwork::lodMaxWorldError() {
+  glm::mat4 modelView = getModelView();
+  glm::mat4 projection = view::getCameraPerspectiveMatrix();
+
+  // the point of the bounding box closest to the camera, in object space
+  glm::vec3 cameraPos = glm::vec3(glm::inverse(modelView) * glm::vec4(0., 0., 0., 1.));
+  glm::vec3 nearestPos =
+      glm::clamp(cameraPos, std::get<0>(objectSpaceBoundingBox), std::get<1>(objectSpaceBoundingBox));
+  glm::vec4 clipPos = projection * modelView * glm::vec4(nearestPos, 1.);
+  if (!(clipPos.w > 0.)) {
+    return 0.; // (the camera is inside the bounding box)
   }
+
+  float viewScale = glm::length(glm::vec3(modelView[0]));
+  float pixelsPerUnit = viewScale * projection[1][1] * view::bufferHeight / (2.f * clipPos.w);
+  return options::curveNetworkLODPixelError / pixelsPerUnit;
 }
 
 void CurveNetwork::computeEdgeCenters() {
-  nodePositions.ensureHostBufferPopulated();
+  const std::vector<glm::vec3>& positions = nodePositions.getPopulatedHostBufferRef();
   edgeTailInds.ensureHostBufferPopulated();
   edgeTipInds.ensureHostBufferPopulated();
 
@@ -321,7 +497,7 @@ void CurveNetwork::computeEdgeCenters() {
   for (size_t iE = 0; iE < nEdges(); iE++) {
     size_t eTail = edgeTailInds.data[iE];
     size_t eTip = edgeTipInds.data[iE];
-    glm::vec3 p = 0.5f * (nodePositions.data[eTail] + nodePositions.data[eTip]);
+    glm::vec3 p = 0.5f * (positions[eTail] + positions[eTip]);
     edgeCenters.data[iE] = p;
   }
 
@@ -335,12 +511,136 @@ void CurveNetwork::refresh() {
   edgeProgram.reset();
   nodePickProgram.reset();
   edgePickProgram.reset();
+  nodeDepthProgram.reset();
   requestRedraw();
   QuantityStructure<CurveNetwork>::refresh(); // call base class version, which refreshes quantities
 }
 
+void CurveNetwork::setNodeMask(const std::vector<size_t>& inds, ElementMaskMode mode) {
+  setMask(nodeMask, nNodes(), inds, mode);
+}
+void CurveNetwork::setEdgeMask(const std::vector<size_t>& inds, ElementMaskMode mode) {
+  setMask(edgeMask, nEdges(), inds, mode);
+}
+void CurveNetwork::clearNodeMask() { clearMask(nodeMask); }
+void CurveNetwork::clearEdgeMask() { clearMask(edgeMask); }
+ElementMask& CurveNetwork::getNodeMask() { return nodeMask; }
+ElementMask& CurveNetwork::getEdgeMask() { return edgeMask; }
+
+void CurveNetwork::setMask(ElementMask& mask, size_t maskSize, const std::vector<size_t>& inds, ElementMaskMode mode) {
+  // (nodes and edges are drawn in index order, so the mask texels are just the indices)
+  bool wasActive = mask.isActive();
+  if (mask.size() != maskSize) mask.resize(maskSize);
+  for (size_t ind : inds) {
+    mask.set(ind, mode);
+  }
+  if (mask.isActive() != wasActive) refresh(); // the mask rules are only added while it is active
+  requestRedraw();
+}
+
+void CurveNetwork::clearMask(ElementMask& mask) {
+  bool wasActive = mask.isActive();
+  mask.clear();
+  if (wasActive) refresh();
+  requestRedraw();
+}
+
 void CurveNetwork::recomputeGeometryIfPopulated() { edgeCenters.recomputeIfPopulated(); }
 
+void CurveNetwork::sharedBufferUpdated(const std::string& bufferName) {
+  if (bufferName == nodePositions.name) {
+    recomputeGeometryIfPopulated();
+  }
+}
+
+bool CurveNetwork::queryRay(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayHit& hitOut) {
+
+  // Rebuild the acceleration structure if the geometry or radius changed
+  const std::vector<glm::vec3>& positions = nodePositions.getPopulatedHostBufferRef();
+  edgeTailInds.ensureHostBufferPopulated();
+  edgeTipInds.ensureHostBufferPopulated();
+  float rad = getRadius();
+  std::vector<uint64_t> key{nodePositions.getDataVersion(), edgeTailInds.getDataVersion(),
+                            edgeTipInds.getDataVersion(), RayQueryAccel::keyFromFloat(rad)};
+  if (!rayQueryAccel.isCurrent(key)) {
+    RayQueryGeometry geom;
+    geom.positions = positions;
+    geom.cylinders.resize(nEdges());
+    for (size_t iE = 0; iE < nEdges(); iE++) {
+      geom.cylinders[iE] = {edgeTailInds.data[iE], edgeTipInds.data[iE]};
+    }
+    geom.spheres.resize(nNodes());
+    std::iota(geom.spheres.begin(), geom.spheres.end(), 0);
+    geom.radius = rad;
+    rayQueryAccel.setGeometry(std::move(geom), key);
+  }
+
+  // Nodes come first in the pick indexing, then edges
+  RayQueryAccel::Hit primHit;
+  if (!queryRayAccel(rayOrigin, rayDir, waitForBuild, primHit, hitOut)) return false;
+  if (primHit.type == RayQueryAccel::PrimitiveType::Cylinder) {
+    hitOut.localIndex = nNodes() + primHit.index;
+  } else {
+    hitOut.localIndex = primHit.index;
+  }
+  return true;
+}
+
+bool CurveNetwork::selectInScreenRegion(const ScreenRegion& region, std::vector<size_t>& localIndsOut) {
+  localIndsOut = selectNodesInScreenRegion(region); // nodes come first in the pick indexing
+  return true;
+}
+
+bool CurveNetwork::filterScalarQuantityElements(Quantity& q, ElementFilter filter, uint64_t& versionOut,
+                                                std::vector<char>* includeOut) {
+  bool onEdges = dynamic_cast<CurveNetworkEdgeScalarQuantity*>(&q) != nullptr;
+  size_t nElements = onEdges ? nEdges() : nNodes();
+  if (includeOut) includeOut->clear();
+  switch (filter) {
+  case ElementFilter::All:
+    versionOut = 0;
+    return true;
+  case ElementFilter::Visible: {
+    // (nodes and edges are drawn in index order, so the mask texels are just the indices)
+    ElementMask& mask = onEdges ? edgeMask : nodeMask;
+    versionOut = mask.getVersion();
+    if (includeOut && mask.isActive() && mask.size() == nElements) {
+      includeOut->resize(nElements);
+      for (size_t i = 0; i < nElements; i++) {
+        (*includeOut)[i] = mask.get(i) != ElementMaskMode::Hide;
+      }
+    }
+    return true;
+  }
+  case ElementFilter::Selected:
+    // Nodes are selected directly, edges when both of their nodes are
+    versionOut = region_selection::getSelectionVersion();
+    if (includeOut) {
+      *includeOut = region_selection::getSelectionFlags(this, nNodes());
+      if (onEdges) {
+        std::vector<char> nodeSelected = std::move(*includeOut);
+        edgeTailInds.ensureHostBufferPopulated();
+        edgeTipInds.ensureHostBufferPopulated();
+        includeOut->resize(nEdges());
+        for (size_t iE = 0; iE < nEdges(); iE++) {
+          (*includeOut)[iE] = nodeSelected[edgeTailInds.data[iE]] && nodeSelected[edgeTipInds.data[iE]];
+        }
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+std::vector<size_t> CurveNetwork::selectNodesInScreenRegion(const ScreenRegion& region) {
+  const std::vector<glm::vec3>& positions = nodePositions.getPopulatedHostBufferRef();
+  std::vector<uint64_t> key{nodePositions.getDataVersion()};
+  if (!nodeRegionIndex.isCurrent(key)) {
+    nodeRegionIndex.build(positions, key);
+  }
+  return nodeRegionIndex.select(positions, region, view::getCameraPerspectiveMatrix() * getModelView());
+}
+
 void CurveNetwork::buildPickUI(size_t localPickID) {
 
   if (localPickID < nNodes()) {
@@ -405,6 +705,7 @@ void CurveNetwork::buildCustomUI() {
   if (ImGui::SliderFloat("Radius", radius.get().getValuePtr(), 0.0, .1, "%.5f",
                          ImGuiSliderFlags_Logarithmic | ImGuiSliderFlags_NoRoundToFormat)) {
     radius.manuallyChanged();
+    pick::markPickBufferStale();
     requestRedraw();
   }
   ImGui::PopItemWidth();
@@ -433,27 +734,14 @@ void CurveNetwork::buildCustomOptionsUI() {
     material.manuallyChanged();
     setMaterial(material.get()); // trigger the other updates that happen on set()
   }
+
+  if (ImGui::MenuItem("Depth Pre-pass", NULL, depthPrepass.get())) setDepthPrepass(!depthPrepass.get());
+  if (ImGui::MenuItem("Level of Detail", NULL, levelOfDetail.get())) setLevelOfDetail(!levelOfDetail.get());
 }
 
 void CurveNetwork::updateObjectSpaceBounds() {
-  nodePositions.ensureHostBufferPopulated();
-
-  // bounding box
-  glm::vec3 min = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
-  glm::vec3 max = -glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
-  for (const glm::vec3& p : nodePositions.data) {
-    min = componentwiseMin(min, p);
-    max = componentwiseMax(max, p);
-  }
-  objectSpaceBoundingBox = std::make_tuple(min, max);
-
-  // length scale, as twice the radius from the center of the bounding box
-  glm::vec3 center = 0.5f * (min + max);
-  float lengthScale = 0.0;
-  for (const glm::vec3& p : nodePositions.data) {
-    lengthScale = std::max(lengthScale, glm::length2(p - center));
-  }
-  objectSpaceLengthScale = 2 * std::sqrt(lengthScale);
+  computeBoundingBoxAndLengthScale(nodePositions.getPopulatedHostBufferRef(), objectSpaceBoundingBox,
+                                   objectSpaceLengthScale);
 }
 
 CurveNetwork* CurveNetwork::setColor(glm::vec3 newVal) {
@@ -483,6 +771,7 @@ void CurveNetwork::clearNodeRadiusQuantity() {
 
 CurveNetwork* CurveNetwork::setRadius(float newVal, bool isRelative) {
   radius = ScaledValue<float>(newVal, isRelative);
+  pick::markPickBufferStale();
   polyscope::requestRedraw();
   return this;
 }
@@ -496,6 +785,28 @@ CurveNetwork* CurveNetwork::setMaterial(std::string m) {
 }
 std::string CurveNetwork::getMaterial() { return material.get(); }
 
+CurveNetwork* CurveNetwork::setDepthPrepass(bool newVal) {
+  depthPrepass = newVal;
+  requestRedraw();
+  return this;
+}
+bool CurveNetwork::getDepthPrepass() { return depthPrepass.get(); }
+
+CurveNetwork* CurveNetwork::setLevelOfDetail(bool newVal) {
+  levelOfDetail = newVal;
+  requestRedraw();
+  return this;
+}
+bool CurveNetwork::getLevelOfDetail() { return levelOfDetail.get(); }
+
+bool CurveNetwork::usesLevelOfDetail() {
+  // (the element masks are looked up by draw order, which the level of detail changes)
+  return levelOfDetail.get() && nEdges() >= options::curveNetworkLODMinEdges && !nodeMask.isActive() &&
+         !edgeMask.isActive();
+}
+
+size_t CurveNetwork::getCurrentLODLevel() { return lodActive ? lodLevel : 0; }
+
 std::string CurveNetwork::typeName() { return structureTypeName; }
 
 // === Quantities
@@ -506,6 +817,7 @@ CurveNetworkQuantity::CurveNetworkQuantity(std::string name_, CurveNetwork& curv
 
 void CurveNetworkQuantity::buildNodeInfoGUI(size_t nodeInd) {}
 void CurveNetworkQuantity::buildEdgeInfoGUI(size_t edgeInd) {}
+void CurveNetworkQuantity::updateLODViews() {}
 
 // === Quantity adders
 
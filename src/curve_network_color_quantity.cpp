@@ -70,18 +70,20 @@ void CurveNetworkNodeColorQuantity::createProgram() {
   parent.fillNodeGeometryBuffers(*nodeProgram);
 
   { // Fill node color buffers
-    nodeProgram->setAttribute("a_color", colors.getRenderAttributeBuffer());
+    nodeProgram->setAttribute("a_color", parent.getNodeDrawAttributeBuffer(colors));
   }
 
   { // Fill edge color buffers
-    edgeProgram->setAttribute("a_color_tail", colors.getIndexedRenderAttributeBuffer(parent.edgeTailInds));
-    edgeProgram->setAttribute("a_color_tip", colors.getIndexedRenderAttributeBuffer(parent.edgeTipInds));
+    edgeProgram->setAttribute("a_color_tail", parent.getEdgeTailDrawAttributeBuffer(colors));
+    edgeProgram->setAttribute("a_color_tip", parent.getEdgeTipDrawAttributeBuffer(colors));
   }
 
   render::engine->setMaterial(*nodeProgram, parent.getMaterial());
   render::engine->setMaterial(*edgeProgram, parent.getMaterial());
 }
 
+void CurveNetworkNodeColorQuantity::updateLODViews() { parent.updateNodeDrawAttributeBuffers(colors); }
+
 
 void CurveNetworkNodeColorQuantity::buildNodeInfoGUI(size_t vInd) {
   ImGui::TextUnformatted(name.c_str());
@@ -142,17 +144,22 @@ void CurveNetworkEdgeColorQuantity::createProgram() {
   { // Fill node color buffers
     // Compute an average color at each node
     updateNodeAverageColors();
-    nodeProgram->setAttribute("a_color", nodeAverageColors.getRenderAttributeBuffer());
+    nodeProgram->setAttribute("a_color", parent.getNodeDrawAttributeBuffer(nodeAverageColors));
   }
 
   { // Fill edge color buffers
-    edgeProgram->setAttribute("a_color", colors.getRenderAttributeBuffer());
+    edgeProgram->setAttribute("a_color", parent.getEdgeDrawAttributeBuffer(colors));
   }
 
   render::engine->setMaterial(*nodeProgram, parent.getMaterial());
   render::engine->setMaterial(*edgeProgram, parent.getMaterial());
 }
 
+void CurveNetworkEdgeColorQuantity::updateLODViews() {
+  parent.updateNodeDrawAttributeBuffers(nodeAverageColors);
+  parent.updateEdgeDrawAttributeBuffers(colors);
+}
+
 void CurveNetworkEdgeColorQuantity::updateNodeAverageColors() {
   parent.edgeTailInds.ensureHostBufferPopulated();
   parent.edgeTipInds.ensureHostBufferPopulated();
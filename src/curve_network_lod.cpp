@@ -0,0 +1,275 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/curve_network_lod.h"
+
+#include "polyscope/messages.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <tuple>
+
+namespace polyscope {
+
+namespace {
+
+// Two edges which meet at less than about 10 degrees hide the sphere at their shared node
+const float hiddenNodeMinCos = 0.985f;
+
+// The first simplified level has a tolerance of this fraction of the mean edge length, and each level after it doubles
+// the tolerance. Levels stop once one would keep more than minEdgeReduction of the edges of the level before it.
+const float firstToleranceFactor = 0.05f;
+const size_t maxLevels = 16;
+const double minEdgeReduction = 0.9;
+
+float pointSegmentDistance(glm::vec3 p, glm::vec3 a, glm::vec3 b) {
+  glm::vec3 ab = b - a;
+  float len2 = glm::dot(ab, ab);
+  float t = len2 > 0. ? glm::clamp(glm::dot(p - a, ab) / len2, 0.f, 1.f) : 0.f;
+  return glm::length(p - (a + t * ab));
+}
+
+bool isStraightJoint(glm::vec3 prev, glm::vec3 p, glm::vec3 next) {
+  glm::vec3 dIn = p - prev;
+  glm::vec3 dOut = next - p;
+  float lenProduct = glm::length(dIn) * glm::length(dOut);
+  if (!(lenProduct > 0.)) return false;
+  return glm::dot(dIn, dOut) > hiddenNodeMinCos * lenProduct;
+}
+
+} // namespace
+
+void CurveNetworkLOD::build(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& edgeTailInds,
+                            const std::vector<uint32_t>& edgeTipInds, uint64_t key) {
+  if (edgeTailInds.size() != edgeTipInds.size()) {
+    exception("curve network LOD: got " + std::to_string(edgeTailInds.size()) + " edge tails but " +
+              std::to_string(edgeTipInds.size()) + " edge tips");
+  }
+
+  clear();
+  size_t nNodes = positions.size();
+  size_t nEdges = edgeTailInds.size();
+
+  // == Node-edge adjacency
+  std::vector<size_t> adjStart(nNodes + 1, 0);
+  for (size_t iE = 0; iE < nEdges; iE++) {
+    adjStart[edgeTailInds[iE] + 1]++;
+    adjStart[edgeTipInds[iE] + 1]++;
+  }
+  for (size_t iN = 0; iN < nNodes; iN++) adjStart[iN + 1] += adjStart[iN];
+  std::vector<uint32_t> adjEdges(adjStart[nNodes]);
+  {
+    std::vector<size_t> fill(adjStart.begin(), adjStart.end() - 1);
+    for (size_t iE = 0; iE < nEdges; iE++) {
+      adjEdges[fill[edgeTailInds[iE]]++] = iE;
+      adjEdges[fill[edgeTipInds[iE]]++] = iE;
+    }
+  }
+  auto degree = [&](uint32_t iN) { return adjStart[iN + 1] - adjStart[iN]; };
+
+  // == Split the network into chains
+  // Chain c is chainNodes[chainStart[c]] ... chainNodes[chainStart[c+1] - 1], and chainEdges[j] is the edge between
+  // chainNodes[j-1] and chainNodes[j] (unused for the first node of a chain).
+  std::vector<uint32_t> chainNodes;
+  std::vector<uint32_t> chainEdges;
+  std::vector<size_t> chainStart;
+  std::vector<char> edgeVisited(nEdges, false);
+  auto walkChain = [&](uint32_t startNode, uint32_t firstEdge) {
+    chainStart.push_back(chainNodes.size());
+    chainNodes.push_back(startNode);
+    chainEdges.push_back(firstEdge);
+    uint32_t node = startNode;
+    uint32_t edge = firstEdge;
+    while (true) {
+      edgeVisited[edge] = true;
+      uint32_t next = edgeTailInds[edge] == node ? edgeTipInds[edge] : edgeTailInds[edge];
+      chainNodes.push_back(next);
+      chainEdges.push_back(edge);
+      if (next == startNode || degree(next) != 2) break;
+
+      // continue along the other edge of the node
+      uint32_t e0 = adjEdges[adjStart[next]];
+      uint32_t e1 = adjEdges[adjStart[next] + 1];
+      uint32_t nextEdge = e0 == edge ? e1 : e0;
+      if (edgeVisited[nextEdge]) break;
+      node = next;
+      edge = nextEdge;
+    }
+  };
+  for (size_t iN = 0; iN < nNodes; iN++) {
+    if (degree(iN) == 2) continue;
+    for (size_t iA = adjStart[iN]; iA < adjStart[iN + 1]; iA++) {
+      if (!edgeVisited[adjEdges[iA]]) walkChain(iN, adjEdges[iA]);
+    }
+  }
+  for (size_t iE = 0; iE < nEdges; iE++) { // what is left are closed loops
+    if (!edgeVisited[iE]) walkChain(edgeTailInds[iE], iE);
+  }
+  size_t nChains = chainStart.size();
+  chainStart.push_back(chainNodes.size());
+
+  // == Node errors
+  const float inf = std::numeric_limits<float>::infinity();
+  nodeErrors = std::vector<float>(nNodes, inf);
+  std::vector<std::tuple<size_t, size_t, float>> spans; // (first node, last node, error cap)
+  for (size_t iC = 0; iC < nChains; iC++) {
+    spans.emplace_back(chainStart[iC], chainStart[iC + 1] - 1, inf);
+    while (!spans.empty()) {
+      size_t a, b;
+      float cap;
+      std::tie(a, b, cap) = spans.back();
+      spans.pop_back();
+      if (b - a < 2) continue;
+
+      glm::vec3 pA = positions[chainNodes[a]];
+      glm::vec3 pB = positions[chainNodes[b]];
+      size_t m = a + 1;
+      float maxDist = -1.;
+      for (size_t j = a + 1; j < b; j++) {
+        float d = pointSegmentDistance(positions[chainNodes[j]], pA, pB);
+        if (d > maxDist) {
+          maxDist = d;
+          m = j;
+        }
+      }
+      float err = std::min(maxDist, cap);
+      nodeErrors[chainNodes[m]] = err;
+      spans.emplace_back(a, m, err);
+      spans.emplace_back(m, b, err);
+    }
+  }
+
+  // == Levels
+  double meanEdgeLength = 0.;
+  for (size_t iE = 0; iE < nEdges; iE++) {
+    meanEdgeLength += glm::length(positions[edgeTipInds[iE]] - positions[edgeTailInds[iE]]);
+  }
+  if (nEdges > 0) meanEdgeLength /= nEdges;
+
+  // Fill the nodes and (for simplified levels) the edges of a level
+  std::vector<size_t> kept;
+  auto buildLevel = [&](Level& level, bool keepAll) {
+    std::vector<char> drawNode(nNodes, false);
+    for (size_t iN = 0; iN < nNodes; iN++) drawNode[iN] = degree(iN) != 2; // junctions, ends, and isolated nodes
+
+    for (size_t iC = 0; iC < nChains; iC++) {
+      size_t first = chainStart[iC];
+      size_t last = chainStart[iC + 1] - 1;
+      kept.clear();
+      for (size_t j = first; j <= last; j++) {
+        if (keepAll || j == first || j == last || nodeErrors[chainNodes[j]] > level.tolerance) kept.push_back(j);
+      }
+
+      if (!keepAll) {
+        for (size_t k = 1; k < kept.size(); k++) {
+          level.edgeTailInds.push_back(chainNodes[kept[k - 1]]);
+          level.edgeTipInds.push_back(chainNodes[kept[k]]);
+          level.edgeInds.push_back(chainEdges[kept[k - 1] + 1]);
+        }
+      }
+
+      // Sphere visibility of the degree-2 nodes in this chain
+      bool closed = chainNodes[first] == chainNodes[last];
+      for (size_t k = 0; k + 1 < kept.size(); k++) {
+        uint32_t node = chainNodes[kept[k]];
+        if (degree(node) != 2) continue;
+        size_t kPrev, kNext;
+        if (k > 0) {
+          kPrev = kept[k - 1];
+          kNext = kept[k + 1];
+        } else if (closed && kept.size() >= 3) {
+          kPrev = kept[kept.size() - 2];
+          kNext = kept[1];
+        } else {
+          drawNode[node] = true;
+          continue;
+        }
+        drawNode[node] =
+            !isStraightJoint(positions[chainNodes[kPrev]], positions[node], positions[chainNodes[kNext]]);
+      }
+    }
+
+    for (size_t iN = 0; iN < nNodes; iN++) {
+      if (drawNode[iN]) level.nodeInds.push_back(iN);
+    }
+  };
+
+  levels.emplace_back();
+  buildLevel(levels.back(), true);
+
+  size_t prevEdgeCount = nEdges;
+  float tolerance = firstToleranceFactor * meanEdgeLength;
+  while (tolerance > 0. && levels.size() < maxLevels && prevEdgeCount > nChains) {
+    Level level;
+    level.tolerance = tolerance;
+    buildLevel(level, false);
+    if (level.edgeTailInds.size() > minEdgeReduction * prevEdgeCount) break;
+    prevEdgeCount = level.edgeTailInds.size();
+    levels.push_back(std::move(level));
+    tolerance *= 2.;
+  }
+
+  currentKey = key;
+  haveKey = true;
+}
+
+CurveNetworkLOD::~CurveNetworkLOD() {
+  // (the future from std::async blocks on destruction anyway, this is just explicit about it)
+  if (pendingBuild.valid()) pendingBuild.wait();
+}
+
+void CurveNetworkLOD::buildAsync(std::vector<glm::vec3> positions, std::vector<uint32_t> edgeTailInds,
+                                 std::vector<uint32_t> edgeTipInds, uint64_t key) {
+  if (pendingBuild.valid()) pendingBuild.wait();
+  pendingBuild = std::async(
+      std::launch::async,
+      [](std::vector<glm::vec3> positions, std::vector<uint32_t> edgeTailInds, std::vector<uint32_t> edgeTipInds,
+         uint64_t key) {
+        std::shared_ptr<CurveNetworkLOD> result = std::make_shared<CurveNetworkLOD>();
+        result->build(positions, edgeTailInds, edgeTipInds, key);
+        return result;
+      },
+      std::move(positions), std::move(edgeTailInds), std::move(edgeTipInds), key);
+}
+
+bool CurveNetworkLOD::isReady(bool waitForBuild) {
+  // Pick up the result of the background build, if there is one
+  if (pendingBuild.valid() &&
+      (waitForBuild || pendingBuild.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+    std::shared_ptr<CurveNetworkLOD> result = pendingBuild.get();
+    levels = std::move(result->levels);
+    nodeErrors = std::move(result->nodeErrors);
+    currentKey = result->currentKey;
+    haveKey = result->haveKey;
+  }
+  return !levels.empty();
+}
+
+bool CurveNetworkLOD::isCurrent(uint64_t key) const { return haveKey && key == currentKey; }
+
+void CurveNetworkLOD::clear() {
+  if (pendingBuild.valid()) pendingBuild.wait();
+  pendingBuild = std::future<std::shared_ptr<CurveNetworkLOD>>();
+  levels.clear();
+  nodeErrors.clear();
+  currentKey = 0;
+  haveKey = false;
+}
+
+const CurveNetworkLOD::Level& CurveNetworkLOD::getLevel(size_t iLevel) const {
+  if (iLevel >= levels.size()) {
+    exception("curve network LOD level " + std::to_string(iLevel) + " is not available");
+  }
+  return levels[iLevel];
+}
+
+size_t CurveNetworkLOD::levelForError(float maxError) const {
+  size_t iLevel = 0;
+  while (iLevel + 1 < levels.size() && levels[iLevel + 1].tolerance <= maxError) {
+    iLevel++;
+  }
+  return iLevel;
+}
+
+} // namespace polyscope
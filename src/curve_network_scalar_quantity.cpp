@@ -103,12 +103,12 @@ void CurveNetworkNodeScalarQuantity::createProgram() {
   parent.fillEdgeGeometryBuffers(*edgeProgram);
 
   { // Fill node color buffers
-    nodeProgram->setAttribute("a_value", values.getRenderAttributeBuffer());
+    nodeProgram->setAttribute("a_value", parent.getNodeDrawAttributeBuffer(values));
   }
 
   { // Fill edge color buffers
-    edgeProgram->setAttribute("a_value_tail", values.getIndexedRenderAttributeBuffer(parent.edgeTailInds));
-    edgeProgram->setAttribute("a_value_tip", values.getIndexedRenderAttributeBuffer(parent.edgeTipInds));
+    edgeProgram->setAttribute("a_value_tail", parent.getEdgeTailDrawAttributeBuffer(values));
+    edgeProgram->setAttribute("a_value_tip", parent.getEdgeTipDrawAttributeBuffer(values));
   }
 
   edgeProgram->setTextureFromColormap("t_colormap", cMap.get());
@@ -117,6 +117,8 @@ void CurveNetworkNodeScalarQuantity::createProgram() {
   render::engine->setMaterial(*edgeProgram, parent.getMaterial());
 }
 
+void CurveNetworkNodeScalarQuantity::updateLODViews() { parent.updateNodeDrawAttributeBuffers(values); }
+
 
 void CurveNetworkNodeScalarQuantity::buildNodeInfoGUI(size_t nInd) {
   ImGui::TextUnformatted(name.c_str());
@@ -165,11 +167,11 @@ void CurveNetworkEdgeScalarQuantity::createProgram() {
 
   { // Fill node color buffers
     updateNodeAverageValues();
-    nodeProgram->setAttribute("a_value", nodeAverageValues.getRenderAttributeBuffer());
+    nodeProgram->setAttribute("a_value", parent.getNodeDrawAttributeBuffer(nodeAverageValues));
   }
 
   { // Fill edge color buffers
-    edgeProgram->setAttribute("a_value", values.getRenderAttributeBuffer());
+    edgeProgram->setAttribute("a_value", parent.getEdgeDrawAttributeBuffer(values));
   }
 
   edgeProgram->setTextureFromColormap("t_colormap", cMap.get());
@@ -178,6 +180,11 @@ void CurveNetworkEdgeScalarQuantity::createProgram() {
   render::engine->setMaterial(*edgeProgram, parent.getMaterial());
 }
 
+void CurveNetworkEdgeScalarQuantity::updateLODViews() {
+  parent.updateNodeDrawAttributeBuffers(nodeAverageValues);
+  parent.updateEdgeDrawAttributeBuffers(values);
+}
+
 void CurveNetworkEdgeScalarQuantity::updateNodeAverageValues() {
   parent.edgeTailInds.ensureHostBufferPopulated();
   parent.edgeTipInds.ensureHostBufferPopulated();
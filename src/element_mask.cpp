@@ -0,0 +1,138 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/element_mask.h"
+
+#include "polyscope/messages.h"
+
+#include <algorithm>
+
+namespace polyscope {
+
+namespace {
+
+// Changed texels closer than this on the same row are sent in one upload, rather than paying for a call per texel
+const size_t uploadMergeGap = 32;
+
+// If more than this fraction of the texels changed, just send them all
+const size_t fullUploadFraction = 16;
+
+} // namespace
+
+void ElementMask::resize(size_t newSize) {
+  modes.assign(newSize, static_cast<uint8_t>(ElementMaskMode::None));
+  changedTexels.clear();
+  fullUploadNeeded = true;
+  version++;
+}
+
+void ElementMask::set(size_t texel, ElementMaskMode mode) {
+  if (texel >= modes.size()) {
+    exception("element mask index " + std::to_string(texel) + " out of bounds for size " +
+              std::to_string(modes.size()));
+  }
+
+  uint8_t val = static_cast<uint8_t>(mode);
+  if (mode != ElementMaskMode::None) active = true;
+  if (modes[texel] == val) return;
+  modes[texel] = val;
+  version++;
+  if (!fullUploadNeeded) changedTexels.push_back(texel);
+}
+
+void ElementMask::setRange(size_t texelStart, size_t count, ElementMaskMode mode) {
+  for (size_t i = texelStart; i < texelStart + count; i++) {
+    set(i, mode);
+  }
+}
+
+ElementMaskMode ElementMask::get(size_t texel) const {
+  if (texel >= modes.size()) {
+    exception("element mask index " + std::to_string(texel) + " out of bounds for size " +
+              std::to_string(modes.size()));
+  }
+  return static_cast<ElementMaskMode>(modes[texel]);
+}
+
+void ElementMask::clear() {
+  std::fill(modes.begin(), modes.end(), static_cast<uint8_t>(ElementMaskMode::None));
+  changedTexels.clear();
+  fullUploadNeeded = true;
+  active = false;
+  version++;
+}
+
+void ElementMask::ensureTextureAllocated() {
+  unsigned int width = std::max<size_t>(1, std::min<size_t>(modes.size(), textureWidth));
+  unsigned int height = std::max<size_t>(1, (modes.size() + textureWidth - 1) / textureWidth);
+
+  if (!texture) {
+    texture = render::engine->generateTextureBuffer(TextureFormat::R8, width, height);
+    fullUploadNeeded = true;
+  } else if (texture->getSizeX() != width || texture->getSizeY() != height) {
+    // (resize in place, so programs which already have the texture bound keep it)
+    texture->resize(width, height);
+    fullUploadNeeded = true;
+  }
+}
+
+void ElementMask::uploadAll() {
+  size_t nFullRows = modes.size() / textureWidth;
+  size_t nRemainder = modes.size() % textureWidth;
+  if (nFullRows > 0) {
+    texture->setDataRegion2D(0, 0, textureWidth, nFullRows, &modes.front());
+  }
+  if (nRemainder > 0) {
+    texture->setDataRegion2D(0, nFullRows, nRemainder, 1, &modes[nFullRows * textureWidth]);
+  }
+  lastUploadBytes = modes.size();
+}
+
+void ElementMask::update() {
+  if (!active && !fullUploadNeeded) return;
+  ensureTextureAllocated();
+  if (modes.empty()) return;
+
+  if (fullUploadNeeded || changedTexels.size() > modes.size() / fullUploadFraction) {
+    uploadAll();
+    changedTexels.clear();
+    fullUploadNeeded = false;
+    return;
+  }
+
+  if (changedTexels.empty()) return;
+
+  // Upload runs of nearby changed texels, one row at a time
+  std::sort(changedTexels.begin(), changedTexels.end());
+  size_t bytes = 0;
+  size_t iC = 0;
+  while (iC < changedTexels.size()) {
+    size_t runStart = changedTexels[iC];
+    size_t runEnd = runStart + 1;
+    size_t row = runStart / textureWidth;
+    size_t rowEnd = (row + 1) * textureWidth;
+    iC++;
+    while (iC < changedTexels.size() && changedTexels[iC] < rowEnd && changedTexels[iC] <= runEnd + uploadMergeGap) {
+      runEnd = std::max<size_t>(runEnd, changedTexels[iC] + 1);
+      iC++;
+    }
+
+    texture->setDataRegion2D(runStart % textureWidth, row, runEnd - runStart, 1, &modes[runStart]);
+    bytes += runEnd - runStart;
+  }
+
+  changedTexels.clear();
+  lastUploadBytes = bytes;
+}
+
+void ElementMask::setTextures(render::ShaderProgram& p) {
+  if (!p.hasTexture("t_elementMask")) return;
+  update();
+  p.setTextureFromBuffer("t_elementMask", texture.get());
+}
+
+void ElementMask::setUniforms(render::ShaderProgram& p) {
+  if (!p.hasUniform("u_elementMaskColor")) return;
+  p.setUniform("u_elementMaskColor", color);
+}
+
+} // namespace polyscope
@@ -0,0 +1,249 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/frame_pacer.h"
+
+#include "polyscope/options.h"
+#include "polyscope/render/engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace polyscope {
+namespace frame_pacer {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Number of frames the statistics are computed over
+const size_t statsWindow = 120;
+
+// Bounds on how long before a deadline the pacer stops sleeping and starts spinning
+const double minSpinSeconds = 0.0002;
+const double maxSpinSeconds = 0.004;
+
+// Idle callbacks are not called with less time than this
+const double minIdleSeconds = 0.0005;
+
+// A buffer swap which takes longer than this on average is assumed to be waiting for vsync
+const double swapBlockingSeconds = 0.0005;
+
+struct FrameSample {
+  double frame;
+  double work;
+  double swap;
+  double idleWork;
+  double sleep;
+};
+std::vector<FrameSample> samples; // ring buffer of the most recent frames
+size_t lastSample = 0;
+
+// Timestamps of the current frame
+bool haveFrameStart = false;
+Clock::time_point frameStart;
+Clock::time_point swapStart;
+Clock::time_point swapEnd;
+
+// Timings of the last completed frame, and of the wait before the current one, to be recorded at the next beginFrame()
+double lastWorkSeconds = 0.;
+double lastSwapSeconds = 0.;
+double pendingIdleWorkSeconds = 0.;
+double pendingSleepSeconds = 0.;
+
+bool vsyncPaced = false;
+double spinSeconds = 0.001; // adapted to the sleep overshoot observed so far
+
+std::vector<std::pair<size_t, std::function<bool(double)>>> idleCallbacks;
+size_t nextIdleCallbackId = 1;
+
+double secondsBetween(Clock::time_point a, Clock::time_point b) {
+  return std::chrono::duration<double>(b - a).count();
+}
+
+Clock::duration toDuration(double seconds) {
+  return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+bool idleCallbackRegistered(size_t id) {
+  for (const std::pair<size_t, std::function<bool(double)>>& entry : idleCallbacks) {
+    if (entry.first == id) return true;
+  }
+  return false;
+}
+
+// Apply deferred uploads in the idle time rather than at the start of the next frame
+bool serviceDeferredUploads(double secondsAvailable) {
+  if (!options::deferDeviceUploads || render::engine == nullptr || render::engine->uploadScheduler.empty()) {
+    return false;
+  }
+  render::engine->uploadScheduler.service(options::maxUploadBytesPerFrame, 1000. * secondsAvailable);
+  return !render::engine->uploadScheduler.empty();
+}
+
+void runIdleWork(Clock::time_point deadline) {
+  bool moreWork = true;
+  while (moreWork) {
+    moreWork = false;
+
+    double available = secondsBetween(Clock::now(), deadline) - spinSeconds;
+    if (available < minIdleSeconds) return;
+    if (serviceDeferredUploads(available)) moreWork = true;
+
+    // (iterate over a copy, callbacks may add or remove callbacks)
+    std::vector<std::pair<size_t, std::function<bool(double)>>> callbacks = idleCallbacks;
+    for (std::pair<size_t, std::function<bool(double)>>& entry : callbacks) {
+      available = secondsBetween(Clock::now(), deadline) - spinSeconds;
+      if (available < minIdleSeconds) return;
+      if (!idleCallbackRegistered(entry.first)) continue;
+      if (entry.second(available)) moreWork = true;
+    }
+  }
+}
+
+void sleepUntil(Clock::time_point deadline) {
+
+  // Sleep for most of the remaining time...
+  double remaining = secondsBetween(Clock::now(), deadline);
+  if (remaining > spinSeconds) {
+    double requested = remaining - spinSeconds;
+    Clock::time_point sleepStart = Clock::now();
+    std::this_thread::sleep_for(toDuration(requested));
+    double overshoot = secondsBetween(sleepStart, Clock::now()) - requested;
+
+    // Spin for as long as recent sleeps have overshot, slowly forgetting old overshoots
+    spinSeconds = std::min(maxSpinSeconds, std::max(minSpinSeconds, std::max(overshoot, 0.98 * spinSeconds)));
+  }
+
+  // ...then spin for the rest
+  while (Clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+}
+
+} // namespace
+
+FrameStats getFrameStats() {
+  FrameStats stats;
+  stats.nFrames = samples.size();
+  stats.vsyncPaced = vsyncPaced;
+  if (samples.empty()) return stats;
+
+  stats.lastFrameSeconds = samples[lastSample].frame;
+  for (const FrameSample& s : samples) {
+    stats.averageFrameSeconds += s.frame;
+    stats.maxFrameSeconds = std::max(stats.maxFrameSeconds, s.frame);
+    stats.averageWorkSeconds += s.work;
+    stats.averageSwapSeconds += s.swap;
+    stats.averageIdleWorkSeconds += s.idleWork;
+    stats.averageSleepSeconds += s.sleep;
+  }
+  double n = static_cast<double>(samples.size());
+  stats.averageFrameSeconds /= n;
+  stats.averageWorkSeconds /= n;
+  stats.averageSwapSeconds /= n;
+  stats.averageIdleWorkSeconds /= n;
+  stats.averageSleepSeconds /= n;
+  return stats;
+}
+
+void resetFrameStats() {
+  samples.clear();
+  lastSample = 0;
+}
+
+size_t addIdleCallback(std::function<bool(double secondsAvailable)> callback) {
+  size_t id = nextIdleCallbackId++;
+  idleCallbacks.emplace_back(id, std::move(callback));
+  return id;
+}
+
+void removeIdleCallback(size_t id) {
+  idleCallbacks.erase(std::remove_if(idleCallbacks.begin(), idleCallbacks.end(),
+                                     [&](const std::pair<size_t, std::function<bool(double)>>& entry) {
+                                       return entry.first == id;
+                                     }),
+                      idleCallbacks.end());
+}
+
+size_t refreshesPerFrame(double maxFPS, double refreshRate) {
+  // Round up, so maxFPS is a cap, but not when the ratio is within rounding of a whole number (e.g. 60 on 120Hz)
+  double nRefreshes = std::ceil(refreshRate / maxFPS - 1e-3);
+  return static_cast<size_t>(std::max(1., nRefreshes));
+}
+
+void waitForNextFrame() {
+  if (options::maxFPS == -1 || !haveFrameStart) {
+    vsyncPaced = false;
+    return;
+  }
+
+  double targetSeconds = 1. / options::maxFPS;
+  double refreshRate = render::engine == nullptr ? 0. : render::engine->getDisplayRefreshRate();
+
+  // The swap is doing the pacing if vsync is on, the swap has been blocking, and frames have not been coming faster
+  // than the display refreshes
+  FrameStats stats = getFrameStats();
+  vsyncPaced = options::enableVSync && refreshRate > 0. && stats.nFrames > 0 &&
+               stats.averageSwapSeconds > swapBlockingSeconds && stats.averageFrameSeconds > 0.9 / refreshRate;
+
+  Clock::time_point deadline;
+  double expectedSwapWait = 0.;
+  if (vsyncPaced) {
+    // Show each frame for a whole number of refreshes, by waking up just after the vertical blank before the one the
+    // frame should be shown on. Usually this is the very next one, and there is no sleeping.
+    double refreshSeconds = 1. / refreshRate;
+    double nRefreshes = static_cast<double>(refreshesPerFrame(options::maxFPS, refreshRate));
+    deadline = swapEnd + toDuration((nRefreshes - 1.) * refreshSeconds);
+
+    // Some of the time the swap would spend waiting can go to idle work instead (but not all, so we don't miss the
+    // vertical blank)
+    expectedSwapWait = 0.5 * stats.averageSwapSeconds;
+  } else {
+    deadline = frameStart + toDuration(0.95 * targetSeconds); // give a little slack so we actually hit target fps
+  }
+
+  Clock::time_point idleStart = Clock::now();
+  runIdleWork(deadline + toDuration(expectedSwapWait));
+  Clock::time_point idleEnd = Clock::now();
+  sleepUntil(deadline);
+
+  pendingIdleWorkSeconds = secondsBetween(idleStart, idleEnd);
+  pendingSleepSeconds = secondsBetween(idleEnd, Clock::now());
+}
+
+void beginFrame() {
+  Clock::time_point now = Clock::now();
+
+  if (haveFrameStart) {
+    FrameSample sample{secondsBetween(frameStart, now), lastWorkSeconds, lastSwapSeconds, pendingIdleWorkSeconds,
+                       pendingSleepSeconds};
+    if (samples.size() < statsWindow) {
+      samples.push_back(sample);
+      lastSample = samples.size() - 1;
+    } else {
+      lastSample = (lastSample + 1) % statsWindow;
+      samples[lastSample] = sample;
+    }
+  }
+
+  haveFrameStart = true;
+  frameStart = now;
+  swapStart = now;
+  pendingIdleWorkSeconds = 0.;
+  pendingSleepSeconds = 0.;
+}
+
+void beginSwap() { swapStart = Clock::now(); }
+
+void endFrame() {
+  swapEnd = Clock::now();
+  lastWorkSeconds = secondsBetween(frameStart, swapStart);
+  lastSwapSeconds = secondsBetween(swapStart, swapEnd);
+}
+
+} // namespace frame_pacer
+} // namespace polyscope
@@ -4,6 +4,7 @@
 
 #include "polyscope/affine_remapper.h"
 #include "polyscope/polyscope.h"
+#include "polyscope/reductions.h"
 
 #include "imgui.h"
 
@@ -20,65 +21,77 @@ Histogram::Histogram(std::vector<float>& values) { buildHistogram(values); }
 Histogram::~Histogram() {}
 
 void Histogram::buildHistogram(const std::vector<float>& values) {
+  std::pair<float, float> finiteRange = computeFiniteRange(values);
+  std::pair<double, double> range = robustifyMinMax<double>(finiteRange.first, finiteRange.second);
+  buildHistogram(computeHistogramCounts(values, range.first, range.second, rawHistBinCount), range);
+}
 
-  // Build arrays of values
-  size_t N = values.size();
-
-  // == Build histogram
-  dataRange = robustMinMax(values);
+void Histogram::buildHistogram(const std::vector<double>& binCounts, std::pair<double, double> range) {
+  dataRange = range;
   colormapRange = dataRange;
+  buildCurve(binCounts);
+}
 
-  // Helper to build the four histogram variants
-  auto buildCurve = [&](size_t binCount, std::vector<std::array<float, 2>>& curveX, std::vector<float>& curveY) {
-    // linspace coords
-    double range = dataRange.second - dataRange.first;
-    double inc = range / binCount;
-    std::vector<double> sumBin(binCount, 0.0);
-
-    // count values in buckets
-    for (size_t iData = 0; iData < N; iData++) {
-
-      double iBinf = binCount * (values[iData] - dataRange.first) / range;
-      size_t iBin = std::floor(glm::clamp(iBinf, 0.0, (double)binCount - 1));
-
-      // NaN values and finite values near the bottom of float range lead to craziness, so only increment bins if we got
-      // something reasonable
-      if (iBin < binCount) {
-        sumBin[iBin] += 1.0;
+void Histogram::buildHistogram(render::ManagedBuffer<float>& values) {
+
+  // (only if the device has the current values, not while a deferred upload is waiting)
+  if (values.hasRenderAttributeBuffer() && !values.hasPendingDeferredUpload() &&
+      render::engine->computeTierAvailable()) {
+    render::AttributeBuffer& buffer = *values.getRenderAttributeBuffer();
+
+    float minVal, maxVal;
+    std::vector<uint32_t> counts;
+    if (render::engine->computeRange(buffer, minVal, maxVal)) {
+      std::pair<double, double> deviceRange = robustifyMinMax<double>(minVal, maxVal);
+      if (render::engine->computeHistogram(buffer, deviceRange.first, deviceRange.second, rawHistBinCount, counts)) {
+        dataRange = deviceRange;
+        colormapRange = dataRange;
+        buildCurve(std::vector<double>(counts.begin(), counts.end()));
+        return;
       }
     }
+  }
 
+  // fall back on the host
+  buildHistogram(values.getPopulatedHostBufferRef());
+}
 
-    // build histogram coords
-    curveX = std::vector<std::array<float, 2>>(binCount);
-    curveY = std::vector<float>(binCount);
-    double prevSumU = 0.0;
-    double prevSumW = 0.0;
-    double prevXEnd = dataRange.first;
-    for (size_t iBin = 0; iBin < binCount; iBin++) {
-      // y value
-      curveY[iBin] = sumBin[iBin];
-
-      // x value
-      double xEnd = prevXEnd + inc;
-      curveX[iBin] = {{static_cast<float>(prevXEnd), static_cast<float>(xEnd)}};
-      prevXEnd = xEnd;
-    }
+void Histogram::buildCurve(const std::vector<double>& binCounts) {
+
+  // linspace coords
+  size_t binCount = binCounts.size();
+  double range = dataRange.second - dataRange.first;
+  double inc = range / binCount;
+
+  // build histogram coords
+  rawHistCurveX = std::vector<std::array<float, 2>>(binCount);
+  rawHistCurveY = std::vector<float>(binCount);
+  double prevXEnd = dataRange.first;
+  for (size_t iBin = 0; iBin < binCount; iBin++) {
+    // y value
+    rawHistCurveY[iBin] = binCounts[iBin];
+
+    // x value
+    double xEnd = prevXEnd + inc;
+    rawHistCurveX[iBin] = {{static_cast<float>(prevXEnd), static_cast<float>(xEnd)}};
+    prevXEnd = xEnd;
+  }
 
-    { // Rescale curves to [0,1] in both dimensions
-      double maxHeight = *std::max_element(curveY.begin(), curveY.end());
-      for (size_t i = 0; i < binCount; i++) {
-        curveX[i][0] = (curveX[i][0] - dataRange.first) / range;
-        curveX[i][1] = (curveX[i][1] - dataRange.first) / range;
-        curveY[i] /= maxHeight;
-      }
+  { // Rescale curves to [0,1] in both dimensions
+    double maxHeight = *std::max_element(rawHistCurveY.begin(), rawHistCurveY.end());
+    for (size_t i = 0; i < binCount; i++) {
+      rawHistCurveX[i][0] = (rawHistCurveX[i][0] - dataRange.first) / range;
+      rawHistCurveX[i][1] = (rawHistCurveX[i][1] - dataRange.first) / range;
+      rawHistCurveY[i] /= maxHeight;
     }
-  };
+  }
 
-  buildCurve(rawHistBinCount, rawHistCurveX, rawHistCurveY);
+  // If we have already been drawn, the render buffers are now stale
+  if (program) {
+    fillBuffers();
+  }
 }
 
-
 void Histogram::updateColormap(const std::string& newColormap) {
   colormap = newColormap;
   if (program) {
@@ -0,0 +1,214 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/locality_order.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+namespace polyscope {
+
+namespace {
+
+// Spread the low 21 bits of x out to every third bit
+uint64_t spreadBits3(uint64_t x) {
+  x &= 0x1fffff;
+  x = (x | x << 32) & 0x1f00000000ffffULL;
+  x = (x | x << 16) & 0x1f0000ff0000ffULL;
+  x = (x | x << 8) & 0x100f00f00f00f00fULL;
+  x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+  x = (x | x << 2) & 0x1249249249249249ULL;
+  return x;
+}
+
+// Tipsify parameters: the modeled post-transform cache size, and the largest cluster used for overdraw sorting
+const int tipsifyCacheSize = 16;
+const size_t maxClusterSize = 512;
+
+} // namespace
+
+std::vector<uint32_t> computeMortonOrder(const std::vector<glm::vec3>& points) {
+
+  size_t N = points.size();
+  std::vector<uint32_t> order(N);
+  std::iota(order.begin(), order.end(), 0);
+  if (N < 2) return order;
+
+  glm::vec3 bboxMin = points[0];
+  glm::vec3 bboxMax = points[0];
+  for (const glm::vec3& p : points) {
+    bboxMin = glm::min(bboxMin, p);
+    bboxMax = glm::max(bboxMax, p);
+  }
+
+  // Quantize to a grid of 2^21 cells along each axis (uniform scale, so the curve does not stretch with the box)
+  glm::vec3 extent = bboxMax - bboxMin;
+  float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+  float scale = maxExtent > 0 ? static_cast<float>((1 << 21) - 1) / maxExtent : 0.f;
+
+  std::vector<std::pair<uint64_t, uint32_t>> codes(N);
+  for (size_t i = 0; i < N; i++) {
+    glm::vec3 q = (points[i] - bboxMin) * scale;
+    uint64_t code = 0;
+    for (int j = 0; j < 3; j++) {
+      // (written so that NaN coordinates land at 0)
+      float c = q[j] > 0.f ? std::min(q[j], static_cast<float>((1 << 21) - 1)) : 0.f;
+      code |= spreadBits3(static_cast<uint64_t>(c)) << j;
+    }
+    codes[i] = std::make_pair(code, static_cast<uint32_t>(i));
+  }
+
+  std::sort(codes.begin(), codes.end());
+  for (size_t i = 0; i < N; i++) order[i] = codes[i].second;
+  return order;
+}
+
+std::vector<uint32_t> computeTriangleDrawOrder(const std::vector<glm::vec3>& vertexPositions,
+                                               const std::vector<uint32_t>& triangleVertexInds) {
+
+  size_t nTri = triangleVertexInds.size() / 3;
+  size_t nVert = vertexPositions.size();
+
+  // == Vertex-triangle adjacency, in compressed rows
+  std::vector<uint32_t> adjStart(nVert + 1, 0);
+  for (uint32_t iV : triangleVertexInds) adjStart[iV + 1]++;
+  for (size_t iV = 0; iV < nVert; iV++) adjStart[iV + 1] += adjStart[iV];
+  std::vector<uint32_t> adjTris(adjStart.back());
+  {
+    std::vector<uint32_t> fill(adjStart.begin(), adjStart.end() - 1);
+    for (size_t iT = 0; iT < nTri; iT++) {
+      for (size_t j = 0; j < 3; j++) adjTris[fill[triangleVertexInds[3 * iT + j]]++] = iT;
+    }
+  }
+
+  // == Tipsify
+  // Repeatedly pick a fanning vertex and emit all of its remaining triangles. The next fanning vertex is one of the
+  // vertices just touched which will still be in the cache, preferring the one which entered the cache earliest;
+  // failing that, the most recently touched vertex with triangles left, and failing that the next such vertex by index.
+
+  std::vector<uint32_t> liveTriangles(nVert);
+  for (size_t iV = 0; iV < nVert; iV++) liveTriangles[iV] = adjStart[iV + 1] - adjStart[iV];
+  std::vector<int64_t> cacheTime(nVert, 0);
+  std::vector<char> emitted(nTri, false);
+  std::vector<uint32_t> deadEnd;
+  std::vector<uint32_t> candidates;
+
+  std::vector<uint32_t> tipsified;
+  tipsified.reserve(nTri);
+  std::vector<size_t> runStarts; // positions in `tipsified` where the walk jumped to an unrelated vertex
+
+  int64_t timestamp = tipsifyCacheSize + 1;
+  size_t cursor = 0;
+  int64_t fanVertex = nVert > 0 ? 0 : -1;
+  runStarts.push_back(0);
+
+  while (fanVertex >= 0) {
+    candidates.clear();
+    for (uint32_t iA = adjStart[fanVertex]; iA < adjStart[fanVertex + 1]; iA++) {
+      uint32_t iT = adjTris[iA];
+      if (emitted[iT]) continue;
+      emitted[iT] = true;
+      tipsified.push_back(iT);
+      for (size_t j = 0; j < 3; j++) {
+        uint32_t iV = triangleVertexInds[3 * iT + j];
+        deadEnd.push_back(iV);
+        candidates.push_back(iV);
+        liveTriangles[iV]--;
+        if (timestamp - cacheTime[iV] > tipsifyCacheSize) {
+          cacheTime[iV] = timestamp;
+          timestamp++;
+        }
+      }
+    }
+
+    // Next fanning vertex: a candidate which will still be in the cache after its triangles are emitted
+    fanVertex = -1;
+    int64_t bestPriority = -1;
+    for (uint32_t iV : candidates) {
+      if (liveTriangles[iV] == 0) continue;
+      int64_t priority = 0;
+      if (timestamp - cacheTime[iV] + 2 * static_cast<int64_t>(liveTriangles[iV]) <= tipsifyCacheSize) {
+        priority = timestamp - cacheTime[iV];
+      }
+      if (priority > bestPriority) {
+        bestPriority = priority;
+        fanVertex = iV;
+      }
+    }
+    if (fanVertex >= 0) continue;
+
+    // Dead end: back up through recently touched vertices
+    while (!deadEnd.empty() && fanVertex < 0) {
+      uint32_t iV = deadEnd.back();
+      deadEnd.pop_back();
+      if (liveTriangles[iV] > 0) fanVertex = iV;
+    }
+    if (fanVertex >= 0) continue;
+
+    // Nothing nearby left, jump to the next vertex with triangles
+    while (cursor < nVert && liveTriangles[cursor] == 0) cursor++;
+    if (cursor < nVert) {
+      fanVertex = cursor;
+      runStarts.push_back(tipsified.size());
+    }
+  }
+
+  // == Overdraw
+  // Split the walk in to clusters at its jumps (and at a maximum size), then sort the clusters so the ones facing most
+  // directly away from the mesh centroid come first.
+
+  std::vector<std::pair<size_t, size_t>> clusters; // [start, end) in tipsified
+  runStarts.push_back(tipsified.size());
+  for (size_t iR = 0; iR + 1 < runStarts.size(); iR++) {
+    for (size_t start = runStarts[iR]; start < runStarts[iR + 1]; start += maxClusterSize) {
+      clusters.emplace_back(start, std::min(start + maxClusterSize, runStarts[iR + 1]));
+    }
+  }
+
+  glm::vec3 meshCenter{0., 0., 0.};
+  float meshArea = 0.;
+  std::vector<glm::vec3> clusterCenters(clusters.size());
+  std::vector<glm::vec3> clusterNormals(clusters.size());
+  for (size_t iC = 0; iC < clusters.size(); iC++) {
+    glm::vec3 center{0., 0., 0.};
+    glm::vec3 normal{0., 0., 0.};
+    float area = 0.;
+    for (size_t i = clusters[iC].first; i < clusters[iC].second; i++) {
+      uint32_t iT = tipsified[i];
+      glm::vec3 pA = vertexPositions[triangleVertexInds[3 * iT + 0]];
+      glm::vec3 pB = vertexPositions[triangleVertexInds[3 * iT + 1]];
+      glm::vec3 pC = vertexPositions[triangleVertexInds[3 * iT + 2]];
+      glm::vec3 areaNormal = glm::cross(pB - pA, pC - pA); // length is twice the area
+      float triArea = glm::length(areaNormal);
+      center += triArea * (pA + pB + pC) / 3.f;
+      normal += areaNormal;
+      area += triArea;
+    }
+    meshCenter += center;
+    meshArea += area;
+    clusterCenters[iC] = area > 0 ? center / area : center;
+    clusterNormals[iC] = normal;
+  }
+  if (meshArea > 0) meshCenter /= meshArea;
+
+  std::vector<float> clusterKey(clusters.size());
+  for (size_t iC = 0; iC < clusters.size(); iC++) {
+    float normalLen = glm::length(clusterNormals[iC]);
+    float key = normalLen > 0 ? glm::dot(clusterCenters[iC] - meshCenter, clusterNormals[iC] / normalLen) : -1.f;
+    clusterKey[iC] = std::isfinite(key) ? key : -1.f; // (keeps the sort well-defined for degenerate geometry)
+  }
+  std::vector<size_t> clusterOrder(clusters.size());
+  std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+  std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+                   [&](size_t a, size_t b) { return clusterKey[a] > clusterKey[b]; });
+
+  std::vector<uint32_t> order;
+  order.reserve(nTri);
+  for (size_t iC : clusterOrder) {
+    order.insert(order.end(), tipsified.begin() + clusters[iC].first, tipsified.begin() + clusters[iC].second);
+  }
+  return order;
+}
+
+} // namespace polyscope
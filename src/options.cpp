@@ -12,6 +12,7 @@ std::string printPrefix = "[polyscope] ";
 bool errorsThrowExceptions = false;
 bool debugDrawPickBuffer = false;
 int maxFPS = 60;
+bool paceFrameTick = false;
 bool enableVSync = true;
 bool usePrefsFile = true;
 bool initializeWithDefaultStructures = true;
@@ -22,10 +23,31 @@ bool automaticallyComputeSceneExtents = true;
 bool invokeUserCallbackForNestedShow = false;
 bool giveFocusOnShow = false;
 bool hideWindowAfterShow = true;
+int maxWorkerThreads = -1;
+bool enableComputeTier = true;
+bool pickWithRayQueries = false;
+bool enableHoverHighlight = false;
+bool deferDeviceUploads = false;
+size_t maxUploadBytesPerFrame = 64 << 20;
+float maxUploadMillisecondsPerFrame = 4.;
+size_t virtualTextureThreshold = 8192;
+size_t virtualTextureCachePages = 256;
+size_t virtualTexturePageUploadsPerFrame = 16;
+bool reorderForLocality = false;
+bool impostorDepthPrepass = false;
+size_t volumeGridMipMinCells = 262144;
+float volumeGridInteractiveCellPixels = 4.;
+float volumeGridRefineDelay = 0.25;
+size_t curveNetworkLODMinEdges = 65536;
+float curveNetworkLODPixelError = 0.5;
+float curveNetworkLinePixelRadius = 0.5;
 
 bool screenshotTransparency = true;
 std::string screenshotExtension = ".png";
 
+int64_t remoteViewMaxBytesPerSecond = -1;
+int remoteViewMaxQuality = 90;
+
 // == Scene options
 
 // Ground plane / shadows
@@ -44,6 +66,9 @@ int ssaaFactor = 1;
 // Transparency
 TransparencyMode transparencyMode = TransparencyMode::None;
 int transparencyRenderPasses = 8;
+bool eyeDomeLighting = false;
+float eyeDomeLightingStrength = 1.;
+float eyeDomeLightingRadius = 1.5;
 
 // === Advanced ImGui configuration
 
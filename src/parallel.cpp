@@ -0,0 +1,55 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/parallel.h"
+
+#include "polyscope/options.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace polyscope {
+
+size_t workerThreadCount() {
+  if (options::maxWorkerThreads > 0) {
+    return static_cast<size_t>(options::maxWorkerThreads);
+  }
+
+  // hardware_concurrency() is allowed to return 0 if it can't tell
+  size_t hwCount = std::thread::hardware_concurrency();
+  return std::max(hwCount, static_cast<size_t>(1));
+}
+
+size_t parallelChunkCount(size_t N, size_t minChunkSize) {
+  minChunkSize = std::max(minChunkSize, static_cast<size_t>(1));
+  size_t maxChunks = std::max((N + minChunkSize - 1) / minChunkSize, static_cast<size_t>(1));
+  return std::min(workerThreadCount(), maxChunks);
+}
+
+void parallelForChunks(size_t N, size_t minChunkSize, const std::function<void(size_t, size_t, size_t)>& func) {
+
+  size_t nChunks = parallelChunkCount(N, minChunkSize);
+
+  auto chunkStart = [&](size_t iChunk) -> size_t { return (N * iChunk) / nChunks; };
+
+  // Quick out for the common small-data case, run on this thread
+  if (nChunks == 1) {
+    func(0, N, 0);
+    return;
+  }
+
+  // Launch all but the first chunk on new threads, the calling thread does the first chunk itself
+  std::vector<std::thread> workers;
+  workers.reserve(nChunks - 1);
+  for (size_t iChunk = 1; iChunk < nChunks; iChunk++) {
+    workers.emplace_back(func, chunkStart(iChunk), chunkStart(iChunk + 1), iChunk);
+  }
+
+  func(chunkStart(0), chunkStart(1), 0);
+
+  for (std::thread& t : workers) {
+    t.join();
+  }
+}
+
+} // namespace polyscope
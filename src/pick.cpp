@@ -4,9 +4,11 @@
 
 #include "polyscope/polyscope.h"
 
+#include <algorithm>
 #include <limits>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace polyscope {
 namespace pick {
@@ -15,6 +17,29 @@ size_t currLocalPickInd = 0;
 Structure* currPickStructure = nullptr;
 bool haveSelectionVal = false;
 
+// The hovered element, if any
+Structure* hoverStructure = nullptr;
+size_t hoverLocalInd = 0;
+
+// The pick buffer is kept between frames for hover queries, this records what it was rendered for
+bool pickBufferStale = true;
+glm::mat4 pickBufferViewMat, pickBufferProjMat;
+int pickBufferWidth = -1, pickBufferHeight = -1;
+std::vector<float> pickBufferSceneState;
+uint64_t pickBufferGeneration = 0; // incremented each time it is rendered
+
+// Hover queries read a (2r+1)x(2r+1) window of pixels around the cursor
+const int hoverReadRadius = 3;
+
+// The window of pixels read for a hover query (clamped at the edges of the buffer), and the pick buffer it came from
+struct HoverQuery {
+  int xCenter = -1, yCenter = -1;
+  int xStart = 0, yStart = 0, xEnd = 0, yEnd = 0;
+  uint64_t pickBufferGeneration = 0;
+};
+HoverQuery lastHoverQuery;     // the hover is the result of this query, once its pixels have been read back
+bool hoverReadPending = false; // (the read is asynchronous)
+
 // The next pick index that a structure can use to identify its elements
 // (get it by calling request pickBufferRange())
 size_t nextPickBufferInd = 1; // 0 reserved for "none"
@@ -64,6 +89,9 @@ void resetSelectionIfStructure(Structure* s) {
   if (haveSelectionVal && currPickStructure == s) {
     resetSelection();
   }
+  if (hoverStructure == s) {
+    resetHover();
+  }
 }
 
 std::pair<Structure*, size_t> getSelection() {
@@ -119,6 +147,11 @@ size_t localIndexToGlobal(std::pair<Structure*, size_t> localPick) {
 }
 
 std::pair<Structure*, size_t> pickAtScreenCoords(glm::vec2 screenCoords) {
+  if (options::pickWithRayQueries) {
+    RayHit hit = queryRayAtScreenCoords(screenCoords);
+    return {hit.structure, hit.localIndex};
+  }
+
   int xInd, yInd;
   std::tie(xInd, yInd) = view::screenCoordsToBufferInds(screenCoords);
   return pickAtBufferCoords(xInd, yInd);
@@ -126,15 +159,30 @@ std::pair<Structure*, size_t> pickAtScreenCoords(glm::vec2 screenCoords) {
 
 std::pair<Structure*, size_t> pickAtBufferCoords(int xPos, int yPos) { return evaluatePickQuery(xPos, yPos); }
 
-std::pair<Structure*, size_t> evaluatePickQuery(int xPos, int yPos) {
+namespace {
 
-  // NOTE: hack used for debugging: if xPos == yPos == -1 we do a pick render but do not query the value.
-
-  // Be sure not to pick outside of buffer
-  if (xPos < -1 || xPos >= view::bufferWidth || yPos < -1 || yPos >= view::bufferHeight) {
-    return {nullptr, 0};
+// The visibility and transforms of the structures and slice planes. These are compared against their values when the
+// pick buffer was rendered, rather than marking it stale when they change, since gizmos edit the transforms in place.
+std::vector<float> currentPickSceneState() {
+  std::vector<float> sceneState{state::lengthScale}; // (relative sizes are scaled by it)
+  for (auto& cat : state::structures) {
+    for (auto& x : cat.second) {
+      Structure* s = x.second.get();
+      sceneState.push_back(s->isEnabled() ? 1.f : 0.f);
+      glm::mat4 T = s->getTransform();
+      sceneState.insert(sceneState.end(), &T[0][0], &T[0][0] + 16);
+    }
+  }
+  for (std::unique_ptr<SlicePlane>& p : state::slicePlanes) {
+    sceneState.push_back(p->getActive() ? 1.f : 0.f);
+    glm::mat4 T = p->getTransform();
+    sceneState.insert(sceneState.end(), &T[0][0], &T[0][0] + 16);
   }
+  return sceneState;
+}
 
+// Render all structures in to the pick buffer, and remember the view it was rendered for
+bool renderPickBuffer() {
   render::FrameBuffer* pickFramebuffer = render::engine->pickFramebuffer.get();
 
   render::engine->setDepthMode(DepthMode::Less);
@@ -143,7 +191,7 @@ std::pair<Structure*, size_t> evaluatePickQuery(int xPos, int yPos) {
   pickFramebuffer->resize(view::bufferWidth, view::bufferHeight);
   pickFramebuffer->setViewport(0, 0, view::bufferWidth, view::bufferHeight);
   pickFramebuffer->clearColor = glm::vec3{0., 0., 0.};
-  if (!pickFramebuffer->bindForRendering()) return {nullptr, 0};
+  if (!pickFramebuffer->bindForRendering()) return false;
   pickFramebuffer->clear();
 
   // Render pick buffer
@@ -153,17 +201,210 @@ std::pair<Structure*, size_t> evaluatePickQuery(int xPos, int yPos) {
     }
   }
 
+  pickBufferStale = false;
+  pickBufferViewMat = view::getCameraViewMatrix();
+  pickBufferProjMat = view::getCameraPerspectiveMatrix();
+  pickBufferWidth = view::bufferWidth;
+  pickBufferHeight = view::bufferHeight;
+  pickBufferSceneState = currentPickSceneState();
+  pickBufferGeneration++;
+  return true;
+}
+
+// Re-render the pick buffer only if the scene or view has changed since it was last rendered
+bool ensurePickBufferCurrent() {
+  if (pickBufferIsCurrent()) return true;
+  return renderPickBuffer();
+}
+
+} // namespace
+
+bool pickBufferIsCurrent() {
+  return !pickBufferStale && pickBufferWidth == view::bufferWidth && pickBufferHeight == view::bufferHeight &&
+         pickBufferViewMat == view::getCameraViewMatrix() && pickBufferProjMat == view::getCameraPerspectiveMatrix() &&
+         pickBufferSceneState == currentPickSceneState();
+}
+
+std::pair<Structure*, size_t> evaluatePickQuery(int xPos, int yPos) {
+
+  // NOTE: hack used for debugging: if xPos == yPos == -1 we do a pick render but do not query the value.
+
+  // Be sure not to pick outside of buffer
+  if (xPos < -1 || xPos >= view::bufferWidth || yPos < -1 || yPos >= view::bufferHeight) {
+    return {nullptr, 0};
+  }
+
+  if (options::pickWithRayQueries && xPos != -1 && yPos != -1) {
+    // cast through the center of the buffer pixel
+    glm::vec2 screenCoords{(xPos + 0.5f) * view::windowWidth / static_cast<float>(view::bufferWidth),
+                           (yPos + 0.5f) * view::windowHeight / static_cast<float>(view::bufferHeight)};
+    RayHit hit = queryRayAtScreenCoords(screenCoords);
+    return {hit.structure, hit.localIndex};
+  }
+
+  if (!renderPickBuffer()) return {nullptr, 0};
+
   if (xPos == -1 || yPos == -1) {
     return {nullptr, 0};
   }
 
   // Read from the pick buffer
+  render::FrameBuffer* pickFramebuffer = render::engine->pickFramebuffer.get();
   std::array<float, 4> result = pickFramebuffer->readFloat4(xPos, view::bufferHeight - yPos);
   size_t globalInd = pick::vecToInd(glm::vec3{result[0], result[1], result[2]});
 
   return pick::globalIndexToLocal(globalInd);
 }
 
+// == Hover
+
+namespace {
+
+// Set the hover to the nearest element in the pixels read back for a query
+void resolveHover(const HoverQuery& q, const std::vector<float>& window) {
+  if (window.size() != static_cast<size_t>(4 * (q.xEnd - q.xStart) * (q.yEnd - q.yStart))) {
+    resetHover();
+    return;
+  }
+
+  // Take the nearest pixel which hit something
+  std::pair<Structure*, size_t> nearest{nullptr, 0};
+  int nearestDist2 = std::numeric_limits<int>::max();
+  for (int y = q.yStart; y < q.yEnd; y++) {
+    for (int x = q.xStart; x < q.xEnd; x++) {
+      int dist2 = (x - q.xCenter) * (x - q.xCenter) + (y - q.yCenter) * (y - q.yCenter);
+      if (dist2 >= nearestDist2) continue;
+
+      const float* px = &window[4 * ((y - q.yStart) * (q.xEnd - q.xStart) + (x - q.xStart))];
+      size_t globalInd = pick::vecToInd(glm::vec3{px[0], px[1], px[2]});
+      if (globalInd == 0) continue;
+      std::pair<Structure*, size_t> hit = pick::globalIndexToLocal(globalInd);
+      if (hit.first == nullptr) continue;
+
+      nearest = hit;
+      nearestDist2 = dist2;
+    }
+  }
+
+  hoverStructure = nearest.first;
+  hoverLocalInd = nearest.second;
+}
+
+// Take the pixels of the pending hover query if they have arrived, without waiting for them
+void collectHoverRead() {
+  if (!hoverReadPending) return;
+  std::vector<float> window;
+  if (!render::engine->pickFramebuffer->finishAsyncReadFloat4Region(window, false)) return;
+  hoverReadPending = false;
+
+  // (if the pick buffer has been re-rendered since, these pixels are out of date and a new query gets started)
+  if (lastHoverQuery.pickBufferGeneration == pickBufferGeneration) {
+    resolveHover(lastHoverQuery, window);
+  }
+}
+
+} // namespace
+
+void updateHover(glm::vec2 screenCoords) {
+
+  int xPos, yPos;
+  std::tie(xPos, yPos) = view::screenCoordsToBufferInds(screenCoords);
+  if (xPos < 0 || xPos >= view::bufferWidth || yPos < 0 || yPos >= view::bufferHeight) {
+    resetHover();
+    return;
+  }
+
+  if (!ensurePickBufferCurrent()) {
+    resetHover();
+    return;
+  }
+
+  collectHoverRead();
+
+  // Nothing to read if neither the cursor nor the pick buffer have changed
+  int xCenter = xPos;
+  int yCenter = view::bufferHeight - yPos;
+  if (xCenter == lastHoverQuery.xCenter && yCenter == lastHoverQuery.yCenter &&
+      pickBufferGeneration == lastHoverQuery.pickBufferGeneration) {
+    return;
+  }
+
+  // Start reading a small window around the cursor. This replaces any read which is still pending.
+  HoverQuery q;
+  q.xCenter = xCenter;
+  q.yCenter = yCenter;
+  q.xStart = std::max(xCenter - hoverReadRadius, 0);
+  q.yStart = std::max(yCenter - hoverReadRadius, 0);
+  q.xEnd = std::min(xCenter + hoverReadRadius + 1, view::bufferWidth);
+  q.yEnd = std::min(yCenter + hoverReadRadius + 1, view::bufferHeight);
+  q.pickBufferGeneration = pickBufferGeneration;
+  lastHoverQuery = q;
+  render::engine->pickFramebuffer->beginAsyncReadFloat4Region(q.xStart, q.yStart, q.xEnd - q.xStart,
+                                                              q.yEnd - q.yStart);
+  hoverReadPending = true;
+
+  collectHoverRead(); // (backends which read synchronously have the pixels right away)
+}
+
+std::pair<Structure*, size_t> getHover() {
+  if (hoverStructure != nullptr) {
+    return {hoverStructure, hoverLocalInd};
+  } else {
+    return {nullptr, 0};
+  }
+}
+
+bool haveHover() { return hoverStructure != nullptr; }
+
+void resetHover() {
+  hoverStructure = nullptr;
+  hoverLocalInd = 0;
+  lastHoverQuery = HoverQuery(); // (so the next update queries again)
+  hoverReadPending = false;
+}
+
+void drawHoverHighlight() {
+  if (!haveHover()) return;
+
+  // The highlight is drawn from the kept pick buffer, so skip it for a frame if the buffer no longer matches the scene
+  if (!pickBufferIsCurrent()) return;
+
+  render::engine->drawPickHighlight(indToVec(localIndexToGlobal(getHover())));
+}
+
+void markPickBufferStale() { pickBufferStale = true; }
+
+RayHit queryRay(glm::vec3 origin, glm::vec3 direction, bool waitForBuild) {
+  RayHit nearest;
+  for (auto& cat : state::structures) {
+    for (auto& x : cat.second) {
+      Structure* s = x.second.get();
+      if (!s->isEnabled()) continue;
+
+      RayHit hit;
+      if (s->queryRay(origin, direction, waitForBuild, hit) && hit.t < nearest.t) {
+        nearest = hit;
+      }
+    }
+  }
+  return nearest;
+}
+
+RayHit queryRayAtScreenCoords(glm::vec2 screenCoords, bool waitForBuild) {
+
+  // Unproject the pixel at the near and far planes, which gives the right ray for both perspective and orthographic
+  // projections
+  glm::mat4 viewMat = view::getCameraViewMatrix();
+  glm::mat4 projMat = view::getCameraPerspectiveMatrix();
+  glm::vec4 viewport = {0., 0., view::windowWidth, view::windowHeight};
+  glm::vec3 nearPos = glm::unProject(glm::vec3{screenCoords.x, view::windowHeight - screenCoords.y, 0.}, viewMat,
+                                     projMat, viewport);
+  glm::vec3 farPos = glm::unProject(glm::vec3{screenCoords.x, view::windowHeight - screenCoords.y, 1.}, viewMat,
+                                    projMat, viewport);
+
+  return queryRay(nearPos, farPos - nearPos, waitForBuild);
+}
+
 } // namespace pick
 
 
@@ -3,8 +3,11 @@
 #include "polyscope/point_cloud.h"
 
 #include "polyscope/file_helpers.h"
+#include "polyscope/locality_order.h"
 #include "polyscope/pick.h"
 #include "polyscope/polyscope.h"
+#include "polyscope/reductions.h"
+#include "polyscope/region_selection.h"
 #include "polyscope/render/engine.h"
 
 #include "polyscope/point_cloud_color_quantity.h"
@@ -15,6 +18,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <numeric>
 
 namespace polyscope {
 
@@ -26,14 +30,32 @@ PointCloud::PointCloud(std::string name, std::vector<glm::vec3> points_)
     : // clang-format off
     QuantityStructure<PointCloud>(name, structureTypeName), 
       points(this, uniquePrefix() + "points", pointsData),
+      drawOrder(this, uniquePrefix() + "drawOrder", drawOrderData),
       pointsData(std::move(points_)), 
       pointRenderMode(uniquePrefix() + "pointRenderMode", "sphere"),
       pointColor(uniquePrefix() + "pointColor", getNextUniqueColor()),
       pointRadius(uniquePrefix() + "pointRadius", relativeValue(0.005)),
-      material(uniquePrefix() + "material", "clay")
+      pointPixelSize(uniquePrefix() + "pointPixelSize", 1.),
+      material(uniquePrefix() + "material", "clay"),
+      depthPrepass(uniquePrefix() + "depthPrepass", false)
 // clang-format on
 {
   cullWholeElements.setPassive(true);
+  initializePoints();
+}
+
+PointCloud::PointCloud(std::string name, render::ManagedBuffer<glm::vec3>& sharedPoints)
+    : PointCloud(name, std::vector<glm::vec3>()) {
+  points.shareFrom(sharedPoints);
+  initializePoints();
+}
+
+void PointCloud::initializePoints() {
+  if (options::reorderForLocality) {
+    drawOrderData = computeMortonOrder(points.getPopulatedHostBufferRef());
+    drawOrder.markHostBufferUpdated();
+  }
+
   updateObjectSpaceBounds();
 }
 
@@ -47,7 +69,10 @@ void PointCloud::setPointCloudUniforms(render::ShaderProgram& p) {
     p.setUniform("u_viewport", render::engine->getCurrentViewport());
   }
 
-  if (pointRadiusQuantityName != "" && !pointRadiusQuantityAutoscale) {
+  if (getPointRenderMode() == PointRenderMode::Pixel) {
+    // (pixel points have no radius in the scene)
+    p.setUniform("u_pointPixelSize", pointPixelSize.get() * render::engine->getCurrentPixelScaling());
+  } else if (pointRadiusQuantityName != "" && !pointRadiusQuantityAutoscale) {
     // special case: ignore radius uniform
     p.setUniform("u_pointRadius", 1.);
   } else {
@@ -61,6 +86,8 @@ void PointCloud::setPointCloudUniforms(render::ShaderProgram& p) {
 
     p.setUniform("u_pointRadius", pointRadius.get().asAbsolute() / scalarQScale);
   }
+
+  pointMask.setUniforms(p);
 }
 
 void PointCloud::draw() {
@@ -72,11 +99,24 @@ void PointCloud::draw() {
   // (this warning is only printed once, and only if verbosity is high enough)
   if (nPoints() > 500000 && getPointRenderMode() == PointRenderMode::Sphere &&
       !internal::pointCloudEfficiencyWarningReported && options::verbosity > 1) {
-    info("To render large point clouds efficiently, set their render mode to 'quad' instead of 'sphere'. (disable "
-         "these warnings by setting Polyscope's verbosity < 2)");
+    info("To render large point clouds efficiently, set their render mode to 'quad' or 'pixel' instead of 'sphere'. "
+         "(disable these warnings by setting Polyscope's verbosity < 2)");
     internal::pointCloudEfficiencyWarningReported = true;
   }
 
+  pointMask.update();
+
+  // Lay down the depth of the spheres first, so that the shading below (by this class or the quantities) only runs for
+  // the front-most fragments
+  bool prepass = usesDepthPrepass();
+  if (prepass) {
+    ensureDepthProgramPrepared();
+    setStructureUniforms(*depthProgram);
+    setPointCloudUniforms(*depthProgram);
+    render::engine->beginDepthPrepass();
+    depthProgram->draw();
+    render::engine->beginDepthPrepassShading();
+  }
 
   // If there is no dominant quantity, then this class is responsible for drawing points
   if (dominantQuantity == nullptr) {
@@ -101,6 +141,10 @@ void PointCloud::draw() {
   for (auto& x : floatingQuantities) {
     x.second->draw();
   }
+
+  if (prepass) {
+    render::engine->endDepthPrepass();
+  }
 }
 
 void PointCloud::drawDelayed() {
@@ -121,12 +165,19 @@ void PointCloud::drawPick() {
     return;
   }
 
+  pointMask.update();
+
   // Ensure we have prepared buffers
   ensurePickProgramPrepared();
 
   // Set uniforms
   setStructureUniforms(*pickProgram);
   setPointCloudUniforms(*pickProgram);
+  if (getPointRenderMode() == PointRenderMode::Pixel) {
+    // draw pixel points a bit larger for picking, so single-pixel points can still be clicked
+    float pickPixelSize = std::max(pointPixelSize.get(), 3.f) * render::engine->getCurrentPixelScaling();
+    pickProgram->setUniform("u_pointPixelSize", pickPixelSize);
+  }
 
   pickProgram->draw();
 }
@@ -161,34 +212,53 @@ void PointCloud::ensurePickProgramPrepared() {
   // clang-format off
   pickProgram = render::engine->requestShader(
       getShaderNameForRenderMode(), 
-      addPointCloudRules({"SPHERE_PROPAGATE_COLOR"}, true),
+      addPointCloudRules({"SPHERE_PROPAGATE_COLOR"}, true, false),
       render::ShaderReplacementDefaults::Pick
   );
   // clang-format on
 
   setPointProgramGeometryAttributes(*pickProgram);
 
-  // Fill color buffer with packed point indices
+  // Fill color buffer with packed point indices (in draw order, like the other attributes)
+  if (drawOrder.size() > 0) drawOrder.ensureHostBufferPopulated();
   std::vector<glm::vec3> pickColors;
-  for (size_t i = pickStart; i < pickStart + pickCount; i++) {
-    glm::vec3 val = pick::indToVec(i);
-    pickColors.push_back(pick::indToVec(i));
+  for (size_t i = 0; i < pickCount; i++) {
+    size_t iPt = drawOrder.size() > 0 ? drawOrder.data[i] : i;
+    pickColors.push_back(pick::indToVec(pickStart + iPt));
   }
 
   // Store data in buffers
   pickProgram->setAttribute("a_color", pickColors);
 }
 
+void PointCloud::ensureDepthProgramPrepared() {
+  if (depthProgram) return;
+
+  // (no shading rules, the program only writes depth)
+  depthProgram = render::engine->requestShader("RAYCAST_SPHERE_DEPTH", addPointCloudRules({}, true, false));
+  setPointProgramGeometryAttributes(*depthProgram);
+}
+
+bool PointCloud::usesDepthPrepass() {
+  return (depthPrepass.get() || options::impostorDepthPrepass) && getPointRenderMode() == PointRenderMode::Sphere &&
+         transparencyQuantityName == "" && render::engine->depthPrepassAllowed();
+}
+
+bool PointCloud::usesPointRadiusAttribute() {
+  return pointRadiusQuantityName != "" && getPointRenderMode() != PointRenderMode::Pixel;
+}
+
 void PointCloud::setPointProgramGeometryAttributes(render::ShaderProgram& p) {
-  p.setAttribute("a_position", points.getRenderAttributeBuffer());
-  if (pointRadiusQuantityName != "") {
+  p.setAttribute("a_position", getPointRenderAttributeBuffer(points));
+  if (usesPointRadiusAttribute()) {
     PointCloudScalarQuantity& radQ = resolvePointRadiusQuantity();
-    p.setAttribute("a_pointRadius", radQ.values.getRenderAttributeBuffer());
+    p.setAttribute("a_pointRadius", getPointRenderAttributeBuffer(radQ.values));
   }
   if (transparencyQuantityName != "") {
     PointCloudScalarQuantity& transparencyQ = resolveTransparencyQuantity();
-    p.setAttribute("a_valueAlpha", transparencyQ.values.getRenderAttributeBuffer());
+    p.setAttribute("a_valueAlpha", getPointRenderAttributeBuffer(transparencyQ.values));
   }
+  pointMask.setTextures(p);
 }
 
 std::string PointCloud::getShaderNameForRenderMode() {
@@ -196,6 +266,8 @@ std::string PointCloud::getShaderNameForRenderMode() {
     return "RAYCAST_SPHERE";
   else if (getPointRenderMode() == PointRenderMode::Quad)
     return "POINT_QUAD";
+  else if (getPointRenderMode() == PointRenderMode::Pixel)
+    return "POINT_PIXEL";
   return "ERROR";
 }
 
@@ -204,25 +276,65 @@ size_t PointCloud::nPoints() { return points.size(); }
 glm::vec3 PointCloud::getPointPosition(size_t iPt) { return points.getValue(iPt); }
 
 
-std::vector<std::string> PointCloud::addPointCloudRules(std::vector<std::string> initRules, bool withPointCloud) {
+std::vector<std::string> PointCloud::addPointCloudRules(std::vector<std::string> initRules, bool withPointCloud,
+                                                       bool withShade) {
   initRules = addStructureRules(initRules);
   if (withPointCloud) {
-    if (pointRadiusQuantityName != "") {
+    if (usesPointRadiusAttribute()) {
       initRules.push_back("SPHERE_VARIABLE_SIZE");
     }
     if (wantsCullPosition()) {
       if (getPointRenderMode() == PointRenderMode::Sphere)
         initRules.push_back("SPHERE_CULLPOS_FROM_CENTER");
-      else if (getPointRenderMode() == PointRenderMode::Quad)
+      else
         initRules.push_back("SPHERE_CULLPOS_FROM_CENTER_QUAD");
     }
     if (transparencyQuantityName != "") {
       initRules.push_back("SPHERE_PROPAGATE_VALUEALPHA");
     }
+    if (pointMask.isActive()) {
+      initRules.push_back("ELEMENT_MASK_PROPAGATE_GEOM");
+      if (withShade) {
+        if (getPointRenderMode() == PointRenderMode::Sphere)
+          initRules.push_back("ELEMENT_MASK_SHADE_RAYCAST");
+        else
+          initRules.push_back("ELEMENT_MASK_SHADE_FLAT");
+      }
+    }
   }
   return initRules;
 }
 
+void PointCloud::setPointMask(const std::vector<size_t>& inds, ElementMaskMode mode) {
+  bool wasActive = pointMask.isActive();
+  if (pointMask.size() != nPoints()) pointMask.resize(nPoints());
+
+  if (drawOrder.size() > 0 && drawRank.size() != drawOrder.size()) {
+    drawOrder.ensureHostBufferPopulated();
+    drawRank.resize(drawOrder.size());
+    for (size_t i = 0; i < drawOrder.size(); i++) drawRank[drawOrder.data[i]] = i;
+  }
+
+  for (size_t iPt : inds) {
+    if (iPt >= nPoints()) {
+      exception("point mask index " + std::to_string(iPt) + " out of bounds for point cloud [" + name + "]");
+    }
+    pointMask.set(drawRank.empty() ? iPt : drawRank[iPt], mode);
+  }
+
+  if (pointMask.isActive() != wasActive) refresh(); // the mask rules are only added while it is active
+  requestRedraw();
+}
+
+void PointCloud::clearPointMask() {
+  bool wasActive = pointMask.isActive();
+  pointMask.clear();
+  if (wasActive) refresh();
+  requestRedraw();
+}
+
+ElementMask& PointCloud::getPointMask() { return pointMask; }
+
 // helper
 PointCloudScalarQuantity& PointCloud::resolvePointRadiusQuantity() {
   PointCloudScalarQuantity* sizeScalarQ = nullptr;
@@ -239,6 +351,67 @@ PointCloudScalarQuantity& PointCloud::resolvePointRadiusQuantity() {
   return *sizeScalarQ;
 }
 
+bool PointCloud::queryRay(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayHit& hitOut) {
+
+  // Rebuild the acceleration structure if the points or their size changed
+  // (per-point radii from a quantity are not accounted for)
+  const std::vector<glm::vec3>& positions = points.getPopulatedHostBufferRef();
+  float radius = getPointRadius();
+  std::vector<uint64_t> key{points.getDataVersion(), RayQueryAccel::keyFromFloat(radius)};
+  if (!rayQueryAccel.isCurrent(key)) {
+    RayQueryGeometry geom;
+    geom.positions = positions;
+    geom.spheres.resize(nPoints());
+    std::iota(geom.spheres.begin(), geom.spheres.end(), 0);
+    geom.radius = radius;
+    rayQueryAccel.setGeometry(std::move(geom), key);
+  }
+
+  RayQueryAccel::Hit primHit;
+  if (!queryRayAccel(rayOrigin, rayDir, waitForBuild, primHit, hitOut)) return false;
+  hitOut.localIndex = primHit.index;
+  return true;
+}
+
+bool PointCloud::selectInScreenRegion(const ScreenRegion& region, std::vector<size_t>& localIndsOut) {
+  localIndsOut = selectPointsInScreenRegion(region);
+  return true;
+}
+
+bool PointCloud::filterScalarQuantityElements(Quantity& q, ElementFilter filter, uint64_t& versionOut,
+                                              std::vector<char>* includeOut) {
+  // (all scalar quantities on point clouds are per-point)
+  if (includeOut) includeOut->clear();
+  switch (filter) {
+  case ElementFilter::All:
+    versionOut = 0;
+    return true;
+  case ElementFilter::Visible:
+    versionOut = pointMask.getVersion();
+    if (includeOut && pointMask.isActive() && pointMask.size() == nPoints()) {
+      includeOut->resize(nPoints());
+      for (size_t iPt = 0; iPt < nPoints(); iPt++) {
+        (*includeOut)[iPt] = pointMask.get(drawRank.empty() ? iPt : drawRank[iPt]) != ElementMaskMode::Hide;
+      }
+    }
+    return true;
+  case ElementFilter::Selected:
+    versionOut = region_selection::getSelectionVersion();
+    if (includeOut) *includeOut = region_selection::getSelectionFlags(this, nPoints());
+    return true;
+  }
+  return false;
+}
+
+std::vector<size_t> PointCloud::selectPointsInScreenRegion(const ScreenRegion& region) {
+  const std::vector<glm::vec3>& positions = points.getPopulatedHostBufferRef();
+  std::vector<uint64_t> key{points.getDataVersion()};
+  if (!pointRegionIndex.isCurrent(key)) {
+    pointRegionIndex.build(positions, key);
+  }
+  return pointRegionIndex.select(positions, region, view::getCameraPerspectiveMatrix() * getModelView());
+}
+
 void PointCloud::buildPickUI(size_t localPickID) {
   ImGui::TextUnformatted(("#" + std::to_string(localPickID) + "  ").c_str());
   ImGui::SameLine();
@@ -266,10 +439,19 @@ void PointCloud::buildCustomUI() {
   }
   ImGui::SameLine();
   ImGui::PushItemWidth(70);
-  if (ImGui::SliderFloat("Radius", pointRadius.get().getValuePtr(), 0.0, .1, "%.5f",
-                         ImGuiSliderFlags_Logarithmic | ImGuiSliderFlags_NoRoundToFormat)) {
-    pointRadius.manuallyChanged();
-    requestRedraw();
+  if (getPointRenderMode() == PointRenderMode::Pixel) {
+    if (ImGui::SliderFloat("Pixel size", &pointPixelSize.get(), 1., 16., "%.1f")) {
+      pointPixelSize.manuallyChanged();
+      pick::markPickBufferStale();
+      requestRedraw();
+    }
+  } else {
+    if (ImGui::SliderFloat("Radius", pointRadius.get().getValuePtr(), 0.0, .1, "%.5f",
+                           ImGuiSliderFlags_Logarithmic | ImGuiSliderFlags_NoRoundToFormat)) {
+      pointRadius.manuallyChanged();
+      pick::markPickBufferStale();
+      requestRedraw();
+    }
   }
   ImGui::PopItemWidth();
 }
@@ -282,7 +464,7 @@ void PointCloud::buildCustomOptionsUI() {
 
   if (ImGui::BeginMenu("Point Render Mode")) {
 
-    for (const PointRenderMode& m : {PointRenderMode::Sphere, PointRenderMode::Quad}) {
+    for (const PointRenderMode& m : {PointRenderMode::Sphere, PointRenderMode::Quad, PointRenderMode::Pixel}) {
       bool selected = (m == getPointRenderMode());
       std::string fancyName;
       switch (m) {
@@ -292,6 +474,9 @@ void PointCloud::buildCustomOptionsUI() {
       case PointRenderMode::Quad:
         fancyName = "quad (fast)";
         break;
+      case PointRenderMode::Pixel:
+        fancyName = "pixel (fastest)";
+        break;
       }
       if (ImGui::MenuItem(fancyName.c_str(), NULL, selected)) {
         setPointRenderMode(m);
@@ -301,6 +486,8 @@ void PointCloud::buildCustomOptionsUI() {
     ImGui::EndMenu();
   }
 
+  if (ImGui::MenuItem("Depth Pre-pass", NULL, depthPrepass.get())) setDepthPrepass(!depthPrepass.get());
+
   if (ImGui::BeginMenu("Variable Radius")) {
 
     if (ImGui::MenuItem("none", nullptr, pointRadiusQuantityName == "")) clearPointRadiusQuantity();
@@ -336,24 +523,7 @@ void PointCloud::buildCustomOptionsUI() {
 }
 
 void PointCloud::updateObjectSpaceBounds() {
-  points.ensureHostBufferPopulated();
-
-  // bounding box
-  glm::vec3 min = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
-  glm::vec3 max = -glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
-  for (const glm::vec3& p : points.data) {
-    min = componentwiseMin(min, p);
-    max = componentwiseMax(max, p);
-  }
-  objectSpaceBoundingBox = std::make_tuple(min, max);
-
-  // length scale, as twice the radius from the center of the bounding box
-  glm::vec3 center = 0.5f * (min + max);
-  float lengthScale = 0.0;
-  for (const glm::vec3& p : points.data) {
-    lengthScale = std::max(lengthScale, glm::length2(p - center));
-  }
-  objectSpaceLengthScale = 2 * std::sqrt(lengthScale);
+  computeBoundingBoxAndLengthScale(points.getPopulatedHostBufferRef(), objectSpaceBoundingBox, objectSpaceLengthScale);
 }
 
 
@@ -363,6 +533,7 @@ std::string PointCloud::typeName() { return structureTypeName; }
 void PointCloud::refresh() {
   program.reset();
   pickProgram.reset();
+  depthProgram.reset();
   QuantityStructure<PointCloud>::refresh(); // call base class version, which refreshes quantities
 }
 
@@ -485,6 +656,9 @@ PointCloud* PointCloud::setPointRenderMode(PointRenderMode newVal) {
   case PointRenderMode::Quad:
     pointRenderMode = "quad";
     break;
+  case PointRenderMode::Pixel:
+    pointRenderMode = "pixel";
+    break;
   }
   refresh();
   polyscope::requestRedraw();
@@ -496,9 +670,19 @@ PointRenderMode PointCloud::getPointRenderMode() {
     return PointRenderMode::Sphere;
   else if (pointRenderMode.get() == "quad")
     return PointRenderMode::Quad;
+  else if (pointRenderMode.get() == "pixel")
+    return PointRenderMode::Pixel;
   return PointRenderMode::Sphere; // should never happen
 }
 
+PointCloud* PointCloud::setPointPixelSize(float newVal) {
+  pointPixelSize = std::max(newVal, 1.f);
+  pick::markPickBufferStale();
+  polyscope::requestRedraw();
+  return this;
+}
+float PointCloud::getPointPixelSize() { return pointPixelSize.get(); }
+
 PointCloud* PointCloud::setPointColor(glm::vec3 newVal) {
   pointColor = newVal;
   polyscope::requestRedraw();
@@ -514,8 +698,16 @@ PointCloud* PointCloud::setMaterial(std::string m) {
 }
 std::string PointCloud::getMaterial() { return material.get(); }
 
+PointCloud* PointCloud::setDepthPrepass(bool newVal) {
+  depthPrepass = newVal;
+  requestRedraw();
+  return this;
+}
+bool PointCloud::getDepthPrepass() { return depthPrepass.get(); }
+
 PointCloud* PointCloud::setPointRadius(double newVal, bool isRelative) {
   pointRadius = ScaledValue<float>(newVal, isRelative);
+  pick::markPickBufferStale();
   polyscope::requestRedraw();
   return this;
 }
@@ -2,15 +2,16 @@
 
 #include "polyscope/polyscope.h"
 
-#include <chrono>
 #include <fstream>
 #include <iostream>
-#include <thread>
 
 #include "imgui.h"
 
+#include "polyscope/benchmark.h"
+#include "polyscope/frame_pacer.h"
 #include "polyscope/options.h"
 #include "polyscope/pick.h"
+#include "polyscope/region_selection.h"
 #include "polyscope/render/engine.h"
 #include "polyscope/view.h"
 
@@ -50,8 +51,6 @@ float lastWindowHeightUser = 200;
 float leftWindowsWidth = 305;
 float rightWindowsWidth = 500;
 
-auto lastMainLoopIterTime = std::chrono::steady_clock::now();
-
 const std::string prefsFilename = ".polyscope.ini";
 
 void readPrefsFile() {
@@ -210,17 +209,7 @@ void pushContext(std::function<void()> callbackFunction, bool drawDefaultUI) {
   while (contextStack.size() >= currentContextStackSize) {
 
     // The windowing system will let the main loop busy-loop on some platforms. Make sure that doesn't happen.
-    if (options::maxFPS != -1) {
-      auto currTime = std::chrono::steady_clock::now();
-      long microsecPerLoop = 1000000 / options::maxFPS;
-      microsecPerLoop = (95 * microsecPerLoop) / 100; // give a little slack so we actually hit target fps
-      while (std::chrono::duration_cast<std::chrono::microseconds>(currTime - lastMainLoopIterTime).count() <
-             microsecPerLoop) {
-        std::this_thread::yield();
-        currTime = std::chrono::steady_clock::now();
-      }
-    }
-    lastMainLoopIterTime = std::chrono::steady_clock::now();
+    frame_pacer::waitForNextFrame();
 
     mainLoopIteration();
 
@@ -271,6 +260,10 @@ void frameTick() {
   checkInitialized();
   render::engine->showWindow();
 
+  if (options::paceFrameTick) {
+    frame_pacer::waitForNextFrame();
+  }
+
   // All-imporant main loop iteration
   mainLoopIteration();
 
@@ -359,10 +352,15 @@ void processInputEvents() {
     }
 
     // === Mouse inputs
-    if (!io.WantCaptureMouse && !widgetCapturedMouse) {
+    // Region selection, if active, takes over plain left-drags. It sees releases even when the mouse is captured, so a
+    // drag which ends over the UI does not carry over to the next click.
+    bool mouseCaptured = io.WantCaptureMouse || widgetCapturedMouse;
+    bool leftUsedByRegion = region_selection::processInput(mouseCaptured);
+
+    if (!mouseCaptured) {
 
       // Process drags
-      bool dragLeft = ImGui::IsMouseDragging(0);
+      bool dragLeft = !leftUsedByRegion && ImGui::IsMouseDragging(0);
       bool dragRight = !dragLeft && ImGui::IsMouseDragging(1); // left takes priority, so only one can be true
       if (dragLeft || dragRight) {
 
@@ -396,7 +394,7 @@ void processInputEvents() {
       if (ImGui::IsMouseReleased(0)) {
 
         // Don't pick at the end of a long drag
-        if (dragDistSinceLastRelease < dragIgnoreThreshold) {
+        if (!leftUsedByRegion && dragDistSinceLastRelease < dragIgnoreThreshold) {
           ImVec2 p = ImGui::GetMousePos();
           std::pair<Structure*, size_t> pickResult = pick::pickAtScreenCoords(glm::vec2{p.x, p.y});
           pick::setSelection(pickResult);
@@ -415,6 +413,15 @@ void processInputEvents() {
     }
   }
 
+  // Hover, only while the mouse is over the scene and not dragging
+  if (options::enableHoverHighlight && state::doDefaultMouseInteraction && !io.WantCaptureMouse &&
+      !widgetCapturedMouse && !ImGui::IsAnyMouseDown()) {
+    ImVec2 p = ImGui::GetMousePos();
+    pick::updateHover(glm::vec2{p.x, p.y});
+  } else {
+    pick::resetHover();
+  }
+
   // === Key-press inputs
   if (!io.WantCaptureKeyboard) {
     view::processKeyboardNavigation(io);
@@ -621,6 +628,8 @@ void buildPolyscopeGui() {
 			ImGui::TextUnformatted("   Select elements of a structure with [left click]. Data from");
 			ImGui::TextUnformatted("     that element will be shown on the right. Use [right click]");
 			ImGui::TextUnformatted("     to clear the selection.");
+			ImGui::TextUnformatted("   With a region selection mode enabled, [left click drag] draws");
+			ImGui::TextUnformatted("     a box or lasso and selects the elements inside it.");
 		ImGui::End();
     // clang-format on
   }
@@ -631,6 +640,9 @@ void buildPolyscopeGui() {
   // Appearance options tree
   render::engine->buildEngineGui();
 
+  // Region selection tree
+  region_selection::buildRegionSelectionGui();
+
   // Render options tree
   ImGui::SetNextItemOpen(false, ImGuiCond_FirstUseEver);
   if (ImGui::TreeNode("Render")) {
@@ -650,6 +662,15 @@ void buildPolyscopeGui() {
     ImGui::SameLine();
     ImGui::Checkbox("vsync", &options::enableVSync);
 
+    frame_pacer::FrameStats frameStats = frame_pacer::getFrameStats();
+    ImGui::Text("Max: %.1f ms/frame", frameStats.maxFrameSeconds * 1000.);
+    ImGui::Text("Work %.1f ms, swap %.1f ms, idle %.1f ms, sleep %.1f ms", frameStats.averageWorkSeconds * 1000.,
+                frameStats.averageSwapSeconds * 1000., frameStats.averageIdleWorkSeconds * 1000.,
+                frameStats.averageSleepSeconds * 1000.);
+    if (frameStats.vsyncPaced) {
+      ImGui::TextUnformatted("(paced by vsync)");
+    }
+
     ImGui::TreePop();
   }
 
@@ -766,6 +787,18 @@ void buildPickGui() {
   }
 }
 
+void buildHoverGui() {
+  if (pick::haveHover()) {
+    std::pair<Structure*, size_t> hover = pick::getHover();
+
+    ImGui::BeginTooltip();
+    ImGui::TextUnformatted((hover.first->typeName() + ": " + hover.first->name).c_str());
+    ImGui::Separator();
+    hover.first->buildPickUI(hover.second);
+    ImGui::EndTooltip();
+  }
+}
+
 void buildUserGuiAndInvokeCallback() {
 
   if (!options::invokeUserCallbackForNestedShow && (contextStack.size() + frameTickStack) > 2) {
@@ -825,6 +858,7 @@ void draw(bool withUI, bool withContextCallback) {
           buildPolyscopeGui();
           buildStructureGui();
           buildPickGui();
+          buildHoverGui();
         }
 
         for (WeakHandle<Widget> wHandle : state::widgets) {
@@ -846,15 +880,28 @@ void draw(bool withUI, bool withContextCallback) {
 
   processLazyProperties();
 
+  // Apply uploads which were deferred by updated buffers
+  benchmark::beginPass("uploads");
+  render::engine->serviceDeferredUploads();
+  benchmark::endPass();
+
   // Draw structures in the scene
   if (redrawNextFrame || options::alwaysRedraw) {
+    benchmark::beginPass("scene");
     renderScene();
+    benchmark::endPass();
     redrawNextFrame = false;
   }
+  benchmark::beginPass("composite");
   renderSceneToScreen();
+  benchmark::endPass();
 
   // Draw the GUI
   if (withUI) {
+    // highlight the hovered element
+    render::engine->bindDisplay();
+    pick::drawHoverHighlight();
+
     // render widgets
     render::engine->bindDisplay();
     for (WeakHandle<Widget> wHandle : state::widgets) {
@@ -872,6 +919,8 @@ void draw(bool withUI, bool withContextCallback) {
 
 void mainLoopIteration() {
 
+  frame_pacer::beginFrame();
+
   processLazyProperties();
 
   render::engine->makeContextCurrent();
@@ -879,13 +928,17 @@ void mainLoopIteration() {
 
   // Process UI events
   render::engine->pollEvents();
+  remote::processInput();
 
   // Housekeeping
   purgeWidgets();
 
   // Rendering
   draw();
+  remote::sendFrame();
+  frame_pacer::beginSwap();
   render::engine->swapDisplayBuffers();
+  frame_pacer::endFrame();
 }
 
 void show(size_t forFrames) {
@@ -941,6 +994,7 @@ void shutdown() {
     writePrefsFile();
   }
 
+  remote::stop();
   render::engine->shutdownImGui();
 }
 
@@ -972,6 +1026,7 @@ bool registerStructure(Structure* s, bool replaceIfPresent) {
   // Add the new structure
   sMap[s->name] = std::unique_ptr<Structure>(s); // take ownership with a unique pointer
   updateStructureExtents();
+  pick::markPickBufferStale();
   requestRedraw();
 
   return true;
@@ -1054,6 +1109,8 @@ void removeStructure(std::string type, std::string name, bool errorIfAbsent) {
     g.second->removeChildStructure(*s);
   }
   pick::resetSelectionIfStructure(s);
+  pick::markPickBufferStale();
+  region_selection::resetSelectionIfStructure(s);
   sMap.erase(s->name);
   updateStructureExtents();
   return;
@@ -1115,6 +1172,7 @@ void removeAllStructures() {
 
   requestRedraw();
   pick::resetSelection();
+  region_selection::clearSelection();
 }
 
 
@@ -31,10 +31,16 @@ void Quantity::buildPickUI(size_t localPickInd) {}
 
 bool Quantity::isEnabled() { return enabled.get(); }
 
+render::ManagedBufferRegistry* Quantity::getUploadGroup() { return &parent; }
+
+bool Quantity::isUploadVisible() { return isEnabled() && parent.isEnabled(); }
+
 void Quantity::refresh() { requestRedraw(); }
 
 std::string Quantity::niceName() { return name; }
 
+render::ManagedBuffer<float>* Quantity::getScalarValues() { return nullptr; }
+
 std::string Quantity::uniquePrefix() { return parent.uniquePrefix() + name + "#"; }
 
 } // namespace polyscope
@@ -0,0 +1,216 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/ray_query.h"
+
+#include "polyscope/utilities.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace polyscope {
+
+namespace {
+
+const float floatInf = std::numeric_limits<float>::infinity();
+
+// Smallest positive root of a*t^2 + b*t + c, or infinity if there is none
+float smallestPositiveRoot(float a, float b, float c) {
+  if (!(a > 0.)) return floatInf;
+  float disc = b * b - 4.f * a * c;
+  if (disc < 0.) return floatInf;
+  float sqrtDisc = std::sqrt(disc);
+  float t0 = (-b - sqrtDisc) / (2.f * a);
+  float t1 = (-b + sqrtDisc) / (2.f * a);
+  if (t0 > 0.) return t0;
+  if (t1 > 0.) return t1;
+  return floatInf;
+}
+
+// Möller–Trumbore, hitting both sides
+float intersectTriangle(glm::vec3 o, glm::vec3 d, glm::vec3 pA, glm::vec3 pB, glm::vec3 pC, glm::vec3& baryOut) {
+  glm::vec3 e1 = pB - pA;
+  glm::vec3 e2 = pC - pA;
+  glm::vec3 p = glm::cross(d, e2);
+  float det = glm::dot(e1, p);
+  if (det == 0.) return floatInf;
+  float invDet = 1.f / det;
+
+  glm::vec3 s = o - pA;
+  float u = glm::dot(s, p) * invDet;
+  if (u < 0. || u > 1.) return floatInf;
+  glm::vec3 q = glm::cross(s, e1);
+  float v = glm::dot(d, q) * invDet;
+  if (v < 0. || u + v > 1.) return floatInf;
+
+  float t = glm::dot(e2, q) * invDet;
+  if (!(t > 0.)) return floatInf;
+  baryOut = glm::vec3{1.f - u - v, u, v};
+  return t;
+}
+
+float intersectSphere(glm::vec3 o, glm::vec3 d, glm::vec3 center, float radius) {
+  glm::vec3 w = o - center;
+  return smallestPositiveRoot(glm::dot(d, d), 2.f * glm::dot(d, w), glm::dot(w, w) - radius * radius);
+}
+
+// The body of the cylinder only, the caller is responsible for the end caps
+float intersectCylinder(glm::vec3 o, glm::vec3 d, glm::vec3 pA, glm::vec3 pB, float radius, float& sOut) {
+  glm::vec3 axis = pB - pA;
+  float axisLen2 = glm::dot(axis, axis);
+  if (!(axisLen2 > 0.)) return floatInf;
+
+  // Solve in the plane orthogonal to the axis
+  glm::vec3 w = o - pA;
+  glm::vec3 dPerp = d - (glm::dot(d, axis) / axisLen2) * axis;
+  glm::vec3 wPerp = w - (glm::dot(w, axis) / axisLen2) * axis;
+  float a = glm::dot(dPerp, dPerp);
+  float b = 2.f * glm::dot(dPerp, wPerp);
+  float c = glm::dot(wPerp, wPerp) - radius * radius;
+  float t = smallestPositiveRoot(a, b, c);
+  if (t == floatInf) return floatInf;
+
+  float s = glm::dot(w + t * d, axis) / axisLen2;
+  if (s < 0. || s > 1.) return floatInf;
+  sOut = s;
+  return t;
+}
+
+} // namespace
+
+RayQueryAccel::~RayQueryAccel() {
+  // (the futures from std::async block on destruction anyway, this is just explicit about it)
+  latestGeneration->fetch_add(1);
+  waitForAllBuilds();
+}
+
+uint64_t RayQueryAccel::keyFromFloat(float val) {
+  uint32_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  return bits;
+}
+
+bool RayQueryAccel::isCurrent(const std::vector<uint64_t>& key) const { return haveKey && key == currentKey; }
+
+void RayQueryAccel::setGeometry(RayQueryGeometry geometry, std::vector<uint64_t> key) {
+  // (builds which are still running are left to stop on their own, see collectBuilds())
+  collectBuilds(false);
+  uint64_t generation = latestGeneration->fetch_add(1) + 1;
+  built.reset();
+  currentKey = std::move(key);
+  haveKey = true;
+  std::shared_ptr<std::atomic<uint64_t>> latest = latestGeneration;
+  auto buildLatest = [latest, generation](RayQueryGeometry geometry) {
+    std::function<bool()> superseded = [&]() { return latest->load() != generation; };
+    std::shared_ptr<Built> result = build(std::move(geometry), superseded);
+    return superseded() ? nullptr : result;
+  };
+  pendingBuilds.emplace_back(generation, std::async(std::launch::async, buildLatest, std::move(geometry)));
+}
+
+void RayQueryAccel::clear() {
+  latestGeneration->fetch_add(1);
+  waitForAllBuilds();
+  built.reset();
+  currentKey.clear();
+  haveKey = false;
+}
+
+void RayQueryAccel::collectBuilds(bool waitForBuild) {
+  uint64_t latest = latestGeneration->load();
+  for (size_t i = 0; i < pendingBuilds.size();) {
+    PendingBuild& pending = pendingBuilds[i];
+    bool isLatest = pending.first == latest;
+    if ((waitForBuild && isLatest) || pending.second.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+      std::shared_ptr<Built> result = pending.second.get();
+      if (isLatest) built = result; // (results of older generations are dropped)
+      pendingBuilds.erase(pendingBuilds.begin() + i);
+    } else {
+      i++;
+    }
+  }
+}
+
+void RayQueryAccel::waitForAllBuilds() {
+  for (PendingBuild& pending : pendingBuilds) pending.second.wait();
+  pendingBuilds.clear();
+}
+
+std::shared_ptr<RayQueryAccel::Built> RayQueryAccel::build(RayQueryGeometry geometry, std::function<bool()> stop) {
+  std::shared_ptr<Built> result = std::make_shared<Built>();
+  result->geometry = std::move(geometry);
+  const RayQueryGeometry& g = result->geometry;
+  const std::vector<glm::vec3>& pos = g.positions;
+
+  size_t nPrims = g.triangles.size() + g.cylinders.size() + g.spheres.size();
+  std::vector<glm::vec3> primMin, primMax;
+  primMin.reserve(nPrims);
+  primMax.reserve(nPrims);
+
+  for (const std::array<uint32_t, 3>& tri : g.triangles) {
+    primMin.push_back(componentwiseMin(pos[tri[0]], componentwiseMin(pos[tri[1]], pos[tri[2]])));
+    primMax.push_back(componentwiseMax(pos[tri[0]], componentwiseMax(pos[tri[1]], pos[tri[2]])));
+  }
+  glm::vec3 rad{g.radius, g.radius, g.radius};
+  for (const std::array<uint32_t, 2>& cyl : g.cylinders) {
+    primMin.push_back(componentwiseMin(pos[cyl[0]], pos[cyl[1]]) - rad);
+    primMax.push_back(componentwiseMax(pos[cyl[0]], pos[cyl[1]]) + rad);
+  }
+  for (uint32_t iP : g.spheres) {
+    primMin.push_back(pos[iP] - rad);
+    primMax.push_back(pos[iP] + rad);
+  }
+
+  if (stop && stop()) return nullptr;
+  result->bvh.build(primMin, primMax);
+  return result;
+}
+
+bool RayQueryAccel::intersect(glm::vec3 origin, glm::vec3 dir, bool waitForBuild, Hit& hitOut) {
+
+  // Pick up the result of the background build, if there is one
+  collectBuilds(waitForBuild);
+  if (!built) return false;
+
+  const RayQueryGeometry& g = built->geometry;
+  const std::vector<glm::vec3>& pos = g.positions;
+  size_t nTri = g.triangles.size();
+  size_t nCyl = g.cylinders.size();
+
+  glm::vec3 bestBary{0., 0., 0.};
+  auto intersectPrimitive = [&](size_t iPrim, float tMax) -> float {
+    glm::vec3 bary{0., 0., 0.};
+    float t;
+    if (iPrim < nTri) {
+      const std::array<uint32_t, 3>& tri = g.triangles[iPrim];
+      t = intersectTriangle(origin, dir, pos[tri[0]], pos[tri[1]], pos[tri[2]], bary);
+    } else if (iPrim < nTri + nCyl) {
+      const std::array<uint32_t, 2>& cyl = g.cylinders[iPrim - nTri];
+      t = intersectCylinder(origin, dir, pos[cyl[0]], pos[cyl[1]], g.radius, bary.x);
+    } else {
+      t = intersectSphere(origin, dir, pos[g.spheres[iPrim - nTri - nCyl]], g.radius);
+    }
+    if (t < tMax) bestBary = bary;
+    return t;
+  };
+
+  float tHit = floatInf;
+  size_t iHit = built->bvh.intersectRay(origin, dir, tHit, intersectPrimitive);
+  if (iHit == BVH::INVALID_PRIM) return false;
+
+  if (iHit < nTri) {
+    hitOut.type = PrimitiveType::Triangle;
+    hitOut.index = iHit;
+  } else if (iHit < nTri + nCyl) {
+    hitOut.type = PrimitiveType::Cylinder;
+    hitOut.index = iHit - nTri;
+  } else {
+    hitOut.type = PrimitiveType::Sphere;
+    hitOut.index = iHit - nTri - nCyl;
+  }
+  hitOut.t = tHit;
+  hitOut.bary = bestBary;
+  return true;
+}
+
+} // namespace polyscope
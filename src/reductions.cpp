@@ -0,0 +1,306 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/reductions.h"
+
+#include "polyscope/parallel.h"
+#include "polyscope/utilities.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POLYSCOPE_REDUCTIONS_USE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace polyscope {
+
+// The SIMD kernels below read the vector arrays as flat arrays of floats
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be tightly packed");
+static_assert(sizeof(glm::vec2) == 2 * sizeof(float), "glm::vec2 must be tightly packed");
+
+namespace {
+
+// Don't bother spinning up threads for fewer entries than this
+const size_t reductionMinChunkSize = 1 << 18;
+
+const float floatInf = std::numeric_limits<float>::infinity();
+
+#ifdef POLYSCOPE_REDUCTIONS_USE_SSE
+// Given 12 consecutive floats holding 4 vec3s in a/b/c = [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3], transpose to
+// X = [x0 x1 x2 x3], Y = [y0 y1 y2 y3], Z = [z0 z1 z2 z3]
+inline void transposeVec3x4(__m128 a, __m128 b, __m128 c, __m128& X, __m128& Y, __m128& Z) {
+  __m128 t0 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)); // b2 b2 c1 c1
+  X = _mm_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));        // a0 a3 b2 c1
+
+  __m128 t1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)); // a1 a1 b0 b0
+  __m128 t2 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)); // b3 b3 c2 c2
+  Y = _mm_shuffle_ps(t1, t2, _MM_SHUFFLE(2, 0, 2, 0));       // a1 b0 b3 c2
+
+  __m128 t3 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)); // a2 a2 b1 b1
+  __m128 t4 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)); // c0 c0 c3 c3
+  Z = _mm_shuffle_ps(t3, t4, _MM_SHUFFLE(2, 0, 2, 0));       // a2 b1 c0 c3
+}
+
+inline float horizontalMax(__m128 v) {
+  float vals[4];
+  _mm_storeu_ps(vals, v);
+  return std::max(std::max(vals[0], vals[1]), std::max(vals[2], vals[3]));
+}
+#endif
+
+// NOTE: all of the kernels below are careful about argument order in min/max, so that NaN inputs are ignored.
+// std::min/max return the first argument when either is NaN, so the accumulator goes first; _mm_min/max_ps return the
+// second, so the accumulator goes second.
+
+void boundingBoxRange(const glm::vec3* points, size_t iStart, size_t iEnd, glm::vec3& minOut, glm::vec3& maxOut) {
+  glm::vec3 minV{floatInf, floatInf, floatInf};
+  glm::vec3 maxV{-floatInf, -floatInf, -floatInf};
+  size_t i = iStart;
+
+#ifdef POLYSCOPE_REDUCTIONS_USE_SSE
+  if (iEnd - iStart >= 4) {
+    const float* f = reinterpret_cast<const float*>(points);
+
+    // Three accumulators, one for each of the 4-float registers in a 12-float block. Lane j of the block always
+    // holds component (j % 3), so the lanes can be sorted out once at the end.
+    __m128 minA = _mm_set1_ps(floatInf);
+    __m128 minB = minA;
+    __m128 minC = minA;
+    __m128 maxA = _mm_set1_ps(-floatInf);
+    __m128 maxB = maxA;
+    __m128 maxC = maxA;
+    for (; i + 4 <= iEnd; i += 4) {
+      const float* block = f + 3 * i;
+      __m128 a = _mm_loadu_ps(block);
+      __m128 b = _mm_loadu_ps(block + 4);
+      __m128 c = _mm_loadu_ps(block + 8);
+      minA = _mm_min_ps(a, minA);
+      minB = _mm_min_ps(b, minB);
+      minC = _mm_min_ps(c, minC);
+      maxA = _mm_max_ps(a, maxA);
+      maxB = _mm_max_ps(b, maxB);
+      maxC = _mm_max_ps(c, maxC);
+    }
+
+    float lo[12], hi[12];
+    _mm_storeu_ps(lo, minA);
+    _mm_storeu_ps(lo + 4, minB);
+    _mm_storeu_ps(lo + 8, minC);
+    _mm_storeu_ps(hi, maxA);
+    _mm_storeu_ps(hi + 4, maxB);
+    _mm_storeu_ps(hi + 8, maxC);
+    for (int j = 0; j < 12; j++) {
+      minV[j % 3] = std::min(minV[j % 3], lo[j]);
+      maxV[j % 3] = std::max(maxV[j % 3], hi[j]);
+    }
+  }
+#endif
+
+  // Scalar loop for the remainder (or everything, without SIMD)
+  for (; i < iEnd; i++) {
+    minV = componentwiseMin(minV, points[i]);
+    maxV = componentwiseMax(maxV, points[i]);
+  }
+
+  minOut = minV;
+  maxOut = maxV;
+}
+
+float maxDistance2Range(const glm::vec3* points, size_t iStart, size_t iEnd, glm::vec3 center) {
+  float maxD2 = 0.;
+  size_t i = iStart;
+
+#ifdef POLYSCOPE_REDUCTIONS_USE_SSE
+  if (iEnd - iStart >= 4) {
+    const float* f = reinterpret_cast<const float*>(points);
+    __m128 cX = _mm_set1_ps(center.x);
+    __m128 cY = _mm_set1_ps(center.y);
+    __m128 cZ = _mm_set1_ps(center.z);
+    __m128 maxAcc = _mm_setzero_ps();
+    for (; i + 4 <= iEnd; i += 4) {
+      const float* block = f + 3 * i;
+      __m128 X, Y, Z;
+      transposeVec3x4(_mm_loadu_ps(block), _mm_loadu_ps(block + 4), _mm_loadu_ps(block + 8), X, Y, Z);
+      __m128 dX = _mm_sub_ps(X, cX);
+      __m128 dY = _mm_sub_ps(Y, cY);
+      __m128 dZ = _mm_sub_ps(Z, cZ);
+      __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dX, dX), _mm_mul_ps(dY, dY)), _mm_mul_ps(dZ, dZ));
+      maxAcc = _mm_max_ps(d2, maxAcc);
+    }
+    maxD2 = horizontalMax(maxAcc);
+  }
+#endif
+
+  for (; i < iEnd; i++) {
+    glm::vec3 d = points[i] - center;
+    maxD2 = std::max(maxD2, glm::dot(d, d));
+  }
+
+  return maxD2;
+}
+
+float maxNorm2Range(const glm::vec2* vectors, size_t iStart, size_t iEnd) {
+  float maxN2 = 0.;
+  size_t i = iStart;
+
+#ifdef POLYSCOPE_REDUCTIONS_USE_SSE
+  if (iEnd - iStart >= 4) {
+    const float* f = reinterpret_cast<const float*>(vectors);
+    __m128 maxAcc = _mm_setzero_ps();
+    for (; i + 4 <= iEnd; i += 4) {
+      const float* block = f + 2 * i;
+      __m128 a = _mm_loadu_ps(block);     // x0 y0 x1 y1
+      __m128 b = _mm_loadu_ps(block + 4); // x2 y2 x3 y3
+      __m128 X = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+      __m128 Y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+      __m128 n2 = _mm_add_ps(_mm_mul_ps(X, X), _mm_mul_ps(Y, Y));
+      maxAcc = _mm_max_ps(n2, maxAcc);
+    }
+    maxN2 = horizontalMax(maxAcc);
+  }
+#endif
+
+  for (; i < iEnd; i++) {
+    maxN2 = std::max(maxN2, glm::dot(vectors[i], vectors[i]));
+  }
+
+  return maxN2;
+}
+
+void finiteRangeRange(const float* values, size_t iStart, size_t iEnd, float& minOut, float& maxOut) {
+  float minV = floatInf;
+  float maxV = -floatInf;
+  size_t i = iStart;
+
+#ifdef POLYSCOPE_REDUCTIONS_USE_SSE
+  if (iEnd - iStart >= 4) {
+    // Lanes which are not finite (|x| < inf fails for inf and NaN) are replaced by the identity for each accumulator
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 posInf = _mm_set1_ps(floatInf);
+    const __m128 negInf = _mm_set1_ps(-floatInf);
+    __m128 minAcc = posInf;
+    __m128 maxAcc = negInf;
+    for (; i + 4 <= iEnd; i += 4) {
+      __m128 x = _mm_loadu_ps(values + i);
+      __m128 isFinite = _mm_cmplt_ps(_mm_and_ps(x, absMask), posInf);
+      minAcc = _mm_min_ps(_mm_or_ps(_mm_and_ps(isFinite, x), _mm_andnot_ps(isFinite, posInf)), minAcc);
+      maxAcc = _mm_max_ps(_mm_or_ps(_mm_and_ps(isFinite, x), _mm_andnot_ps(isFinite, negInf)), maxAcc);
+    }
+    float lo[4], hi[4];
+    _mm_storeu_ps(lo, minAcc);
+    _mm_storeu_ps(hi, maxAcc);
+    for (int j = 0; j < 4; j++) {
+      minV = std::min(minV, lo[j]);
+      maxV = std::max(maxV, hi[j]);
+    }
+  }
+#endif
+
+  for (; i < iEnd; i++) {
+    if (std::isfinite(values[i])) {
+      minV = std::min(minV, values[i]);
+      maxV = std::max(maxV, values[i]);
+    }
+  }
+
+  minOut = minV;
+  maxOut = maxV;
+}
+
+} // namespace
+
+std::tuple<glm::vec3, glm::vec3> computeBoundingBox(const std::vector<glm::vec3>& points) {
+  size_t nChunks = parallelChunkCount(points.size(), reductionMinChunkSize);
+  std::vector<glm::vec3> chunkMin(nChunks), chunkMax(nChunks);
+
+  parallelForChunks(points.size(), reductionMinChunkSize, [&](size_t iStart, size_t iEnd, size_t iChunk) {
+    boundingBoxRange(points.data(), iStart, iEnd, chunkMin[iChunk], chunkMax[iChunk]);
+  });
+
+  glm::vec3 minV{floatInf, floatInf, floatInf};
+  glm::vec3 maxV{-floatInf, -floatInf, -floatInf};
+  for (size_t iChunk = 0; iChunk < nChunks; iChunk++) {
+    minV = componentwiseMin(minV, chunkMin[iChunk]);
+    maxV = componentwiseMax(maxV, chunkMax[iChunk]);
+  }
+  return std::make_tuple(minV, maxV);
+}
+
+float computeMaxDistance(const std::vector<glm::vec3>& points, glm::vec3 center) {
+  size_t nChunks = parallelChunkCount(points.size(), reductionMinChunkSize);
+  std::vector<float> chunkMax(nChunks, 0.);
+
+  parallelForChunks(points.size(), reductionMinChunkSize, [&](size_t iStart, size_t iEnd, size_t iChunk) {
+    chunkMax[iChunk] = maxDistance2Range(points.data(), iStart, iEnd, center);
+  });
+
+  return std::sqrt(*std::max_element(chunkMax.begin(), chunkMax.end()));
+}
+
+float computeMaxNorm(const std::vector<glm::vec3>& vectors) {
+  return computeMaxDistance(vectors, glm::vec3{0., 0., 0.});
+}
+
+float computeMaxNorm(const std::vector<glm::vec2>& vectors) {
+  size_t nChunks = parallelChunkCount(vectors.size(), reductionMinChunkSize);
+  std::vector<float> chunkMax(nChunks, 0.);
+
+  parallelForChunks(vectors.size(), reductionMinChunkSize, [&](size_t iStart, size_t iEnd, size_t iChunk) {
+    chunkMax[iChunk] = maxNorm2Range(vectors.data(), iStart, iEnd);
+  });
+
+  return std::sqrt(*std::max_element(chunkMax.begin(), chunkMax.end()));
+}
+
+std::pair<float, float> computeFiniteRange(const std::vector<float>& values) {
+  size_t nChunks = parallelChunkCount(values.size(), reductionMinChunkSize);
+  std::vector<float> chunkMin(nChunks), chunkMax(nChunks);
+
+  parallelForChunks(values.size(), reductionMinChunkSize, [&](size_t iStart, size_t iEnd, size_t iChunk) {
+    finiteRangeRange(values.data(), iStart, iEnd, chunkMin[iChunk], chunkMax[iChunk]);
+  });
+
+  float minV = floatInf;
+  float maxV = -floatInf;
+  for (size_t iChunk = 0; iChunk < nChunks; iChunk++) {
+    minV = std::min(minV, chunkMin[iChunk]);
+    maxV = std::max(maxV, chunkMax[iChunk]);
+  }
+  return std::make_pair(minV, maxV);
+}
+
+std::vector<double> computeHistogramCounts(const std::vector<float>& values, double low, double high, size_t nBins) {
+  if (nBins == 0) return std::vector<double>();
+  size_t nChunks = parallelChunkCount(values.size(), reductionMinChunkSize);
+  std::vector<std::vector<size_t>> chunkCounts(nChunks, std::vector<size_t>(nBins, 0));
+
+  double binScale = nBins / (high - low);
+  double lastBin = static_cast<double>(nBins - 1);
+  parallelForChunks(values.size(), reductionMinChunkSize, [&](size_t iStart, size_t iEnd, size_t iChunk) {
+    std::vector<size_t>& counts = chunkCounts[iChunk];
+    for (size_t i = iStart; i < iEnd; i++) {
+      double iBinf = binScale * (values[i] - low);
+      if (!(iBinf == iBinf)) continue; // NaN
+      counts[static_cast<size_t>(std::min(std::max(iBinf, 0.), lastBin))]++;
+    }
+  });
+
+  std::vector<double> counts(nBins, 0.);
+  for (const std::vector<size_t>& c : chunkCounts) {
+    for (size_t iBin = 0; iBin < nBins; iBin++) counts[iBin] += c[iBin];
+  }
+  return counts;
+}
+
+void computeBoundingBoxAndLengthScale(const std::vector<glm::vec3>& points,
+                                      std::tuple<glm::vec3, glm::vec3>& boundingBox, float& lengthScale) {
+  boundingBox = computeBoundingBox(points);
+
+  // length scale, as twice the radius from the center of the bounding box
+  glm::vec3 center = 0.5f * (std::get<0>(boundingBox) + std::get<1>(boundingBox));
+  lengthScale = 2 * computeMaxDistance(points, center);
+}
+
+} // namespace polyscope
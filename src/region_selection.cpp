@@ -0,0 +1,196 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/region_selection.h"
+
+#include "polyscope/polyscope.h"
+
+#include "imgui.h"
+
+namespace polyscope {
+namespace region_selection {
+
+namespace {
+
+RegionSelectionMode currMode = RegionSelectionMode::Off;
+std::vector<std::pair<Structure*, std::vector<size_t>>> currSelection;
+uint64_t selectionVersion = 0;
+
+// State of the region being drawn
+bool dragging = false;
+glm::vec2 dragStart{0., 0.};
+glm::vec2 lastMousePos{0., 0.};
+std::vector<glm::vec2> lassoPoints;
+
+// Lasso points closer than this (in pixels) to the previous one are dropped, which keeps the polygon small for long
+// drags
+const float lassoMinSpacing = 3.;
+
+ScreenRegion currentRegion(glm::vec2 mousePos) {
+  if (currMode == RegionSelectionMode::Lasso) {
+    return ScreenRegion::lasso(lassoPoints);
+  }
+  return ScreenRegion::box(dragStart, mousePos);
+}
+
+void drawRegionOverlay(glm::vec2 mousePos) {
+  ImDrawList* drawList = ImGui::GetForegroundDrawList();
+  ImU32 lineColor = ImGui::GetColorU32(ImVec4(1.0, 0.8, 0.1, 1.0));
+
+  if (currMode == RegionSelectionMode::Lasso) {
+    for (size_t i = 0; i + 1 < lassoPoints.size(); i++) {
+      drawList->AddLine(ImVec2(lassoPoints[i].x, lassoPoints[i].y),
+                        ImVec2(lassoPoints[i + 1].x, lassoPoints[i + 1].y), lineColor);
+    }
+    if (lassoPoints.size() > 2) { // closing segment
+      drawList->AddLine(ImVec2(lassoPoints.back().x, lassoPoints.back().y),
+                        ImVec2(lassoPoints.front().x, lassoPoints.front().y), lineColor);
+    }
+  } else {
+    ImU32 fillColor = ImGui::GetColorU32(ImVec4(1.0, 0.8, 0.1, 0.15));
+    ImVec2 a(dragStart.x, dragStart.y);
+    ImVec2 b(mousePos.x, mousePos.y);
+    drawList->AddRectFilled(a, b, fillColor);
+    drawList->AddRect(a, b, lineColor);
+  }
+}
+
+} // namespace
+
+void setMode(RegionSelectionMode newMode) {
+  currMode = newMode;
+  dragging = false;
+  lassoPoints.clear();
+}
+
+RegionSelectionMode getMode() { return currMode; }
+
+std::vector<std::pair<Structure*, std::vector<size_t>>> selectInScreenRegion(const ScreenRegion& region) {
+  std::vector<std::pair<Structure*, std::vector<size_t>>> result;
+  for (auto& cat : state::structures) {
+    for (auto& x : cat.second) {
+      Structure* s = x.second.get();
+      if (!s->isEnabled()) continue;
+
+      std::vector<size_t> inds;
+      if (s->selectInScreenRegion(region, inds) && !inds.empty()) {
+        result.emplace_back(s, std::move(inds));
+      }
+    }
+  }
+  return result;
+}
+
+const std::vector<std::pair<Structure*, std::vector<size_t>>>& getSelection() { return currSelection; }
+
+void setSelection(std::vector<std::pair<Structure*, std::vector<size_t>>> newSelection) {
+  currSelection = std::move(newSelection);
+  selectionVersion++;
+}
+
+void clearSelection() {
+  currSelection.clear();
+  selectionVersion++;
+}
+
+uint64_t getSelectionVersion() { return selectionVersion; }
+
+std::vector<char> getSelectionFlags(Structure* s, size_t nIndices) {
+  std::vector<char> flags(nIndices, false);
+  for (const std::pair<Structure*, std::vector<size_t>>& entry : currSelection) {
+    if (entry.first != s) continue;
+    for (size_t ind : entry.second) {
+      if (ind < nIndices) flags[ind] = true;
+    }
+  }
+  return flags;
+}
+
+void resetSelectionIfStructure(Structure* s) {
+  for (size_t i = 0; i < currSelection.size(); i++) {
+    if (currSelection[i].first == s) {
+      currSelection.erase(currSelection.begin() + i);
+      selectionVersion++;
+      return;
+    }
+  }
+}
+
+bool processInput(bool mouseCaptured) {
+  if (currMode == RegionSelectionMode::Off) {
+    dragging = false;
+    return false;
+  }
+
+  if (mouseCaptured) {
+    if (ImGui::IsMouseReleased(0) || !ImGui::IsMouseDown(0)) {
+      dragging = false;
+      lassoPoints.clear();
+    }
+    return false;
+  }
+
+  ImGuiIO& io = ImGui::GetIO();
+  glm::vec2 mousePos{io.MousePos.x, io.MousePos.y};
+
+  if (!dragging) {
+    // Only plain left-drags draw regions, so the modifier versions still move the camera
+    if (!ImGui::IsMouseClicked(0) || io.KeyShift || io.KeyCtrl) return false;
+    dragging = true;
+    dragStart = mousePos;
+    lastMousePos = mousePos;
+    lassoPoints = {mousePos};
+    setSelection(selectInScreenRegion(currentRegion(mousePos)));
+  }
+
+  // Update the selection live, but only when the region actually changed
+  if (mousePos != lastMousePos) {
+    if (currMode == RegionSelectionMode::Lasso) {
+      glm::vec2 d = mousePos - lassoPoints.back();
+      if (d.x * d.x + d.y * d.y >= lassoMinSpacing * lassoMinSpacing) {
+        lassoPoints.push_back(mousePos);
+      }
+    }
+    setSelection(selectInScreenRegion(currentRegion(mousePos)));
+    lastMousePos = mousePos;
+  }
+
+  drawRegionOverlay(mousePos);
+
+  if (ImGui::IsMouseReleased(0) || !ImGui::IsMouseDown(0)) {
+    dragging = false;
+    lassoPoints.clear();
+  }
+  return true;
+}
+
+void buildRegionSelectionGui() {
+
+  ImGui::SetNextItemOpen(false, ImGuiCond_FirstUseEver);
+  if (ImGui::TreeNode("Region Selection")) {
+
+    int mode = static_cast<int>(currMode);
+    ImGui::RadioButton("Off", &mode, static_cast<int>(RegionSelectionMode::Off));
+    ImGui::SameLine();
+    ImGui::RadioButton("Box", &mode, static_cast<int>(RegionSelectionMode::Box));
+    ImGui::SameLine();
+    ImGui::RadioButton("Lasso", &mode, static_cast<int>(RegionSelectionMode::Lasso));
+    if (mode != static_cast<int>(currMode)) {
+      setMode(static_cast<RegionSelectionMode>(mode));
+    }
+
+    size_t nSelected = 0;
+    for (const std::pair<Structure*, std::vector<size_t>>& entry : currSelection) {
+      nSelected += entry.second.size();
+    }
+    ImGui::Text("%zu elements in %zu structures", nSelected, currSelection.size());
+    ImGui::SameLine();
+    if (ImGui::Button("Clear")) {
+      clearSelection();
+    }
+
+    ImGui::TreePop();
+  }
+}
+
+} // namespace region_selection
+} // namespace polyscope
@@ -0,0 +1,996 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/remote_view.h"
+
+#include "polyscope/messages.h"
+#include "polyscope/options.h"
+#include "polyscope/parallel.h"
+#include "polyscope/polyscope.h"
+#include "polyscope/view.h"
+
+#include "imgui.h"
+#include "stb_image_write.h"
+
+#include "nlohmann/json.hpp"
+using json = nlohmann::json;
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace polyscope {
+namespace remote {
+
+namespace {
+
+// The browser client, served at "/"
+const char* clientPage = R"(<!DOCTYPE html>
+<html>
+<head>
+<meta charset="utf-8">
+<title>Polyscope</title>
+<style>
+  html, body { margin: 0; height: 100%; overflow: hidden; background: #202020; }
+  canvas { display: block; width: 100%; height: 100%; outline: none; }
+</style>
+</head>
+<body>
+<canvas id="view" tabindex="0"></canvas>
+<script>
+const canvas = document.getElementById('view');
+const ctx = canvas.getContext('2d');
+const ws = new WebSocket('ws://' + location.host + '/ws');
+ws.binaryType = 'arraybuffer';
+
+function send(msg) {
+  if (ws.readyState === WebSocket.OPEN) ws.send(JSON.stringify(msg));
+}
+function sendSize() {
+  const r = window.devicePixelRatio || 1;
+  send({type: 'resize', w: Math.round(canvas.clientWidth * r), h: Math.round(canvas.clientHeight * r)});
+}
+ws.onopen = sendSize;
+window.addEventListener('resize', sendSize);
+
+// Tiles are decoded concurrently, but frames are drawn in the order they arrive
+let lastFrame = Promise.resolve();
+ws.onmessage = (e) => {
+  const d = new DataView(e.data);
+  const w = d.getUint16(0, true), h = d.getUint16(2, true), scale = d.getUint8(4), n = d.getUint16(6, true);
+  const tiles = [];
+  let o = 8;
+  for (let i = 0; i < n; i++) {
+    const t = {x: d.getUint16(o, true), y: d.getUint16(o + 2, true), w: d.getUint16(o + 4, true),
+               h: d.getUint16(o + 6, true)};
+    const len = d.getUint32(o + 8, true);
+    o += 12;
+    t.image = createImageBitmap(new Blob([new Uint8Array(e.data, o, len)], {type: 'image/jpeg'}));
+    tiles.push(t);
+    o += len;
+  }
+  lastFrame = lastFrame.then(() => Promise.all(tiles.map(t => t.image))).then((images) => {
+    if (canvas.width !== w || canvas.height !== h) {
+      canvas.width = w;
+      canvas.height = h;
+    }
+    images.forEach((image, i) => {
+      const t = tiles[i];
+      ctx.drawImage(image, t.x * scale, t.y * scale, t.w * scale, t.h * scale);
+      image.close();
+    });
+  });
+};
+
+function position(e) {
+  const r = canvas.getBoundingClientRect();
+  return {x: (e.clientX - r.left) / r.width, y: (e.clientY - r.top) / r.height};
+}
+canvas.addEventListener('mousemove', (e) => send(Object.assign({type: 'mousemove'}, position(e))));
+canvas.addEventListener('mousedown', (e) => {
+  canvas.focus();
+  send({type: 'mousebutton', button: e.button, down: true});
+});
+window.addEventListener('mouseup', (e) => send({type: 'mousebutton', button: e.button, down: false}));
+canvas.addEventListener('contextmenu', (e) => e.preventDefault());
+canvas.addEventListener('wheel', (e) => {
+  e.preventDefault();
+  send({type: 'wheel', dx: -Math.sign(e.deltaX), dy: -Math.sign(e.deltaY)});
+}, {passive: false});
+function key(e, down) {
+  e.preventDefault();
+  send({type: 'key', key: e.key, down: down, shift: e.shiftKey, ctrl: e.ctrlKey, alt: e.altKey, meta: e.metaKey});
+}
+canvas.addEventListener('keydown', (e) => key(e, true));
+canvas.addEventListener('keyup', (e) => key(e, false));
+</script>
+</body>
+</html>
+)";
+
+// == Image streaming parameters
+
+const int tileSize = 64;
+
+// Backlog of unsent data (per client) above which we start degrading quality, and above which we drop frames entirely
+const size_t targetBacklogBytes = 256 * 1024;
+const size_t maxBacklogBytes = 4 * targetBacklogBytes;
+
+// Frames without any backlog before stepping quality back up, or without any changes before sending a full-quality
+// refresh
+const int framesBeforeImproving = 10;
+const int idleFramesBeforeRefresh = 5;
+
+// Degradation levels, from best to worst
+struct StreamLevel {
+  int downscale;
+  int quality;
+};
+const std::vector<StreamLevel> streamLevels{{1, 90}, {1, 70}, {1, 50}, {2, 60}, {2, 40}, {4, 50}, {4, 30}};
+
+// == Helpers for the WebSocket handshake
+
+std::array<uint8_t, 20> sha1(const std::string& message) {
+
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  auto rotl = [](uint32_t x, int c) -> uint32_t { return (x << c) | (x >> (32 - c)); };
+
+  // pad to a multiple of 64 bytes, with the bit length at the end
+  std::string data = message;
+  uint64_t bitLen = static_cast<uint64_t>(message.size()) * 8;
+  data.push_back(static_cast<char>(0x80));
+  while (data.size() % 64 != 56) data.push_back(0);
+  for (int i = 7; i >= 0; i--) data.push_back(static_cast<char>((bitLen >> (8 * i)) & 0xFF));
+
+  for (size_t iChunk = 0; iChunk < data.size(); iChunk += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+      const unsigned char* p = reinterpret_cast<const unsigned char*>(&data[iChunk + 4 * i]);
+      w[i] = (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    }
+    for (int i = 16; i < 80; i++) w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5A827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6;
+      }
+      uint32_t temp = rotl(a, 5) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = rotl(b, 30);
+      b = a;
+      a = temp;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+
+  std::array<uint8_t, 20> digest;
+  for (int i = 0; i < 20; i++) digest[i] = (h[i / 4] >> (24 - 8 * (i % 4))) & 0xFF;
+  return digest;
+}
+
+std::string base64Encode(const uint8_t* bytes, size_t len) {
+  const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t v = uint32_t(bytes[i]) << 16;
+    if (i + 1 < len) v |= uint32_t(bytes[i + 1]) << 8;
+    if (i + 2 < len) v |= uint32_t(bytes[i + 2]);
+    out.push_back(alphabet[(v >> 18) & 63]);
+    out.push_back(alphabet[(v >> 12) & 63]);
+    out.push_back(i + 1 < len ? alphabet[(v >> 6) & 63] : '=');
+    out.push_back(i + 2 < len ? alphabet[v & 63] : '=');
+  }
+  return out;
+}
+
+std::string webSocketAcceptKey(const std::string& clientKey) {
+  std::array<uint8_t, 20> digest = sha1(clientKey + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11");
+  return base64Encode(digest.data(), digest.size());
+}
+
+// Wrap a payload in a (server-to-client, unmasked) WebSocket frame
+std::string webSocketFrame(uint8_t opcode, const std::string& payload) {
+  std::string frame;
+  frame.push_back(static_cast<char>(0x80 | opcode));
+  size_t len = payload.size();
+  if (len < 126) {
+    frame.push_back(static_cast<char>(len));
+  } else if (len < 65536) {
+    frame.push_back(static_cast<char>(126));
+    frame.push_back(static_cast<char>((len >> 8) & 0xFF));
+    frame.push_back(static_cast<char>(len & 0xFF));
+  } else {
+    frame.push_back(static_cast<char>(127));
+    for (int i = 7; i >= 0; i--) frame.push_back(static_cast<char>((static_cast<uint64_t>(len) >> (8 * i)) & 0xFF));
+  }
+  frame += payload;
+  return frame;
+}
+
+void appendU16(std::string& s, uint32_t v) {
+  s.push_back(static_cast<char>(v & 0xFF));
+  s.push_back(static_cast<char>((v >> 8) & 0xFF));
+}
+
+void appendU32(std::string& s, uint32_t v) {
+  appendU16(s, v & 0xFFFF);
+  appendU16(s, v >> 16);
+}
+
+#ifndef _WIN32
+
+// == The server
+//
+// All socket work happens on a background thread, which never calls in to the rest of Polyscope. The main thread
+// hands it encoded frames with broadcast(), and picks up input messages with takeInputMessages().
+
+class Server {
+
+public:
+  Server(int port, std::string bindAddress) {
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) exception("remote view: could not create socket");
+
+    int yes = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, bindAddress.c_str(), &addr.sin_addr) != 1) {
+      close(listenFd);
+      exception("remote view: invalid bind address " + bindAddress);
+    }
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listenFd, 8) != 0) {
+      close(listenFd);
+      exception("remote view: could not listen on port " + std::to_string(port));
+    }
+
+    socklen_t addrLen = sizeof(addr);
+    getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &addrLen);
+    boundPort = ntohs(addr.sin_port);
+
+    if (pipe(wakeFds) != 0) {
+      close(listenFd);
+      exception("remote view: could not create wakeup pipe");
+    }
+    setNonBlocking(listenFd);
+    setNonBlocking(wakeFds[0]);
+    setNonBlocking(wakeFds[1]);
+
+    thread = std::thread(&Server::run, this);
+  }
+
+  ~Server() {
+    stopRequested = true;
+    wake();
+    thread.join();
+
+    for (std::unique_ptr<Client>& c : clients) close(c->fd);
+    close(listenFd);
+    close(wakeFds[0]);
+    close(wakeFds[1]);
+  }
+
+  int getPort() const { return boundPort; }
+
+  size_t clientCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (std::unique_ptr<Client>& c : clients) {
+      if (c->isWebSocket && !c->closeAfterSend) count++;
+    }
+    return count;
+  }
+
+  // The largest amount of queued-but-unsent data for any client
+  size_t backlogBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t maxBacklog = 0;
+    for (std::unique_ptr<Client>& c : clients) {
+      if (c->isWebSocket) maxBacklog = std::max(maxBacklog, c->backlog);
+    }
+    return maxBacklog;
+  }
+
+  // True if some client needs a full frame, because it just connected or missed a frame
+  bool takeRefreshRequest() {
+    std::lock_guard<std::mutex> lock(mutex);
+    bool val = refreshRequested;
+    refreshRequested = false;
+    return val;
+  }
+
+  std::vector<std::string> takeInputMessages() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> out;
+    out.swap(inputMessages);
+    return out;
+  }
+
+  void setMaxBytesPerSecond(int64_t val) { maxBytesPerSecond = val; }
+
+  // Send a binary message to all connected clients
+  void broadcast(const std::string& payload) {
+    std::string frame = webSocketFrame(0x2, payload);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (std::unique_ptr<Client>& c : clients) {
+        if (!c->isWebSocket || c->closeAfterSend) continue;
+        if (c->backlog > maxBacklogBytes) {
+          // this client is too far behind, it gets a full frame once it catches up
+          refreshRequested = true;
+          continue;
+        }
+        c->outQueue.push_back(frame);
+        c->backlog += frame.size();
+      }
+    }
+    wake();
+  }
+
+private:
+  struct Client {
+    int fd;
+    std::string inBuffer;
+    std::deque<std::string> outQueue; // guarded by the mutex
+    size_t outOffset = 0;             // bytes of the front of the queue which have been sent already
+    size_t backlog = 0;
+    bool isWebSocket = false;
+    bool closeAfterSend = false;
+    bool failed = false;
+  };
+
+  int listenFd = -1;
+  int wakeFds[2] = {-1, -1};
+  int boundPort = -1;
+  std::thread thread;
+  std::atomic<bool> stopRequested{false};
+  std::atomic<int64_t> maxBytesPerSecond{-1};
+
+  std::mutex mutex; // guards the client list, their output queues, and the members below
+  std::vector<std::unique_ptr<Client>> clients;
+  std::vector<std::string> inputMessages;
+  bool refreshRequested = false;
+
+  static void setNonBlocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK); }
+
+  void wake() {
+    char c = 0;
+    ssize_t ret = write(wakeFds[1], &c, 1);
+    (void)ret; // if the pipe is full, the thread is waking up anyway
+  }
+
+  void run() {
+
+    // Token bucket for the outgoing bandwidth limit
+    double sendTokens = 0.;
+    auto lastRefill = std::chrono::steady_clock::now();
+
+    while (!stopRequested) {
+
+      int64_t rate = maxBytesPerSecond;
+      bool limited = rate > 0;
+      if (limited) {
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+        lastRefill = now;
+        sendTokens = std::min(sendTokens + elapsed * rate, 0.1 * rate); // allow bursts of up to 100ms
+      }
+      bool canSend = !limited || sendTokens > 0.;
+
+      // Gather the sockets to wait on
+      std::vector<pollfd> fds;
+      fds.push_back(pollfd{wakeFds[0], POLLIN, 0});
+      fds.push_back(pollfd{listenFd, POLLIN, 0});
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::unique_ptr<Client>& c : clients) {
+          short events = POLLIN;
+          if (canSend && !c->outQueue.empty()) events |= POLLOUT;
+          fds.push_back(pollfd{c->fd, events, 0});
+        }
+      }
+
+      poll(fds.data(), fds.size(), (limited && !canSend) ? 10 : 100);
+
+      // Drain wakeups
+      if (fds[0].revents & POLLIN) {
+        char buff[64];
+        while (read(wakeFds[0], buff, sizeof(buff)) > 0) {
+        }
+      }
+
+      // Accept new connections
+      if (fds[1].revents & POLLIN) {
+        int fd;
+        while ((fd = accept(listenFd, nullptr, nullptr)) >= 0) {
+          setNonBlocking(fd);
+#ifdef SO_NOSIGPIPE
+          int yes = 1;
+          setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+#endif
+          std::unique_ptr<Client> client(new Client());
+          client->fd = fd;
+          std::lock_guard<std::mutex> lock(mutex);
+          clients.push_back(std::move(client));
+        }
+      }
+
+      // Service existing clients (the ones we polled are the first entries of the client list, new ones come after)
+      for (size_t iFd = 2; iFd < fds.size(); iFd++) {
+        Client& c = *clients[iFd - 2];
+        if (fds[iFd].revents & (POLLERR | POLLHUP | POLLNVAL)) c.failed = true;
+        if (!c.failed && (fds[iFd].revents & POLLIN)) readFrom(c);
+        if (!c.failed && (fds[iFd].revents & POLLOUT)) writeTo(c, limited, sendTokens);
+      }
+
+      // Remove closed clients
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < clients.size();) {
+          Client& c = *clients[i];
+          if (c.failed || (c.closeAfterSend && c.outQueue.empty())) {
+            close(c.fd);
+            clients.erase(clients.begin() + i);
+          } else {
+            i++;
+          }
+        }
+      }
+    }
+  }
+
+  void readFrom(Client& c) {
+    char buff[4096];
+    while (true) {
+      ssize_t n = recv(c.fd, buff, sizeof(buff), 0);
+      if (n > 0) {
+        c.inBuffer.append(buff, n);
+      } else if (n == 0) {
+        c.failed = true; // closed by the other side
+        return;
+      } else {
+        break; // no more data for now
+      }
+    }
+
+    if (c.isWebSocket) {
+      processWebSocketData(c);
+    } else {
+      processHttpRequest(c);
+    }
+
+    // Don't let misbehaving clients use up memory
+    if (c.inBuffer.size() > (1 << 20)) c.failed = true;
+  }
+
+  void writeTo(Client& c, bool limited, double& sendTokens) {
+    std::lock_guard<std::mutex> lock(mutex);
+    while (!c.outQueue.empty()) {
+      const std::string& front = c.outQueue.front();
+      size_t toSend = front.size() - c.outOffset;
+      if (limited) {
+        if (sendTokens <= 0.) return;
+        toSend = std::min(toSend, static_cast<size_t>(sendTokens) + 1);
+      }
+
+#ifdef MSG_NOSIGNAL
+      ssize_t n = send(c.fd, front.data() + c.outOffset, toSend, MSG_NOSIGNAL);
+#else
+      ssize_t n = send(c.fd, front.data() + c.outOffset, toSend, 0);
+#endif
+      if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) c.failed = true;
+        return;
+      }
+
+      c.outOffset += n;
+      c.backlog -= n;
+      sendTokens -= n;
+      if (c.outOffset == front.size()) {
+        c.outQueue.pop_front();
+        c.outOffset = 0;
+      }
+    }
+  }
+
+  void queueRaw(Client& c, const std::string& data) {
+    std::lock_guard<std::mutex> lock(mutex);
+    c.outQueue.push_back(data);
+    c.backlog += data.size();
+  }
+
+  void processHttpRequest(Client& c) {
+    size_t headerEnd = c.inBuffer.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) return;
+    std::string request = c.inBuffer.substr(0, headerEnd);
+    c.inBuffer.erase(0, headerEnd + 4);
+
+    // Parse the request line and headers. Header names are case-insensitive.
+    std::vector<std::string> lines;
+    size_t lineStart = 0;
+    while (lineStart <= request.size()) {
+      size_t lineEnd = request.find("\r\n", lineStart);
+      if (lineEnd == std::string::npos) lineEnd = request.size();
+      lines.push_back(request.substr(lineStart, lineEnd - lineStart));
+      lineStart = lineEnd + 2;
+    }
+    std::string method, path;
+    {
+      size_t sp1 = lines[0].find(' ');
+      size_t sp2 = lines[0].find(' ', sp1 + 1);
+      if (sp1 != std::string::npos && sp2 != std::string::npos) {
+        method = lines[0].substr(0, sp1);
+        path = lines[0].substr(sp1 + 1, sp2 - sp1 - 1);
+      }
+    }
+    std::map<std::string, std::string> headers;
+    for (size_t i = 1; i < lines.size(); i++) {
+      size_t colon = lines[i].find(':');
+      if (colon == std::string::npos) continue;
+      std::string name = lines[i].substr(0, colon);
+      std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+      size_t valStart = lines[i].find_first_not_of(' ', colon + 1);
+      headers[name] = valStart == std::string::npos ? "" : lines[i].substr(valStart);
+    }
+
+    auto respond = [&](std::string status, std::string contentType, std::string body) {
+      queueRaw(c, "HTTP/1.1 " + status + "\r\nContent-Type: " + contentType +
+                      "\r\nContent-Length: " + std::to_string(body.size()) +
+                      "\r\nCache-Control: no-store\r\nConnection: close\r\n\r\n" + body);
+      std::lock_guard<std::mutex> lock(mutex);
+      c.closeAfterSend = true;
+    };
+
+    if (method != "GET") {
+      respond("405 Method Not Allowed", "text/plain", "");
+      return;
+    }
+
+    if (headers.count("sec-websocket-key")) {
+      queueRaw(c, "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                  "Sec-WebSocket-Accept: " +
+                      webSocketAcceptKey(headers["sec-websocket-key"]) + "\r\n\r\n");
+      std::lock_guard<std::mutex> lock(mutex);
+      c.isWebSocket = true;
+      refreshRequested = true;
+      return;
+    }
+
+    if (path == "/" || path == "/index.html") {
+      respond("200 OK", "text/html; charset=utf-8", clientPage);
+    } else {
+      respond("404 Not Found", "text/plain", "");
+    }
+  }
+
+  void processWebSocketData(Client& c) {
+    std::string& in = c.inBuffer;
+    while (in.size() >= 2) {
+      const unsigned char* b = reinterpret_cast<const unsigned char*>(in.data());
+      uint8_t opcode = b[0] & 0x0F;
+      bool masked = b[1] & 0x80;
+      uint64_t len = b[1] & 0x7F;
+      size_t pos = 2;
+      if (len == 126) {
+        if (in.size() < 4) return;
+        len = (uint64_t(b[2]) << 8) | b[3];
+        pos = 4;
+      } else if (len == 127) {
+        if (in.size() < 10) return;
+        len = 0;
+        for (int i = 0; i < 8; i++) len = (len << 8) | b[2 + i];
+        pos = 10;
+      }
+      if (len > (1 << 20)) {
+        c.failed = true;
+        return;
+      }
+      uint8_t mask[4] = {0, 0, 0, 0};
+      if (masked) {
+        if (in.size() < pos + 4) return;
+        std::memcpy(mask, b + pos, 4);
+        pos += 4;
+      }
+      if (in.size() < pos + len) return;
+
+      std::string payload = in.substr(pos, len);
+      for (size_t i = 0; i < payload.size(); i++) payload[i] ^= mask[i % 4];
+      in.erase(0, pos + len);
+
+      switch (opcode) {
+      case 0x1: { // text
+        std::lock_guard<std::mutex> lock(mutex);
+        inputMessages.push_back(payload);
+        break;
+      }
+      case 0x8: { // close
+        queueRaw(c, webSocketFrame(0x8, ""));
+        std::lock_guard<std::mutex> lock(mutex);
+        c.closeAfterSend = true;
+        return;
+      }
+      case 0x9: // ping
+        queueRaw(c, webSocketFrame(0xA, payload));
+        break;
+      default:
+        break;
+      }
+    }
+  }
+};
+
+#else
+
+// Placeholder so the rest of this file compiles, start() refuses to create one
+class Server {
+public:
+  int getPort() const { return -1; }
+  size_t clientCount() { return 0; }
+  size_t backlogBytes() { return 0; }
+  bool takeRefreshRequest() { return false; }
+  std::vector<std::string> takeInputMessages() { return {}; }
+  void setMaxBytesPerSecond(int64_t) {}
+  void broadcast(const std::string&) {}
+};
+
+#endif
+
+// == Main-thread state
+
+std::unique_ptr<Server> server;
+
+// The downscaled image which clients currently show, as top-to-bottom rows of RGBA
+std::vector<unsigned char> clientImage;
+int clientImageWidth = 0;
+int clientImageHeight = 0;
+int clientImageDownscale = 0;
+bool clientImageIsDegraded = false;
+
+size_t currLevel = 0;
+int framesWithoutBacklog = 0;
+int framesWithoutChanges = 0;
+
+// Size of the display buffer when the pending async read was started
+int pendingReadWidth = 0;
+int pendingReadHeight = 0;
+
+ImGuiKey keyFromName(const std::string& name) {
+  if (name.size() == 1) {
+    char c = name[0];
+    if (c >= 'a' && c <= 'z') return static_cast<ImGuiKey>(ImGuiKey_A + (c - 'a'));
+    if (c >= 'A' && c <= 'Z') return static_cast<ImGuiKey>(ImGuiKey_A + (c - 'A'));
+    if (c >= '0' && c <= '9') return static_cast<ImGuiKey>(ImGuiKey_0 + (c - '0'));
+  }
+  static const std::map<std::string, ImGuiKey> namedKeys{
+      {" ", ImGuiKey_Space},
+      {"Enter", ImGuiKey_Enter},
+      {"Escape", ImGuiKey_Escape},
+      {"Tab", ImGuiKey_Tab},
+      {"Backspace", ImGuiKey_Backspace},
+      {"Delete", ImGuiKey_Delete},
+      {"Insert", ImGuiKey_Insert},
+      {"Home", ImGuiKey_Home},
+      {"End", ImGuiKey_End},
+      {"PageUp", ImGuiKey_PageUp},
+      {"PageDown", ImGuiKey_PageDown},
+      {"ArrowLeft", ImGuiKey_LeftArrow},
+      {"ArrowRight", ImGuiKey_RightArrow},
+      {"ArrowUp", ImGuiKey_UpArrow},
+      {"ArrowDown", ImGuiKey_DownArrow},
+      {"Shift", ImGuiKey_LeftShift},
+      {"Control", ImGuiKey_LeftCtrl},
+      {"Alt", ImGuiKey_LeftAlt},
+      {"-", ImGuiKey_Minus},
+      {"=", ImGuiKey_Equal},
+      {".", ImGuiKey_Period},
+      {",", ImGuiKey_Comma},
+      {"/", ImGuiKey_Slash},
+  };
+  auto it = namedKeys.find(name);
+  return it == namedKeys.end() ? ImGuiKey_None : it->second;
+}
+
+bool backendIsHeadless() {
+  std::string backend = render::getRenderEngineBackendName();
+  return backend == "openGL3_egl" || backend == "openGL_mock";
+}
+
+// Pass an event from the browser to ImGui (throws if the message is malformed)
+void applyInputMessage(ImGuiIO& io, const json& msg) {
+  std::string type = msg.value("type", "");
+
+  if (type == "mousemove") {
+    io.AddMousePosEvent(msg.value("x", 0.f) * view::windowWidth, msg.value("y", 0.f) * view::windowHeight);
+  } else if (type == "mousebutton") {
+    // browsers number the buttons left-middle-right, ImGui uses left-right-middle
+    int button = msg.value("button", 0);
+    if (button == 1) {
+      button = 2;
+    } else if (button == 2) {
+      button = 1;
+    }
+    if (button >= 0 && button < 3) io.AddMouseButtonEvent(button, msg.value("down", false));
+  } else if (type == "wheel") {
+    io.AddMouseWheelEvent(msg.value("dx", 0.f), msg.value("dy", 0.f));
+  } else if (type == "key") {
+    bool down = msg.value("down", false);
+    bool ctrl = msg.value("ctrl", false) || msg.value("meta", false);
+    io.AddKeyEvent(ImGuiMod_Shift, msg.value("shift", false));
+    io.AddKeyEvent(ImGuiMod_Ctrl, ctrl);
+    io.AddKeyEvent(ImGuiMod_Alt, msg.value("alt", false));
+    std::string keyName = msg.value("key", "");
+    ImGuiKey key = keyFromName(keyName);
+    if (key != ImGuiKey_None) io.AddKeyEvent(key, down);
+    if (down && !ctrl && keyName.size() == 1) io.AddInputCharacter(static_cast<unsigned char>(keyName[0]));
+  } else if (type == "resize") {
+    // Only headless displays follow the browser's size, a real window stays the size the user made it
+    int newW = msg.value("w", 0);
+    int newH = msg.value("h", 0);
+    if (backendIsHeadless() && newW > 0 && newH > 0 && (newW != view::windowWidth || newH != view::windowHeight)) {
+      view::setWindowSize(newW, newH);
+    }
+  }
+}
+
+// Downsample the (bottom-to-top) display buffer by an integer factor with a box filter, flipping to top-to-bottom
+std::vector<unsigned char> downsampleAndFlip(const std::vector<unsigned char>& pixels, int w, int h, int factor,
+                                             int& outW, int& outH) {
+  outW = (w + factor - 1) / factor;
+  outH = (h + factor - 1) / factor;
+  std::vector<unsigned char> out(4 * outW * outH);
+
+  parallelForChunks(outH, 64, [&](size_t iStart, size_t iEnd, size_t) {
+    for (size_t jOut = iStart; jOut < iEnd; jOut++) {
+      for (int iOut = 0; iOut < outW; iOut++) {
+        uint32_t sum[4] = {0, 0, 0, 0};
+        int count = 0;
+        for (int dj = 0; dj < factor; dj++) {
+          int jTop = static_cast<int>(jOut) * factor + dj;
+          if (jTop >= h) break;
+          int jSrc = h - 1 - jTop;
+          for (int di = 0; di < factor; di++) {
+            int iSrc = iOut * factor + di;
+            if (iSrc >= w) break;
+            const unsigned char* p = &pixels[4 * (jSrc * w + iSrc)];
+            for (int c = 0; c < 4; c++) sum[c] += p[c];
+            count++;
+          }
+        }
+        unsigned char* q = &out[4 * (jOut * outW + iOut)];
+        for (int c = 0; c < 4; c++) q[c] = static_cast<unsigned char>(sum[c] / count);
+      }
+    }
+  });
+
+  return out;
+}
+
+void appendToString(void* context, void* data, int size) {
+  static_cast<std::string*>(context)->append(static_cast<const char*>(data), size);
+}
+
+void encodeAndSend(const std::vector<unsigned char>& pixels, int w, int h) {
+
+  bool fullRefresh = server->takeRefreshRequest();
+
+  // == Pick a quality level based on how well the clients are keeping up
+  size_t backlog = server->backlogBytes();
+  if (backlog > maxBacklogBytes) {
+    // Way behind, don't make it worse. Nothing is marked as sent, so the changes go out with a later frame.
+    if (fullRefresh) {
+      // hang on to the request until we actually send something
+      clientImageDownscale = 0;
+    }
+    currLevel = streamLevels.size() - 1;
+    framesWithoutBacklog = 0;
+    return;
+  }
+  if (backlog > targetBacklogBytes) {
+    currLevel = std::min(currLevel + 1, streamLevels.size() - 1);
+    framesWithoutBacklog = 0;
+  } else if (backlog == 0) {
+    framesWithoutBacklog++;
+    if (framesWithoutBacklog >= framesBeforeImproving && currLevel > 0) {
+      currLevel--;
+      framesWithoutBacklog = 0;
+    }
+  }
+
+  // If nothing has been changing for a while, sharpen up a degraded image
+  if (framesWithoutChanges >= idleFramesBeforeRefresh && clientImageIsDegraded && backlog == 0) {
+    currLevel = 0;
+    fullRefresh = true;
+  }
+
+  StreamLevel level = streamLevels[currLevel];
+  int quality = std::min(level.quality, options::remoteViewMaxQuality);
+
+  int imgW, imgH;
+  std::vector<unsigned char> image = downsampleAndFlip(pixels, w, h, level.downscale, imgW, imgH);
+
+  if (imgW != clientImageWidth || imgH != clientImageHeight || level.downscale != clientImageDownscale) {
+    fullRefresh = true;
+  }
+
+  // == Find the tiles which changed
+  std::vector<std::array<int, 4>> tiles; // x, y, w, h
+  for (int tileY = 0; tileY < imgH; tileY += tileSize) {
+    for (int tileX = 0; tileX < imgW; tileX += tileSize) {
+      int tileW = std::min(tileSize, imgW - tileX);
+      int tileH = std::min(tileSize, imgH - tileY);
+      bool changed = fullRefresh;
+      for (int j = tileY; !changed && j < tileY + tileH; j++) {
+        size_t offset = 4 * (j * imgW + tileX);
+        changed = std::memcmp(&image[offset], &clientImage[offset], 4 * tileW) != 0;
+      }
+      if (changed) tiles.push_back({{tileX, tileY, tileW, tileH}});
+    }
+  }
+
+  if (tiles.empty()) {
+    framesWithoutChanges++;
+    return;
+  }
+  framesWithoutChanges = 0;
+
+  // == Encode the changed tiles
+  stbi_flip_vertically_on_write(0); // (screenshots turn this on)
+  std::vector<std::string> encoded(tiles.size());
+  parallelForChunks(tiles.size(), 4, [&](size_t iStart, size_t iEnd, size_t) {
+    std::vector<unsigned char> tilePixels;
+    for (size_t iTile = iStart; iTile < iEnd; iTile++) {
+      int tileX = tiles[iTile][0], tileY = tiles[iTile][1], tileW = tiles[iTile][2], tileH = tiles[iTile][3];
+      tilePixels.resize(4 * tileW * tileH);
+      for (int j = 0; j < tileH; j++) {
+        std::memcpy(&tilePixels[4 * j * tileW], &image[4 * ((tileY + j) * imgW + tileX)], 4 * tileW);
+      }
+      stbi_write_jpg_to_func(appendToString, &encoded[iTile], tileW, tileH, 4, &tilePixels.front(), quality);
+    }
+  });
+
+  // Message layout (little-endian): u16 width, u16 height, u8 downscale, u8 unused, u16 tile count, then for each tile
+  // u16 x, u16 y, u16 w, u16 h (in downscaled pixels), u32 byte count, and the JPEG data
+  std::string message;
+  appendU16(message, w);
+  appendU16(message, h);
+  message.push_back(static_cast<char>(level.downscale));
+  message.push_back(0);
+  appendU16(message, tiles.size());
+  for (size_t iTile = 0; iTile < tiles.size(); iTile++) {
+    for (int k = 0; k < 4; k++) appendU16(message, tiles[iTile][k]);
+    appendU32(message, encoded[iTile].size());
+    message += encoded[iTile];
+  }
+  server->broadcast(message);
+
+  // == Remember what the clients have now
+  if (fullRefresh) {
+    clientImage.swap(image);
+    clientImageWidth = imgW;
+    clientImageHeight = imgH;
+    clientImageDownscale = level.downscale;
+    clientImageIsDegraded = currLevel > 0;
+  } else {
+    for (const std::array<int, 4>& t : tiles) {
+      for (int j = t[1]; j < t[1] + t[3]; j++) {
+        size_t offset = 4 * (j * imgW + t[0]);
+        std::memcpy(&clientImage[offset], &image[offset], 4 * t[2]);
+      }
+    }
+    clientImageIsDegraded = clientImageIsDegraded || currLevel > 0;
+  }
+}
+
+} // namespace
+
+int start(int port, std::string bindAddress) {
+#ifdef _WIN32
+  exception("remote view is not supported on this platform");
+  return -1;
+#else
+  if (server) {
+    exception("remote view is already running on port " + std::to_string(server->getPort()));
+  }
+  server.reset(new Server(port, bindAddress));
+  clientImageDownscale = 0; // forces a full frame
+  currLevel = 0;
+  info("remote view: serving on http://" + bindAddress + ":" + std::to_string(server->getPort()));
+  return server->getPort();
+#endif
+}
+
+void stop() {
+  server.reset();
+  clientImage.clear();
+  clientImageWidth = 0;
+  clientImageHeight = 0;
+}
+
+bool isRunning() { return static_cast<bool>(server); }
+
+size_t clientCount() { return server ? server->clientCount() : 0; }
+
+void processInput() {
+  if (!server) return;
+
+  std::vector<std::string> messages = server->takeInputMessages();
+  if (messages.empty()) return;
+
+  ImGuiIO& io = ImGui::GetIO();
+  for (const std::string& msgStr : messages) {
+    try {
+      applyInputMessage(io, json::parse(msgStr));
+    } catch (const std::exception&) {
+      // ignore malformed messages
+    }
+  }
+
+  requestRedraw();
+}
+
+void sendFrame() {
+  if (!server) return;
+  server->setMaxBytesPerSecond(options::remoteViewMaxBytesPerSecond);
+
+  render::FrameBuffer& display = *render::engine->displayBuffer;
+  if (server->clientCount() == 0) {
+    return;
+  }
+
+  // Encode the result of the read started on an earlier frame (if it is ready), so we don't stall waiting on the GPU
+  std::vector<unsigned char> pixels;
+  if (display.finishAsyncReadBuffer(pixels)) {
+    if (pixels.size() == static_cast<size_t>(4 * pendingReadWidth * pendingReadHeight)) {
+      encodeAndSend(pixels, pendingReadWidth, pendingReadHeight);
+    }
+  }
+
+  if (!display.asyncReadBufferPending()) {
+    pendingReadWidth = display.getSizeX();
+    pendingReadHeight = display.getSizeY();
+    display.beginAsyncReadBuffer();
+  }
+}
+
+} // namespace remote
+} // namespace polyscope
@@ -25,6 +25,7 @@ int dimension(const TextureFormat& x) {
     case TextureFormat::RGB32F:   return 3;
     case TextureFormat::RGBA32F:  return 4;
     case TextureFormat::DEPTH24:  return 1;
+    case TextureFormat::R8:       return 1;
   }
   // clang-format on
   exception("bad enum");
@@ -44,6 +45,7 @@ int sizeInBytes(const TextureFormat& f) {
     case TextureFormat::RGB32F:   return 3*4;
     case TextureFormat::RGBA32F:  return 4*4;
     case TextureFormat::DEPTH24:  return 1*3;
+    case TextureFormat::R8:       return 1*1;
   }
   // clang-format on
   return -1;
@@ -175,6 +177,16 @@ TextureBuffer::~TextureBuffer() {}
 
 void TextureBuffer::setFilterMode(FilterMode newMode) {}
 
+void TextureBuffer::setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX,
+                                    unsigned int regionY, const float* data) {
+  exception("texture region updates are not supported by this backend");
+}
+
+void TextureBuffer::setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX,
+                                    unsigned int regionY, const unsigned char* data) {
+  exception("texture region updates are not supported by this backend");
+}
+
 void TextureBuffer::resize(unsigned int newLen) { sizeX = newLen; }
 void TextureBuffer::resize(unsigned int newX, unsigned int newY) {
   sizeX = newX;
@@ -243,6 +255,32 @@ void FrameBuffer::verifyBufferSizes() {
   }
 }
 
+void FrameBuffer::beginAsyncReadBuffer() {
+  asyncReadData = readBuffer();
+  asyncReadPending = true;
+}
+
+bool FrameBuffer::finishAsyncReadBuffer(std::vector<unsigned char>& out, bool wait) {
+  if (!asyncReadPending) return false;
+  out.swap(asyncReadData);
+  asyncReadData.clear();
+  asyncReadPending = false;
+  return true;
+}
+
+void FrameBuffer::beginAsyncReadFloat4Region(int xStart, int yStart, int sizeX, int sizeY) {
+  asyncRegionReadData = readFloat4Region(xStart, yStart, sizeX, sizeY);
+  asyncRegionReadPending = true;
+}
+
+bool FrameBuffer::finishAsyncReadFloat4Region(std::vector<float>& out, bool wait) {
+  if (!asyncRegionReadPending) return false;
+  out.swap(asyncRegionReadData);
+  asyncRegionReadData.clear();
+  asyncRegionReadPending = false;
+  return true;
+}
+
 ShaderReplacementRule::ShaderReplacementRule() {}
 
 ShaderReplacementRule::ShaderReplacementRule(std::string ruleName_,
@@ -336,6 +374,20 @@ void Engine::buildEngineGui() {
     // == Ground plane
     groundPlane.buildGui();
 
+    ImGui::SetNextItemOpen(false, ImGuiCond_FirstUseEver);
+    if (ImGui::TreeNode("Eye-Dome Lighting")) {
+      if (ImGui::Checkbox("enabled", &options::eyeDomeLighting)) requestRedraw();
+      if (ImGui::SliderFloat("strength", &options::eyeDomeLightingStrength, 0.01, 10.0, "%.3f",
+                             ImGuiSliderFlags_Logarithmic | ImGuiSliderFlags_NoRoundToFormat)) {
+        requestRedraw();
+      }
+      if (ImGui::SliderFloat("radius", &options::eyeDomeLightingRadius, 0.5, 5.0, "%.1f")) requestRedraw();
+      if (options::eyeDomeLighting && transparencyMode != TransparencyMode::None) {
+        ImGui::TextWrapped("Eye-dome lighting is not applied while transparency is enabled.");
+      }
+      ImGui::TreePop();
+    }
+
     ImGui::SetNextItemOpen(false, ImGuiCond_FirstUseEver);
     if (ImGui::TreeNode("Tone Mapping")) {
       ImGui::SliderFloat("exposure", &exposure, 0.1, 2.0, "%.3f",
@@ -424,6 +476,12 @@ FrameBuffer& Engine::getDisplayBuffer() { return useAltDisplayBuffer ? *displayB
 
 TextureBuffer& Engine::getFinalSceneColorTexture() { return *sceneColorFinal; }
 
+double Engine::getDisplayRefreshRate() { return 0.; }
+
+void Engine::finishDeviceWork() {}
+
+bool Engine::getDeviceMemoryInfo(size_t& totalBytesOut, size_t& availableBytesOut) { return false; }
+
 void Engine::setBackgroundColor(glm::vec3 c) {
   FrameBuffer& targetBuffer = getDisplayBuffer();
   targetBuffer.clearColor = c;
@@ -434,6 +492,20 @@ void Engine::setBackgroundAlpha(float newAlpha) {
   targetBuffer.clearAlpha = newAlpha;
 }
 
+bool Engine::depthPrepassAllowed() { return transparencyMode == TransparencyMode::None; }
+
+void Engine::beginDepthPrepass() {
+  setColorMask({false, false, false, false});
+  setDepthMode(DepthMode::Less);
+}
+
+void Engine::beginDepthPrepassShading() {
+  setColorMask();
+  setDepthMode(DepthMode::LEqual); // (still writes depth, for anything else the structure draws in this pass)
+}
+
+void Engine::endDepthPrepass() { applyTransparencySettings(); }
+
 void Engine::setCurrentViewport(glm::vec4 val) { currViewport = val; }
 glm::vec4 Engine::getCurrentViewport() { return currViewport; }
 void Engine::setCurrentPixelScaling(float val) { currPixelScale = val; }
@@ -503,8 +575,12 @@ void Engine::applyLightingTransform(std::shared_ptr<TextureBuffer>& texture) {
     if (sampleLevel > 4) exception("lighting downsampling only implemented up to 4x");
   }
 
+  // (eye-dome lighting needs the depth buffer to hold the front-most surface)
+  bool eyeDome = options::eyeDomeLighting && transparencyMode == TransparencyMode::None;
+
   // == Lazily regnerate the mapper if it doesn't match the current settings
-  if (!mapLight || currLightingSampleLevel != sampleLevel || currLightingTransparencyMode != transparencyMode) {
+  if (!mapLight || currLightingSampleLevel != sampleLevel || currLightingTransparencyMode != transparencyMode ||
+      currLightingEyeDome != eyeDome) {
 
     std::string sampleRuleName = "";
     if (sampleLevel == 1) sampleRuleName = "DOWNSAMPLE_RESOLVE_1";
@@ -524,10 +600,23 @@ void Engine::applyLightingTransform(std::shared_ptr<TextureBuffer>& texture) {
       break;
     }
 
+    if (eyeDome) {
+      resolveRules.push_back("EYE_DOME_LIGHTING");
+    }
+
     mapLight = render::engine->requestShader("MAP_LIGHT", resolveRules, render::ShaderReplacementDefaults::Process);
     mapLight->setAttribute("a_position", screenTrianglesCoords());
     currLightingSampleLevel = sampleLevel;
     currLightingTransparencyMode = transparencyMode;
+    currLightingEyeDome = eyeDome;
+  }
+
+  if (eyeDome) {
+    glm::mat4 Pinv = glm::inverse(view::getCameraPerspectiveMatrix());
+    mapLight->setTextureFromBuffer("t_depth", sceneDepth.get());
+    mapLight->setUniform("u_invProjMatrix", glm::value_ptr(Pinv));
+    mapLight->setUniform("u_eyeDomeStrength", options::eyeDomeLightingStrength);
+    mapLight->setUniform("u_eyeDomeRadius", options::eyeDomeLightingRadius * ssaaFactor);
   }
 
   mapLight->setUniform("u_bgColor", glm::vec3{view::bgColor[0], view::bgColor[1], view::bgColor[2]});
@@ -543,6 +632,23 @@ void Engine::applyLightingTransform(std::shared_ptr<TextureBuffer>& texture) {
   mapLight->draw();
 }
 
+void Engine::drawPickHighlight(glm::vec3 pickColor) {
+
+  if (!pickHighlight) {
+    pickHighlight = render::engine->requestShader("PICK_HIGHLIGHT", {}, render::ShaderReplacementDefaults::Process);
+    pickHighlight->setAttribute("a_position", screenTrianglesCoords());
+    pickHighlight->setTextureFromBuffer("t_pick", pickColorBuffer.get());
+  }
+
+  pickHighlight->setUniform("u_pickColor", pickColor);
+  glm::vec2 texelSize{1. / pickColorBuffer->getSizeX(), 1. / pickColorBuffer->getSizeY()};
+  pickHighlight->setUniform("u_texelSize", texelSize);
+
+  setBlendMode(BlendMode::AlphaOver);
+  setDepthMode(DepthMode::Disable);
+  pickHighlight->draw();
+}
+
 void Engine::setTonemapUniforms(ShaderProgram& p) {
   p.setUniform("u_exposure", exposure);
   p.setUniform("u_whiteLevel", whiteLevel);
@@ -704,7 +810,8 @@ void Engine::allocateGlobalBuffersAndPrograms() {
   }
 
   { // Pick buffer
-    pickColorBuffer = generateRenderBuffer(RenderBufferType::Float4, view::bufferWidth, view::bufferHeight);
+    // (a texture rather than a renderbuffer, so the hover highlight can sample it)
+    pickColorBuffer = generateTextureBuffer(TextureFormat::RGBA32F, view::bufferWidth, view::bufferHeight);
     pickDepthBuffer = generateRenderBuffer(RenderBufferType::Depth, view::bufferWidth, view::bufferHeight);
 
     pickFramebuffer = generateFrameBuffer(view::bufferWidth, view::bufferHeight);
@@ -1152,6 +1259,40 @@ void Engine::loadDefaultColorMaps() {
 }
 
 
+std::shared_ptr<AttributeBuffer> Engine::wrapNativeAttributeBuffer(RenderDataType dataType_, int arrayCount_,
+                                                                   uint32_t nativeID, int64_t dataSize) {
+  exception("the " + engineBackendName + " rendering backend does not support wrapping native attribute buffers");
+  return nullptr;
+}
+
+std::shared_ptr<TextureBuffer> Engine::wrapNativeTextureBuffer(TextureFormat format, int dim, uint32_t nativeID,
+                                                               unsigned int sizeX_, unsigned int sizeY_,
+                                                               unsigned int sizeZ_) {
+  exception("the " + engineBackendName + " rendering backend does not support wrapping native textures");
+  return nullptr;
+}
+
+bool Engine::computeTierAvailable() { return computeTierSupported && options::enableComputeTier; }
+
+bool Engine::computeRange(AttributeBuffer& values, float& minOut, float& maxOut) { return false; }
+
+bool Engine::computeHistogram(AttributeBuffer& values, float rangeMin, float rangeMax, size_t nBins,
+                              std::vector<uint32_t>& countsOut) {
+  return false;
+}
+
+bool Engine::computeGather(AttributeBuffer& source, AttributeBuffer& indices, AttributeBuffer& target) {
+  return false;
+}
+
+void Engine::serviceDeferredUploads() {
+  if (options::deferDeviceUploads) {
+    uploadScheduler.service(options::maxUploadBytesPerFrame, options::maxUploadMillisecondsPerFrame);
+  } else {
+    uploadScheduler.flush(); // (in case the option was just turned off)
+  }
+}
+
 void Engine::showTextureInImGuiWindow(std::string windowName, TextureBuffer* buffer) {
   ImGui::Begin(windowName.c_str());
 
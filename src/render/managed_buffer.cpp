@@ -1,12 +1,14 @@
 // Copyright 2018-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
 
 
+#include <algorithm>
 #include <vector>
 
 #include "polyscope/render/managed_buffer.h"
 
 #include "polyscope/internal.h"
 #include "polyscope/messages.h"
+#include "polyscope/pick.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/render/engine.h"
 #include "polyscope/render/templated_buffers.h"
@@ -14,6 +16,15 @@
 namespace polyscope {
 namespace render {
 
+namespace {
+
+// New device-side values for a buffer which is drawn in to the pick buffer mean that it must be re-rendered
+void markPickBufferStaleFor(ManagedBufferRegistry* registry) {
+  if (registry && registry->buffersAffectPicking()) pick::markPickBufferStale();
+}
+
+} // namespace
+
 template <typename T>
 ManagedBuffer<T>::ManagedBuffer(ManagedBufferRegistry* registry_, const std::string& name_, std::vector<T>& data_)
     : name(name_), uniqueID(internal::getNextUniqueID()), registry(registry_), data(data_), dataGetsComputed(false),
@@ -37,7 +48,15 @@ ManagedBuffer<T>::ManagedBuffer(ManagedBufferRegistry* registry_, const std::str
 }
 
 template <typename T>
-ManagedBuffer<T>::~ManagedBuffer() {}
+ManagedBuffer<T>::~ManagedBuffer() {
+  if (sharedSource) {
+    std::vector<ManagedBuffer<T>*>& siblings = sharedSource->sharingBuffers;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+  } else if (!sharingBuffers.empty()) {
+    handOverSharedValues();
+  }
+  cancelDeferredUpload();
+}
 
 template <typename T>
 void ManagedBuffer<T>::setTextureSize(uint32_t sizeX_) {
@@ -74,6 +93,10 @@ std::array<uint32_t, 3> ManagedBuffer<T>::getTextureSize() const {
 
 template <typename T>
 void ManagedBuffer<T>::ensureHostBufferPopulated() {
+  if (sharedSource) {
+    sharedSource->ensureHostBufferPopulated();
+    return;
+  }
 
   switch (currentCanonicalDataSource()) {
   case CanonicalDataSource::HostData:
@@ -84,6 +107,7 @@ void ManagedBuffer<T>::ensureHostBufferPopulated() {
 
     // compute it
     computeFunc();
+    dataVersion++;
 
     break;
 
@@ -101,6 +125,7 @@ void ManagedBuffer<T>::ensureHostBufferPopulated() {
 
       // copy the data back from the renderBuffer
       data = getAttributeBufferDataRange<T>(*renderAttributeBuffer, 0, renderAttributeBuffer->getDataSize());
+      hostBufferIsPopulated = true;
     }
 
     break;
@@ -114,13 +139,43 @@ void ManagedBuffer<T>::ensureHostBufferAllocated() {
 
 template <typename T>
 std::vector<T>& ManagedBuffer<T>::getPopulatedHostBufferRef() {
+  if (sharedSource) return sharedSource->getPopulatedHostBufferRef();
   ensureHostBufferPopulated();
   return data;
 }
 
 template <typename T>
 void ManagedBuffer<T>::markHostBufferUpdated() {
-  hostBufferIsPopulated = true;
+
+  // If the values are shared, the new ones were written to this buffer's `data`; move them to the buffer which holds
+  // the values for everyone
+  if (sharedSource) {
+    if (data.size() != sharedSource->size()) {
+      exception("ManagedBuffer " + name + " was updated with " + std::to_string(data.size()) +
+                " values, but the values it shares have size " + std::to_string(sharedSource->size()));
+    }
+    sharedSource->data.swap(data);
+    std::vector<T>().swap(data);
+  }
+  ManagedBuffer<T>& owner = sharedSource ? *sharedSource : *this;
+
+  owner.hostBufferIsPopulated = true;
+  owner.dataVersion++;
+  notifySharingBuffers();
+
+  // Optionally, leave the upload for the engine to do later, under its per-frame budget
+  bool hasDeviceData = owner.renderAttributeBuffer || owner.renderTextureBuffer || !owner.existingIndexedViews.empty();
+  if (options::deferDeviceUploads && hasDeviceData && render::engine) {
+    render::engine->uploadScheduler.enqueue(&owner, owner.registry, owner.data.size() * sizeof(T),
+                                            [&owner]() { owner.uploadHostBufferToDevice(); });
+    return;
+  }
+
+  owner.uploadHostBufferToDevice();
+}
+
+template <typename T>
+void ManagedBuffer<T>::uploadHostBufferToDevice() {
 
   // If the data is stored in the device-side buffers, update it as needed
   if (renderAttributeBuffer) {
@@ -137,10 +192,15 @@ void ManagedBuffer<T>::markHostBufferUpdated() {
     updateIndexedViews();
     requestRedraw();
   }
+
+  if (renderAttributeBuffer || renderTextureBuffer) {
+    markPickBufferStaleFor(registry);
+  }
 }
 
 template <typename T>
 T ManagedBuffer<T>::getValue(size_t ind) {
+  if (sharedSource) return sharedSource->getValue(ind);
 
   // For the texture case, always copy to the host and pull from there
   if (deviceBufferTypeIsTexture()) {
@@ -196,6 +256,7 @@ T ManagedBuffer<T>::getValue(size_t indX, size_t indY, size_t indZ) {
 
 template <typename T>
 size_t ManagedBuffer<T>::size() {
+  if (sharedSource) return sharedSource->size();
 
   switch (currentCanonicalDataSource()) {
   case CanonicalDataSource::HostData:
@@ -224,6 +285,7 @@ size_t ManagedBuffer<T>::size() {
 
 template <typename T>
 bool ManagedBuffer<T>::hasData() {
+  if (sharedSource) return sharedSource->hasData();
 
   if (hostBufferIsPopulated) return true;
   if (deviceBufferType == DeviceBufferType::Attribute && renderAttributeBuffer) return true;
@@ -244,6 +306,10 @@ std::string ManagedBuffer<T>::summaryString() {
   std::string str = "";
 
   str += "[" + name + "]";
+  if (sharedSource) {
+    str += "   shared from: " + sharedSource->summaryString();
+    return str;
+  }
   str += "   status: ";
   switch (currentCanonicalDataSource()) {
   case CanonicalDataSource::HostData:
@@ -293,9 +359,22 @@ void ManagedBuffer<T>::recomputeIfPopulated() {
   markHostBufferUpdated();
 }
 
+template <typename T>
+bool ManagedBuffer<T>::hasRenderAttributeBuffer() {
+  if (sharedSource) return sharedSource->hasRenderAttributeBuffer();
+  return static_cast<bool>(renderAttributeBuffer);
+}
+
+template <typename T>
+bool ManagedBuffer<T>::hasPendingDeferredUpload() {
+  if (sharedSource) return sharedSource->hasPendingDeferredUpload();
+  return render::engine && render::engine->uploadScheduler.isPending(this);
+}
+
 template <typename T>
 std::shared_ptr<render::AttributeBuffer> ManagedBuffer<T>::getRenderAttributeBuffer() {
   checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
+  if (sharedSource) return sharedSource->getRenderAttributeBuffer();
 
   if (!renderAttributeBuffer) {
     ensureHostBufferPopulated(); // warning: the order of these matters because of how hostBufferPopulated works
@@ -338,9 +417,57 @@ std::shared_ptr<render::TextureBuffer> ManagedBuffer<T>::getRenderTextureBuffer(
 template <typename T>
 void ManagedBuffer<T>::markRenderAttributeBufferUpdated() {
   checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
+  ManagedBuffer<T>& owner = sharedSource ? *sharedSource : *this;
 
+  owner.invalidateHostBuffer();
+  owner.dataVersion++;
+  owner.updateIndexedViews();
+  notifySharingBuffers();
+  markPickBufferStaleFor(owner.registry);
+  requestRedraw();
+}
+
+template <typename T>
+void ManagedBuffer<T>::setExternalRenderAttributeBuffer(uint32_t nativeID, size_t count) {
+  checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
+  if (sharedSource) {
+    exception("ManagedBuffer " + name + " shares its values from " + sharedSource->name +
+              ", set the external buffer on that one instead");
+  }
+
+  bool replacingExisting = static_cast<bool>(renderAttributeBuffer);
+  renderAttributeBuffer = wrapNativeAttributeBuffer<T>(render::engine, nativeID, static_cast<int64_t>(count));
+
+  // the external buffer now holds the canonical data
   invalidateHostBuffer();
+  dataVersion++;
   updateIndexedViews();
+  notifySharingBuffers();
+
+  // any shader programs which were already drawing from the old buffer need to be rebuilt
+  if (replacingExisting) {
+    refresh();
+  }
+  markPickBufferStaleFor(registry);
+  requestRedraw();
+}
+
+template <typename T>
+void ManagedBuffer<T>::setExternalRenderTextureBuffer(uint32_t nativeID) {
+  checkDeviceBufferTypeIsTexture();
+
+  bool replacingExisting = static_cast<bool>(renderTextureBuffer);
+  renderTextureBuffer = wrapNativeTextureBuffer<T>(deviceBufferType, render::engine, nativeID, sizeX, sizeY, sizeZ);
+
+  // the external texture now holds the canonical data
+  invalidateHostBuffer();
+  dataVersion++;
+
+  // any shader programs which were already drawing from the old texture need to be rebuilt
+  if (replacingExisting) {
+    refresh();
+  }
+  markPickBufferStaleFor(registry);
   requestRedraw();
 }
 
@@ -349,6 +476,8 @@ void ManagedBuffer<T>::markRenderTextureBufferUpdated() {
   checkDeviceBufferTypeIsTexture();
 
   invalidateHostBuffer();
+  dataVersion++;
+  markPickBufferStaleFor(registry);
   requestRedraw();
 }
 
@@ -356,6 +485,7 @@ template <typename T>
 std::shared_ptr<render::AttributeBuffer>
 ManagedBuffer<T>::getIndexedRenderAttributeBuffer(ManagedBuffer<uint32_t>& indices) {
   checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
+  if (sharedSource) return sharedSource->getIndexedRenderAttributeBuffer(indices);
 
   removeDeletedIndexedViews(); // periodic filtering
 
@@ -376,16 +506,31 @@ ManagedBuffer<T>::getIndexedRenderAttributeBuffer(ManagedBuffer<uint32_t>& indic
   }
 
   // We don't have it. Create a new one and return that.
-  ensureHostBufferPopulated();
   std::shared_ptr<render::AttributeBuffer> newBuffer = generateAttributeBuffer<T>(render::engine);
-  indices.ensureHostBufferPopulated();
-  std::vector<T> expandData = gather(data, indices.data);
-  newBuffer->setData(expandData); // initially populate
+  gatherIndexedView(indices, *newBuffer); // initially populate
   existingIndexedViews.emplace_back(&indices, newBuffer);
 
   return newBuffer;
 }
 
+template <typename T>
+void ManagedBuffer<T>::updateIndexedView(ManagedBuffer<uint32_t>& indices) {
+  checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
+  if (sharedSource) {
+    sharedSource->updateIndexedView(indices);
+    return;
+  }
+
+  for (std::tuple<render::ManagedBuffer<uint32_t>*, std::weak_ptr<render::AttributeBuffer>>& existingViewTup :
+       existingIndexedViews) {
+    std::shared_ptr<render::AttributeBuffer> viewBufferPtr = std::get<1>(existingViewTup).lock();
+    if (viewBufferPtr && std::get<0>(existingViewTup)->uniqueID == indices.uniqueID) {
+      gatherIndexedView(indices, *viewBufferPtr);
+      requestRedraw();
+    }
+  }
+}
+
 template <typename T>
 void ManagedBuffer<T>::updateIndexedViews() {
   checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
@@ -401,20 +546,34 @@ void ManagedBuffer<T>::updateIndexedViews() {
     // note: index buffer must still be alive here. we can't check it, you will just get memory errors
     // if it has been deleted
     render::ManagedBuffer<uint32_t>& indices = *std::get<0>(existingViewTup);
-    render::AttributeBuffer& viewBuffer = *viewBufferPtr;
 
     // apply the indexing and set the data
-    indices.ensureHostBufferPopulated();
-    std::vector<T> expandData = gather(data, indices.data);
-    viewBuffer.setData(expandData);
-
-    // TODO fornow, only CPU-side updating is supported. Add direct GPU-side support using the bufferIndexCopyProgram
-    // below.
+    gatherIndexedView(indices, *viewBufferPtr);
   }
 
   requestRedraw();
 }
 
+template <typename T>
+void ManagedBuffer<T>::gatherIndexedView(ManagedBuffer<uint32_t>& indices, render::AttributeBuffer& viewBuffer) {
+
+  // If the data is already on the device, try to do the gather there
+  // (not if either buffer is waiting on a deferred upload, the device would still have the old values)
+  if (renderAttributeBuffer && !hasPendingDeferredUpload() && !indices.hasPendingDeferredUpload() &&
+      render::engine->computeTierAvailable()) {
+    if (render::engine->computeGather(*renderAttributeBuffer, *indices.getRenderAttributeBuffer(), viewBuffer)) {
+      return;
+    }
+  }
+
+  // Otherwise, gather on the host
+  // (if the canonical data lives on the device, this reads it back to the host first)
+  ensureHostBufferPopulated();
+  indices.ensureHostBufferPopulated();
+  std::vector<T> expandData = gather(data, indices.data);
+  viewBuffer.setData(expandData);
+}
+
 template <typename T>
 void ManagedBuffer<T>::removeDeletedIndexedViews() {
   checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
@@ -429,8 +588,102 @@ void ManagedBuffer<T>::removeDeletedIndexedViews() {
       existingIndexedViews.end());
 }
 
+template <typename T>
+void ManagedBuffer<T>::shareFrom(ManagedBuffer<T>& source) {
+  checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
+  source.checkDeviceBufferTypeIs(DeviceBufferType::Attribute);
+  if (dataGetsComputed || source.dataGetsComputed) {
+    exception("cannot share values between ManagedBuffers " + name + " and " + source.name +
+              ", buffers whose values are computed cannot be shared");
+  }
+
+  // Always share from the buffer which actually holds the values
+  ManagedBuffer<T>* newSource = source.sharedSource ? source.sharedSource : &source;
+  if (newSource == this || newSource == sharedSource) return; // already sharing
+  if (!sharingBuffers.empty()) {
+    exception("ManagedBuffer " + name + " cannot share values from " + source.name +
+              ", other buffers are already sharing its own values");
+  }
+
+  // Stop sharing from the previous source, if any
+  if (sharedSource) {
+    std::vector<ManagedBuffer<T>*>& siblings = sharedSource->sharingBuffers;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+  }
+
+  // Release our own copy of the values, on the host and on the device
+  bool hadDeviceData = renderAttributeBuffer || !existingIndexedViews.empty();
+  cancelDeferredUpload();
+  std::vector<T>().swap(data);
+  hostBufferIsPopulated = false;
+  renderAttributeBuffer.reset();
+  existingIndexedViews.clear();
+
+  sharedSource = newSource;
+  newSource->sharingBuffers.push_back(this);
+
+  // any shader programs which were already drawing from our own buffers need to be rebuilt
+  if (hadDeviceData) {
+    refresh();
+  }
+  requestRedraw();
+}
+
+template <typename T>
+void ManagedBuffer<T>::notifySharingBuffers() {
+  ManagedBuffer<T>& owner = sharedSource ? *sharedSource : *this;
+
+  // (everyone but this buffer, whose owner made the update and already knows about it)
+  if (&owner != this && owner.registry) {
+    owner.registry->sharedBufferUpdated(owner.name);
+  }
+  for (ManagedBuffer<T>* other : owner.sharingBuffers) {
+    if (other != this && other->registry) {
+      other->registry->sharedBufferUpdated(other->name);
+    }
+  }
+}
+
+template <typename T>
+void ManagedBuffer<T>::handOverSharedValues() {
+  ManagedBuffer<T>& heir = *sharingBuffers.front();
+  bool uploadPending = render::engine && render::engine->uploadScheduler.isPending(this);
+
+  // NOTE: the indexed views are handed over too, since the sharing buffers' programs draw from them. Some of them may
+  // be keyed on index buffers which are being deleted along with our owner, but their views are deleted with it too,
+  // and are filtered out before the keys are ever used again.
+  removeDeletedIndexedViews();
+
+  heir.sharedSource = nullptr;
+  heir.data.swap(data);
+  heir.hostBufferIsPopulated = hostBufferIsPopulated;
+  heir.dataVersion = dataVersion;
+  heir.renderAttributeBuffer = renderAttributeBuffer;
+  heir.existingIndexedViews = existingIndexedViews;
+
+  for (size_t i = 1; i < sharingBuffers.size(); i++) {
+    sharingBuffers[i]->sharedSource = &heir;
+    heir.sharingBuffers.push_back(sharingBuffers[i]);
+  }
+  sharingBuffers.clear();
+
+  // (not applied right away, our owner is in the middle of being deleted)
+  if (uploadPending) {
+    render::engine->uploadScheduler.enqueue(&heir, heir.registry, heir.data.size() * sizeof(T),
+                                            [&heir]() { heir.uploadHostBufferToDevice(); });
+  }
+}
+
+template <typename T>
+void ManagedBuffer<T>::cancelDeferredUpload() {
+  if (render::engine) {
+    render::engine->uploadScheduler.cancel(this);
+  }
+}
+
 template <typename T>
 void ManagedBuffer<T>::invalidateHostBuffer() {
+  cancelDeferredUpload(); // the host data is no longer the newest
   hostBufferIsPopulated = false;
   data.clear();
 }
@@ -481,22 +734,6 @@ typename ManagedBuffer<T>::CanonicalDataSource ManagedBuffer<T>::currentCanonica
 }
 
 
-template <typename T>
-void ManagedBuffer<T>::ensureHaveBufferIndexCopyProgram() {
-  if (bufferIndexCopyProgram) return;
-
-  // sanity check
-  if (!renderAttributeBuffer) exception("ManagedBuffer " + name + " asked to copy indices, but has no buffers");
-
-  // TODO allocate the transform feedback program
-}
-
-template <typename T>
-void ManagedBuffer<T>::invokeBufferIndexCopyProgram() {
-  ensureHaveBufferIndexCopyProgram();
-  bufferIndexCopyProgram->draw();
-}
-
 // === Interact with the buffer registry
 
 std::tuple<bool, ManagedBufferType> ManagedBufferRegistry::hasManagedBufferType(std::string name) {
@@ -29,6 +29,11 @@
 
 #include "stb_image.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
 namespace polyscope {
 namespace render {
 namespace backend_openGL_mock {
@@ -54,6 +59,13 @@ void checkGLError(bool fatal = true) {}
 GLAttributeBuffer::GLAttributeBuffer(RenderDataType dataType_, int arrayCount_)
     : AttributeBuffer(dataType_, arrayCount_) {}
 
+GLAttributeBuffer::GLAttributeBuffer(RenderDataType dataType_, int arrayCount_, int64_t dataSize_)
+    : AttributeBuffer(dataType_, arrayCount_) {
+  setFlag = true;
+  dataSize = dataSize_;
+  bufferSize = dataSize_;
+}
+
 GLAttributeBuffer::~GLAttributeBuffer() { bind(); }
 
 void GLAttributeBuffer::bind() {}
@@ -87,6 +99,8 @@ void GLAttributeBuffer::setData_helper(const std::vector<T>& data) {
 
   // do the actual copy
   dataSize = data.size();
+  storedBytes.resize(data.size() * sizeof(T));
+  if (!data.empty()) std::memcpy(&storedBytes.front(), &data.front(), storedBytes.size());
 
   checkGLError();
 }
@@ -173,6 +187,7 @@ T GLAttributeBuffer::getData_helper(size_t ind) {
   if (!isSet() || ind >= static_cast<size_t>(getDataSize() * getArrayCount())) exception("bad getData");
   bind();
   T readValue{};
+  if ((ind + 1) * sizeof(T) <= storedBytes.size()) std::memcpy(&readValue, &storedBytes[ind * sizeof(T)], sizeof(T));
   return readValue;
 }
 
@@ -223,6 +238,9 @@ std::vector<T> GLAttributeBuffer::getDataRange_helper(size_t start, size_t count
   if (!isSet() || start + count > static_cast<size_t>(getDataSize() * getArrayCount())) exception("bad getData");
   bind();
   std::vector<T> readValues(count);
+  if (count > 0 && (start + count) * sizeof(T) <= storedBytes.size()) {
+    std::memcpy(&readValues.front(), &storedBytes[start * sizeof(T)], count * sizeof(T));
+  }
   return readValues;
 }
 
@@ -277,6 +295,13 @@ std::vector<glm::uvec4> GLAttributeBuffer::getDataRange_uvec4(size_t start, size
 
 uint32_t GLAttributeBuffer::getNativeBufferID() { return 777; }
 
+void GLAttributeBuffer::setStoredBytes(const std::vector<unsigned char>& bytes, int64_t newDataSize) {
+  setFlag = true;
+  dataSize = newDataSize;
+  bufferSize = std::max(bufferSize, static_cast<uint64_t>(newDataSize));
+  storedBytes = bytes;
+}
+
 // =============================================================
 // ==================== Texture buffer =========================
 // =============================================================
@@ -334,6 +359,10 @@ GLTextureBuffer::GLTextureBuffer(TextureFormat format_, unsigned int sizeX_, uns
   setFilterMode(FilterMode::Nearest);
 }
 
+GLTextureBuffer::GLTextureBuffer(TextureFormat format_, int dim_, unsigned int sizeX_, unsigned int sizeY_,
+                                 unsigned int sizeZ_)
+    : TextureBuffer(dim_, format_, sizeX_, sizeY_, sizeZ_) {}
+
 GLTextureBuffer::~GLTextureBuffer() {}
 
 void GLTextureBuffer::resize(unsigned int newLen) {
@@ -461,6 +490,22 @@ void GLTextureBuffer::setData(const std::vector<std::array<glm::vec3, 2>>& data)
 void GLTextureBuffer::setData(const std::vector<std::array<glm::vec3, 3>>& data) { exception("not implemented"); };
 void GLTextureBuffer::setData(const std::vector<std::array<glm::vec3, 4>>& data) { exception("not implemented"); };
 
+void GLTextureBuffer::setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX,
+                                      unsigned int regionY, const float* data) {
+  if (dim != 2) exception("OpenGL error: texture region updates are only supported for 2D textures");
+  if (xOffset + regionX > sizeX || yOffset + regionY > sizeY) {
+    exception("OpenGL error: texture region is out of bounds.");
+  }
+}
+
+void GLTextureBuffer::setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX,
+                                      unsigned int regionY, const unsigned char* data) {
+  if (dim != 2) exception("OpenGL error: texture region updates are only supported for 2D textures");
+  if (xOffset + regionX > sizeX || yOffset + regionY > sizeY) {
+    exception("OpenGL error: texture region is out of bounds.");
+  }
+}
+
 void GLTextureBuffer::setFilterMode(FilterMode newMode) {
 
   bind();
@@ -658,6 +703,23 @@ float GLFrameBuffer::readDepth(int xPos, int yPos) {
   return result;
 }
 
+std::vector<float> GLFrameBuffer::readFloat4Region(int xStart, int yStart, int sizeX, int sizeY) {
+  // Clamp to the buffer
+  int xEnd = std::min(xStart + sizeX, static_cast<int>(getSizeX()));
+  int yEnd = std::min(yStart + sizeY, static_cast<int>(getSizeY()));
+  xStart = std::max(xStart, 0);
+  yStart = std::max(yStart, 0);
+  if (xEnd <= xStart || yEnd <= yStart) return {};
+
+  // Read from the buffer (same value as readFloat4() at every pixel)
+  std::vector<float> result;
+  for (int i = 0; i < (xEnd - xStart) * (yEnd - yStart); i++) {
+    result.insert(result.end(), {1., 2., 3., 4.});
+  }
+
+  return result;
+}
+
 std::vector<unsigned char> GLFrameBuffer::readBuffer() {
   bind();
 
@@ -1574,6 +1636,9 @@ void MockGLEngine::initialize() {
   updateWindowSize();
 
   populateDefaultShadersAndRules();
+
+  // (the compute tier is emulated on the host, so the device-side code paths get exercised in tests)
+  computeTierSupported = true;
 }
 
 void MockGLEngine::initializeImGui() {
@@ -1686,6 +1751,68 @@ void MockGLEngine::setFrontFaceCCW(bool newVal) {
 // == Factories
 
 
+bool MockGLEngine::computeRange(AttributeBuffer& values, float& minOut, float& maxOut) {
+  if (!computeTierAvailable()) return false;
+  if (values.getType() != RenderDataType::Float || values.getArrayCount() != 1 || !values.isSet()) return false;
+  size_t N = values.getDataSize();
+
+  minOut = std::numeric_limits<float>::infinity();
+  maxOut = -std::numeric_limits<float>::infinity();
+  if (N == 0) return true;
+
+  for (float v : values.getDataRange_float(0, N)) {
+    if (std::isfinite(v)) {
+      minOut = std::min(minOut, v);
+      maxOut = std::max(maxOut, v);
+    }
+  }
+  return true;
+}
+
+bool MockGLEngine::computeHistogram(AttributeBuffer& values, float rangeMin, float rangeMax, size_t nBins,
+                                    std::vector<uint32_t>& countsOut) {
+  if (!computeTierAvailable()) return false;
+  if (values.getType() != RenderDataType::Float || values.getArrayCount() != 1 || !values.isSet()) return false;
+  if (nBins == 0 || nBins > 256 || !(rangeMax > rangeMin)) return false; // (256 = openGL workgroup size)
+  size_t N = values.getDataSize();
+
+  countsOut = std::vector<uint32_t>(nBins, 0);
+  if (N == 0) return true;
+
+  float binScale = static_cast<float>(nBins) / (rangeMax - rangeMin);
+  for (float v : values.getDataRange_float(0, N)) {
+    if (std::isnan(v)) continue;
+    float iBinF = std::min(std::max((v - rangeMin) * binScale, 0.f), static_cast<float>(nBins) - 1.f);
+    countsOut[static_cast<size_t>(std::floor(iBinF))]++;
+  }
+  return true;
+}
+
+bool MockGLEngine::computeGather(AttributeBuffer& source, AttributeBuffer& indices, AttributeBuffer& target) {
+  if (!computeTierAvailable()) return false;
+  if (source.getType() != target.getType() || source.getArrayCount() != target.getArrayCount()) return false;
+  if (indices.getType() != RenderDataType::UInt || indices.getArrayCount() != 1) return false;
+  if (!source.isSet() || !indices.isSet() || indices.getDataSize() == 0) return false;
+  GLAttributeBuffer& mockSource = dynamic_cast<GLAttributeBuffer&>(source);
+  GLAttributeBuffer& mockTarget = dynamic_cast<GLAttributeBuffer&>(target);
+
+  size_t entryBytes = sizeInBytes(source.getType()) * source.getArrayCount();
+  if (entryBytes % 4 != 0) return false; // (the openGL version copies 32-bit words)
+  size_t N = indices.getDataSize();
+
+  const std::vector<unsigned char>& sourceBytes = mockSource.getStoredBytes();
+  std::vector<unsigned char> targetBytes(N * entryBytes, 0);
+  std::vector<uint32_t> inds = indices.getDataRange_uint32(0, N);
+  for (size_t i = 0; i < N; i++) {
+    size_t offset = static_cast<size_t>(inds[i]) * entryBytes;
+    if (offset + entryBytes > sourceBytes.size()) continue; // (left as zeros, like the openGL version)
+    std::memcpy(&targetBytes[i * entryBytes], &sourceBytes[offset], entryBytes);
+  }
+  mockTarget.setStoredBytes(targetBytes, N);
+
+  return true;
+}
+
 std::shared_ptr<AttributeBuffer> MockGLEngine::generateAttributeBuffer(RenderDataType dataType_, int arrayCount_) {
   GLAttributeBuffer* newA = new GLAttributeBuffer(dataType_, arrayCount_);
   return std::shared_ptr<AttributeBuffer>(newA);
@@ -1726,6 +1853,19 @@ std::shared_ptr<TextureBuffer> MockGLEngine::generateTextureBuffer(TextureFormat
 }
 
 
+std::shared_ptr<AttributeBuffer> MockGLEngine::wrapNativeAttributeBuffer(RenderDataType dataType_, int arrayCount_,
+                                                                         uint32_t nativeID, int64_t dataSize) {
+  GLAttributeBuffer* newA = new GLAttributeBuffer(dataType_, arrayCount_, dataSize);
+  return std::shared_ptr<AttributeBuffer>(newA);
+}
+
+std::shared_ptr<TextureBuffer> MockGLEngine::wrapNativeTextureBuffer(TextureFormat format, int dim, uint32_t nativeID,
+                                                                     unsigned int sizeX_, unsigned int sizeY_,
+                                                                     unsigned int sizeZ_) {
+  GLTextureBuffer* newT = new GLTextureBuffer(format, dim, sizeX_, sizeY_, sizeZ_);
+  return std::shared_ptr<TextureBuffer>(newT);
+}
+
 std::shared_ptr<RenderBuffer> MockGLEngine::generateRenderBuffer(RenderBufferType type, unsigned int sizeX_,
                                                                  unsigned int sizeY_) {
   GLRenderBuffer* newR = new GLRenderBuffer(type, sizeX_, sizeY_);
@@ -1895,9 +2035,12 @@ void MockGLEngine::populateDefaultShadersAndRules() {
   registerShaderProgram("SIMPLE_MESH", {SIMPLE_MESH_VERT_SHADER, SIMPLE_MESH_FRAG_SHADER}, DrawMode::IndexedTriangles);
   registerShaderProgram("SLICE_TETS", {SLICE_TETS_VERT_SHADER, SLICE_TETS_GEOM_SHADER, SLICE_TETS_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("RAYCAST_SPHERE", {FLEX_SPHERE_VERT_SHADER, FLEX_SPHERE_GEOM_SHADER, FLEX_SPHERE_FRAG_SHADER}, DrawMode::Points);
+  registerShaderProgram("RAYCAST_SPHERE_DEPTH", {FLEX_SPHERE_VERT_SHADER, FLEX_SPHERE_GEOM_SHADER, FLEX_SPHERE_DEPTH_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("POINT_QUAD", {FLEX_POINTQUAD_VERT_SHADER, FLEX_POINTQUAD_GEOM_SHADER, FLEX_POINTQUAD_FRAG_SHADER}, DrawMode::Points);
+  registerShaderProgram("POINT_PIXEL", {FLEX_POINTQUAD_VERT_SHADER, FLEX_POINTPIXEL_GEOM_SHADER, FLEX_POINTPIXEL_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("GRIDCUBE", {FLEX_GRIDCUBE_VERT_SHADER, FLEX_GRIDCUBE_GEOM_SHADER, FLEX_GRIDCUBE_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("GRIDCUBE_PLANE", {FLEX_GRIDCUBE_PLANE_VERT_SHADER, FLEX_GRIDCUBE_PLANE_FRAG_SHADER}, DrawMode::Triangles);
+  registerShaderProgram("GRIDCUBE_RAYCAST", {FLEX_GRIDCUBE_RAYCAST_VERT_SHADER, FLEX_GRIDCUBE_RAYCAST_FRAG_SHADER}, DrawMode::Triangles);
   registerShaderProgram("RAYCAST_VECTOR", {FLEX_VECTOR_VERT_SHADER, FLEX_VECTOR_GEOM_SHADER, FLEX_VECTOR_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("RAYCAST_SCALE", {FLEX_VECTOR_VERT_SHADER, FLEX_VECTOR_GEOM_SHADER, FLEX_SCALE_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("RAYCAST_TANGENT_VECTOR", {FLEX_TANGENT_VECTOR_VERT_SHADER, FLEX_VECTOR_GEOM_SHADER, FLEX_VECTOR_FRAG_SHADER}, DrawMode::Points);
@@ -1919,6 +2062,7 @@ void MockGLEngine::populateDefaultShadersAndRules() {
   registerShaderProgram("COMPOSITE_PEEL", {TEXTURE_DRAW_VERT_SHADER, COMPOSITE_PEEL}, DrawMode::Triangles);
   registerShaderProgram("DEPTH_COPY", {TEXTURE_DRAW_VERT_SHADER, DEPTH_COPY}, DrawMode::Triangles);
   registerShaderProgram("DEPTH_TO_MASK", {TEXTURE_DRAW_VERT_SHADER, DEPTH_TO_MASK}, DrawMode::Triangles);
+  registerShaderProgram("PICK_HIGHLIGHT", {TEXTURE_DRAW_VERT_SHADER, PICK_HIGHLIGHT}, DrawMode::Triangles);
   registerShaderProgram("SCALAR_TEXTURE_COLORMAP", {TEXTURE_DRAW_VERT_SHADER, SCALAR_TEXTURE_COLORMAP}, DrawMode::Triangles);
   registerShaderProgram("BLUR_RGB", {TEXTURE_DRAW_VERT_SHADER, BLUR_RGB}, DrawMode::Triangles);
   registerShaderProgram("TRANSFORMATION_GIZMO_ROT", {TRANSFORMATION_GIZMO_ROT_VERT, TRANSFORMATION_GIZMO_ROT_FRAG}, DrawMode::Triangles);
@@ -1935,6 +2079,7 @@ void MockGLEngine::populateDefaultShadersAndRules() {
   
   registerShaderRule("TRANSPARENCY_STRUCTURE", TRANSPARENCY_STRUCTURE);
   registerShaderRule("TRANSPARENCY_RESOLVE_SIMPLE", TRANSPARENCY_RESOLVE_SIMPLE);
+  registerShaderRule("EYE_DOME_LIGHTING", EYE_DOME_LIGHTING);
   registerShaderRule("TRANSPARENCY_PEEL_STRUCTURE", TRANSPARENCY_PEEL_STRUCTURE);
   registerShaderRule("TRANSPARENCY_PEEL_GROUND", TRANSPARENCY_PEEL_GROUND);
   
@@ -1942,6 +2087,11 @@ void MockGLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("COMPUTE_SHADE_NORMAL_FROM_POSITION", COMPUTE_SHADE_NORMAL_FROM_POSITION);
   registerShaderRule("PREMULTIPLY_LIT_COLOR", PREMULTIPLY_LIT_COLOR);
   registerShaderRule("CULL_POS_FROM_VIEW", CULL_POS_FROM_VIEW);
+  registerShaderRule("ELEMENT_MASK_PROPAGATE_GEOM", ELEMENT_MASK_PROPAGATE_GEOM);
+  registerShaderRule("ELEMENT_MASK_PROPAGATE_MESH", ELEMENT_MASK_PROPAGATE_MESH);
+  registerShaderRule("ELEMENT_MASK_SHADE_RAYCAST", ELEMENT_MASK_SHADE_RAYCAST);
+  registerShaderRule("ELEMENT_MASK_SHADE_FLAT", ELEMENT_MASK_SHADE_FLAT);
+  registerShaderRule("ELEMENT_MASK_SHADE_MESH", ELEMENT_MASK_SHADE_MESH);
   registerShaderRule("PROJ_AND_INV_PROJ_MAT", PROJ_AND_INV_PROJ_MAT);
 
   // Lighting and shading things
@@ -1970,6 +2120,9 @@ void MockGLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("TEXTURE_SHADE_COLORALPHA", TEXTURE_SHADE_COLORALPHA);
   registerShaderRule("TEXTURE_PROPAGATE_VALUE", TEXTURE_PROPAGATE_VALUE);
   registerShaderRule("TEXTURE_PROPAGATE_COLOR", TEXTURE_PROPAGATE_COLOR);
+  registerShaderRule("VIRTUAL_TEXTURE_LOOKUP", VIRTUAL_TEXTURE_LOOKUP);
+  registerShaderRule("VIRTUAL_TEXTURE_PROPAGATE_VALUE", VIRTUAL_TEXTURE_PROPAGATE_VALUE);
+  registerShaderRule("VIRTUAL_TEXTURE_PROPAGATE_COLOR", VIRTUAL_TEXTURE_PROPAGATE_COLOR);
   registerShaderRule("TEXTURE_BILLBOARD_FROM_UNIFORMS", TEXTURE_BILLBOARD_FROM_UNIFORMS);
   registerShaderRule("SHADE_NORMAL_FROM_TEXTURE", SHADE_NORMAL_FROM_TEXTURE);
   registerShaderRule("SHADE_NORMAL_FROM_VIEWPOS_VAR", SHADE_NORMAL_FROM_VIEWPOS_VAR);
@@ -1977,6 +2130,7 @@ void MockGLEngine::populateDefaultShadersAndRules() {
   // mesh things
   registerShaderRule("MESH_WIREFRAME", MESH_WIREFRAME);
   registerShaderRule("MESH_WIREFRAME_FROM_BARY", MESH_WIREFRAME_FROM_BARY);
+  registerShaderRule("MESH_WIREFRAME_FROM_BARY_ALL_REAL", MESH_WIREFRAME_FROM_BARY_ALL_REAL);
   registerShaderRule("MESH_WIREFRAME_ONLY", MESH_WIREFRAME_ONLY);
   registerShaderRule("MESH_BACKFACE_NORMAL_FLIP", MESH_BACKFACE_NORMAL_FLIP);
   registerShaderRule("MESH_BACKFACE_DIFFERENT", MESH_BACKFACE_DIFFERENT);
@@ -2022,6 +2176,7 @@ void MockGLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("CYLINDER_PROPAGATE_PICK", CYLINDER_PROPAGATE_PICK);
   registerShaderRule("CYLINDER_CULLPOS_FROM_MID", CYLINDER_CULLPOS_FROM_MID);
   registerShaderRule("CYLINDER_VARIABLE_SIZE", CYLINDER_VARIABLE_SIZE);
+  registerShaderRule("CYLINDER_THIN_AS_LINE", CYLINDER_THIN_AS_LINE);
 
   // marching tets things
   registerShaderRule("SLICE_TETS_BASECOLOR_SHADE", SLICE_TETS_BASECOLOR_SHADE);
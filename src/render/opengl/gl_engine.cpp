@@ -14,6 +14,7 @@
 
 // all the shaders
 #include "polyscope/render/opengl/shaders/common.h"
+#include "polyscope/render/opengl/shaders/compute_shaders.h"
 #include "polyscope/render/opengl/shaders/cylinder_shaders.h"
 #include "polyscope/render/opengl/shaders/gizmo_shaders.h"
 #include "polyscope/render/opengl/shaders/grid_shaders.h"
@@ -31,6 +32,8 @@
 #include "stb_image.h"
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
 #include <set>
 
 namespace polyscope {
@@ -40,6 +43,46 @@ namespace backend_openGL3 {
 
 GLEngine* glEngine = nullptr; // alias for global engine pointer
 
+// == Optional compute tier
+// The loader only covers openGL 3.3, so the handful of 4.3 enums and entry points used for compute are declared here,
+// and loaded at runtime by GLEngine::initializeComputeTier() if the context supports them.
+
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
+#define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x00000001
+#endif
+#ifndef GL_BUFFER_UPDATE_BARRIER_BIT
+#define GL_BUFFER_UPDATE_BARRIER_BIT 0x00000200
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+
+#ifdef _WIN32
+#define POLYSCOPE_GL_APIENTRY __stdcall
+#else
+#define POLYSCOPE_GL_APIENTRY
+#endif
+
+namespace {
+typedef void(POLYSCOPE_GL_APIENTRY* DispatchComputeProc)(GLuint, GLuint, GLuint);
+typedef void(POLYSCOPE_GL_APIENTRY* MemoryBarrierProc)(GLbitfield);
+DispatchComputeProc dispatchComputeFunc = nullptr;
+MemoryBarrierProc memoryBarrierFunc = nullptr;
+
+// Number of workgroups to launch for a grid-stride loop over N entries. Large inputs get fewer groups than entries,
+// with each invocation processing multiple entries.
+GLuint computeGroupCount(size_t N) {
+  size_t nGroups = (N + COMPUTE_WORKGROUP_SIZE - 1) / COMPUTE_WORKGROUP_SIZE;
+  return static_cast<GLuint>(std::max(std::min(nGroups, static_cast<size_t>(1024)), static_cast<size_t>(1)));
+}
+} // namespace
+
 // == Map enums to native values
 
 // clang-format off
@@ -56,6 +99,7 @@ inline GLenum internalFormat(const TextureFormat& x) {
     case TextureFormat::RGB32F:     return GL_RGBA32F;
     case TextureFormat::RGBA32F:    return GL_RGBA32F;
     case TextureFormat::DEPTH24:    return GL_DEPTH_COMPONENT24;
+    case TextureFormat::R8:         return GL_R8;
   }
   exception("bad enum");
   return GL_RGB8;
@@ -73,6 +117,7 @@ inline GLenum formatF(const TextureFormat& x) {
     case TextureFormat::RGB32F:     return GL_RGB;
     case TextureFormat::RGBA32F:    return GL_RGBA;
     case TextureFormat::DEPTH24:    return GL_DEPTH_COMPONENT;
+    case TextureFormat::R8:         return GL_RED;
   }
   exception("bad enum");
   return GL_RGB;
@@ -90,6 +135,7 @@ inline GLenum type(const TextureFormat& x) {
     case TextureFormat::RGB32F:     return GL_FLOAT;
     case TextureFormat::RGBA32F:    return GL_FLOAT;
     case TextureFormat::DEPTH24:    return GL_FLOAT;
+    case TextureFormat::R8:         return GL_UNSIGNED_BYTE;
   }
   exception("bad enum");
   return GL_UNSIGNED_BYTE;
@@ -99,7 +145,7 @@ inline GLenum native(const ShaderStageType& x) {
   switch (x) {
     case ShaderStageType::Vertex:           return GL_VERTEX_SHADER;
     case ShaderStageType::Geometry:         return GL_GEOMETRY_SHADER;
-    //case ShaderStageType::Compute:          return GL_COMPUTE_SHADER;
+    case ShaderStageType::Compute:          return GL_COMPUTE_SHADER;
     case ShaderStageType::Fragment:         return GL_FRAGMENT_SHADER;
   }
   exception("bad enum");
@@ -225,13 +271,52 @@ GLAttributeBuffer::GLAttributeBuffer(RenderDataType dataType_, int arrayCount_)
   glGenBuffers(1, &VBOLoc);
 }
 
-GLAttributeBuffer::~GLAttributeBuffer() {
+GLAttributeBuffer::GLAttributeBuffer(RenderDataType dataType_, int arrayCount_, VertexBufferHandle externalHandle,
+                                     int64_t dataSize_)
+    : AttributeBuffer(dataType_, arrayCount_), VBOLoc(externalHandle), ownsHandle(false) {
+
+  if (!glIsBuffer(VBOLoc)) exception("OpenGL error: " + std::to_string(VBOLoc) + " is not a buffer object");
+
+  // make sure the external buffer is actually big enough to hold the data we were told it holds
   bind();
-  glDeleteBuffers(1, &VBOLoc);
+  GLint64 allocatedBytes = 0;
+  glGetBufferParameteri64v(getTarget(), GL_BUFFER_SIZE, &allocatedBytes);
+  checkGLError();
+  int64_t entryBytes = sizeInBytes(dataType) * arrayCount;
+  if (dataSize_ < 0 || dataSize_ * entryBytes > allocatedBytes) {
+    exception("OpenGL error: external buffer object holds " + std::to_string(allocatedBytes) +
+              " bytes, which is too small for " + std::to_string(dataSize_) + " entries");
+  }
+
+  setFlag = true;
+  dataSize = dataSize_;
+  bufferSize = allocatedBytes / entryBytes;
+}
+
+GLAttributeBuffer::~GLAttributeBuffer() {
+  if (ownsHandle) {
+    bind();
+    glDeleteBuffers(1, &VBOLoc);
+  }
 }
 
 void GLAttributeBuffer::bind() { glBindBuffer(getTarget(), VBOLoc); }
 
+void GLAttributeBuffer::allocate(int64_t newDataSize) {
+  bind();
+
+  int64_t entryBytes = sizeInBytes(dataType) * arrayCount;
+  if (!isSet() || static_cast<uint64_t>(newDataSize) > bufferSize) {
+    setFlag = true;
+    uint64_t newSize = std::max(static_cast<uint64_t>(newDataSize), static_cast<uint64_t>(1));
+    glBufferData(getTarget(), newSize * entryBytes, NULL, GL_STATIC_DRAW);
+    bufferSize = newSize;
+  }
+  dataSize = newDataSize;
+
+  checkGLError();
+}
+
 void GLAttributeBuffer::checkType(RenderDataType targetType) {
   if (dataType != targetType) {
     throw std::invalid_argument("Tried to set GLAttributeBuffer with wrong type. Actual type: " +
@@ -536,7 +621,33 @@ GLTextureBuffer::GLTextureBuffer(TextureFormat format_, unsigned int sizeX_, uns
   setFilterMode(FilterMode::Nearest);
 }
 
-GLTextureBuffer::~GLTextureBuffer() { glDeleteTextures(1, &handle); }
+GLTextureBuffer::GLTextureBuffer(TextureFormat format_, int dim_, TextureBufferHandle externalHandle,
+                                 unsigned int sizeX_, unsigned int sizeY_, unsigned int sizeZ_)
+    : TextureBuffer(dim_, format_, sizeX_, sizeY_, sizeZ_), handle(externalHandle), ownsHandle(false) {
+
+  if (!glIsTexture(handle)) exception("OpenGL error: " + std::to_string(handle) + " is not a texture object");
+
+  // make sure the external texture matches the dimensions we were told it has
+  bind();
+  GLint texX = 0, texY = 0, texZ = 0;
+  glGetTexLevelParameteriv(textureType(), 0, GL_TEXTURE_WIDTH, &texX);
+  glGetTexLevelParameteriv(textureType(), 0, GL_TEXTURE_HEIGHT, &texY);
+  glGetTexLevelParameteriv(textureType(), 0, GL_TEXTURE_DEPTH, &texZ);
+  checkGLError();
+  bool sizeMatches = static_cast<unsigned int>(texX) == sizeX;
+  if (dim > 1) sizeMatches = sizeMatches && static_cast<unsigned int>(texY) == sizeY;
+  if (dim > 2) sizeMatches = sizeMatches && static_cast<unsigned int>(texZ) == sizeZ;
+  if (!sizeMatches) {
+    exception("OpenGL error: external texture has size " + std::to_string(texX) + "x" + std::to_string(texY) + "x" +
+              std::to_string(texZ) + ", which does not match the expected size");
+  }
+}
+
+GLTextureBuffer::~GLTextureBuffer() {
+  if (ownsHandle) {
+    glDeleteTextures(1, &handle);
+  }
+}
 
 void GLTextureBuffer::resize(unsigned int newLen) {
 
@@ -685,6 +796,32 @@ void GLTextureBuffer::setData(const std::vector<std::array<glm::vec3, 2>>& data)
 void GLTextureBuffer::setData(const std::vector<std::array<glm::vec3, 3>>& data) { exception("not implemented"); };
 void GLTextureBuffer::setData(const std::vector<std::array<glm::vec3, 4>>& data) { exception("not implemented"); };
 
+void GLTextureBuffer::setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX,
+                                      unsigned int regionY, const float* data) {
+  if (dim != 2) exception("OpenGL error: texture region updates are only supported for 2D textures");
+  if (xOffset + regionX > sizeX || yOffset + regionY > sizeY) {
+    exception("OpenGL error: texture region is out of bounds.");
+  }
+
+  bind();
+  glTexSubImage2D(GL_TEXTURE_2D, 0, xOffset, yOffset, regionX, regionY, formatF(format), GL_FLOAT, data);
+  checkGLError();
+}
+
+void GLTextureBuffer::setDataRegion2D(unsigned int xOffset, unsigned int yOffset, unsigned int regionX,
+                                      unsigned int regionY, const unsigned char* data) {
+  if (dim != 2) exception("OpenGL error: texture region updates are only supported for 2D textures");
+  if (xOffset + regionX > sizeX || yOffset + regionY > sizeY) {
+    exception("OpenGL error: texture region is out of bounds.");
+  }
+
+  bind();
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // rows of bytes are not necessarily 4-aligned
+  glTexSubImage2D(GL_TEXTURE_2D, 0, xOffset, yOffset, regionX, regionY, formatF(format), GL_UNSIGNED_BYTE, data);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  checkGLError();
+}
+
 
 void GLTextureBuffer::setFilterMode(FilterMode newMode) {
 
@@ -820,6 +957,18 @@ GLFrameBuffer::~GLFrameBuffer() {
   if (handle != 0) {
     glDeleteFramebuffers(1, &handle);
   }
+  if (asyncReadFence != nullptr) {
+    glDeleteSync(asyncReadFence);
+  }
+  if (asyncReadPBO != 0) {
+    glDeleteBuffers(1, &asyncReadPBO);
+  }
+  if (asyncRegionReadFence != nullptr) {
+    glDeleteSync(asyncRegionReadFence);
+  }
+  if (asyncRegionReadPBO != 0) {
+    glDeleteBuffers(1, &asyncRegionReadPBO);
+  }
 }
 
 void GLFrameBuffer::bind() {
@@ -985,6 +1134,26 @@ float GLFrameBuffer::readDepth(int xPos, int yPos) {
   return result;
 }
 
+std::vector<float> GLFrameBuffer::readFloat4Region(int xStart, int yStart, int sizeX, int sizeY) {
+
+  // Clamp to the buffer
+  int xEnd = std::min(xStart + sizeX, static_cast<int>(getSizeX()));
+  int yEnd = std::min(yStart + sizeY, static_cast<int>(getSizeY()));
+  xStart = std::max(xStart, 0);
+  yStart = std::max(yStart, 0);
+  if (xEnd <= xStart || yEnd <= yStart) return {};
+
+  glFlush();
+  glFinish();
+  bind();
+
+  // Read from the buffer
+  std::vector<float> result(4 * (xEnd - xStart) * (yEnd - yStart));
+  glReadPixels(xStart, yStart, xEnd - xStart, yEnd - yStart, GL_RGBA, GL_FLOAT, &result.front());
+
+  return result;
+}
+
 std::vector<unsigned char> GLFrameBuffer::readBuffer() {
 
   glFlush();
@@ -1003,6 +1172,126 @@ std::vector<unsigned char> GLFrameBuffer::readBuffer() {
   return buff;
 }
 
+void GLFrameBuffer::beginAsyncReadBuffer() {
+
+  bind();
+
+  int w = getSizeX();
+  int h = getSizeY();
+  asyncReadSize = w * h * 4;
+
+  if (asyncReadPBO == 0) {
+    glGenBuffers(1, &asyncReadPBO);
+  }
+  if (asyncReadFence != nullptr) {
+    glDeleteSync(asyncReadFence);
+    asyncReadFence = nullptr;
+  }
+
+  // With a pack buffer bound, glReadPixels() returns right away and the copy happens on the device
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, asyncReadPBO);
+  glBufferData(GL_PIXEL_PACK_BUFFER, asyncReadSize, nullptr, GL_STREAM_READ);
+  glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  asyncReadFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  checkGLError();
+
+  asyncReadPending = true;
+}
+
+bool GLFrameBuffer::finishAsyncReadBuffer(std::vector<unsigned char>& out, bool wait) {
+  if (!asyncReadPending) return false;
+
+  GLuint64 timeoutNanosec = wait ? 1000000000ull : 0;
+  GLenum status = glClientWaitSync(asyncReadFence, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNanosec);
+  if (status == GL_TIMEOUT_EXPIRED) {
+    return false;
+  }
+  if (status == GL_WAIT_FAILED) {
+    exception("async framebuffer read failed");
+  }
+
+  glDeleteSync(asyncReadFence);
+  asyncReadFence = nullptr;
+  asyncReadPending = false;
+
+  out.resize(asyncReadSize);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, asyncReadPBO);
+  void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, asyncReadSize, GL_MAP_READ_BIT);
+  if (mapped != nullptr) {
+    std::memcpy(&out.front(), mapped, asyncReadSize);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  checkGLError();
+
+  return mapped != nullptr;
+}
+
+void GLFrameBuffer::beginAsyncReadFloat4Region(int xStart, int yStart, int sizeX, int sizeY) {
+
+  // Clamp to the buffer
+  int xEnd = std::min(xStart + sizeX, static_cast<int>(getSizeX()));
+  int yEnd = std::min(yStart + sizeY, static_cast<int>(getSizeY()));
+  xStart = std::max(xStart, 0);
+  yStart = std::max(yStart, 0);
+
+  if (asyncRegionReadFence != nullptr) {
+    glDeleteSync(asyncRegionReadFence);
+    asyncRegionReadFence = nullptr;
+  }
+  asyncRegionReadPending = true;
+  asyncRegionReadSize = (xEnd > xStart && yEnd > yStart) ? 4 * (xEnd - xStart) * (yEnd - yStart) : 0;
+  if (asyncRegionReadSize == 0) return;
+
+  bind();
+  if (asyncRegionReadPBO == 0) {
+    glGenBuffers(1, &asyncRegionReadPBO);
+  }
+
+  // As in beginAsyncReadBuffer(), the copy in to the pack buffer happens on the device
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, asyncRegionReadPBO);
+  glBufferData(GL_PIXEL_PACK_BUFFER, asyncRegionReadSize * sizeof(float), nullptr, GL_STREAM_READ);
+  glReadPixels(xStart, yStart, xEnd - xStart, yEnd - yStart, GL_RGBA, GL_FLOAT, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  asyncRegionReadFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  checkGLError();
+}
+
+bool GLFrameBuffer::finishAsyncReadFloat4Region(std::vector<float>& out, bool wait) {
+  if (!asyncRegionReadPending) return false;
+
+  if (asyncRegionReadFence != nullptr) {
+    GLuint64 timeoutNanosec = wait ? 1000000000ull : 0;
+    GLenum status = glClientWaitSync(asyncRegionReadFence, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNanosec);
+    if (status == GL_TIMEOUT_EXPIRED) {
+      return false;
+    }
+    if (status == GL_WAIT_FAILED) {
+      exception("async framebuffer read failed");
+    }
+    glDeleteSync(asyncRegionReadFence);
+    asyncRegionReadFence = nullptr;
+  }
+  asyncRegionReadPending = false;
+
+  out.assign(asyncRegionReadSize, 0.f);
+  if (asyncRegionReadSize == 0) return true;
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, asyncRegionReadPBO);
+  void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, asyncRegionReadSize * sizeof(float), GL_MAP_READ_BIT);
+  if (mapped != nullptr) {
+    std::memcpy(&out.front(), mapped, asyncRegionReadSize * sizeof(float));
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  checkGLError();
+
+  return mapped != nullptr;
+}
+
 void GLFrameBuffer::blitTo(FrameBuffer* targetIn) {
 
   // it _better_ be a GL buffer
@@ -2059,7 +2348,9 @@ void GLShaderProgram::draw() {
 
   switch (drawMode) {
   case DrawMode::Points:
+    glEnable(GL_PROGRAM_POINT_SIZE); // (for programs which emit points sized with gl_PointSize)
     glDrawArrays(GL_POINTS, 0, drawDataLength);
+    glDisable(GL_PROGRAM_POINT_SIZE);
     break;
   case DrawMode::Triangles:
     glDrawArrays(GL_TRIANGLES, 0, drawDataLength);
@@ -2109,10 +2400,56 @@ void GLShaderProgram::draw() {
 }
 
 GLEngine::GLEngine() {}
-GLEngine::~GLEngine() {}
+GLEngine::~GLEngine() {
+  for (auto& entry : computeProgramCache) {
+    glDeleteProgram(entry.second);
+  }
+}
 
 void GLEngine::checkError(bool fatal) { checkGLError(fatal); }
 
+void GLEngine::finishDeviceWork() { glFinish(); }
+
+bool GLEngine::getDeviceMemoryInfo(size_t& totalBytesOut, size_t& availableBytesOut) {
+  // These vendor extensions are not in the loader's headers; values from the extension specifications
+  const GLenum GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX = 0x9048;
+  const GLenum GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX = 0x9049;
+  const GLenum VBO_FREE_MEMORY_ATI = 0x87FB;
+
+  bool haveNVX = false;
+  bool haveATI = false;
+  GLint nExtensions = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &nExtensions);
+  for (GLint i = 0; i < nExtensions; i++) {
+    const char* ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+    if (ext == nullptr) continue;
+    std::string extStr(ext);
+    if (extStr == "GL_NVX_gpu_memory_info") haveNVX = true;
+    if (extStr == "GL_ATI_meminfo") haveATI = true;
+  }
+
+  // (both report kilobytes)
+  if (haveNVX) {
+    GLint totalKB = 0;
+    GLint availableKB = 0;
+    glGetIntegerv(GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &totalKB);
+    glGetIntegerv(GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &availableKB);
+    checkGLError();
+    totalBytesOut = 1024 * static_cast<size_t>(totalKB);
+    availableBytesOut = 1024 * static_cast<size_t>(availableKB);
+    return true;
+  }
+  if (haveATI) {
+    GLint vboFree[4] = {0, 0, 0, 0}; // (total free, largest free block, total auxiliary free, largest auxiliary free)
+    glGetIntegerv(VBO_FREE_MEMORY_ATI, vboFree);
+    checkGLError();
+    totalBytesOut = 0;
+    availableBytesOut = 1024 * static_cast<size_t>(vboFree[0]);
+    return true;
+  }
+  return false;
+}
+
 std::vector<unsigned char> GLEngine::readDisplayBuffer() {
   // TODO do we need to bind here?
 
@@ -2250,6 +2587,162 @@ void GLEngine::setFrontFaceCCW(bool newVal) {
 // == Factories
 
 
+void GLEngine::initializeComputeTier(GLProcLoader loader) {
+  computeTierSupported = false;
+
+  GLint major = 0, minor = 0;
+  glGetIntegerv(GL_MAJOR_VERSION, &major);
+  glGetIntegerv(GL_MINOR_VERSION, &minor);
+  if (major < 4 || (major == 4 && minor < 3)) {
+    return;
+  }
+
+  dispatchComputeFunc = reinterpret_cast<DispatchComputeProc>(loader("glDispatchCompute"));
+  memoryBarrierFunc = reinterpret_cast<MemoryBarrierProc>(loader("glMemoryBarrier"));
+  computeTierSupported = (dispatchComputeFunc != nullptr) && (memoryBarrierFunc != nullptr);
+
+  if (options::verbosity > 1 && computeTierSupported) {
+    std::cout << options::printPrefix << "openGL compute tier available" << std::endl;
+  }
+}
+
+ProgramHandle GLEngine::getComputeProgram(const std::string& name, const ShaderStageSpecification& spec) {
+
+  auto it = computeProgramCache.find(name);
+  if (it != computeProgramCache.end()) {
+    return it->second;
+  }
+
+  ShaderHandle shaderHandle = glCreateShader(native(spec.stage));
+  const char* src = spec.src.c_str();
+  glShaderSource(shaderHandle, 1, &src, nullptr);
+  glCompileShader(shaderHandle);
+  GLint status;
+  glGetShaderiv(shaderHandle, GL_COMPILE_STATUS, &status);
+  if (!status) {
+    printShaderInfoLog(shaderHandle);
+    exception("[polyscope] GL compute shader compile failed: " + name);
+  }
+
+  ProgramHandle programHandle = glCreateProgram();
+  glAttachShader(programHandle, shaderHandle);
+  glLinkProgram(programHandle);
+  glGetProgramiv(programHandle, GL_LINK_STATUS, &status);
+  if (!status) {
+    printProgramInfoLog(programHandle);
+    exception("[polyscope] GL compute program link failed: " + name);
+  }
+  glDeleteShader(shaderHandle);
+  checkGLError();
+
+  computeProgramCache[name] = programHandle;
+  return programHandle;
+}
+
+bool GLEngine::computeRange(AttributeBuffer& values, float& minOut, float& maxOut) {
+  if (!computeTierAvailable()) return false;
+  if (values.getType() != RenderDataType::Float || values.getArrayCount() != 1 || !values.isSet()) return false;
+  GLAttributeBuffer& glValues = dynamic_cast<GLAttributeBuffer&>(values);
+  size_t N = glValues.getDataSize();
+
+  minOut = std::numeric_limits<float>::infinity();
+  maxOut = -std::numeric_limits<float>::infinity();
+  if (N == 0) return true;
+
+  // each workgroup writes out the range of its entries, which get combined below
+  GLuint nGroups = computeGroupCount(N);
+  GLuint groupRangesBuffer;
+  glGenBuffers(1, &groupRangesBuffer);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, groupRangesBuffer);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, nGroups * sizeof(glm::vec2), NULL, GL_STREAM_READ);
+
+  ProgramHandle program = getComputeProgram("range", COMPUTE_RANGE_SHADER);
+  glUseProgram(program);
+  glUniform1ui(glGetUniformLocation(program, "u_count"), static_cast<GLuint>(N));
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, glValues.getHandle());
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, groupRangesBuffer);
+  dispatchComputeFunc(nGroups, 1, 1);
+  memoryBarrierFunc(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+  std::vector<glm::vec2> groupRanges(nGroups);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, groupRangesBuffer);
+  glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, nGroups * sizeof(glm::vec2), &groupRanges.front());
+  glDeleteBuffers(1, &groupRangesBuffer);
+  checkGLError();
+
+  for (const glm::vec2& r : groupRanges) {
+    minOut = std::min(minOut, r.x);
+    maxOut = std::max(maxOut, r.y);
+  }
+  return true;
+}
+
+bool GLEngine::computeHistogram(AttributeBuffer& values, float rangeMin, float rangeMax, size_t nBins,
+                                std::vector<uint32_t>& countsOut) {
+  if (!computeTierAvailable()) return false;
+  if (values.getType() != RenderDataType::Float || values.getArrayCount() != 1 || !values.isSet()) return false;
+  if (nBins == 0 || nBins > COMPUTE_WORKGROUP_SIZE || !(rangeMax > rangeMin)) return false;
+  GLAttributeBuffer& glValues = dynamic_cast<GLAttributeBuffer&>(values);
+  size_t N = glValues.getDataSize();
+
+  countsOut = std::vector<uint32_t>(nBins, 0);
+  if (N == 0) return true;
+
+  GLuint binsBuffer;
+  glGenBuffers(1, &binsBuffer);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, binsBuffer);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, nBins * sizeof(uint32_t), &countsOut.front(), GL_STREAM_READ);
+
+  ProgramHandle program = getComputeProgram("histogram", COMPUTE_HISTOGRAM_SHADER);
+  glUseProgram(program);
+  glUniform1ui(glGetUniformLocation(program, "u_count"), static_cast<GLuint>(N));
+  glUniform1ui(glGetUniformLocation(program, "u_nBins"), static_cast<GLuint>(nBins));
+  glUniform1f(glGetUniformLocation(program, "u_rangeMin"), rangeMin);
+  glUniform1f(glGetUniformLocation(program, "u_rangeMax"), rangeMax);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, glValues.getHandle());
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, binsBuffer);
+  dispatchComputeFunc(computeGroupCount(N), 1, 1);
+  memoryBarrierFunc(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, binsBuffer);
+  glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, nBins * sizeof(uint32_t), &countsOut.front());
+  glDeleteBuffers(1, &binsBuffer);
+  checkGLError();
+
+  return true;
+}
+
+bool GLEngine::computeGather(AttributeBuffer& source, AttributeBuffer& indices, AttributeBuffer& target) {
+  if (!computeTierAvailable()) return false;
+  if (source.getType() != target.getType() || source.getArrayCount() != target.getArrayCount()) return false;
+  if (indices.getType() != RenderDataType::UInt || indices.getArrayCount() != 1) return false;
+  if (!source.isSet() || !indices.isSet() || indices.getDataSize() == 0) return false;
+  GLAttributeBuffer& glSource = dynamic_cast<GLAttributeBuffer&>(source);
+  GLAttributeBuffer& glIndices = dynamic_cast<GLAttributeBuffer&>(indices);
+  GLAttributeBuffer& glTarget = dynamic_cast<GLAttributeBuffer&>(target);
+
+  int entryBytes = sizeInBytes(source.getType()) * source.getArrayCount();
+  if (entryBytes % 4 != 0) return false; // copies are done as 32-bit words
+  size_t N = glIndices.getDataSize();
+  glTarget.allocate(N);
+
+  ProgramHandle program = getComputeProgram("gather", COMPUTE_GATHER_SHADER);
+  glUseProgram(program);
+  glUniform1ui(glGetUniformLocation(program, "u_count"), static_cast<GLuint>(N));
+  glUniform1ui(glGetUniformLocation(program, "u_width"), static_cast<GLuint>(entryBytes / 4));
+  glUniform1ui(glGetUniformLocation(program, "u_sourceCount"), static_cast<GLuint>(glSource.getDataSize()));
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, glSource.getHandle());
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, glIndices.getHandle());
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, glTarget.getHandle());
+  dispatchComputeFunc(computeGroupCount(N), 1, 1);
+
+  // the target is consumed as a vertex attribute, or possibly read back to the host
+  memoryBarrierFunc(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+  checkGLError();
+
+  return true;
+}
+
 std::shared_ptr<AttributeBuffer> GLEngine::generateAttributeBuffer(RenderDataType dataType_, int arrayCount_) {
   GLAttributeBuffer* newA = new GLAttributeBuffer(dataType_, arrayCount_);
   return std::shared_ptr<AttributeBuffer>(newA);
@@ -2290,6 +2783,19 @@ std::shared_ptr<TextureBuffer> GLEngine::generateTextureBuffer(TextureFormat for
   return std::shared_ptr<TextureBuffer>(newT);
 }
 
+std::shared_ptr<AttributeBuffer> GLEngine::wrapNativeAttributeBuffer(RenderDataType dataType_, int arrayCount_,
+                                                                     uint32_t nativeID, int64_t dataSize) {
+  GLAttributeBuffer* newA = new GLAttributeBuffer(dataType_, arrayCount_, nativeID, dataSize);
+  return std::shared_ptr<AttributeBuffer>(newA);
+}
+
+std::shared_ptr<TextureBuffer> GLEngine::wrapNativeTextureBuffer(TextureFormat format, int dim, uint32_t nativeID,
+                                                                 unsigned int sizeX_, unsigned int sizeY_,
+                                                                 unsigned int sizeZ_) {
+  GLTextureBuffer* newT = new GLTextureBuffer(format, dim, nativeID, sizeX_, sizeY_, sizeZ_);
+  return std::shared_ptr<TextureBuffer>(newT);
+}
+
 std::shared_ptr<RenderBuffer> GLEngine::generateRenderBuffer(RenderBufferType type, unsigned int sizeX_,
                                                              unsigned int sizeY_) {
   GLRenderBuffer* newR = new GLRenderBuffer(type, sizeX_, sizeY_);
@@ -2454,9 +2960,12 @@ void GLEngine::populateDefaultShadersAndRules() {
   registerShaderProgram("SIMPLE_MESH", {SIMPLE_MESH_VERT_SHADER, SIMPLE_MESH_FRAG_SHADER}, DrawMode::IndexedTriangles);
   registerShaderProgram("SLICE_TETS", {SLICE_TETS_VERT_SHADER, SLICE_TETS_GEOM_SHADER, SLICE_TETS_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("RAYCAST_SPHERE", {FLEX_SPHERE_VERT_SHADER, FLEX_SPHERE_GEOM_SHADER, FLEX_SPHERE_FRAG_SHADER}, DrawMode::Points);
+  registerShaderProgram("RAYCAST_SPHERE_DEPTH", {FLEX_SPHERE_VERT_SHADER, FLEX_SPHERE_GEOM_SHADER, FLEX_SPHERE_DEPTH_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("POINT_QUAD", {FLEX_POINTQUAD_VERT_SHADER, FLEX_POINTQUAD_GEOM_SHADER, FLEX_POINTQUAD_FRAG_SHADER}, DrawMode::Points);
+  registerShaderProgram("POINT_PIXEL", {FLEX_POINTQUAD_VERT_SHADER, FLEX_POINTPIXEL_GEOM_SHADER, FLEX_POINTPIXEL_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("GRIDCUBE", {FLEX_GRIDCUBE_VERT_SHADER, FLEX_GRIDCUBE_GEOM_SHADER, FLEX_GRIDCUBE_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("GRIDCUBE_PLANE", {FLEX_GRIDCUBE_PLANE_VERT_SHADER, FLEX_GRIDCUBE_PLANE_FRAG_SHADER}, DrawMode::Triangles);
+  registerShaderProgram("GRIDCUBE_RAYCAST", {FLEX_GRIDCUBE_RAYCAST_VERT_SHADER, FLEX_GRIDCUBE_RAYCAST_FRAG_SHADER}, DrawMode::Triangles);
   registerShaderProgram("RAYCAST_VECTOR", {FLEX_VECTOR_VERT_SHADER, FLEX_VECTOR_GEOM_SHADER, FLEX_VECTOR_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("RAYCAST_SCALE", {FLEX_VECTOR_VERT_SHADER, FLEX_VECTOR_GEOM_SHADER, FLEX_SCALE_FRAG_SHADER}, DrawMode::Points);
   registerShaderProgram("RAYCAST_TANGENT_VECTOR", {FLEX_TANGENT_VECTOR_VERT_SHADER, FLEX_VECTOR_GEOM_SHADER, FLEX_VECTOR_FRAG_SHADER}, DrawMode::Points);
@@ -2478,6 +2987,7 @@ void GLEngine::populateDefaultShadersAndRules() {
   registerShaderProgram("COMPOSITE_PEEL", {TEXTURE_DRAW_VERT_SHADER, COMPOSITE_PEEL}, DrawMode::Triangles);
   registerShaderProgram("DEPTH_COPY", {TEXTURE_DRAW_VERT_SHADER, DEPTH_COPY}, DrawMode::Triangles);
   registerShaderProgram("DEPTH_TO_MASK", {TEXTURE_DRAW_VERT_SHADER, DEPTH_TO_MASK}, DrawMode::Triangles);
+  registerShaderProgram("PICK_HIGHLIGHT", {TEXTURE_DRAW_VERT_SHADER, PICK_HIGHLIGHT}, DrawMode::Triangles);
   registerShaderProgram("SCALAR_TEXTURE_COLORMAP", {TEXTURE_DRAW_VERT_SHADER, SCALAR_TEXTURE_COLORMAP}, DrawMode::Triangles);
   registerShaderProgram("BLUR_RGB", {TEXTURE_DRAW_VERT_SHADER, BLUR_RGB}, DrawMode::Triangles);
   registerShaderProgram("TRANSFORMATION_GIZMO_ROT", {TRANSFORMATION_GIZMO_ROT_VERT, TRANSFORMATION_GIZMO_ROT_FRAG}, DrawMode::Triangles);
@@ -2494,6 +3004,7 @@ void GLEngine::populateDefaultShadersAndRules() {
 
   registerShaderRule("TRANSPARENCY_STRUCTURE", TRANSPARENCY_STRUCTURE);
   registerShaderRule("TRANSPARENCY_RESOLVE_SIMPLE", TRANSPARENCY_RESOLVE_SIMPLE);
+  registerShaderRule("EYE_DOME_LIGHTING", EYE_DOME_LIGHTING);
   registerShaderRule("TRANSPARENCY_PEEL_STRUCTURE", TRANSPARENCY_PEEL_STRUCTURE);
   registerShaderRule("TRANSPARENCY_PEEL_GROUND", TRANSPARENCY_PEEL_GROUND);
 
@@ -2501,6 +3012,11 @@ void GLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("COMPUTE_SHADE_NORMAL_FROM_POSITION", COMPUTE_SHADE_NORMAL_FROM_POSITION);
   registerShaderRule("PREMULTIPLY_LIT_COLOR", PREMULTIPLY_LIT_COLOR);
   registerShaderRule("CULL_POS_FROM_VIEW", CULL_POS_FROM_VIEW);
+  registerShaderRule("ELEMENT_MASK_PROPAGATE_GEOM", ELEMENT_MASK_PROPAGATE_GEOM);
+  registerShaderRule("ELEMENT_MASK_PROPAGATE_MESH", ELEMENT_MASK_PROPAGATE_MESH);
+  registerShaderRule("ELEMENT_MASK_SHADE_RAYCAST", ELEMENT_MASK_SHADE_RAYCAST);
+  registerShaderRule("ELEMENT_MASK_SHADE_FLAT", ELEMENT_MASK_SHADE_FLAT);
+  registerShaderRule("ELEMENT_MASK_SHADE_MESH", ELEMENT_MASK_SHADE_MESH);
   registerShaderRule("PROJ_AND_INV_PROJ_MAT", PROJ_AND_INV_PROJ_MAT);
 
   // Lighting and shading things
@@ -2529,12 +3045,16 @@ void GLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("TEXTURE_SHADE_COLORALPHA", TEXTURE_SHADE_COLORALPHA);
   registerShaderRule("TEXTURE_PROPAGATE_VALUE", TEXTURE_PROPAGATE_VALUE);
   registerShaderRule("TEXTURE_PROPAGATE_COLOR", TEXTURE_PROPAGATE_COLOR);
+  registerShaderRule("VIRTUAL_TEXTURE_LOOKUP", VIRTUAL_TEXTURE_LOOKUP);
+  registerShaderRule("VIRTUAL_TEXTURE_PROPAGATE_VALUE", VIRTUAL_TEXTURE_PROPAGATE_VALUE);
+  registerShaderRule("VIRTUAL_TEXTURE_PROPAGATE_COLOR", VIRTUAL_TEXTURE_PROPAGATE_COLOR);
   registerShaderRule("TEXTURE_BILLBOARD_FROM_UNIFORMS", TEXTURE_BILLBOARD_FROM_UNIFORMS);
   registerShaderRule("SHADE_NORMAL_FROM_TEXTURE", SHADE_NORMAL_FROM_TEXTURE);
   registerShaderRule("SHADE_NORMAL_FROM_VIEWPOS_VAR", SHADE_NORMAL_FROM_VIEWPOS_VAR);
 
   // mesh things
   registerShaderRule("MESH_WIREFRAME_FROM_BARY", MESH_WIREFRAME_FROM_BARY);
+  registerShaderRule("MESH_WIREFRAME_FROM_BARY_ALL_REAL", MESH_WIREFRAME_FROM_BARY_ALL_REAL);
   registerShaderRule("MESH_WIREFRAME", MESH_WIREFRAME);
   registerShaderRule("MESH_WIREFRAME_ONLY", MESH_WIREFRAME_ONLY);
   registerShaderRule("MESH_BACKFACE_NORMAL_FLIP", MESH_BACKFACE_NORMAL_FLIP);
@@ -2581,6 +3101,7 @@ void GLEngine::populateDefaultShadersAndRules() {
   registerShaderRule("CYLINDER_PROPAGATE_PICK", CYLINDER_PROPAGATE_PICK);
   registerShaderRule("CYLINDER_CULLPOS_FROM_MID", CYLINDER_CULLPOS_FROM_MID);
   registerShaderRule("CYLINDER_VARIABLE_SIZE", CYLINDER_VARIABLE_SIZE);
+  registerShaderRule("CYLINDER_THIN_AS_LINE", CYLINDER_THIN_AS_LINE);
 
   // marching tets things
   registerShaderRule("SLICE_TETS_BASECOLOR_SHADE", SLICE_TETS_BASECOLOR_SHADE);
@@ -209,6 +209,8 @@ void GLEngineEGL::initialize() {
               << "EGL version: " << majorVer << "." << minorVer << std::endl;
   }
 
+  initializeComputeTier([](const char* name) -> void* { return reinterpret_cast<void*>(eglGetProcAddress(name)); });
+
   { // Manually create the screen frame buffer
     // NOTE: important difference here, we manually create both the framebuffer and and its render buffer, since
     // headless EGL means we are not getting them from a window
@@ -99,6 +99,11 @@ void GLEngineGLFW::initialize() {
               << "Loaded openGL version: " << glGetString(GL_VERSION) << std::endl;
   }
 
+#ifndef __APPLE__
+  // (apple caps out at openGL 4.1, so there is never compute support)
+  initializeComputeTier([](const char* name) -> void* { return reinterpret_cast<void*>(glfwGetProcAddress(name)); });
+#endif
+
 #ifdef __APPLE__
   // Hack to classify the process as interactive
   glfwPollEvents();
@@ -227,6 +232,16 @@ bool GLEngineGLFW::windowRequestsClose() {
   return false;
 }
 
+double GLEngineGLFW::getDisplayRefreshRate() {
+  // Windowed windows have no monitor of their own, assume they are on the primary one
+  GLFWmonitor* monitor = glfwGetWindowMonitor(mainWindow);
+  if (monitor == nullptr) monitor = glfwGetPrimaryMonitor();
+  if (monitor == nullptr) return 0.;
+  const GLFWvidmode* mode = glfwGetVideoMode(monitor);
+  if (mode == nullptr) return 0.;
+  return mode->refreshRate;
+}
+
 void GLEngineGLFW::pollEvents() { glfwPollEvents(); }
 
 bool GLEngineGLFW::isKeyPressed(char c) {
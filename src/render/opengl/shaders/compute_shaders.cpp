@@ -0,0 +1,179 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+
+#include "polyscope/render/opengl/shaders/compute_shaders.h"
+
+namespace polyscope {
+namespace render {
+namespace backend_openGL3 {
+
+// clang-format off
+
+const ShaderStageSpecification COMPUTE_RANGE_SHADER = {
+
+    ShaderStageType::Compute,
+
+    // uniforms
+    {
+        {"u_count", RenderDataType::UInt},
+    },
+
+    {}, // attributes
+
+    {}, // textures
+
+    // source
+R"(
+      #version 430 core
+      layout(local_size_x = 256) in;
+
+      layout(std430, binding = 0) readonly buffer Values { float values[]; };
+      layout(std430, binding = 1) writeonly buffer GroupRanges { vec2 groupRanges[]; };
+
+      uniform uint u_count;
+
+      shared vec2 partialRanges[256];
+
+      void main() {
+        uint iLocal = gl_LocalInvocationID.x;
+        uint stride = gl_NumWorkGroups.x * gl_WorkGroupSize.x;
+        float inf = uintBitsToFloat(0x7F800000u);
+
+        // accumulate this invocation's share of the data, skipping NaN and inf
+        vec2 range = vec2(inf, -inf);
+        for (uint i = gl_GlobalInvocationID.x; i < u_count; i += stride) {
+          float v = values[i];
+          if (!isnan(v) && !isinf(v)) {
+            range = vec2(min(range.x, v), max(range.y, v));
+          }
+        }
+        partialRanges[iLocal] = range;
+        barrier();
+
+        // tree reduction within the workgroup
+        for (uint s = gl_WorkGroupSize.x / 2u; s > 0u; s /= 2u) {
+          if (iLocal < s) {
+            vec2 other = partialRanges[iLocal + s];
+            partialRanges[iLocal] = vec2(min(partialRanges[iLocal].x, other.x), max(partialRanges[iLocal].y, other.y));
+          }
+          barrier();
+        }
+
+        if (iLocal == 0u) {
+          groupRanges[gl_WorkGroupID.x] = partialRanges[0];
+        }
+      }
+)"
+};
+
+const ShaderStageSpecification COMPUTE_HISTOGRAM_SHADER = {
+
+    ShaderStageType::Compute,
+
+    // uniforms
+    {
+        {"u_count", RenderDataType::UInt},
+        {"u_nBins", RenderDataType::UInt},
+        {"u_rangeMin", RenderDataType::Float},
+        {"u_rangeMax", RenderDataType::Float},
+    },
+
+    {}, // attributes
+
+    {}, // textures
+
+    // source
+R"(
+      #version 430 core
+      layout(local_size_x = 256) in;
+
+      layout(std430, binding = 0) readonly buffer Values { float values[]; };
+      layout(std430, binding = 1) buffer Bins { uint bins[]; };
+
+      uniform uint u_count;
+      uniform uint u_nBins; // at most 256
+      uniform float u_rangeMin;
+      uniform float u_rangeMax;
+
+      shared uint localBins[256];
+
+      void main() {
+        uint iLocal = gl_LocalInvocationID.x;
+        uint stride = gl_NumWorkGroups.x * gl_WorkGroupSize.x;
+
+        localBins[iLocal] = 0u;
+        barrier();
+
+        // count in to workgroup-local bins, to cut down on contention for the global atomics
+        float binScale = float(u_nBins) / (u_rangeMax - u_rangeMin);
+        for (uint i = gl_GlobalInvocationID.x; i < u_count; i += stride) {
+          float v = values[i];
+          if (isnan(v)) continue;
+          float iBinF = clamp((v - u_rangeMin) * binScale, 0., float(u_nBins) - 1.);
+          atomicAdd(localBins[uint(floor(iBinF))], 1u);
+        }
+        barrier();
+
+        if (iLocal < u_nBins && localBins[iLocal] > 0u) {
+          atomicAdd(bins[iLocal], localBins[iLocal]);
+        }
+      }
+)"
+};
+
+const ShaderStageSpecification COMPUTE_GATHER_SHADER = {
+
+    ShaderStageType::Compute,
+
+    // uniforms
+    {
+        {"u_count", RenderDataType::UInt},
+        {"u_width", RenderDataType::UInt},
+        {"u_sourceCount", RenderDataType::UInt},
+    },
+
+    {}, // attributes
+
+    {}, // textures
+
+    // source
+R"(
+      #version 430 core
+      layout(local_size_x = 256) in;
+
+      // entries are copied as raw 32-bit words, so this works for any type
+      layout(std430, binding = 0) readonly buffer Source { uint source[]; };
+      layout(std430, binding = 1) readonly buffer Indices { uint indices[]; };
+      layout(std430, binding = 2) writeonly buffer Target { uint target[]; };
+
+      uniform uint u_count;
+      uniform uint u_width; // number of words per entry
+      uniform uint u_sourceCount; // number of source entries
+
+      void main() {
+        uint stride = gl_NumWorkGroups.x * gl_WorkGroupSize.x;
+        for (uint i = gl_GlobalInvocationID.x; i < u_count; i += stride) {
+          uint iTarget = i * u_width;
+
+          // out of range indices gather zeros, rather than reading past the end of the source
+          if (indices[i] >= u_sourceCount) {
+            for (uint c = 0u; c < u_width; c++) {
+              target[iTarget + c] = 0u;
+            }
+            continue;
+          }
+
+          uint iSource = indices[i] * u_width;
+          for (uint c = 0u; c < u_width; c++) {
+            target[iTarget + c] = source[iSource + c];
+          }
+        }
+      }
+)"
+};
+
+// clang-format on
+
+} // namespace backend_openGL3
+} // namespace render
+} // namespace polyscope
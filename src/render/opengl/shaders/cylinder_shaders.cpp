@@ -74,6 +74,7 @@ R"(
         uniform float u_radius;
         out vec3 tipView;
         out vec3 tailView;
+        flat out int cylinderAsLine;
 
         ${ GEOM_DECLARATIONS }$
 
@@ -106,24 +107,40 @@ R"(
             vec4 p6 = tipProj + dxTip - dyTip;
             vec4 p7 = tipProj - dxTip + dyTip;
             vec4 p8 = tipProj + dxTip + dyTip;
+
+            // Rules may choose to draw thin cylinders as flat screen-space lines instead, offset to either side by
+            // lineOffsetNDC
+            bool emitAsLine = false;
+            vec2 lineOffsetNDC = vec2(0., 0.);
+            ${ CYLINDER_CHOOSE_LINE_GEOM }$
+            if(emitAsLine) {
+              vec4 offTail = vec4(lineOffsetNDC * tailProj.w, 0., 0.);
+              vec4 offTip = vec4(lineOffsetNDC * tipProj.w, 0., 0.);
+              ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 1; gl_Position = tailProj - offTail; EmitVertex(); 
+              ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 1; gl_Position = tailProj + offTail; EmitVertex(); 
+              ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 1; gl_Position = tipProj - offTip; EmitVertex(); 
+              ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 1; gl_Position = tipProj + offTip; EmitVertex(); 
+              EndPrimitive();
+              return;
+            }
             
             // Other data to emit   
     
             // Emit the vertices as a triangle strip
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p7; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p8; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p5; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p6; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p2; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p8; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p4; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p7; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p3; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p5; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p1; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p2; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p3; EmitVertex(); 
-            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; gl_Position = p4; EmitVertex();
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p7; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p8; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p5; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p6; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p2; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p8; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p4; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p7; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p3; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p5; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p1; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p2; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p3; EmitVertex(); 
+            ${ GEOM_PER_EMIT }$ tailView = tailViewVal; tipView = tipViewVal; cylinderAsLine = 0; gl_Position = p4; EmitVertex();
     
             EndPrimitive();
 
@@ -160,6 +177,7 @@ R"(
         uniform float u_radius;
         in vec3 tailView;
         in vec3 tipView;
+        flat in int cylinderAsLine;
         layout(location = 0) out vec4 outputF;
 
         float LARGE_FLOAT();
@@ -184,7 +202,19 @@ R"(
            float tHit;
            vec3 pHit;
            vec3 nHit;
-           rayTaperedCylinderIntersection(vec3(0., 0., 0), viewRay, tailView, tipView, tailRadius, tipRadius, tHit, pHit, nHit);
+           if(cylinderAsLine == 1) {
+             // Drawn as a line: use the point on the axis closest to the ray, facing the camera
+             vec3 rayDir = normalize(viewRay);
+             vec3 axis = tipView - tailView;
+             float b = dot(axis, rayDir);
+             float denom = dot(axis, axis) - b * b;
+             float s = denom > 1e-12 ? clamp((b * dot(rayDir, tailView) - dot(axis, tailView)) / denom, 0., 1.) : 0.;
+             pHit = tailView + s * axis;
+             nHit = -rayDir;
+             tHit = dot(pHit, rayDir);
+           } else {
+             rayTaperedCylinderIntersection(vec3(0., 0., 0), viewRay, tailView, tipView, tailRadius, tipRadius, tHit, pHit, nHit);
+           }
            if(tHit >= LARGE_FLOAT()) {
               discard;
            }
@@ -477,6 +507,38 @@ const ShaderReplacementRule CYLINDER_VARIABLE_SIZE (
     /* textures */ {}
 );
 
+// Draw cylinders whose radius on screen is below u_lineMaxPixelRadius pixels as one-pixel-wide lines, which are much
+// cheaper to rasterize than the ray-cast impostor
+const ShaderReplacementRule CYLINDER_THIN_AS_LINE (
+    /* rule name */ "CYLINDER_THIN_AS_LINE",
+    { /* replacement sources */
+      {"GEOM_DECLARATIONS", R"(
+          uniform vec4 u_viewport;
+          uniform float u_lineMaxPixelRadius;
+        )"},
+      {"CYLINDER_CHOOSE_LINE_GEOM", R"(
+          if(tailProj.w > 0. && tipProj.w > 0.) {
+            vec2 viewportHalfSize = 0.5 * u_viewport.zw;
+            float tailRadiusPixels =
+                max(length(dxTail.xy * viewportHalfSize), length(dyTail.xy * viewportHalfSize)) / tailProj.w;
+            float tipRadiusPixels =
+                max(length(dxTip.xy * viewportHalfSize), length(dyTip.xy * viewportHalfSize)) / tipProj.w;
+            if(max(tailRadiusPixels, tipRadiusPixels) < u_lineMaxPixelRadius) {
+              vec2 dirPixels = (tipProj.xy / tipProj.w - tailProj.xy / tailProj.w) * viewportHalfSize;
+              vec2 perpPixels = length(dirPixels) > 0. ? normalize(vec2(-dirPixels.y, dirPixels.x)) : vec2(1., 0.);
+              emitAsLine = true;
+              lineOffsetNDC = 0.5 * perpPixels / viewportHalfSize;
+            }
+          }
+        )"},
+    },
+    /* uniforms */ {
+      {"u_lineMaxPixelRadius", RenderDataType::Float},
+    },
+    /* attributes */ {},
+    /* textures */ {}
+);
+
 // clang-format on
 
 } // namespace backend_openGL3
@@ -362,17 +362,231 @@ R"(
 };
 
 
+// Draws the whole grid at once: rasterizes the far faces of the bounding box, then marches each pixel's ray through the
+// cells with a 3D DDA to find the first visible one. Fill cost follows the pixels covered, not the grid resolution.
+// The local variables after the march have the same names as in the GRIDCUBE_PLANE shader, so the same rules apply.
+const ShaderStageSpecification FLEX_GRIDCUBE_RAYCAST_VERT_SHADER = {
+
+    ShaderStageType::Vertex,
+
+    // uniforms
+    {
+        {"u_modelView", RenderDataType::Matrix44Float},
+        {"u_projMatrix", RenderDataType::Matrix44Float},
+        {"u_boundMin", RenderDataType::Vector3Float},
+        {"u_boundMax", RenderDataType::Vector3Float},
+    }, 
+
+    // attributes
+    {
+        {"a_referencePosition", RenderDataType::Vector3Float},
+    },
+
+    {}, // textures
+
+    // source
+R"(
+        ${ GLSL_VERSION }$
+        
+        uniform mat4 u_modelView;
+        uniform mat4 u_projMatrix;
+        uniform vec3 u_boundMin;
+        uniform vec3 u_boundMax;
+
+        in vec3 a_referencePosition;
+        
+        ${ VERT_DECLARATIONS }$
+        
+        void main()
+        {
+            vec3 boxPos = mix(u_boundMin, u_boundMax, a_referencePosition);
+            gl_Position = u_projMatrix * u_modelView * vec4(boxPos,1.);
+
+            ${ VERT_ASSIGNMENTS }$
+        }
+)"
+};
+
+const ShaderStageSpecification FLEX_GRIDCUBE_RAYCAST_FRAG_SHADER = {
+    
+    ShaderStageType::Fragment,
+    
+    // uniforms
+    {
+        {"u_modelView", RenderDataType::Matrix44Float},
+        {"u_projMatrix", RenderDataType::Matrix44Float},
+        {"u_invProjMatrix", RenderDataType::Matrix44Float},
+        {"u_viewToReference", RenderDataType::Matrix44Float},
+        {"u_viewport", RenderDataType::Vector4Float},
+        {"u_boundMin", RenderDataType::Vector3Float},
+        {"u_boundMax", RenderDataType::Vector3Float},
+        {"u_gridSpacingReference", RenderDataType::Vector3Float},
+        {"u_cubeSizeFactor", RenderDataType::Float},
+    }, 
+
+    { }, // attributes
+    
+    // textures 
+    {
+    },
+ 
+    // source
+R"(
+        ${ GLSL_VERSION }$
+        
+        uniform mat4 u_modelView;
+        uniform mat4 u_projMatrix;
+        uniform mat4 u_invProjMatrix;
+        uniform mat4 u_viewToReference;
+        uniform vec4 u_viewport;
+        uniform vec3 u_boundMin;
+        uniform vec3 u_boundMax;
+        uniform vec3 u_gridSpacingReference;
+        uniform float u_cubeSizeFactor;
+
+        layout(location = 0) out vec4 outputF;
+        
+        float fragDepthFromView(mat4 projMat, vec2 depthRange, vec3 viewPoint);
+
+        ${ FRAG_DECLARATIONS }$
+
+        vec3 referenceToView(vec3 refPos) {
+          return (u_modelView * vec4(mix(u_boundMin, u_boundMax, refPos), 1.)).xyz;
+        }
+
+        // intersect a ray with an axis-aligned box, returning false on a miss
+        bool rayBoxIntersection(vec3 rayStart, vec3 invRayDir, vec3 boxLow, vec3 boxHigh, 
+                                out float tNear, out float tFar, out int nearAxis) {
+          vec3 t0 = (boxLow - rayStart) * invRayDir;
+          vec3 t1 = (boxHigh - rayStart) * invRayDir;
+          vec3 tMin = min(t0, t1);
+          vec3 tMax = max(t0, t1);
+          nearAxis = (tMin.x > tMin.y) ? ((tMin.x > tMin.z) ? 0 : 2) : ((tMin.y > tMin.z) ? 1 : 2);
+          tNear = tMin[nearAxis];
+          tFar = min(min(tMax.x, tMax.y), tMax.z);
+          return tNear <= tFar;
+        }
+
+        void main()
+        {
+           // The ray through this pixel from the near plane (t=0) to the far plane (t=1), measured in cells
+           vec2 depthRange = vec2(gl_DepthRange.near, gl_DepthRange.far);
+           vec2 ndcXY = ((2.0 * gl_FragCoord.xy) - (2.0 * u_viewport.xy)) / (u_viewport.zw) - 1.;
+           vec4 nearView = u_invProjMatrix * vec4(ndcXY, -1., 1.);
+           vec4 farView = u_invProjMatrix * vec4(ndcXY, 1., 1.);
+           vec3 nearRef = (u_viewToReference * vec4(nearView.xyz / nearView.w, 1.)).xyz;
+           vec3 farRef = (u_viewToReference * vec4(farView.xyz / farView.w, 1.)).xyz;
+           // (on coarse mip levels, the last cell along an axis may be cut off by the bounds)
+           vec3 gridExtent = 1. / u_gridSpacingReference;
+           ivec3 cellDimI = ivec3(ceil(gridExtent - 0.001));
+           vec3 rayStart = nearRef * gridExtent;
+           vec3 rayDir = (farRef - nearRef) * gridExtent;
+           rayDir = mix(rayDir, vec3(1e-12), lessThan(abs(rayDir), vec3(1e-12))); // avoid dividing by zero
+           vec3 invRayDir = 1. / rayDir;
+
+           // Clip to the grid
+           float tEnter, tExit;
+           int enterAxis;
+           if(!rayBoxIntersection(rayStart, invRayDir, vec3(0.), gridExtent, tEnter, tExit, enterAxis)) discard;
+           tEnter = max(tEnter, 0.);
+           if(tEnter > tExit) discard;
+
+           // March through the cells along the ray until one is visible (and, if the cubes are shrunk, actually hit)
+           ivec3 cell = clamp(ivec3(floor(rayStart + rayDir * tEnter)), ivec3(0), cellDimI - 1);
+           ivec3 stepDir = ivec3(sign(rayDir));
+           vec3 tDelta = abs(invRayDir);
+           vec3 tNextBoundary = (vec3(cell) + max(vec3(stepDir), vec3(0.)) - rayStart) * invRayDir;
+           float halfSize = 0.5 * u_cubeSizeFactor;
+           float tHit = -1.;
+           int hitAxis = enterAxis;
+           int maxSteps = cellDimI.x + cellDimI.y + cellDimI.z;
+           for(int iStep = 0; iStep < maxSteps; iStep++) {
+
+             // (reuses the slice plane test which the planes shader applies to neighboring cells)
+             vec3 neighCullPos = referenceToView((0.667f + vec3(cell)) * u_gridSpacingReference);
+             bool neighIsVisible = true;
+             ${ GRID_PLANE_NEIGHBOR_FILTER }$
+
+             if(neighIsVisible) {
+               float tCubeNear, tCubeFar;
+               int cubeAxis;
+               vec3 cubeCenter = vec3(cell) + 0.5;
+               vec3 cubeHigh = min(cubeCenter + halfSize, gridExtent);
+               if(rayBoxIntersection(rayStart, invRayDir, cubeCenter - halfSize, cubeHigh, 
+                                     tCubeNear, tCubeFar, cubeAxis) && tCubeFar >= tEnter) {
+                 tHit = max(tCubeNear, tEnter);
+                 hitAxis = cubeAxis;
+                 break;
+               }
+             }
+
+             // Step to the next cell
+             vec3 tB = tNextBoundary;
+             int axis = (tB.x < tB.y) ? ((tB.x < tB.z) ? 0 : 2) : ((tB.y < tB.z) ? 1 : 2);
+             if(tNextBoundary[axis] > tExit) break;
+             cell[axis] += stepDir[axis];
+             tNextBoundary[axis] += tDelta[axis];
+             if(cell[axis] < 0 || cell[axis] >= cellDimI[axis]) break;
+           }
+           if(tHit < 0.) discard;
+
+           // Set up the same values the planes shader computes for a fragment
+           vec3 hitCellUnits = rayStart + rayDir * tHit;
+           vec3 a_coordToFrag = hitCellUnits * u_gridSpacingReference;
+           vec3 a_refNormalToFrag = vec3(0.);
+           a_refNormalToFrag[hitAxis] = -float(stepDir[hitAxis]);
+           vec3 cellInd3f = vec3(cell);
+           uvec3 cellInd = uvec3(cell);
+           vec3 coordLocal = (2.f * (hitCellUnits - cellInd3f) - 1.f) / u_cubeSizeFactor; // [-1,1] in the scaled cell
+           vec3 coordLocalAbs = abs(coordLocal) * (1.f - abs(a_refNormalToFrag));
+           vec3 cullPos = referenceToView((0.667f + cellInd3f) * u_gridSpacingReference);
+
+           vec3 viewPos = referenceToView(a_coordToFrag);
+           float depth = fragDepthFromView(u_projMatrix, depthRange, viewPos);
+           ${ GLOBAL_FRAGMENT_FILTER_PREP }$
+           ${ GLOBAL_FRAGMENT_FILTER }$
+           gl_FragDepth = depth;
+
+           // Shading
+           ${ GENERATE_SHADE_VALUE }$
+           ${ GENERATE_SHADE_COLOR }$
+           
+           // Handle the wireframe
+           ${ APPLY_WIREFRAME }$
+
+           // Lighting
+           vec3 shadeNormal = mat3(u_modelView) * a_refNormalToFrag;
+           ${ PERTURB_SHADE_NORMAL }$
+           ${ GENERATE_LIT_COLOR }$
+
+           // Set alpha
+           float alphaOut = 1.0;
+           ${ GENERATE_ALPHA }$
+           
+           ${ PERTURB_LIT_COLOR }$
+
+           // Write output
+           litColor *= alphaOut; // premultiplied alpha
+           outputF = vec4(litColor, alphaOut);
+        }
+)"
+};
+
+
 const ShaderReplacementRule GRIDCUBE_PROPAGATE_NODE_VALUE (
     /* rule name */ "GRIDCUBE_PROPAGATE_NODE_VALUE",
     { /* replacement sources */
       {"FRAG_DECLARATIONS", R"(
           uniform sampler3D t_value;
+          uniform vec3 u_nodeValueExtent; // where the last node of t_value is, in the reference cube
         )"},
       {"GENERATE_SHADE_VALUE", R"(
-          float shadeValue = texture(t_value, a_coordToFrag).r;
+          float shadeValue = texture(t_value, a_coordToFrag / u_nodeValueExtent).r;
         )"},
     },
-    /* uniforms */ {},
+    /* uniforms */ {
+      {"u_nodeValueExtent", RenderDataType::Vector3Float},
+    },
     /* attributes */ { },
     /* textures */ {
       {"t_value", 3},
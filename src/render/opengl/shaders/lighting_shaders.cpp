@@ -75,6 +75,8 @@ R"(
         vec3 color = color4.rgb;
         float alpha = color4.a;
 
+        ${ PROCESS_RESOLVED_COLOR }$
+
         // the u_bgColor / u_bgAlpha are *not* premultiplied
 
         // composite onto non-premultiplied value
@@ -231,6 +233,49 @@ const ShaderReplacementRule TRANSPARENCY_RESOLVE_SIMPLE (
     /* textures */ {}
 );
 
+const ShaderReplacementRule EYE_DOME_LIGHTING (
+    // Eye-dome lighting (Boucheny 2009): darken each pixel by how far it lies behind its neighbors, in log depth, which
+    // brings out the shape of geometry with no normals, like dense point clouds
+    /* rule name */ "EYE_DOME_LIGHTING",
+    { /* replacement sources */
+      {"FRAG_DECLARATIONS", R"(
+          uniform sampler2D t_depth;
+          uniform mat4 u_invProjMatrix;
+          uniform float u_eyeDomeStrength;
+          uniform float u_eyeDomeRadius;
+          float eyeDomeLogDepth(float depth) {
+            vec4 viewPos = u_invProjMatrix * vec4(0., 0., 2. * depth - 1., 1.);
+            return log2(max(abs(viewPos.z / viewPos.w), 1e-6));
+          }
+        )"},
+      {"PROCESS_RESOLVED_COLOR", R"(
+          float eyeDomeDepth = texture(t_depth, tCoord).r;
+          if(eyeDomeDepth < 1.) { // (nothing to do for the background)
+            float eyeDomeCenter = eyeDomeLogDepth(eyeDomeDepth);
+            vec2 eyeDomeTexel = u_eyeDomeRadius / vec2(textureSize(t_depth, 0));
+            float eyeDomeResponse = 0.;
+            for(int i = 0; i < 8; i++) {
+              float angle = 0.785398 * float(i);
+              float neighborDepth = texture(t_depth, tCoord + eyeDomeTexel * vec2(cos(angle), sin(angle))).r;
+              if(neighborDepth < 1.) {
+                eyeDomeResponse += max(0., eyeDomeCenter - eyeDomeLogDepth(neighborDepth));
+              }
+            }
+            color *= exp(-100. * u_eyeDomeStrength * eyeDomeResponse / 8.);
+          }
+        )"},
+    },
+    /* uniforms */ {
+      {"u_invProjMatrix", RenderDataType::Matrix44Float},
+      {"u_eyeDomeStrength", RenderDataType::Float},
+      {"u_eyeDomeRadius", RenderDataType::Float},
+    },
+    /* attributes */ {},
+    /* textures */ {
+      {"t_depth", 2},
+    }
+);
+
 const ShaderReplacementRule TRANSPARENCY_STRUCTURE (
     /* rule name */ "TRANSPARENCY_STRUCTURE",
     { /* replacement sources */
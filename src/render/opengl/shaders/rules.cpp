@@ -413,6 +413,147 @@ const ShaderReplacementRule CULL_POS_FROM_VIEW (
 );
 
 
+// == Per-element masks (see ElementMask)
+// The mask is a texture with one byte per drawn primitive, indexed in draw order and laid out row by row. Each byte is
+// an ElementMaskMode: 0 none, 1 highlight, 2 outline, 3 hide. The _PROPAGATE rules read it in the vertex shader and
+// hide elements, the _SHADE rules tint and outline them (and are left off of pick programs).
+
+const ShaderReplacementRule ELEMENT_MASK_PROPAGATE_GEOM (
+    // for the point/cylinder programs, which draw one vertex per element and expand it in a geometry shader
+    /* rule name */ "ELEMENT_MASK_PROPAGATE_GEOM",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          uniform sampler2D t_elementMask;
+          out float a_elementMaskToGeom;
+          float elementMaskMode(int ind) {
+            int width = textureSize(t_elementMask, 0).x;
+            return floor(texelFetch(t_elementMask, ivec2(ind % width, ind / width), 0).r * 255. + 0.5);
+          }
+        )"},
+      {"VERT_ASSIGNMENTS", R"(
+          a_elementMaskToGeom = elementMaskMode(gl_VertexID);
+        )"},
+      {"GEOM_DECLARATIONS", R"(
+          in float a_elementMaskToGeom[];
+          flat out float a_elementMaskToFrag;
+        )"},
+      {"GEOM_COMPUTE_BEFORE_EMIT", R"(
+          if(a_elementMaskToGeom[0] > 2.5) return; // hidden, emit nothing
+        )"},
+      {"GEOM_PER_EMIT", R"(
+          a_elementMaskToFrag = a_elementMaskToGeom[0];
+        )"},
+      {"FRAG_DECLARATIONS", R"(
+          flat in float a_elementMaskToFrag;
+        )"},
+      {"GLOBAL_FRAGMENT_FILTER", R"(
+          if(a_elementMaskToFrag > 2.5) discard; // (for programs which cannot skip hidden elements earlier)
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {},
+    /* textures */ {
+      {"t_elementMask", 2},
+    }
+);
+
+const ShaderReplacementRule ELEMENT_MASK_PROPAGATE_MESH (
+    // for mesh programs, which draw each triangle as three consecutive vertices
+    /* rule name */ "ELEMENT_MASK_PROPAGATE_MESH",
+    { /* replacement sources */
+      {"VERT_DECLARATIONS", R"(
+          uniform sampler2D t_elementMask;
+          flat out float a_elementMaskToFrag;
+          float elementMaskMode(int ind) {
+            int width = textureSize(t_elementMask, 0).x;
+            return floor(texelFetch(t_elementMask, ivec2(ind % width, ind / width), 0).r * 255. + 0.5);
+          }
+        )"},
+      {"VERT_ASSIGNMENTS", R"(
+          a_elementMaskToFrag = elementMaskMode(gl_VertexID / 3);
+          if(a_elementMaskToFrag > 2.5) gl_Position = vec4(0.); // hidden, collapse the triangle
+        )"},
+      {"FRAG_DECLARATIONS", R"(
+          flat in float a_elementMaskToFrag;
+        )"},
+    },
+    /* uniforms */ {},
+    /* attributes */ {},
+    /* textures */ {
+      {"t_elementMask", 2},
+    }
+);
+
+const ShaderReplacementRule ELEMENT_MASK_SHADE_RAYCAST (
+    // for raycast spheres and cylinders, outlines the silhouette
+    /* rule name */ "ELEMENT_MASK_SHADE_RAYCAST",
+    { /* replacement sources */
+      {"FRAG_DECLARATIONS", R"(
+          uniform vec3 u_elementMaskColor;
+        )"},
+      {"GENERATE_ALPHA", R"(
+          if(a_elementMaskToFrag > 1.5) {
+            // where the surface turns away from the view
+            float facing = abs(dot(normalize(nHit), normalize(viewRay)));
+            litColor = mix(litColor, u_elementMaskColor, 1. - smoothstep(0.4, 0.5, facing));
+          } else if(a_elementMaskToFrag > 0.5) {
+            litColor = mix(litColor, u_elementMaskColor, 0.6);
+          }
+        )"},
+    },
+    /* uniforms */ {
+      {"u_elementMaskColor", RenderDataType::Vector3Float},
+    },
+    /* attributes */ {},
+    /* textures */ {}
+);
+
+const ShaderReplacementRule ELEMENT_MASK_SHADE_FLAT (
+    // for flat point quads, which have no silhouette, so outlined elements are tinted like highlighted ones
+    /* rule name */ "ELEMENT_MASK_SHADE_FLAT",
+    { /* replacement sources */
+      {"FRAG_DECLARATIONS", R"(
+          uniform vec3 u_elementMaskColor;
+        )"},
+      {"GENERATE_ALPHA", R"(
+          if(a_elementMaskToFrag > 0.5) {
+            litColor = mix(litColor, u_elementMaskColor, 0.6);
+          }
+        )"},
+    },
+    /* uniforms */ {
+      {"u_elementMaskColor", RenderDataType::Vector3Float},
+    },
+    /* attributes */ {},
+    /* textures */ {}
+);
+
+const ShaderReplacementRule ELEMENT_MASK_SHADE_MESH (
+    // for meshes, outlines the triangle edges
+    /* rule name */ "ELEMENT_MASK_SHADE_MESH",
+    { /* replacement sources */
+      {"FRAG_DECLARATIONS", R"(
+          uniform vec3 u_elementMaskColor;
+        )"},
+      {"GENERATE_ALPHA", R"(
+          if(a_elementMaskToFrag > 1.5) {
+            // distance to the nearest edge, in pixels
+            vec3 edgeDist = a_barycoordToFrag / max(fwidth(a_barycoordToFrag), vec3(1e-6));
+            float outline = 1. - smoothstep(2., 3., min(edgeDist.x, min(edgeDist.y, edgeDist.z)));
+            litColor = mix(litColor, u_elementMaskColor, outline);
+          } else if(a_elementMaskToFrag > 0.5) {
+            litColor = mix(litColor, u_elementMaskColor, 0.6);
+          }
+        )"},
+    },
+    /* uniforms */ {
+      {"u_elementMaskColor", RenderDataType::Vector3Float},
+    },
+    /* attributes */ {},
+    /* textures */ {}
+);
+
+
 ShaderReplacementRule generateSlicePlaneRule(std::string uniquePostfix) {
 
   std::string centerUniformName = "u_slicePlaneCenter_" + uniquePostfix;
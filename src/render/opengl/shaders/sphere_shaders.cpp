@@ -132,6 +132,7 @@ const ShaderStageSpecification FLEX_SPHERE_FRAG_SHADER = {
     // source
 R"(
         ${ GLSL_VERSION }$
+        #extension GL_ARB_conservative_depth : enable
         uniform mat4 u_projMatrix; 
         uniform mat4 u_invProjMatrix;
         uniform vec4 u_viewport;
@@ -139,6 +140,12 @@ R"(
         in vec3 sphereCenterView;
         layout(location = 0) out vec4 outputF;
 
+        // The billboard is tangent to the front of the sphere, so the depth written is never less than the billboard's.
+        // Declaring this keeps early depth testing on where the extension is available.
+        #ifdef GL_ARB_conservative_depth
+        layout(depth_greater) out float gl_FragDepth;
+        #endif
+
         float LARGE_FLOAT();
         vec3 lightSurfaceMat(vec3 normal, vec3 color, sampler2D t_mat_r, sampler2D t_mat_g, sampler2D t_mat_b, sampler2D t_mat_k);
         vec3 fragmentViewPosition(vec4 viewport, vec2 depthRange, mat4 invProjMat, vec4 fragCoord);
@@ -191,6 +198,77 @@ R"(
 )"
 };
 
+// A cheap variant of the sphere fragment shader for depth pre-passes: it only computes the depth of the sphere, with
+// no shading. The depth is pushed back very slightly, so that the shading pass (which recomputes it) passes an LEqual
+// depth test even if the two programs round differently.
+const ShaderStageSpecification FLEX_SPHERE_DEPTH_FRAG_SHADER = {
+    
+    ShaderStageType::Fragment,
+    
+    // uniforms
+    {
+        {"u_projMatrix", RenderDataType::Matrix44Float},
+        {"u_invProjMatrix", RenderDataType::Matrix44Float},
+        {"u_viewport", RenderDataType::Vector4Float},
+        {"u_pointRadius", RenderDataType::Float},
+    }, 
+
+    { }, // attributes
+    
+    // textures 
+    {
+    },
+ 
+    // source
+R"(
+        ${ GLSL_VERSION }$
+        #extension GL_ARB_conservative_depth : enable
+        uniform mat4 u_projMatrix; 
+        uniform mat4 u_invProjMatrix;
+        uniform vec4 u_viewport;
+        uniform float u_pointRadius;
+        in vec3 sphereCenterView;
+        layout(location = 0) out vec4 outputF;
+
+        #ifdef GL_ARB_conservative_depth
+        layout(depth_greater) out float gl_FragDepth;
+        #endif
+
+        float LARGE_FLOAT();
+        vec3 fragmentViewPosition(vec4 viewport, vec2 depthRange, mat4 invProjMat, vec4 fragCoord);
+        bool raySphereIntersection(vec3 rayStart, vec3 rayDir, vec3 sphereCenter, float sphereRad, out float tHit, out vec3 pHit, out vec3 nHit);
+        float fragDepthFromView(mat4 projMat, vec2 depthRange, vec3 viewPoint);
+        
+        ${ FRAG_DECLARATIONS }$
+
+        void main()
+        {
+           // Build a ray corresponding to this fragment
+           vec2 depthRange = vec2(gl_DepthRange.near, gl_DepthRange.far);
+           vec3 viewRay = fragmentViewPosition(u_viewport, depthRange, u_invProjMatrix, gl_FragCoord);
+
+           float pointRadius = u_pointRadius;
+           ${ SPHERE_SET_POINT_RADIUS_FRAG }$
+
+           // Raycast to the sphere 
+           float tHit;
+           vec3 pHit;
+           vec3 nHit;
+           bool hit = raySphereIntersection(vec3(0., 0., 0), viewRay, sphereCenterView, pointRadius, tHit, pHit, nHit);
+           if(tHit >= LARGE_FLOAT()) {
+              discard;
+           }
+           float depth = fragDepthFromView(u_projMatrix, depthRange, pHit);
+
+           ${ GLOBAL_FRAGMENT_FILTER_PREP }$
+           ${ GLOBAL_FRAGMENT_FILTER }$
+           
+           gl_FragDepth = min(depth + 2.5e-7, depthRange.y);
+           outputF = vec4(0.);
+        }
+)"
+};
+
 //  These POINTQUAD shaders render a quad at the location of the point. Technically, 
 //  they don't draw spheres, but we group them here because they share a lot of logic 
 //  with the spheres & accept the same rules.
@@ -353,6 +431,112 @@ R"(
 };
 
 
+// Draws each point as a single GL point of a fixed size in pixels. The geometry stage only passes the point through, so
+// that the SPHERE_* rules for quantities and picking apply unchanged.
+const ShaderStageSpecification FLEX_POINTPIXEL_GEOM_SHADER = {
+    
+    ShaderStageType::Geometry,
+    
+    // uniforms
+    {
+        {"u_projMatrix", RenderDataType::Matrix44Float},
+        {"u_pointPixelSize", RenderDataType::Float},
+    }, 
+
+    // attributes
+    {
+    },
+
+    {}, // textures
+
+    // source
+R"(
+        ${ GLSL_VERSION }$
+
+        layout(points) in;
+        layout(points, max_vertices=1) out;
+        uniform mat4 u_projMatrix;
+        uniform float u_pointPixelSize;
+
+        ${ GEOM_DECLARATIONS }$
+
+        void main() {
+            
+            ${ GEOM_COMPUTE_BEFORE_EMIT }$
+
+            ${ GEOM_PER_EMIT }$ 
+            gl_Position = u_projMatrix * gl_in[0].gl_Position; 
+            gl_PointSize = u_pointPixelSize;
+            EmitVertex(); 
+    
+            EndPrimitive();
+        }
+
+)"
+};
+
+const ShaderStageSpecification FLEX_POINTPIXEL_FRAG_SHADER = {
+    
+    ShaderStageType::Fragment,
+    
+    // uniforms
+    {
+        {"u_pointPixelSize", RenderDataType::Float},
+    }, 
+
+    { }, // attributes
+    
+    // textures 
+    {
+    },
+ 
+    // source
+R"(
+        ${ GLSL_VERSION }$
+        uniform float u_pointPixelSize;
+        layout(location = 0) out vec4 outputF;
+
+        float LARGE_FLOAT();
+        vec3 lightSurfaceMat(vec3 normal, vec3 color, sampler2D t_mat_r, sampler2D t_mat_g, sampler2D t_mat_b, sampler2D t_mat_k);
+        
+        ${ FRAG_DECLARATIONS }$
+
+        void main()
+        {
+           
+           float depth = gl_FragCoord.z;
+           ${ GLOBAL_FRAGMENT_FILTER_PREP }$
+           ${ GLOBAL_FRAGMENT_FILTER }$
+
+           // Points a few pixels across are drawn as round splats, shaded as if each were a small sphere facing the
+           // camera. Smaller points just face the camera.
+           vec3 shadeNormal = vec3(0.0, 0.0, 1.0);
+           if(u_pointPixelSize > 2.5) {
+             vec2 splatCoord = vec2(2. * gl_PointCoord.x - 1., 1. - 2. * gl_PointCoord.y);
+             float splatR2 = dot(splatCoord, splatCoord);
+             if(splatR2 > 1.) discard;
+             shadeNormal = vec3(splatCoord, sqrt(1. - splatR2));
+           }
+          
+           // Shading
+           ${ GENERATE_SHADE_VALUE }$
+           ${ GENERATE_SHADE_COLOR }$
+
+           // Lighting
+           ${ GENERATE_LIT_COLOR }$
+
+           // Set alpha
+           float alphaOut = 1.0;
+           ${ GENERATE_ALPHA }$
+
+           // Write output
+           litColor *= alphaOut; // premultiplied alpha
+           outputF = vec4(litColor, alphaOut);
+        }
+)"
+};
+
+
 // == Rules
 
 const ShaderReplacementRule SPHERE_PROPAGATE_VALUE (
@@ -23,7 +23,6 @@ const ShaderStageSpecification FLEX_MESH_VERT_SHADER = {
     {
         {"a_vertexPositions", RenderDataType::Vector3Float},
         {"a_vertexNormals", RenderDataType::Vector3Float},
-        {"a_barycoord", RenderDataType::Vector3Float},
     },
 
     {}, // textures
@@ -39,7 +38,6 @@ R"(
         
         in vec3 a_vertexPositions;
         in vec3 a_vertexNormals;
-        in vec3 a_barycoord;
         out vec3 a_barycoordToFrag;
         out vec3 a_vertexNormalToFrag;
         
@@ -50,7 +48,11 @@ R"(
             gl_Position = u_projMatrix * u_modelView * vec4(a_vertexPositions,1.);
             
             a_vertexNormalToFrag = mat3(u_modelView) * a_vertexNormals;
-            a_barycoordToFrag = a_barycoord;
+
+            // Triangles are drawn as unindexed consecutive triples of vertices, so the barycentric coordinates follow
+            // from the vertex index (with indexed drawing they are meaningless, but nothing uses them there).
+            a_barycoordToFrag = vec3(0., 0., 0.);
+            a_barycoordToFrag[gl_VertexID % 3] = 1.;
 
             ${ VERT_ASSIGNMENTS }$
         }
@@ -431,11 +433,14 @@ const ShaderReplacementRule MESH_WIREFRAME_FROM_BARY(
     /* rule name */ "MESH_WIREFRAME_FROM_BARY",
     { /* replacement sources */
       {"VERT_DECLARATIONS", R"(
-          in vec3 a_edgeIsReal;
+          in float a_edgeIsRealMask;
           out vec3 a_edgeIsRealToFrag;
         )"},
       {"VERT_ASSIGNMENTS", R"(
-          a_edgeIsRealToFrag = a_edgeIsReal;
+          // bit k is set if the edge from corner k to k+1 is real
+          int edgeRealBits = int(a_edgeIsRealMask + 0.5);
+          a_edgeIsRealToFrag = vec3(float(edgeRealBits & 1), float((edgeRealBits >> 1) & 1),
+                                    float((edgeRealBits >> 2) & 1));
         )"},
       {"FRAG_DECLARATIONS", R"(
           in vec3 a_edgeIsRealToFrag;
@@ -447,8 +452,22 @@ const ShaderReplacementRule MESH_WIREFRAME_FROM_BARY(
     },
     /* uniforms */ { },
     /* attributes */ {
-      {"a_edgeIsReal", RenderDataType::Vector3Float},
+      {"a_edgeIsRealMask", RenderDataType::Float},
+    },
+    /* textures */ {}
+);
+
+// Like above, but for meshes where every triangle edge is real (pure triangle meshes), so no mask is needed
+const ShaderReplacementRule MESH_WIREFRAME_FROM_BARY_ALL_REAL(
+    /* rule name */ "MESH_WIREFRAME_FROM_BARY_ALL_REAL",
+    { /* replacement sources */
+      {"APPLY_WIREFRAME", R"(
+          vec3 wireframe_UVW = a_barycoordToFrag;
+          vec3 wireframe_mask = vec3(1., 1., 1.);
+      )"},
     },
+    /* uniforms */ { },
+    /* attributes */ { },
     /* textures */ {}
 );
 
@@ -582,6 +582,67 @@ R"(
 )"
 };
 
+const ShaderStageSpecification PICK_HIGHLIGHT = {
+  // Tint the pixels of the pick buffer which hold u_pickColor, and outline them with a band of a few pixels.
+    
+    // stage
+    ShaderStageType::Fragment,
+    
+    // uniforms
+    { 
+      {"u_pickColor", RenderDataType::Vector3Float},
+      {"u_texelSize", RenderDataType::Vector2Float},
+    }, 
+
+    // attributes
+    { },
+    
+    // textures 
+    { 
+      {"t_pick", 2},
+    },
+    
+    // source 
+R"(
+      ${ GLSL_VERSION }$
+
+      in vec2 tCoord;
+      uniform sampler2D t_pick;
+      uniform vec3 u_pickColor;
+      uniform vec2 u_texelSize;
+      layout(location = 0) out vec4 outputF;
+
+      // pick colors are exact multiples of 2^-22, so anything closer than that is a match
+      bool isPicked(vec2 coord) {
+        vec3 val = texture(t_pick, coord).rgb;
+        return all(lessThan(abs(val - u_pickColor), vec3(1e-7)));
+      }
+
+      void main()
+      {
+        const vec3 highlightColor = vec3(1.0, 0.85, 0.2);
+
+        if(isPicked(tCoord)) {
+          // premultiplied alpha
+          float alpha = 0.35;
+          outputF = vec4(alpha * highlightColor, alpha);
+          return;
+        }
+
+        for(int i = -2; i <= 2; i++) {
+          for(int j = -2; j <= 2; j++) {
+            if(isPicked(tCoord + vec2(i, j) * u_texelSize)) {
+              outputF = vec4(highlightColor, 1.);
+              return;
+            }
+          }
+        }
+
+        discard;
+      }
+)"
+};
+
 const ShaderReplacementRule TEXTURE_ORIGIN_UPPERLEFT (
     /* rule name */ "TEXTURE_ORIGIN_UPPERLEFT",
     { /* replacement sources */
@@ -732,6 +793,74 @@ const ShaderReplacementRule TEXTURE_PROPAGATE_COLOR(
     }
 );
 
+// input: page table and page atlas textures, from VirtualTexture
+// output: vec4 sampleVirtualTexture(vec2 tCoord)
+const ShaderReplacementRule VIRTUAL_TEXTURE_LOOKUP(
+    /* rule name */ "VIRTUAL_TEXTURE_LOOKUP",
+    { /* replacement sources */
+      {"FRAG_DECLARATIONS", R"(
+          uniform sampler2D t_vtPageTable;
+          uniform sampler2D t_vtAtlas;
+          uniform vec2 u_vtTextureSize;
+          uniform vec2 u_vtAtlasSize;
+          uniform float u_vtPageSize;
+          uniform float u_vtPageBorder;
+
+          vec4 sampleVirtualTexture(vec2 tCoordIn) {
+            // each page table entry holds the atlas location and level of the page to sample this region from
+            vec2 texel0 = clamp(tCoordIn, vec2(0.), vec2(1.)) * u_vtTextureSize;
+            ivec2 tableSize = textureSize(t_vtPageTable, 0);
+            ivec2 cell = clamp(ivec2(floor(texel0 / u_vtPageSize)), ivec2(0), tableSize - ivec2(1));
+            vec4 entry = texelFetch(t_vtPageTable, cell, 0);
+
+            vec2 texelL = texel0 / exp2(entry.z);
+            vec2 pageOrigin = floor(texelL / u_vtPageSize) * u_vtPageSize;
+            vec2 atlasTexel = entry.xy + vec2(u_vtPageBorder) + (texelL - pageOrigin);
+            return texture(t_vtAtlas, atlasTexel / u_vtAtlasSize);
+          }
+        )" }
+    },
+    /* uniforms */ {
+      {"u_vtTextureSize", RenderDataType::Vector2Float},
+      {"u_vtAtlasSize", RenderDataType::Vector2Float},
+      {"u_vtPageSize", RenderDataType::Float},
+      {"u_vtPageBorder", RenderDataType::Float},
+    },
+    /* attributes */ {},
+    /* textures */ {
+      {"t_vtPageTable", 2},
+      {"t_vtAtlas", 2},
+    }
+);
+
+// input: vec2 tcoord, VIRTUAL_TEXTURE_LOOKUP
+// output: float shadeValue
+const ShaderReplacementRule VIRTUAL_TEXTURE_PROPAGATE_VALUE(
+    /* rule name */ "VIRTUAL_TEXTURE_PROPAGATE_VALUE",
+    { /* replacement sources */
+      {"GENERATE_SHADE_VALUE", R"(
+        float shadeValue = sampleVirtualTexture(tCoord).r;
+        )"}
+    },
+    /* uniforms */ {},
+    /* attributes */ {},
+    /* textures */ {}
+);
+
+// input: vec2 tcoord, VIRTUAL_TEXTURE_LOOKUP
+// output: vec3 shadeColor
+const ShaderReplacementRule VIRTUAL_TEXTURE_PROPAGATE_COLOR(
+    /* rule name */ "VIRTUAL_TEXTURE_PROPAGATE_COLOR",
+    { /* replacement sources */
+      {"GENERATE_SHADE_VALUE", R"(
+        vec3 shadeColor = sampleVirtualTexture(tCoord).rgb;
+        )"}
+    },
+    /* uniforms */ {},
+    /* attributes */ {},
+    /* textures */ {}
+);
+
 const ShaderReplacementRule TEXTURE_BILLBOARD_FROM_UNIFORMS(
     /* rule name */ "TEXTURE_BILLBOARD_FROM_UNIFORMS",
     { /* replacement sources */
@@ -85,6 +85,85 @@ std::shared_ptr<AttributeBuffer> generateAttributeBuffer<glm::uvec4>(Engine* eng
   return engine->generateAttributeBuffer(RenderDataType::Vector4UInt);
 }
 
+// == Wrap externally-owned native buffers
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<float>(Engine* engine, uint32_t nativeID, int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Float, 1, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<double>(Engine* engine, uint32_t nativeID,
+                                                                   int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Float, 1, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<glm::vec2>(Engine* engine, uint32_t nativeID,
+                                                                      int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Vector2Float, 1, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<glm::vec3>(Engine* engine, uint32_t nativeID,
+                                                                      int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Vector3Float, 1, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<std::array<glm::vec3, 2>>(Engine* engine, uint32_t nativeID,
+                                                                                     int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Vector3Float, 2, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<std::array<glm::vec3, 3>>(Engine* engine, uint32_t nativeID,
+                                                                                     int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Vector3Float, 3, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<std::array<glm::vec3, 4>>(Engine* engine, uint32_t nativeID,
+                                                                                     int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Vector3Float, 4, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<glm::vec4>(Engine* engine, uint32_t nativeID,
+                                                                      int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Vector4Float, 1, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<uint32_t>(Engine* engine, uint32_t nativeID,
+                                                                     int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::UInt, 1, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<int32_t>(Engine* engine, uint32_t nativeID,
+                                                                    int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Int, 1, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<glm::uvec2>(Engine* engine, uint32_t nativeID,
+                                                                       int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Vector2UInt, 1, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<glm::uvec3>(Engine* engine, uint32_t nativeID,
+                                                                       int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Vector3UInt, 1, nativeID, dataSize);
+}
+
+template <>
+std::shared_ptr<AttributeBuffer> wrapNativeAttributeBuffer<glm::uvec4>(Engine* engine, uint32_t nativeID,
+                                                                       int64_t dataSize) {
+  return engine->wrapNativeAttributeBuffer(RenderDataType::Vector4UInt, 1, nativeID, dataSize);
+}
+
 // == Get buffer data at a single location
 
 template <>
@@ -354,6 +433,55 @@ std::shared_ptr<TextureBuffer> generateTextureBuffer(DeviceBufferType D, Engine*
   return nullptr;
 }
 
+// == Wrap externally-owned native textures
+
+namespace {
+
+// The texture format used to store each type, which must match the generateTextureBuffer() specializations above
+template <typename T>
+TextureFormat textureFormatForType() {
+  exception("bad call"); // types which cannot be stored as textures
+  return TextureFormat::R32F;
+}
+template <>
+TextureFormat textureFormatForType<float>() {
+  return TextureFormat::R32F;
+}
+template <>
+TextureFormat textureFormatForType<double>() {
+  return TextureFormat::R32F;
+}
+template <>
+TextureFormat textureFormatForType<glm::vec3>() {
+  return TextureFormat::RGB32F;
+}
+template <>
+TextureFormat textureFormatForType<glm::vec4>() {
+  return TextureFormat::RGBA32F;
+}
+
+} // namespace
+
+template <typename T>
+std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer(DeviceBufferType D, Engine* engine, uint32_t nativeID,
+                                                       uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ) {
+  switch (D) {
+  case DeviceBufferType::Attribute:
+    exception("bad call");
+    break;
+  case DeviceBufferType::Texture1d:
+    return engine->wrapNativeTextureBuffer(textureFormatForType<T>(), 1, nativeID, sizeX, 0, 0);
+    break;
+  case DeviceBufferType::Texture2d:
+    return engine->wrapNativeTextureBuffer(textureFormatForType<T>(), 2, nativeID, sizeX, sizeY, 0);
+    break;
+  case DeviceBufferType::Texture3d:
+    return engine->wrapNativeTextureBuffer(textureFormatForType<T>(), 3, nativeID, sizeX, sizeY, sizeZ);
+    break;
+  }
+  return nullptr;
+}
+
 // instantiations for the above function
 // clang-format off
 template std::shared_ptr<TextureBuffer> generateTextureBuffer<float     >(DeviceBufferType D, Engine* engine);
@@ -373,6 +501,23 @@ template std::shared_ptr<TextureBuffer> generateTextureBuffer<std::array<glm::ve
 template std::shared_ptr<TextureBuffer> generateTextureBuffer<std::array<glm::vec3, 3>>(DeviceBufferType D, Engine* engine);
 template std::shared_ptr<TextureBuffer> generateTextureBuffer<std::array<glm::vec3, 4>>(DeviceBufferType D, Engine* engine);
 
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<float     >(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<double    >(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<int32_t   >(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<uint32_t  >(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<glm::vec2>(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<glm::vec3>(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<glm::vec4>(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<glm::uvec2>(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<glm::uvec3>(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<glm::uvec4>(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<std::array<glm::vec3, 2>>(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<std::array<glm::vec3, 3>>(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+template std::shared_ptr<TextureBuffer> wrapNativeTextureBuffer<std::array<glm::vec3, 4>>(DeviceBufferType D, Engine* engine, uint32_t nativeID, uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+
 // clang-format on
 
 
@@ -0,0 +1,133 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/render/upload_scheduler.h"
+
+#include "polyscope/polyscope.h"
+#include "polyscope/render/managed_buffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace polyscope {
+namespace render {
+
+void UploadScheduler::enqueue(const void* buffer, ManagedBufferRegistry* registry, size_t nBytes,
+                              std::function<void()> upload) {
+  for (Entry& e : entries) {
+    if (e.buffer == buffer) {
+      e.registry = registry;
+      e.nBytes = nBytes;
+      e.upload = std::move(upload);
+      return;
+    }
+  }
+  entries.push_back(Entry{buffer, registry, nBytes, std::move(upload)});
+  requestRedraw();
+}
+
+void UploadScheduler::cancel(const void* buffer) {
+  entries.erase(std::remove_if(entries.begin(), entries.end(), [&](const Entry& e) { return e.buffer == buffer; }),
+                entries.end());
+}
+
+bool UploadScheduler::isPending(const void* buffer) const {
+  for (const Entry& e : entries) {
+    if (e.buffer == buffer) return true;
+  }
+  return false;
+}
+
+size_t UploadScheduler::pendingBytes() const {
+  size_t total = 0;
+  for (const Entry& e : entries) total += e.nBytes;
+  return total;
+}
+
+void UploadScheduler::service(size_t maxBytes, double maxMilliseconds) {
+  if (entries.empty()) return;
+
+  // Take the queue, the uploads below may queue more work
+  std::vector<Entry> queued;
+  queued.swap(entries);
+
+  // Gather the groups in the order they were first queued
+  std::vector<ManagedBufferRegistry*> groups;
+  std::vector<bool> groupVisible;
+  std::vector<size_t> entryGroup(queued.size());
+  for (size_t iE = 0; iE < queued.size(); iE++) {
+    ManagedBufferRegistry* reg = queued[iE].registry;
+    ManagedBufferRegistry* group = reg ? reg->getUploadGroup() : nullptr;
+    bool visible = reg ? reg->isUploadVisible() : true;
+
+    size_t iG = std::find(groups.begin(), groups.end(), group) - groups.begin();
+    if (iG == groups.size()) {
+      groups.push_back(group);
+      groupVisible.push_back(false);
+    }
+    groupVisible[iG] = groupVisible[iG] || visible;
+    entryGroup[iE] = iG;
+  }
+
+  // Visible groups first, otherwise first-come first-served
+  std::vector<size_t> groupOrder(groups.size());
+  std::iota(groupOrder.begin(), groupOrder.end(), 0);
+  std::stable_sort(groupOrder.begin(), groupOrder.end(),
+                   [&](size_t a, size_t b) { return groupVisible[a] && !groupVisible[b]; });
+
+  auto startTime = std::chrono::steady_clock::now();
+  size_t bytesUsed = 0;
+  bool anyApplied = false;
+  std::vector<bool> groupApplied(groups.size(), false);
+  for (size_t iG : groupOrder) {
+    if (anyApplied) {
+      double elapsedMs =
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+      if (bytesUsed >= maxBytes || elapsedMs >= maxMilliseconds) break;
+    }
+
+    for (size_t iE = 0; iE < queued.size(); iE++) {
+      if (entryGroup[iE] != iG) continue;
+      queued[iE].upload();
+      bytesUsed += queued[iE].nBytes;
+    }
+    groupApplied[iG] = true;
+    anyApplied = true;
+  }
+
+  std::vector<Entry> remaining;
+  for (size_t iE = 0; iE < queued.size(); iE++) {
+    if (!groupApplied[entryGroup[iE]]) remaining.push_back(std::move(queued[iE]));
+  }
+  requeue(remaining);
+
+  // Keep frames coming until the queue is drained
+  if (!entries.empty()) requestRedraw();
+}
+
+void UploadScheduler::flush() {
+  // (uploads may queue more work, e.g. by computing lazy buffers, so loop until empty)
+  while (!entries.empty()) {
+    std::vector<Entry> queued;
+    queued.swap(entries);
+    for (Entry& e : queued) e.upload();
+  }
+}
+
+void UploadScheduler::requeue(std::vector<Entry>& remaining) {
+  for (Entry& e : entries) {
+    bool merged = false;
+    for (Entry& r : remaining) {
+      if (r.buffer == e.buffer) {
+        r = std::move(e);
+        merged = true;
+        break;
+      }
+    }
+    if (!merged) remaining.push_back(std::move(e));
+  }
+  entries = std::move(remaining);
+}
+
+} // namespace render
+} // namespace polyscope
@@ -0,0 +1,265 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/scene_statistics.h"
+
+#include "polyscope/messages.h"
+#include "polyscope/parallel.h"
+#include "polyscope/polyscope.h"
+#include "polyscope/structure.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <set>
+
+namespace polyscope {
+namespace scene_statistics {
+
+namespace {
+
+// Values gathered and sorted by each worker
+const size_t minChunkSize = 1 << 16;
+
+// The finite values of a quantity which pass a filter, sorted
+struct CachedValues {
+  uint64_t dataVersion = 0;
+  uint64_t filterVersion = 0;
+  std::vector<float> sorted;
+  double sum = 0.;
+};
+
+// By the unique ID of the values buffer, and the filter
+std::map<std::pair<uint64_t, ElementFilter>, CachedValues> cache;
+size_t buildCount = 0;
+
+void gatherSortedValues(const std::vector<float>& values, const std::vector<char>& include, CachedValues& out) {
+  size_t nChunks = parallelChunkCount(values.size(), minChunkSize);
+  std::vector<std::vector<float>> chunks(nChunks);
+  std::vector<double> chunkSums(nChunks, 0.);
+
+  parallelForChunks(values.size(), minChunkSize, [&](size_t iStart, size_t iEnd, size_t iChunk) {
+    std::vector<float>& chunk = chunks[iChunk];
+    chunk.reserve(iEnd - iStart);
+    double sum = 0.;
+    for (size_t i = iStart; i < iEnd; i++) {
+      float v = values[i];
+      if (!std::isfinite(v) || (!include.empty() && !include[i])) continue;
+      chunk.push_back(v);
+      sum += v;
+    }
+    std::sort(chunk.begin(), chunk.end());
+    chunkSums[iChunk] = sum;
+  });
+
+  // Merge pairs of chunks until one is left
+  while (chunks.size() > 1) {
+    size_t nPairs = chunks.size() / 2;
+    std::vector<std::vector<float>> merged((chunks.size() + 1) / 2);
+    parallelForChunks(nPairs, 1, [&](size_t iStart, size_t iEnd, size_t /* iChunk */) {
+      for (size_t iPair = iStart; iPair < iEnd; iPair++) {
+        const std::vector<float>& a = chunks[2 * iPair];
+        const std::vector<float>& b = chunks[2 * iPair + 1];
+        merged[iPair].resize(a.size() + b.size());
+        std::merge(a.begin(), a.end(), b.begin(), b.end(), merged[iPair].begin());
+      }
+    });
+    if (chunks.size() % 2 == 1) merged.back() = std::move(chunks.back());
+    chunks = std::move(merged);
+  }
+
+  out.sorted = std::move(chunks.front());
+  out.sum = 0.;
+  for (double s : chunkSums) out.sum += s;
+}
+
+// The values of a quantity for a filter, from the cache if they are current (null if the filter can't be applied)
+const CachedValues* getCachedValues(Quantity& q, ElementFilter filter) {
+  render::ManagedBuffer<float>* values = q.getScalarValues();
+  uint64_t filterVersion = 0;
+  if (values == nullptr || !q.parent.filterScalarQuantityElements(q, filter, filterVersion, nullptr)) return nullptr;
+
+  std::pair<uint64_t, ElementFilter> key{values->uniqueID, filter};
+  std::map<std::pair<uint64_t, ElementFilter>, CachedValues>::iterator it = cache.find(key);
+  if (it != cache.end() && it->second.dataVersion == values->getDataVersion() &&
+      it->second.filterVersion == filterVersion) {
+    return &it->second;
+  }
+
+  std::vector<char> include;
+  q.parent.filterScalarQuantityElements(q, filter, filterVersion, &include);
+  const std::vector<float>& data = values->getPopulatedHostBufferRef();
+  if (!include.empty() && include.size() != data.size()) {
+    exception("scene statistics: element filter for quantity [" + q.name + "] on [" + q.parent.name + "] has " +
+              std::to_string(include.size()) + " entries, but there are " + std::to_string(data.size()) + " values");
+  }
+
+  CachedValues& entry = cache[key];
+  entry.dataVersion = values->getDataVersion();
+  entry.filterVersion = filterVersion;
+  gatherSortedValues(data, include, entry);
+  buildCount++;
+  return &entry;
+}
+
+// Drop the entries for buffers which no longer exist
+void pruneCache() {
+  std::set<uint64_t> liveIDs;
+  for (auto& typeMap : state::structures) {
+    for (auto& entry : typeMap.second) {
+      for (Quantity* q : entry.second->getQuantityList()) {
+        render::ManagedBuffer<float>* values = q->getScalarValues();
+        if (values) liveIDs.insert(values->uniqueID);
+      }
+    }
+  }
+  for (std::map<std::pair<uint64_t, ElementFilter>, CachedValues>::iterator it = cache.begin(); it != cache.end();) {
+    if (liveIDs.find(it->first.first) == liveIDs.end()) {
+      it = cache.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// Maps finite floats to unsigned integers in the same order, so ranks can be found by bisection
+uint32_t orderedKey(float v) {
+  uint32_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+float fromOrderedKey(uint32_t key) {
+  uint32_t bits = (key & 0x80000000u) ? (key & 0x7fffffffu) : ~key;
+  float v;
+  std::memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+// The value with rank `rank` (counting from 0) among all of the sorted arrays together, all of which lie in [low, high]
+float selectRank(const std::vector<const std::vector<float>*>& arrays, size_t rank, float low, float high) {
+  if (arrays.size() == 1) return (*arrays.front())[rank];
+
+  // Find the smallest value which has more than `rank` values at or below it
+  uint32_t keyLow = orderedKey(low);
+  uint32_t keyHigh = orderedKey(high);
+  while (keyLow < keyHigh) {
+    uint32_t keyMid = keyLow + (keyHigh - keyLow) / 2;
+    float v = fromOrderedKey(keyMid);
+    size_t count = 0;
+    for (const std::vector<float>* a : arrays) {
+      count += std::upper_bound(a->begin(), a->end(), v) - a->begin();
+    }
+    if (count > rank) {
+      keyHigh = keyMid;
+    } else {
+      keyLow = keyMid + 1;
+    }
+  }
+  return fromOrderedKey(keyLow);
+}
+
+ScalarStatistics summarize(const std::vector<const CachedValues*>& entries, const ScalarStatisticsQuery& query) {
+  ScalarStatistics stats;
+  std::vector<const std::vector<float>*> arrays;
+  double sum = 0.;
+  for (const CachedValues* e : entries) {
+    if (e->sorted.empty()) continue;
+    arrays.push_back(&e->sorted);
+    stats.nValues += e->sorted.size();
+    stats.min = std::min(stats.min, e->sorted.front());
+    stats.max = std::max(stats.max, e->sorted.back());
+    sum += e->sum;
+  }
+  if (stats.nValues > 0) stats.mean = sum / stats.nValues;
+
+  for (double t : query.thresholds) {
+    size_t count = 0;
+    for (const std::vector<float>* a : arrays) {
+      count += a->end() - std::upper_bound(a->begin(), a->end(), t);
+    }
+    stats.nAboveThresholds.push_back(count);
+  }
+
+  for (double p : query.percentiles) {
+    if (stats.nValues == 0) {
+      stats.percentiles.push_back(std::numeric_limits<float>::quiet_NaN());
+      continue;
+    }
+    double pos = p / 100. * (stats.nValues - 1);
+    size_t rankLow = static_cast<size_t>(std::floor(pos));
+    double frac = pos - rankLow;
+    float vLow = selectRank(arrays, rankLow, stats.min, stats.max);
+    float vHigh = frac > 0. ? selectRank(arrays, rankLow + 1, stats.min, stats.max) : vLow;
+    stats.percentiles.push_back(static_cast<float>(vLow + frac * (vHigh - vLow)));
+  }
+
+  return stats;
+}
+
+void checkQuery(const ScalarStatisticsQuery& query) {
+  for (double p : query.percentiles) {
+    if (!(p >= 0. && p <= 100.)) {
+      exception("scene statistics: percentile " + std::to_string(p) + " is outside of [0, 100]");
+    }
+  }
+}
+
+} // namespace
+
+std::vector<Quantity*> findScalarQuantities(const ScalarStatisticsQuery& query) {
+  std::vector<Quantity*> found;
+  for (auto& typeMap : state::structures) {
+    if (query.structureType != "" && typeMap.first != query.structureType) continue;
+    for (auto& entry : typeMap.second) {
+      Structure& s = *entry.second;
+      if (query.structureName != "" && s.name != query.structureName) continue;
+      if (query.filter == ElementFilter::Visible && !s.isEnabled()) continue;
+      for (Quantity* q : s.getQuantityList()) {
+        if (query.quantityName != "" && q->name != query.quantityName) continue;
+        if (q->getScalarValues() == nullptr) continue;
+        uint64_t filterVersion;
+        if (!s.filterScalarQuantityElements(*q, query.filter, filterVersion, nullptr)) continue;
+        found.push_back(q);
+      }
+    }
+  }
+  return found;
+}
+
+ScalarStatistics computeScalarStatistics(const ScalarStatisticsQuery& query) {
+  checkQuery(query);
+  pruneCache();
+  std::vector<const CachedValues*> entries;
+  for (Quantity* q : findScalarQuantities(query)) {
+    entries.push_back(getCachedValues(*q, query.filter));
+  }
+  return summarize(entries, query);
+}
+
+std::vector<std::pair<Quantity*, ScalarStatistics>>
+computeScalarStatisticsPerQuantity(const ScalarStatisticsQuery& query) {
+  checkQuery(query);
+  pruneCache();
+  std::vector<std::pair<Quantity*, ScalarStatistics>> result;
+  for (Quantity* q : findScalarQuantities(query)) {
+    result.emplace_back(q, summarize({getCachedValues(*q, query.filter)}, query));
+  }
+  return result;
+}
+
+void clearCache() { cache.clear(); }
+
+size_t getCacheValueCount() {
+  size_t count = 0;
+  for (const std::pair<const std::pair<uint64_t, ElementFilter>, CachedValues>& entry : cache) {
+    count += entry.second.sorted.size();
+  }
+  return count;
+}
+
+size_t getCacheBuildCount() { return buildCount; }
+
+} // namespace scene_statistics
+} // namespace polyscope
@@ -0,0 +1,183 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/screen_region.h"
+
+#include "polyscope/view.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace polyscope {
+
+namespace {
+
+const float floatInf = std::numeric_limits<float>::infinity();
+
+// Does the segment a-b touch the rectangle? (Liang-Barsky clipping)
+bool segmentHitsRect(glm::vec2 a, glm::vec2 b, glm::vec2 rectMin, glm::vec2 rectMax) {
+  glm::vec2 d = b - a;
+  float tEnter = 0.;
+  float tExit = 1.;
+  for (int i = 0; i < 2; i++) {
+    if (d[i] == 0.) {
+      if (a[i] < rectMin[i] || a[i] > rectMax[i]) return false;
+      continue;
+    }
+    float t0 = (rectMin[i] - a[i]) / d[i];
+    float t1 = (rectMax[i] - a[i]) / d[i];
+    if (t0 > t1) std::swap(t0, t1);
+    tEnter = std::max(tEnter, t0);
+    tExit = std::min(tExit, t1);
+    if (tEnter > tExit) return false;
+  }
+  return true;
+}
+
+bool rectsOverlap(glm::vec2 minA, glm::vec2 maxA, glm::vec2 minB, glm::vec2 maxB) {
+  return minA.x <= maxB.x && minB.x <= maxA.x && minA.y <= maxB.y && minB.y <= maxA.y;
+}
+
+bool rectContains(glm::vec2 rectMin, glm::vec2 rectMax, glm::vec2 p) {
+  return p.x >= rectMin.x && p.x <= rectMax.x && p.y >= rectMin.y && p.y <= rectMax.y;
+}
+
+} // namespace
+
+// === ScreenRegion
+
+ScreenRegion ScreenRegion::box(glm::vec2 cornerA, glm::vec2 cornerB) {
+  ScreenRegion r;
+  r.boundMin = glm::vec2{std::min(cornerA.x, cornerB.x), std::min(cornerA.y, cornerB.y)};
+  r.boundMax = glm::vec2{std::max(cornerA.x, cornerB.x), std::max(cornerA.y, cornerB.y)};
+  return r;
+}
+
+ScreenRegion ScreenRegion::lasso(std::vector<glm::vec2> polygon) {
+  ScreenRegion r;
+  if (polygon.size() < 3) {
+    // Degenerate, select nothing
+    r.boundMin = glm::vec2{floatInf, floatInf};
+    r.boundMax = -r.boundMin;
+    return r;
+  }
+  r.polygon = std::move(polygon);
+  r.boundMin = r.polygon[0];
+  r.boundMax = r.polygon[0];
+  for (const glm::vec2& p : r.polygon) {
+    r.boundMin = glm::vec2{std::min(r.boundMin.x, p.x), std::min(r.boundMin.y, p.y)};
+    r.boundMax = glm::vec2{std::max(r.boundMax.x, p.x), std::max(r.boundMax.y, p.y)};
+  }
+  return r;
+}
+
+bool ScreenRegion::contains(glm::vec2 p) const {
+  if (!rectContains(boundMin, boundMax, p)) return false;
+  if (!isLasso()) return true;
+
+  // Even-odd rule
+  bool inside = false;
+  size_t n = polygon.size();
+  for (size_t i = 0, j = n - 1; i < n; j = i++) {
+    const glm::vec2& a = polygon[i];
+    const glm::vec2& b = polygon[j];
+    if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+int ScreenRegion::classifyRect(glm::vec2 rectMin, glm::vec2 rectMax) const {
+  if (!rectsOverlap(rectMin, rectMax, boundMin, boundMax)) return 0;
+
+  if (!isLasso()) {
+    bool inside = rectContains(boundMin, boundMax, rectMin) && rectContains(boundMin, boundMax, rectMax);
+    return inside ? 2 : 1;
+  }
+
+  // If no edge of the lasso touches the rectangle, the rectangle is either entirely inside or entirely outside, unless
+  // the lasso is inside the rectangle
+  size_t n = polygon.size();
+  for (size_t i = 0, j = n - 1; i < n; j = i++) {
+    if (segmentHitsRect(polygon[j], polygon[i], rectMin, rectMax)) return 1;
+  }
+  if (rectContains(rectMin, rectMax, polygon[0])) return 1;
+  return contains(0.5f * (rectMin + rectMax)) ? 2 : 0;
+}
+
+// === PointRegionIndex
+
+bool PointRegionIndex::isCurrent(const std::vector<uint64_t>& key) const { return haveKey && key == currentKey; }
+
+void PointRegionIndex::build(const std::vector<glm::vec3>& points, std::vector<uint64_t> key) {
+  bvh.build(points, points);
+  currentKey = std::move(key);
+  haveKey = true;
+}
+
+void PointRegionIndex::clear() {
+  bvh = BVH();
+  currentKey.clear();
+  haveKey = false;
+}
+
+std::vector<size_t> PointRegionIndex::select(const std::vector<glm::vec3>& points, const ScreenRegion& region,
+                                             const glm::mat4& objectToClip) const {
+
+  float w = static_cast<float>(view::windowWidth);
+  float h = static_cast<float>(view::windowHeight);
+
+  // Project to screen coordinates, returns false if the point is behind the camera or outside the near/far planes
+  auto project = [&](glm::vec3 p, glm::vec2& screenOut, float& depthOut) -> bool {
+    glm::vec4 clip = objectToClip * glm::vec4(p, 1.);
+    if (!(clip.w > 0.)) return false;
+    glm::vec3 ndc = glm::vec3(clip) / clip.w;
+    screenOut = glm::vec2{(0.5f * ndc.x + 0.5f) * w, (0.5f - 0.5f * ndc.y) * h};
+    depthOut = ndc.z;
+    return true;
+  };
+
+  // Bound the projection of a box by projecting its corners. Boxes which straddle the camera plane can't be bounded
+  // this way, so they are always descended in to.
+  auto boxInRegion = [&](glm::vec3 boxMin, glm::vec3 boxMax) -> int {
+    glm::vec2 sMin{floatInf, floatInf};
+    glm::vec2 sMax = -sMin;
+    int nBehind = 0;
+    int nBeforeNear = 0;
+    int nPastFar = 0;
+    for (int c = 0; c < 8; c++) {
+      glm::vec3 corner{(c & 1) ? boxMax.x : boxMin.x, (c & 2) ? boxMax.y : boxMin.y, (c & 4) ? boxMax.z : boxMin.z};
+      glm::vec2 s;
+      float depth;
+      if (!project(corner, s, depth)) {
+        nBehind++;
+        continue;
+      }
+      if (depth < -1.) nBeforeNear++;
+      if (depth > 1.) nPastFar++;
+      sMin = glm::vec2{std::min(sMin.x, s.x), std::min(sMin.y, s.y)};
+      sMax = glm::vec2{std::max(sMax.x, s.x), std::max(sMax.y, s.y)};
+    }
+    if (nBehind == 8 || nPastFar == 8) return 0;
+    if (nBehind > 0) return 1;
+    int status = region.classifyRect(sMin, sMax);
+    if (status == 2 && (nBeforeNear > 0 || nPastFar > 0)) status = 1; // some points might still be clipped
+    return status;
+  };
+
+  std::vector<size_t> result;
+  auto visitPrimitive = [&](size_t iP) {
+    glm::vec2 s;
+    float depth;
+    if (!project(points[iP], s, depth)) return;
+    if (depth < -1. || depth > 1.) return;
+    if (!region.contains(s)) return;
+    result.push_back(iP);
+  };
+
+  bvh.visitRegion(boxInRegion, visitPrimitive);
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+} // namespace polyscope
@@ -66,10 +66,12 @@ void saveImage(std::string name, unsigned char* buffer, int w, int h, int channe
 void screenshot(std::string filename, bool transparentBG) {
 
   render::engine->useAltDisplayBuffer = true;
+  render::engine->loadAllTexturePages = true; // don't capture virtual textures at coarser levels than the view needs
   if (transparentBG) render::engine->lightCopy = true; // copy directly in to buffer without blending
 
   // == Make sure we render first
   processLazyProperties();
+  render::engine->uploadScheduler.flush(); // screenshots always get the latest data
 
   // save the redraw requested bit and restore it below
   bool requestedAlready = redrawRequested();
@@ -100,6 +102,7 @@ void screenshot(std::string filename, bool transparentBG) {
   saveImage(filename, &(buff.front()), w, h, 4);
 
   render::engine->useAltDisplayBuffer = false;
+  render::engine->loadAllTexturePages = false;
   if (transparentBG) render::engine->lightCopy = false;
 }
 
@@ -125,10 +128,12 @@ void resetScreenshotIndex() { state::screenshotInd = 0; }
 std::vector<unsigned char> screenshotToBuffer(bool transparentBG) {
 
   render::engine->useAltDisplayBuffer = true;
+  render::engine->loadAllTexturePages = true; // don't capture virtual textures at coarser levels than the view needs
   if (transparentBG) render::engine->lightCopy = true; // copy directly in to buffer without blending
 
   // == Make sure we render first
   processLazyProperties();
+  render::engine->uploadScheduler.flush(); // screenshots always get the latest data
 
   // save the redraw requested bit and restore it below
   bool requestedAlready = redrawRequested();
@@ -156,6 +161,7 @@ std::vector<unsigned char> screenshotToBuffer(bool transparentBG) {
   }
 
   render::engine->useAltDisplayBuffer = false;
+  render::engine->loadAllTexturePages = false;
   if (transparentBG) render::engine->lightCopy = false;
 
   return buff;
@@ -2,6 +2,7 @@
 
 #include "polyscope/structure.h"
 
+#include "polyscope/pick.h"
 #include "polyscope/polyscope.h"
 
 #include "imgui.h"
@@ -34,6 +35,10 @@ Structure* Structure::setEnabled(bool newEnabled) {
 
 bool Structure::isEnabled() { return enabled.get(); };
 
+bool Structure::isUploadVisible() { return isEnabled(); }
+
+bool Structure::buffersAffectPicking() { return true; }
+
 void Structure::enableIsolate() {
   for (auto& structure : polyscope::state::structures[this->typeName()]) {
     structure.second->setEnabled(false);
@@ -160,6 +165,7 @@ void Structure::buildCustomOptionsUI() {}
 
 void Structure::refresh() {
   updateObjectSpaceBounds();
+  pick::markPickBufferStale();
   requestRedraw();
 }
 
@@ -225,6 +231,38 @@ void Structure::rescaleToUnit() {
 
 bool Structure::hasExtents() { return true; }
 
+bool Structure::queryRay(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayHit& hitOut) { return false; }
+
+bool Structure::selectInScreenRegion(const ScreenRegion& region, std::vector<size_t>& localIndsOut) { return false; }
+
+std::vector<Quantity*> Structure::getQuantityList() { return {}; }
+
+bool Structure::filterScalarQuantityElements(Quantity& q, ElementFilter filter, uint64_t& versionOut,
+                                             std::vector<char>* includeOut) {
+  versionOut = 0;
+  if (includeOut) includeOut->clear();
+  return filter != ElementFilter::Selected;
+}
+
+bool Structure::queryRayAccel(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayQueryAccel::Hit& primHit,
+                              RayHit& hitOut) {
+
+  // Transform the ray to object space. The direction is not re-normalized, so that t values are the same in both.
+  const glm::mat4x4& T = objectTransform.get();
+  glm::mat4x4 Tinv = glm::inverse(T);
+  glm::vec4 originObj = Tinv * glm::vec4(rayOrigin, 1.);
+  glm::vec3 dirObj = glm::vec3(Tinv * glm::vec4(rayDir, 0.));
+
+  if (!rayQueryAccel.intersect(glm::vec3(originObj) / originObj.w, dirObj, waitForBuild, primHit)) {
+    return false;
+  }
+
+  hitOut.structure = this;
+  hitOut.t = primHit.t;
+  hitOut.position = rayOrigin + primHit.t * rayDir;
+  return true;
+}
+
 glm::mat4 Structure::getModelView() { return view::getCameraViewMatrix() * objectTransform.get(); }
 
 std::vector<std::string> Structure::addStructureRules(std::vector<std::string> initRules) {
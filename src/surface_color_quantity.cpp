@@ -130,15 +130,78 @@ SurfaceTextureColorQuantity::SurfaceTextureColorQuantity(std::string name, Surfa
   colors.setTextureSize(dimX, dimY);
 }
 
+SurfaceTextureColorQuantity::SurfaceTextureColorQuantity(std::string name, SurfaceMesh& mesh_,
+                                                         SurfaceParameterizationQuantity& param_,
+                                                         std::shared_ptr<VirtualTextureSource> source_,
+                                                         ImageOrigin origin_)
+    : SurfaceColorQuantity(name, mesh_, "texture", std::vector<glm::vec3>()), param(param_), dimX(source_->dimX()),
+      dimY(source_->dimY()), imageOrigin(origin_), externalSource(source_) {
+  if (externalSource->nChannels() != 3) {
+    exception("texture color quantity [" + name + "] must be read from a source with 3 channels");
+  }
+  colors.setTextureSize(dimX, dimY);
+}
+
+void SurfaceTextureColorQuantity::draw() {
+  if (!isEnabled()) return;
+
+  if (usesVirtualTexture()) {
+    prepareVirtualTexture();
+  } else if (virtualTexture) {
+    // the threshold was raised, go back to a regular texture
+    virtualTexture.reset();
+    program.reset();
+  }
+
+  SurfaceColorQuantity::draw();
+}
+
+bool SurfaceTextureColorQuantity::usesVirtualTexture() const {
+  return externalSource != nullptr || std::max(dimX, dimY) > options::virtualTextureThreshold;
+}
+
+void SurfaceTextureColorQuantity::prepareVirtualTexture() {
+  if (externalSource) {
+    if (!virtualTexture) {
+      virtualTexture.reset(new VirtualTexture(externalSource, options::virtualTextureCachePages));
+      program.reset();
+    }
+  } else {
+    // Pages are read straight from the colors array, so start over whenever it changes
+    colors.ensureHostBufferPopulated();
+    if (!virtualTexture || virtualTextureDataVersion != colors.getDataVersion()) {
+      std::shared_ptr<VirtualTextureSource> source =
+          VirtualTextureSource::fromHostData(&colors.data.front().x, dimX, dimY, 3);
+      virtualTexture.reset(new VirtualTexture(source, options::virtualTextureCachePages));
+      virtualTextureDataVersion = colors.getDataVersion();
+      program.reset();
+    }
+  }
+
+  param.requestVirtualTexturePages(*virtualTexture, imageOrigin);
+  if (render::engine->loadAllTexturePages) {
+    virtualTexture->flush();
+  } else {
+    virtualTexture->update(options::virtualTexturePageUploadsPerFrame);
+  }
+}
+
 void SurfaceTextureColorQuantity::createProgram() {
+  std::vector<std::string> textureRules{"MESH_PROPAGATE_TCOORD", getImageOriginRule(imageOrigin)};
+  if (virtualTexture) {
+    textureRules.push_back("VIRTUAL_TEXTURE_LOOKUP");
+    textureRules.push_back("VIRTUAL_TEXTURE_PROPAGATE_COLOR");
+  } else {
+    textureRules.push_back("TEXTURE_PROPAGATE_COLOR");
+  }
+  textureRules.push_back("SHADE_COLOR");
+
   // Create the program to draw this quantity
   // clang-format off
   program = render::engine->requestShader("MESH", 
       render::engine->addMaterialRules(parent.getMaterial(),
         addColorRules(
-          parent.addSurfaceMeshRules(
-            {"MESH_PROPAGATE_TCOORD", getImageOriginRule(imageOrigin), "TEXTURE_PROPAGATE_COLOR", "SHADE_COLOR"}
-          )
+          parent.addSurfaceMeshRules(textureRules)
         )
       )
     );
@@ -159,11 +222,14 @@ void SurfaceTextureColorQuantity::createProgram() {
     break;
   }
 
-  program->setTextureFromBuffer("t_color", colors.getRenderTextureBuffer().get());
+  if (virtualTexture) {
+    virtualTexture->setTextures(*program);
+    virtualTexture->setUniforms(*program);
+  } else {
+    program->setTextureFromBuffer("t_color", colors.getRenderTextureBuffer().get());
+    colors.getRenderTextureBuffer()->setFilterMode(FilterMode::Linear);
+  }
   render::engine->setMaterial(*program, parent.getMaterial());
-
-  colors.getRenderTextureBuffer()->setFilterMode(FilterMode::Linear);
 }
 
-
 } // namespace polyscope
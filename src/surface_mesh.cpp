@@ -4,19 +4,29 @@
 
 #include "glm/fwd.hpp"
 #include "polyscope/combining_hash_functions.h"
+#include "polyscope/locality_order.h"
 #include "polyscope/pick.h"
 #include "polyscope/polyscope.h"
+#include "polyscope/reductions.h"
+#include "polyscope/region_selection.h"
 #include "polyscope/render/engine.h"
 
 #include "imgui.h"
+#include "polyscope/parallel.h"
 #include "polyscope/types.h"
 #include "polyscope/utilities.h"
 
+#include <algorithm>
 #include <unordered_map>
 #include <utility>
 
 namespace polyscope {
 
+namespace {
+// Don't bother spinning up threads to process fewer faces than this
+const size_t connectivityMinChunkSize = 1 << 16;
+} // namespace
+
 // Initialize statics
 const std::string SurfaceMesh::structureTypeName = "Surface Mesh";
 
@@ -40,8 +50,7 @@ triangleAllHalfedgeInds(   this, uniquePrefix() + "triangleHalfedgeInds",     tr
 triangleAllCornerInds(     this, uniquePrefix() + "triangleAllCornerInds",    triangleAllCornerIndsData,      std::bind(&SurfaceMesh::computeTriangleAllCornerInds, this)),
 
 // internal triangle data for rendering
-baryCoord(              this, uniquePrefix() + "baryCoord",           baryCoordData),
-edgeIsReal(             this, uniquePrefix() + "edgeIsReal",          edgeIsRealData),
+edgeIsRealMask(         this, uniquePrefix() + "edgeIsRealMask",      edgeIsRealMaskData,     std::bind(&SurfaceMesh::computeEdgeIsRealMask, this)),
 
 // other internally-computed geometry
 faceNormals(            this, uniquePrefix() + "faceNormals",         faceNormalsData,        std::bind(&SurfaceMesh::computeFaceNormals, this)),
@@ -66,12 +75,12 @@ shadeStyle(             uniquePrefix() + "shadeStyle",      MeshShadeStyle::Flat
 {}
 
 SurfaceMesh::SurfaceMesh(std::string name_, const std::vector<glm::vec3>& vertexPositions_,
-                         const std::vector<uint32_t>& faceIndsEntries_, const std::vector<uint32_t>& faceIndsStart_)
+                         std::vector<uint32_t> faceIndsEntries_, std::vector<uint32_t> faceIndsStart_)
     : SurfaceMesh(name_) {
 
   vertexPositionsData = vertexPositions_;
-  faceIndsEntries = faceIndsEntries_;
-  faceIndsStart = faceIndsStart_;
+  faceIndsEntries = std::move(faceIndsEntries_);
+  faceIndsStart = std::move(faceIndsStart_);
 
   computeConnectivityData();
   updateObjectSpaceBounds();
@@ -104,27 +113,105 @@ void SurfaceMesh::nestedFacesToFlat(const std::vector<std::vector<size_t>>& nest
 
 void SurfaceMesh::computeConnectivityData() {
 
-  // some number-of-elements arithmetic
   size_t numFaces = faceIndsStart.size() - 1;
   nCornersCount = faceIndsEntries.size();
+
+  // Validate in bulk: check that every face has at least 3 vertices (which also means the face offsets increase), find
+  // the largest vertex index, and check whether all faces are triangles
+  size_t nChunks = parallelChunkCount(numFaces, connectivityMinChunkSize);
+  std::vector<uint32_t> chunkMaxInd(nChunks, 0);
+  std::vector<char> chunkAllTriangles(nChunks, true);
+  std::vector<char> chunkDegreesValid(nChunks, true);
+  parallelForChunks(numFaces, connectivityMinChunkSize, [&](size_t iStart, size_t iEnd, size_t iChunk) {
+    uint32_t maxInd = 0;
+    bool allTriangles = true;
+    for (size_t iF = iStart; iF < iEnd; iF++) {
+      if (faceIndsStart[iF + 1] < faceIndsStart[iF] + 3) {
+        chunkDegreesValid[iChunk] = false;
+        return; // (the entries of this chunk can't be trusted)
+      }
+      allTriangles = allTriangles && (faceIndsStart[iF + 1] - faceIndsStart[iF] == 3);
+    }
+    for (size_t i = faceIndsStart[iStart]; i < faceIndsStart[iEnd]; i++) {
+      maxInd = std::max(maxInd, faceIndsEntries[i]);
+    }
+    chunkMaxInd[iChunk] = maxInd;
+    chunkAllTriangles[iChunk] = allTriangles;
+  });
+
+  // validate the face degrees
+  if (std::find(chunkDegreesValid.begin(), chunkDegreesValid.end(), false) != chunkDegreesValid.end()) {
+    for (size_t iF = 0; iF < numFaces; iF++) {
+      if (faceIndsStart[iF + 1] < faceIndsStart[iF] + 3) {
+        exception("SurfaceMesh " + name + " face " + std::to_string(iF) + " has entries [" +
+                  std::to_string(faceIndsStart[iF]) + ", " + std::to_string(faceIndsStart[iF + 1]) +
+                  "), but faces must have at least 3 vertices");
+        return;
+      }
+    }
+  }
+  facesAreAllTriangles =
+      std::find(chunkAllTriangles.begin(), chunkAllTriangles.end(), false) == chunkAllTriangles.end();
+
+  // some number-of-elements arithmetic
   nFacesTriangulationCount = nCornersCount - 2 * numFaces;
 
+  // validate the face-vertex indices
+  if (numFaces > 0 && *std::max_element(chunkMaxInd.begin(), chunkMaxInd.end()) >= vertexPositions.size()) {
+    for (size_t iV : faceIndsEntries) {
+      if (iV >= vertexPositions.size())
+        exception("SurfaceMesh " + name + " has face vertex index " + std::to_string(iV) +
+                  " out of bounds for number of vertices " + std::to_string(vertexPositions.size()));
+    }
+  }
+
+  if (facesAreAllTriangles) {
+    // Fast path for the common case of a pure triangle mesh: the triangulation is just the input faces, so fill the
+    // buffers in bulk
+    if (options::reorderForLocality) {
+      faceDrawOrder = computeTriangleDrawOrder(vertexPositions.data, faceIndsEntries);
+      faceDrawRank.resize(numFaces);
+      for (size_t i = 0; i < numFaces; i++) faceDrawRank[faceDrawOrder[i]] = i;
+    }
+    if (faceDrawOrder.empty()) {
+      triangleVertexIndsData = faceIndsEntries;
+    } else {
+      triangleVertexIndsData.resize(3 * numFaces);
+    }
+    triangleFaceIndsData.resize(3 * numFaces);
+    parallelForChunks(numFaces, connectivityMinChunkSize, [&](size_t iStart, size_t iEnd, size_t iChunk) {
+      for (size_t i = iStart; i < iEnd; i++) {
+        size_t iF = faceInDrawOrder(i);
+        for (size_t k = 0; k < 3; k++) triangleFaceIndsData[3 * i + k] = iF;
+        if (!faceDrawOrder.empty()) {
+          for (size_t k = 0; k < 3; k++) triangleVertexIndsData[3 * i + k] = faceIndsEntries[3 * iF + k];
+        }
+      }
+    });
+  } else {
+    computePolygonTriangulation();
+  }
+
+  vertexDataSize = nVertices();
+  faceDataSize = nFaces();
+  // edgeDataSize = ... we don't know this yet, gets set below
+  halfedgeDataSize = nHalfedges();
+  cornerDataSize = nCorners();
+
+  triangleVertexInds.markHostBufferUpdated();
+  triangleFaceInds.markHostBufferUpdated();
+  edgeIsRealMask.recomputeIfPopulated();
+}
+
+void SurfaceMesh::computePolygonTriangulation() {
+
+  size_t numFaces = faceIndsStart.size() - 1;
+
   // fill out these buffers as we construct the triangulation
   triangleVertexIndsData.clear();
   triangleVertexIndsData.resize(3 * nFacesTriangulationCount);
   triangleFaceIndsData.clear();
   triangleFaceIndsData.resize(3 * nFacesTriangulationCount);
-  baryCoordData.clear();
-  baryCoordData.resize(3 * nFacesTriangulationCount);
-  edgeIsRealData.clear();
-  edgeIsRealData.resize(3 * nFacesTriangulationCount);
-
-  // validate the face-vertex indices
-  for (size_t iV : faceIndsEntries) {
-    if (iV >= vertexPositions.size())
-      exception("SurfaceMesh " + name + " has face vertex index " + std::to_string(iV) +
-                " out of bounds for number of vertices " + std::to_string(vertexPositions.size()));
-  }
 
   // construct the triangualted draw list and all other related data
   size_t iTriFace = 0;
@@ -147,35 +234,9 @@ void SurfaceMesh::computeConnectivityData() {
       // triangle face indices
       for (size_t k = 0; k < 3; k++) triangleFaceIndsData[3 * iTriFace + k] = iF;
 
-      // barycentric coordinates
-      baryCoordData[3 * iTriFace + 0] = glm::vec3{1., 0., 0.};
-      baryCoordData[3 * iTriFace + 1] = glm::vec3{0., 1., 0.};
-      baryCoordData[3 * iTriFace + 2] = glm::vec3{0., 0., 1.};
-
-      // internal edges for triangulated polygons
-      glm::vec3 edgeRealV{0., 1., 0.};
-      if (j == 1) {
-        edgeRealV.x = 1.;
-      }
-      if (j + 2 == D) {
-        edgeRealV.z = 1.;
-      }
-      for (size_t k = 0; k < 3; k++) edgeIsRealData[3 * iTriFace + k] = edgeRealV;
-
       iTriFace++;
     }
   }
-
-  vertexDataSize = nVertices();
-  faceDataSize = nFaces();
-  // edgeDataSize = ... we don't know this yet, gets set below
-  halfedgeDataSize = nHalfedges();
-  cornerDataSize = nCorners();
-
-  triangleVertexInds.markHostBufferUpdated();
-  triangleFaceInds.markHostBufferUpdated();
-  baryCoord.markHostBufferUpdated();
-  edgeIsReal.markHostBufferUpdated();
 }
 
 // =================================================
@@ -191,7 +252,6 @@ void SurfaceMesh::computeTriangleAllEdgeInds() {
               " performed an operation which requires edge indices to be specified, but none have been set. "
               "Call setEdgePermutation().");
 
-  triangleVertexInds.ensureHostBufferPopulated();
   triangleAllEdgeInds.data.resize(3 * 3 * nFacesTriangulation());
   halfedgeEdgeCorrespondence.resize(nHalfedges());
 
@@ -218,8 +278,8 @@ void SurfaceMesh::computeTriangleAllEdgeInds() {
 
     glm::uvec3 thisTriInds{0, 0, 0};
     for (size_t j = 0; j < 3; j++) {
-      size_t vA = triangleVertexInds.data[3 * iF + j];
-      size_t vB = triangleVertexInds.data[3 * iF + ((j + 1) % 3)];
+      size_t vA = faceIndsEntries[start + j];
+      size_t vB = faceIndsEntries[start + ((j + 1) % 3)];
 
       std::pair<size_t, size_t> key = createEdgeKey(vA, vB);
 
@@ -242,9 +302,10 @@ void SurfaceMesh::computeTriangleAllEdgeInds() {
       thisTriInds[j] = thisEdgeInd;
     }
 
+    size_t iT = faceTriangleInd(iF);
     for (size_t j = 0; j < 3; j++) {
       for (size_t k = 0; k < 3; k++) {
-        triangleAllEdgeInds.data[9 * iF + 3 * j + k] = thisTriInds[k];
+        triangleAllEdgeInds.data[9 * iT + 3 * j + k] = thisTriInds[k];
       }
     }
   }
@@ -277,8 +338,8 @@ void SurfaceMesh::countEdges() {
     }
 
     for (size_t j = 0; j < 3; j++) {
-      size_t vA = triangleVertexInds.data[3 * iF + j];
-      size_t vB = triangleVertexInds.data[3 * iF + ((j + 1) % 3)];
+      size_t vA = faceIndsEntries[start + j];
+      size_t vB = faceIndsEntries[start + ((j + 1) % 3)];
 
       std::pair<size_t, size_t> key = createEdgeKey(vA, vB);
 
@@ -303,7 +364,8 @@ void SurfaceMesh::computeTriangleCornerInds() {
   triangleCornerInds.data.clear();
   triangleCornerInds.data.reserve(3 * nFacesTriangulation());
 
-  for (size_t iF = 0; iF < nFaces(); iF++) {
+  for (size_t i = 0; i < nFaces(); i++) {
+    size_t iF = faceInDrawOrder(i);
     size_t iStart = faceIndsStart[iF];
     size_t D = faceIndsStart[iF + 1] - iStart;
 
@@ -322,6 +384,28 @@ void SurfaceMesh::computeTriangleCornerInds() {
   triangleCornerInds.markHostBufferUpdated();
 }
 
+void SurfaceMesh::computeEdgeIsRealMask() {
+
+  edgeIsRealMask.data.clear();
+  edgeIsRealMask.data.reserve(3 * nFacesTriangulation());
+
+  for (size_t i = 0; i < nFaces(); i++) {
+    size_t iF = faceInDrawOrder(i);
+    size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
+
+    // the triangles fan out from the first corner, so the middle edge is always real, and the first/last edges are
+    // real only for the first/last triangle
+    for (size_t j = 1; (j + 1) < D; j++) {
+      uint32_t bits = 2;
+      if (j == 1) bits |= 1;
+      if (j + 2 == D) bits |= 4;
+      for (size_t k = 0; k < 3; k++) edgeIsRealMask.data.push_back(static_cast<float>(bits));
+    }
+  }
+
+  edgeIsRealMask.markHostBufferUpdated();
+}
+
 void SurfaceMesh::computeTriangleAllHalfedgeInds() {
 
   triangleAllHalfedgeInds.data.clear();
@@ -329,7 +413,8 @@ void SurfaceMesh::computeTriangleAllHalfedgeInds() {
 
   bool haveCustomIndex = !halfedgePerm.empty();
 
-  for (size_t iF = 0; iF < nFaces(); iF++) {
+  for (size_t i = 0; i < nFaces(); i++) {
+    size_t iF = faceInDrawOrder(i);
     size_t iStart = faceIndsStart[iF];
     size_t D = faceIndsStart[iF + 1] - iStart;
 
@@ -370,7 +455,8 @@ void SurfaceMesh::computeTriangleAllCornerInds() {
 
   bool haveCustomIndex = !cornerPerm.empty();
 
-  for (size_t iF = 0; iF < nFaces(); iF++) {
+  for (size_t i = 0; i < nFaces(); i++) {
+    size_t iF = faceInDrawOrder(i);
     size_t iStart = faceIndsStart[iF];
     size_t D = faceIndsStart[iF + 1] - iStart;
 
@@ -647,10 +733,12 @@ void SurfaceMesh::ensureHaveManifoldConnectivity() {
       edgeInds;
 
   // Fill out faceForHalfedge and populate edge lookup map
+  // (only pure-triangle meshes are drawn out of order, so faceTriangleInd() also maps the triangulation)
   for (size_t iF = 0; iF < nFacesTriangulation(); iF++) {
+    size_t iT = faceTriangleInd(iF);
     for (size_t j = 0; j < 3; j++) {
-      size_t iV = triangleVertexInds.data[3 * iF + j];
-      size_t iVNext = triangleVertexInds.data[3 * iF + ((j + 1) % 3)];
+      size_t iV = triangleVertexInds.data[3 * iT + j];
+      size_t iVNext = triangleVertexInds.data[3 * iT + ((j + 1) % 3)];
       size_t iHe = 3 * iF + j;
 
 
@@ -669,9 +757,10 @@ void SurfaceMesh::ensureHaveManifoldConnectivity() {
 
   // Second walk through, setting twins
   for (size_t iF = 0; iF < nFacesTriangulation(); iF++) {
+    size_t iT = faceTriangleInd(iF);
     for (size_t j = 0; j < 3; j++) {
-      size_t iV = triangleVertexInds.data[3 * iF + j];
-      size_t iVNext = triangleVertexInds.data[3 * iF + ((j + 1) % 3)];
+      size_t iV = triangleVertexInds.data[3 * iT + j];
+      size_t iVNext = triangleVertexInds.data[3 * iT + ((j + 1) % 3)];
       size_t iHe = 3 * iF + j;
 
       std::pair<size_t, size_t> edgeKey(std::min(iV, iVNext), std::max(iV, iVNext));
@@ -696,6 +785,8 @@ void SurfaceMesh::draw() {
     return;
   }
 
+  faceMask.update();
+
   render::engine->setBackfaceCull(backFacePolicy.get() == BackFacePolicy::Cull);
 
   // If no quantity is drawing the surface, we should draw it
@@ -753,6 +844,8 @@ void SurfaceMesh::drawPick() {
     return;
   }
 
+  faceMask.update();
+
   if (pickProgram == nullptr) {
     preparePick();
   }
@@ -817,11 +910,8 @@ void SurfaceMesh::setMeshGeometryAttributes(render::ShaderProgram& p) {
   if (p.hasAttribute("a_normal")) {
     p.setAttribute("a_normal", faceNormals.getIndexedRenderAttributeBuffer(triangleFaceInds));
   }
-  if (p.hasAttribute("a_barycoord")) {
-    p.setAttribute("a_barycoord", baryCoord.getRenderAttributeBuffer());
-  }
-  if (p.hasAttribute("a_edgeIsReal")) {
-    p.setAttribute("a_edgeIsReal", edgeIsReal.getRenderAttributeBuffer());
+  if (p.hasAttribute("a_edgeIsRealMask")) {
+    p.setAttribute("a_edgeIsRealMask", edgeIsRealMask.getRenderAttributeBuffer());
   }
   if (wantsCullPosition()) {
     p.setAttribute("a_cullPos", faceCenters.getIndexedRenderAttributeBuffer(triangleFaceInds));
@@ -831,6 +921,8 @@ void SurfaceMesh::setMeshGeometryAttributes(render::ShaderProgram& p) {
     SurfaceScalarQuantity& transparencyQ = resolveTransparencyQuantity();
     p.setAttribute("a_valueAlpha", transparencyQ.getAttributeBuffer());
   }
+
+  faceMask.setTextures(p);
 }
 
 void SurfaceMesh::setMeshPickAttributes(render::ShaderProgram& p) {
@@ -881,9 +973,10 @@ void SurfaceMesh::setMeshPickAttributes(render::ShaderProgram& p) {
   }
 
 
-  // Build all quantities in each face
+  // Build all quantities in each face, in the same order as the triangulation
   size_t iFTri = 0;
-  for (size_t iF = 0; iF < nFaces(); iF++) {
+  for (size_t i = 0; i < nFaces(); i++) {
+    size_t iF = faceInDrawOrder(i);
     size_t D = faceIndsStart[iF + 1] - faceIndsStart[iF];
 
     glm::vec3 fColor = pick::indToVec(iF + faceGlobalPickIndStart);
@@ -996,7 +1089,7 @@ std::vector<std::string> SurfaceMesh::addSurfaceMeshRules(std::vector<std::strin
     if (withSurfaceShade) {
       // rules that only get used when we're shading the surface of the mesh
       if (getEdgeWidth() > 0) {
-        initRules.push_back("MESH_WIREFRAME_FROM_BARY");
+        initRules.push_back(facesAreAllTriangles ? "MESH_WIREFRAME_FROM_BARY_ALL_REAL" : "MESH_WIREFRAME_FROM_BARY");
         initRules.push_back("MESH_WIREFRAME");
       }
 
@@ -1032,6 +1125,11 @@ std::vector<std::string> SurfaceMesh::addSurfaceMeshRules(std::vector<std::strin
     if (transparencyQuantityName != "") {
       initRules.push_back("MESH_PROPAGATE_VALUEALPHA");
     }
+
+    if (faceMask.isActive()) {
+      initRules.push_back("ELEMENT_MASK_PROPAGATE_MESH");
+      if (withSurfaceShade) initRules.push_back("ELEMENT_MASK_SHADE_MESH");
+    }
   }
   return initRules;
 }
@@ -1050,8 +1148,138 @@ void SurfaceMesh::setSurfaceMeshUniforms(render::ShaderProgram& p) {
     p.setUniform("u_invProjMatrix", glm::value_ptr(Pinv));
     p.setUniform("u_viewport", render::engine->getCurrentViewport());
   }
+  faceMask.setUniforms(p);
 }
 
+void SurfaceMesh::setFaceMask(const std::vector<size_t>& inds, ElementMaskMode mode) {
+  bool wasActive = faceMask.isActive();
+  if (faceMask.size() != nFacesTriangulation()) faceMask.resize(nFacesTriangulation());
+
+  for (size_t iF : inds) {
+    if (iF >= nFaces()) {
+      exception("face mask index " + std::to_string(iF) + " out of bounds for surface mesh [" + name + "]");
+    }
+    if (facesAreAllTriangles) {
+      faceMask.set(faceTriangleInd(iF), mode);
+    } else {
+      // the triangles of a polygon are consecutive, a face of degree D is split in to D-2 of them
+      size_t iTStart = faceIndsStart[iF] - 2 * iF;
+      size_t nTri = faceIndsStart[iF + 1] - faceIndsStart[iF] - 2;
+      faceMask.setRange(iTStart, nTri, mode);
+    }
+  }
+
+  if (faceMask.isActive() != wasActive) refresh(); // the mask rules are only added while it is active
+  requestRedraw();
+}
+
+void SurfaceMesh::clearFaceMask() {
+  bool wasActive = faceMask.isActive();
+  faceMask.clear();
+  if (wasActive) refresh();
+  requestRedraw();
+}
+
+ElementMask& SurfaceMesh::getFaceMask() { return faceMask; }
+
+
+bool SurfaceMesh::queryRay(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayHit& hitOut) {
+
+  // Rebuild the acceleration structure if the geometry changed
+  vertexPositions.ensureHostBufferPopulated();
+  triangleVertexInds.ensureHostBufferPopulated();
+  triangleFaceInds.ensureHostBufferPopulated();
+  std::vector<uint64_t> key{vertexPositions.getDataVersion(), triangleVertexInds.getDataVersion()};
+  if (!rayQueryAccel.isCurrent(key)) {
+    RayQueryGeometry geom;
+    geom.positions = vertexPositions.data;
+    size_t nTri = triangleVertexInds.data.size() / 3;
+    geom.triangles.resize(nTri);
+    for (size_t iT = 0; iT < nTri; iT++) {
+      for (int j = 0; j < 3; j++) geom.triangles[iT][j] = triangleVertexInds.data[3 * iT + j];
+    }
+    rayQueryAccel.setGeometry(std::move(geom), key);
+  }
+
+  RayQueryAccel::Hit primHit;
+  if (!queryRayAccel(rayOrigin, rayDir, waitForBuild, primHit, hitOut)) return false;
+
+  // Like the pick buffer, report a vertex for hits close to a corner, and otherwise the face (edges, halfedges, and
+  // corners are not reported). Faces come after vertices in the pick indexing.
+  const float vertRadius = 0.2;
+  for (int j = 0; j < 3; j++) {
+    if (primHit.bary[j] > 1.f - vertRadius) {
+      hitOut.localIndex = triangleVertexInds.data[3 * primHit.index + j];
+      return true;
+    }
+  }
+  hitOut.localIndex = nVertices() + triangleFaceInds.data[3 * primHit.index];
+  return true;
+}
+
+bool SurfaceMesh::selectInScreenRegion(const ScreenRegion& region, std::vector<size_t>& localIndsOut) {
+  localIndsOut = selectVerticesInScreenRegion(region); // vertices come first in the pick indexing
+  return true;
+}
+
+bool SurfaceMesh::filterScalarQuantityElements(Quantity& q, ElementFilter filter, uint64_t& versionOut,
+                                               std::vector<char>* includeOut) {
+  bool onVertices = dynamic_cast<SurfaceVertexScalarQuantity*>(&q) != nullptr;
+  bool onFaces = dynamic_cast<SurfaceFaceScalarQuantity*>(&q) != nullptr;
+  if (includeOut) includeOut->clear();
+  switch (filter) {
+  case ElementFilter::All:
+    versionOut = 0;
+    return true;
+  case ElementFilter::Visible:
+    // Only faces can be hidden, by the face mask. A face is hidden if the first of its triangles is.
+    versionOut = onFaces ? faceMask.getVersion() : 0;
+    if (includeOut && onFaces && faceMask.isActive() && faceMask.size() == nFacesTriangulation()) {
+      includeOut->resize(nFaces());
+      for (size_t iF = 0; iF < nFaces(); iF++) {
+        size_t iT = facesAreAllTriangles ? faceTriangleInd(iF) : faceIndsStart[iF] - 2 * iF;
+        (*includeOut)[iF] = faceMask.get(iT) != ElementMaskMode::Hide;
+      }
+    }
+    return true;
+  case ElementFilter::Selected:
+    // Vertices are selected directly, faces when all of their vertices are. Other elements can't be selected.
+    if (!onVertices && !onFaces) return false;
+    versionOut = region_selection::getSelectionVersion();
+    if (includeOut) {
+      *includeOut = region_selection::getSelectionFlags(this, nVertices());
+      if (onFaces) {
+        std::vector<char> vertexSelected = std::move(*includeOut);
+        includeOut->assign(nFaces(), true);
+        for (size_t iF = 0; iF < nFaces(); iF++) {
+          for (size_t j = faceIndsStart[iF]; j < faceIndsStart[iF + 1]; j++) {
+            if (!vertexSelected[faceIndsEntries[j]]) (*includeOut)[iF] = false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+std::vector<size_t> SurfaceMesh::selectVerticesInScreenRegion(const ScreenRegion& region) {
+  vertexPositions.ensureHostBufferPopulated();
+  std::vector<uint64_t> key{vertexPositions.getDataVersion()};
+  if (!vertexRegionIndex.isCurrent(key)) {
+    vertexRegionIndex.build(vertexPositions.data, key);
+  }
+  return vertexRegionIndex.select(vertexPositions.data, region, view::getCameraPerspectiveMatrix() * getModelView());
+}
+
+std::vector<size_t> SurfaceMesh::selectFacesInScreenRegion(const ScreenRegion& region) {
+  faceCenters.ensureHostBufferPopulated();
+  std::vector<uint64_t> key{faceCenters.getDataVersion()};
+  if (!faceRegionIndex.isCurrent(key)) {
+    faceRegionIndex.build(faceCenters.data, key);
+  }
+  return faceRegionIndex.select(faceCenters.data, region, view::getCameraPerspectiveMatrix() * getModelView());
+}
 
 void SurfaceMesh::buildPickUI(size_t localPickID) {
 
@@ -1340,6 +1568,12 @@ void SurfaceMesh::recomputeGeometryIfPopulated() {
   // edgeLengths.recomputeIfPopulated();
 }
 
+void SurfaceMesh::sharedBufferUpdated(const std::string& bufferName) {
+  if (bufferName == vertexPositions.name) {
+    recomputeGeometryIfPopulated();
+  }
+}
+
 void SurfaceMesh::refresh() {
   recomputeGeometryIfPopulated();
 
@@ -1353,22 +1587,7 @@ void SurfaceMesh::updateObjectSpaceBounds() {
 
   vertexPositions.ensureHostBufferPopulated();
 
-  // bounding box
-  glm::vec3 min = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
-  glm::vec3 max = -glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
-  for (const glm::vec3& p : vertexPositions.data) {
-    min = componentwiseMin(min, p);
-    max = componentwiseMax(max, p);
-  }
-  objectSpaceBoundingBox = std::make_tuple(min, max);
-
-  // length scale, as twice the radius from the center of the bounding box
-  glm::vec3 center = 0.5f * (min + max);
-  float lengthScale = 0.0;
-  for (const glm::vec3& p : vertexPositions.data) {
-    lengthScale = std::max(lengthScale, glm::length2(p - center));
-  }
-  objectSpaceLengthScale = 2 * std::sqrt(lengthScale);
+  computeBoundingBoxAndLengthScale(vertexPositions.data, objectSpaceBoundingBox, objectSpaceLengthScale);
 }
 
 std::string SurfaceMesh::typeName() { return structureTypeName; }
@@ -1599,6 +1818,17 @@ SurfaceMesh::addTextureColorQuantityImpl(std::string name, SurfaceParameterizati
   return q;
 }
 
+SurfaceTextureColorQuantity* SurfaceMesh::addTextureColorQuantityFromFile(std::string name,
+                                                                         SurfaceParameterizationQuantity& param,
+                                                                         size_t dimX, size_t dimY, std::string filename,
+                                                                         ImageOrigin imageOrigin) {
+  checkForQuantityWithNameAndDeleteOrError(name);
+  std::shared_ptr<VirtualTextureSource> source = VirtualTextureSource::fromMappedFile(filename, dimX, dimY, 3);
+  SurfaceTextureColorQuantity* q = new SurfaceTextureColorQuantity(name, *this, param, source, imageOrigin);
+  addQuantity(q);
+  return q;
+}
+
 SurfaceVertexScalarQuantity* SurfaceMesh::addVertexDistanceQuantityImpl(std::string name,
                                                                         const std::vector<float>& data) {
   checkForQuantityWithNameAndDeleteOrError(name);
@@ -9,6 +9,7 @@
 #include "polyscope/file_helpers.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/render/engine.h"
+#include "polyscope/view.h"
 
 #include "imgui.h"
 
@@ -48,6 +49,37 @@ void SurfaceParameterizationQuantity::draw() {
   program->draw();
 }
 
+void SurfaceParameterizationQuantity::requestVirtualTexturePages(VirtualTexture& texture, ImageOrigin imageOrigin) {
+
+  parent.vertexPositions.ensureHostBufferPopulated();
+  parent.triangleVertexInds.ensureHostBufferPopulated();
+  parent.triangleCornerInds.ensureHostBufferPopulated();
+  coords.ensureHostBufferPopulated();
+
+  std::vector<uint64_t> key{parent.vertexPositions.getDataVersion(), parent.triangleVertexInds.getDataVersion(),
+                            parent.triangleCornerInds.getDataVersion(), coords.getDataVersion(),
+                            static_cast<uint64_t>(imageOrigin)};
+  if (!texture.trianglesAreCurrent(key)) {
+    const std::vector<uint32_t>& vertexInds = parent.triangleVertexInds.data;
+    const std::vector<uint32_t>& coordInds =
+        definedOn == MeshElement::VERTEX ? parent.triangleVertexInds.data : parent.triangleCornerInds.data;
+
+    std::vector<glm::vec3> cornerPositions(vertexInds.size());
+    std::vector<glm::vec2> cornerTCoords(vertexInds.size());
+    for (size_t i = 0; i < vertexInds.size(); i++) {
+      cornerPositions[i] = parent.vertexPositions.data[vertexInds[i]];
+      glm::vec2 tc = coords.data[coordInds[i]];
+      if (imageOrigin == ImageOrigin::UpperLeft) {
+        tc.y = 1.f - tc.y; // matches TEXTURE_ORIGIN_UPPERLEFT
+      }
+      cornerTCoords[i] = tc;
+    }
+    texture.setTriangles(std::move(cornerPositions), std::move(cornerTCoords), key);
+  }
+
+  texture.requestPagesForView(view::getCameraPerspectiveMatrix() * parent.getModelView());
+}
+
 void SurfaceParameterizationQuantity::createProgram() {
 
   // sanity check, this should basically never happen, but this guards against weird edge cases such
@@ -112,7 +144,7 @@ CurveNetwork* SurfaceParameterizationQuantity::createCurveNetworkFromSeams(std::
   coords.ensureHostBufferPopulated();
   parent.triangleCornerInds.ensureHostBufferPopulated();
   parent.triangleVertexInds.ensureHostBufferPopulated();
-  parent.edgeIsReal.ensureHostBufferPopulated();
+  parent.edgeIsRealMask.ensureHostBufferPopulated();
   parent.vertexPositions.ensureHostBufferPopulated();
 
   // helper to canonicalize edge direction
@@ -133,7 +165,8 @@ CurveNetwork* SurfaceParameterizationQuantity::createCurveNetworkFromSeams(std::
   // loop over all edges
   for(size_t iT = 0; iT <  parent.nFacesTriangulation(); iT++) {
     for(size_t k = 0; k < 3; k++) {
-      if(parent.edgeIsReal.data[3*iT][k] == 0.) continue; // skip internal tesselation edges
+      uint32_t edgeRealBits = static_cast<uint32_t>(parent.edgeIsRealMask.data[3*iT]);
+      if(!(edgeRealBits & (1u << k))) continue; // skip internal tesselation edges
 
       // gather data for the edge
       int32_t iV_tail = parent.triangleVertexInds.data[3*iT + (k+0)%3];
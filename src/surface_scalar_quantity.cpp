@@ -61,12 +61,7 @@ std::string SurfaceScalarQuantity::niceName() { return name + " (" + definedOn +
 
 SurfaceVertexScalarQuantity::SurfaceVertexScalarQuantity(std::string name, const std::vector<float>& values_,
                                                          SurfaceMesh& mesh_, DataType dataType_)
-    : SurfaceScalarQuantity(name, mesh_, "vertex", values_, dataType_)
-
-{
-  values.ensureHostBufferPopulated();
-  hist.buildHistogram(values.data);
-}
+    : SurfaceScalarQuantity(name, mesh_, "vertex", values_, dataType_) {}
 
 void SurfaceVertexScalarQuantity::createProgram() {
   // Create the program to draw this quantity
@@ -109,9 +104,7 @@ SurfaceFaceScalarQuantity::SurfaceFaceScalarQuantity(std::string name, const std
     : SurfaceScalarQuantity(name, mesh_, "face", values_, dataType_)
 
 {
-  values.ensureHostBufferPopulated();
   parent.faceAreas.ensureHostBufferPopulated();
-  hist.buildHistogram(values.data);
 }
 
 void SurfaceFaceScalarQuantity::createProgram() {
@@ -156,12 +149,7 @@ void SurfaceFaceScalarQuantity::buildFaceInfoGUI(size_t fInd) {
 
 SurfaceEdgeScalarQuantity::SurfaceEdgeScalarQuantity(std::string name, const std::vector<float>& values_,
                                                      SurfaceMesh& mesh_, DataType dataType_)
-    : SurfaceScalarQuantity(name, mesh_, "edge", values_, dataType_)
-
-{
-  values.ensureHostBufferPopulated();
-  hist.buildHistogram(values.data);
-}
+    : SurfaceScalarQuantity(name, mesh_, "edge", values_, dataType_) {}
 
 void SurfaceEdgeScalarQuantity::createProgram() {
   // Create the program to draw this quantity
@@ -201,12 +189,7 @@ void SurfaceEdgeScalarQuantity::buildEdgeInfoGUI(size_t eInd) {
 
 SurfaceHalfedgeScalarQuantity::SurfaceHalfedgeScalarQuantity(std::string name, const std::vector<float>& values_,
                                                              SurfaceMesh& mesh_, DataType dataType_)
-    : SurfaceScalarQuantity(name, mesh_, "halfedge", values_, dataType_)
-
-{
-  values.ensureHostBufferPopulated();
-  hist.buildHistogram(values.data);
-}
+    : SurfaceScalarQuantity(name, mesh_, "halfedge", values_, dataType_) {}
 
 void SurfaceHalfedgeScalarQuantity::createProgram() {
   // Create the program to draw this quantity
@@ -246,12 +229,7 @@ void SurfaceHalfedgeScalarQuantity::buildHalfedgeInfoGUI(size_t heInd) {
 
 SurfaceCornerScalarQuantity::SurfaceCornerScalarQuantity(std::string name, const std::vector<float>& values_,
                                                          SurfaceMesh& mesh_, DataType dataType_)
-    : SurfaceScalarQuantity(name, mesh_, "corner", values_, dataType_)
-
-{
-  values.ensureHostBufferPopulated();
-  hist.buildHistogram(values.data);
-}
+    : SurfaceScalarQuantity(name, mesh_, "corner", values_, dataType_) {}
 
 void SurfaceCornerScalarQuantity::createProgram() {
   // Create the program to draw this quantity
@@ -296,20 +274,61 @@ SurfaceTextureScalarQuantity::SurfaceTextureScalarQuantity(std::string name, Sur
     : SurfaceScalarQuantity(name, mesh_, "vertex", values_, dataType_), param(param_), dimX(dimX_), dimY(dimY_),
       imageOrigin(origin_) {
   values.setTextureSize(dimX, dimY);
+}
+
+void SurfaceTextureScalarQuantity::draw() {
+  if (!isEnabled()) return;
+
+  if (usesVirtualTexture()) {
+    prepareVirtualTexture();
+  } else if (virtualTexture) {
+    // the threshold was raised, go back to a regular texture
+    virtualTexture.reset();
+    program.reset();
+  }
+
+  SurfaceScalarQuantity::draw();
+}
+
+bool SurfaceTextureScalarQuantity::usesVirtualTexture() const {
+  return std::max(dimX, dimY) > options::virtualTextureThreshold;
+}
+
+void SurfaceTextureScalarQuantity::prepareVirtualTexture() {
+  // Pages are read straight from the values array, so start over whenever it changes
   values.ensureHostBufferPopulated();
-  hist.buildHistogram(values.data);
+  if (!virtualTexture || virtualTextureDataVersion != values.getDataVersion()) {
+    std::shared_ptr<VirtualTextureSource> source =
+        VirtualTextureSource::fromHostData(&values.data.front(), dimX, dimY, 1);
+    virtualTexture.reset(new VirtualTexture(source, options::virtualTextureCachePages));
+    virtualTextureDataVersion = values.getDataVersion();
+    program.reset();
+  }
+
+  param.requestVirtualTexturePages(*virtualTexture, imageOrigin);
+  if (render::engine->loadAllTexturePages) {
+    virtualTexture->flush();
+  } else {
+    virtualTexture->update(options::virtualTexturePageUploadsPerFrame);
+  }
 }
 
 void SurfaceTextureScalarQuantity::createProgram() {
+  std::vector<std::string> textureRules{"MESH_PROPAGATE_TCOORD", getImageOriginRule(imageOrigin)};
+  if (virtualTexture) {
+    textureRules.push_back("VIRTUAL_TEXTURE_LOOKUP");
+    textureRules.push_back("VIRTUAL_TEXTURE_PROPAGATE_VALUE");
+  } else {
+    textureRules.push_back("TEXTURE_PROPAGATE_VALUE");
+  }
+
   // Create the program to draw this quantity
 
   // clang-format off
   program = render::engine->requestShader("MESH",
       render::engine->addMaterialRules(parent.getMaterial(),
         parent.addSurfaceMeshRules(
-          addScalarRules(
-            {"MESH_PROPAGATE_TCOORD", getImageOriginRule(imageOrigin), "TEXTURE_PROPAGATE_VALUE"}
-          )
+          addScalarRules(textureRules)
         )
       )
     );
@@ -330,11 +349,15 @@ void SurfaceTextureScalarQuantity::createProgram() {
     break;
   }
 
-  program->setTextureFromBuffer("t_scalar", values.getRenderTextureBuffer().get());
+  if (virtualTexture) {
+    virtualTexture->setTextures(*program);
+    virtualTexture->setUniforms(*program);
+  } else {
+    program->setTextureFromBuffer("t_scalar", values.getRenderTextureBuffer().get());
+    values.getRenderTextureBuffer()->setFilterMode(FilterMode::Linear);
+  }
   render::engine->setMaterial(*program, parent.getMaterial());
   program->setTextureFromColormap("t_colormap", cMap.get());
-
-  values.getRenderTextureBuffer()->setFilterMode(FilterMode::Linear);
 }
 
 std::shared_ptr<render::AttributeBuffer> SurfaceTextureScalarQuantity::getAttributeBuffer() {
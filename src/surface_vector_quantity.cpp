@@ -219,10 +219,11 @@ std::vector<glm::vec2> oneFormToFaceTangentVectors(SurfaceMesh& mesh, const std:
 
     std::array<float, 3> formValues;
     std::array<glm::vec3, 3> vecValues;
+    size_t iT = mesh.faceTriangleInd(iF);
     for (size_t j = 0; j < 3; j++) {
-      size_t vA = mesh.triangleVertexInds.data[3 * iF + j];
-      size_t vB = mesh.triangleVertexInds.data[3 * iF + ((j + 1) % 3)];
-      size_t iE = mesh.triangleAllEdgeInds.data[9 * iF + j];
+      size_t vA = mesh.triangleVertexInds.data[3 * iT + j];
+      size_t vB = mesh.triangleVertexInds.data[3 * iT + ((j + 1) % 3)];
+      size_t iE = mesh.triangleAllEdgeInds.data[9 * iT + j];
 
       bool isCanonicalOriented = (vB > vA) != (canonicalOrientation[iE]); // TODO double check convention
       float orientationSign = isCanonicalOriented ? 1.f : -1.f;
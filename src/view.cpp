@@ -2,6 +2,7 @@
 
 #include "polyscope/view.h"
 
+#include "polyscope/pick.h"
 #include "polyscope/polyscope.h"
 #include "polyscope/utilities.h"
 
@@ -523,6 +524,15 @@ glm::vec3 bufferCoordsToWorldRay(glm::vec2 bufferCoords) {
 
 glm::vec3 screenCoordsToWorldPosition(glm::vec2 screenCoords) {
 
+  if (options::pickWithRayQueries) {
+    RayHit hit = pick::queryRayAtScreenCoords(screenCoords);
+    if (!hit.hit()) {
+      float inf = std::numeric_limits<float>::infinity();
+      return glm::vec3{inf, inf, inf};
+    }
+    return hit.position;
+  }
+
   int xInd, yInd;
   std::tie(xInd, yInd) = screenCoordsToBufferInds(screenCoords);
 
@@ -0,0 +1,515 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/virtual_texture.h"
+
+#include "polyscope/messages.h"
+#include "polyscope/parallel.h"
+#include "polyscope/polyscope.h"
+#include "polyscope/view.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace polyscope {
+
+namespace {
+
+size_t ceilDiv(size_t a, size_t b) { return (a + b - 1) / b; }
+
+float cross2(glm::vec2 a, glm::vec2 b) { return a.x * b.y - a.y * b.x; }
+
+} // namespace
+
+// === VirtualTextureSource
+
+VirtualTextureSource::~VirtualTextureSource() {
+#ifndef _WIN32
+  if (mappedData != nullptr) {
+    munmap(mappedData, mappedBytes);
+  }
+#endif
+}
+
+std::shared_ptr<VirtualTextureSource> VirtualTextureSource::fromHostData(const float* texels, size_t dimX, size_t dimY,
+                                                                         size_t nChannels) {
+  std::shared_ptr<VirtualTextureSource> s(new VirtualTextureSource());
+  s->sizeX = dimX;
+  s->sizeY = dimY;
+  s->channels = nChannels;
+  s->texels = texels;
+  return s;
+}
+
+std::shared_ptr<VirtualTextureSource> VirtualTextureSource::fromMappedFile(std::string filename, size_t dimX,
+                                                                           size_t dimY, size_t nChannels) {
+#ifdef _WIN32
+  exception("memory-mapped virtual textures are not supported on this platform");
+  return nullptr;
+#else
+  size_t nBytes = dimX * dimY * nChannels * sizeof(float);
+  if (nBytes == 0) {
+    exception("virtual texture file " + filename + " must have nonzero dimensions");
+    return nullptr;
+  }
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    exception("could not open virtual texture file " + filename);
+    return nullptr;
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < nBytes) {
+    close(fd);
+    exception("virtual texture file " + filename + " is too small for a " + std::to_string(dimX) + "x" +
+              std::to_string(dimY) + "x" + std::to_string(nChannels) + " float32 texture");
+    return nullptr;
+  }
+
+  void* mapped = mmap(nullptr, nBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // the mapping stays valid
+  if (mapped == MAP_FAILED) {
+    exception("could not memory-map virtual texture file " + filename);
+    return nullptr;
+  }
+
+  std::shared_ptr<VirtualTextureSource> s(new VirtualTextureSource());
+  s->sizeX = dimX;
+  s->sizeY = dimY;
+  s->channels = nChannels;
+  s->texels = static_cast<const float*>(mapped);
+  s->mappedData = mapped;
+  s->mappedBytes = nBytes;
+  return s;
+#endif
+}
+
+// === VirtualTexture
+
+VirtualTexture::VirtualTexture(std::shared_ptr<VirtualTextureSource> source_, size_t cachePages) : source(source_) {
+
+  if (source->dimX() == 0 || source->dimY() == 0) {
+    exception("virtual texture must have nonzero dimensions");
+  }
+
+  TextureFormat format = TextureFormat::RGBA32F;
+  switch (source->nChannels()) {
+  case 1:
+    format = TextureFormat::R32F;
+    break;
+  case 3:
+    format = TextureFormat::RGB32F;
+    break;
+  case 4:
+    format = TextureFormat::RGBA32F;
+    break;
+  default:
+    exception("virtual textures must have 1, 3, or 4 channels");
+    break;
+  }
+
+  // Add levels until a single page covers the whole texture
+  while (true) {
+    size_t span = static_cast<size_t>(pageSize) << levelPages.size();
+    glm::uvec2 nPages(ceilDiv(source->dimX(), span), ceilDiv(source->dimY(), span));
+    levelPages.push_back(nPages);
+    if (nPages.x == 1 && nPages.y == 1) break;
+  }
+  levelCount = levelPages.size();
+
+  // Lay out the cache slots in a square-ish atlas
+  size_t nSlots = std::max(cachePages, static_cast<size_t>(2));
+  slots.resize(nSlots);
+  slotsX = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(nSlots))));
+  size_t slotsY = ceilDiv(nSlots, slotsX);
+  size_t slotWidth = pageSize + 2 * pageBorder;
+  atlas = render::engine->generateTextureBuffer(format, slotsX * slotWidth, slotsY * slotWidth);
+  atlas->setFilterMode(FilterMode::Linear);
+
+  // The coarsest page is pinned to slot 0, so every part of the texture always has something to draw
+  uint64_t coarsestPage = pageKey(levelCount - 1, 0, 0);
+  slots[0].loading = true;
+  uploadPage(coarsestPage, 0, generatePage(*source, coarsestPage));
+
+  std::vector<float> tableData(4 * levelPages[0].x * levelPages[0].y, 0.);
+  pageTable = render::engine->generateTextureBuffer(TextureFormat::RGBA32F, levelPages[0].x, levelPages[0].y,
+                                                    &tableData.front());
+  pageTable->setFilterMode(FilterMode::Nearest);
+  rebuildPageTable();
+}
+
+VirtualTexture::~VirtualTexture() {
+  for (Load& load : loads) {
+    if (load.texels.valid()) load.texels.wait();
+  }
+}
+
+uint64_t VirtualTexture::pageKey(size_t level, size_t pageX, size_t pageY) {
+  return (static_cast<uint64_t>(level) << 48) | (static_cast<uint64_t>(pageY) << 24) | static_cast<uint64_t>(pageX);
+}
+
+void VirtualTexture::unpackPageKey(uint64_t page, size_t& level, size_t& pageX, size_t& pageY) {
+  const uint64_t mask = (static_cast<uint64_t>(1) << 24) - 1;
+  level = static_cast<size_t>(page >> 48);
+  pageY = static_cast<size_t>((page >> 24) & mask);
+  pageX = static_cast<size_t>(page & mask);
+}
+
+glm::uvec2 VirtualTexture::slotOrigin(size_t slot) const {
+  size_t slotWidth = pageSize + 2 * pageBorder;
+  return glm::uvec2((slot % slotsX) * slotWidth, (slot / slotsX) * slotWidth);
+}
+
+bool VirtualTexture::isPageResident(size_t level, size_t pageX, size_t pageY) const {
+  return residentPages.find(pageKey(level, pageX, pageY)) != residentPages.end();
+}
+
+std::vector<float> VirtualTexture::generatePage(const VirtualTextureSource& source, uint64_t page) {
+  size_t level, pageX, pageY;
+  unpackPageKey(page, level, pageX, pageY);
+
+  size_t scale = static_cast<size_t>(1) << level;
+  size_t dimXL = ceilDiv(source.dimX(), scale);
+  size_t dimYL = ceilDiv(source.dimY(), scale);
+  size_t nC = source.nChannels();
+
+  // Each texel at this level averages a grid of samples from the block of full-resolution texels it covers. Sampling
+  // at most 4x4 keeps the cost of coarse pages bounded, at the price of some aliasing at the coarsest levels.
+  size_t nSamples = std::min(scale, static_cast<size_t>(4));
+  float sampleWeight = 1.f / static_cast<float>(nSamples * nSamples);
+
+  size_t slotWidth = pageSize + 2 * pageBorder;
+  std::vector<float> texels(slotWidth * slotWidth * nC, 0.);
+  auto clampL = [](int64_t v, size_t dimL) {
+    return static_cast<size_t>(std::min(std::max(v, static_cast<int64_t>(0)), static_cast<int64_t>(dimL) - 1));
+  };
+
+  for (size_t j = 0; j < slotWidth; j++) {
+    size_t yL = clampL(static_cast<int64_t>(pageY * pageSize + j) - pageBorder, dimYL);
+    size_t yStart = yL * scale;
+    size_t ySpan = std::min(yStart + scale, source.dimY()) - yStart;
+
+    for (size_t i = 0; i < slotWidth; i++) {
+      size_t xL = clampL(static_cast<int64_t>(pageX * pageSize + i) - pageBorder, dimXL);
+      size_t xStart = xL * scale;
+      size_t xSpan = std::min(xStart + scale, source.dimX()) - xStart;
+
+      float* out = &texels[(j * slotWidth + i) * nC];
+      for (size_t sy = 0; sy < nSamples; sy++) {
+        size_t y = yStart + ((2 * sy + 1) * ySpan) / (2 * nSamples);
+        for (size_t sx = 0; sx < nSamples; sx++) {
+          size_t x = xStart + ((2 * sx + 1) * xSpan) / (2 * nSamples);
+          const float* in = source.texel(x, y);
+          for (size_t c = 0; c < nC; c++) {
+            out[c] += sampleWeight * in[c];
+          }
+        }
+      }
+    }
+  }
+
+  return texels;
+}
+
+bool VirtualTexture::trianglesAreCurrent(const std::vector<uint64_t>& key) const {
+  return haveTriangles && key == trianglesKey;
+}
+
+void VirtualTexture::setTriangles(std::vector<glm::vec3> cornerPositions, std::vector<glm::vec2> cornerTCoords,
+                                  std::vector<uint64_t> key) {
+  if (cornerPositions.size() != cornerTCoords.size() || cornerPositions.size() % 3 != 0) {
+    exception("virtual texture triangles must have three positions and texture coordinates each");
+  }
+  triCornerPositions = std::move(cornerPositions);
+  triCornerTCoords = std::move(cornerTCoords);
+  trianglesKey = std::move(key);
+  haveTriangles = true;
+  lastViewportSize = glm::vec2{-1., -1.}; // force the next feedback pass
+}
+
+void VirtualTexture::requestPagesForView(const glm::mat4& objectToClip) {
+  if (!haveTriangles) return;
+
+  glm::vec2 viewport{static_cast<float>(view::windowWidth), static_cast<float>(view::windowHeight)};
+  if (viewport == lastViewportSize && objectToClip == lastObjectToClip) return;
+  lastViewportSize = viewport;
+  lastObjectToClip = objectToClip;
+
+  std::vector<std::vector<bool>> marked(levelCount);
+  for (size_t iL = 0; iL < levelCount; iL++) {
+    marked[iL].resize(levelPages[iL].x * levelPages[iL].y, false);
+  }
+
+  glm::vec2 texSize{static_cast<float>(source->dimX()), static_cast<float>(source->dimY())};
+  size_t nTri = triCornerPositions.size() / 3;
+  for (size_t iT = 0; iT < nTri; iT++) {
+
+    glm::vec4 clip[3];
+    bool allInFront = true;
+    for (size_t c = 0; c < 3; c++) {
+      clip[c] = objectToClip * glm::vec4(triCornerPositions[3 * iT + c], 1.);
+      allInFront = allInFront && clip[c].w > 0.;
+    }
+
+    // Skip triangles which are entirely outside one of the clip planes
+    bool culled = false;
+    for (int axis = 0; axis < 3 && !culled; axis++) {
+      bool allBelow = true;
+      bool allAbove = true;
+      for (size_t c = 0; c < 3; c++) {
+        allBelow = allBelow && clip[c][axis] < -clip[c].w;
+        allAbove = allAbove && clip[c][axis] > clip[c].w;
+      }
+      culled = allBelow || allAbove;
+    }
+    if (culled) continue;
+
+    glm::vec2 tex[3];
+    for (size_t c = 0; c < 3; c++) {
+      glm::vec2 tc = triCornerTCoords[3 * iT + c];
+      tc = glm::vec2{std::min(std::max(tc.x, 0.f), 1.f), std::min(std::max(tc.y, 0.f), 1.f)};
+      tex[c] = glm::vec2{tc.x * texSize.x, tc.y * texSize.y};
+    }
+
+    // Pick the level where a texel is about a pixel. Triangles crossing the camera plane can't be measured this way,
+    // so they conservatively get the finest level.
+    size_t level = 0;
+    if (allInFront) {
+      glm::vec2 s[3];
+      for (size_t c = 0; c < 3; c++) {
+        glm::vec2 ndc{clip[c].x / clip[c].w, clip[c].y / clip[c].w};
+        s[c] = glm::vec2{(0.5f * ndc.x + 0.5f) * viewport.x, (0.5f * ndc.y + 0.5f) * viewport.y};
+      }
+      float screenArea = std::abs(cross2(s[1] - s[0], s[2] - s[0]));
+      float texArea = std::abs(cross2(tex[1] - tex[0], tex[2] - tex[0]));
+      if (!(screenArea > 0.)) continue; // covers no pixels
+      if (texArea > 0.) {
+        float levelF = std::floor(0.5f * std::log2(texArea / screenArea));
+        levelF = std::min(std::max(levelF, 0.f), static_cast<float>(levelCount - 1));
+        level = static_cast<size_t>(levelF);
+      }
+    }
+
+    // Mark the pages overlapping the triangle's texture coordinates
+    glm::vec2 tMin{std::min(std::min(tex[0].x, tex[1].x), tex[2].x), std::min(std::min(tex[0].y, tex[1].y), tex[2].y)};
+    glm::vec2 tMax{std::max(std::max(tex[0].x, tex[1].x), tex[2].x), std::max(std::max(tex[0].y, tex[1].y), tex[2].y)};
+    float span = static_cast<float>(static_cast<size_t>(pageSize) << level);
+    glm::uvec2 nPages = levelPages[level];
+    size_t xMin = std::min(static_cast<size_t>(tMin.x / span), static_cast<size_t>(nPages.x - 1));
+    size_t xMax = std::min(static_cast<size_t>(tMax.x / span), static_cast<size_t>(nPages.x - 1));
+    size_t yMin = std::min(static_cast<size_t>(tMin.y / span), static_cast<size_t>(nPages.y - 1));
+    size_t yMax = std::min(static_cast<size_t>(tMax.y / span), static_cast<size_t>(nPages.y - 1));
+    for (size_t y = yMin; y <= yMax; y++) {
+      for (size_t x = xMin; x <= xMax; x++) {
+        marked[level][y * nPages.x + x] = true;
+      }
+    }
+  }
+
+  // Each page also requests its ancestors, so there is a nearby fallback while it loads
+  for (size_t iL = 0; iL + 1 < levelCount; iL++) {
+    glm::uvec2 nPages = levelPages[iL];
+    glm::uvec2 nParentPages = levelPages[iL + 1];
+    for (size_t y = 0; y < nPages.y; y++) {
+      for (size_t x = 0; x < nPages.x; x++) {
+        if (marked[iL][y * nPages.x + x]) marked[iL + 1][(y / 2) * nParentPages.x + x / 2] = true;
+      }
+    }
+  }
+
+  requestedPages.clear();
+  requestedSet.clear();
+  for (size_t iL = levelCount; iL-- > 0;) {
+    glm::uvec2 nPages = levelPages[iL];
+    for (size_t y = 0; y < nPages.y; y++) {
+      for (size_t x = 0; x < nPages.x; x++) {
+        if (!marked[iL][y * nPages.x + x]) continue;
+        uint64_t page = pageKey(iL, x, y);
+        requestedPages.push_back(page);
+        requestedSet.insert(page);
+      }
+    }
+  }
+
+  pageTableDirty = true;
+}
+
+bool VirtualTexture::findSlot(size_t& slotOut) {
+  // Prefer empty slots, then the least recently used page which the current view does not need. Slot 0 is pinned.
+  bool found = false;
+  for (size_t iS = 1; iS < slots.size(); iS++) {
+    const Slot& s = slots[iS];
+    if (s.loading) continue;
+    if (!s.occupied) {
+      slotOut = iS;
+      found = true;
+      break;
+    }
+    if (requestedSet.find(s.page) != requestedSet.end()) continue;
+    if (!found || s.lastUsedFrame < slots[slotOut].lastUsedFrame) {
+      slotOut = iS;
+      found = true;
+    }
+  }
+  if (!found) return false;
+
+  Slot& s = slots[slotOut];
+  if (s.occupied) {
+    residentPages.erase(s.page);
+    pageTableDirty = true;
+  }
+  s.occupied = false;
+  s.loading = true;
+  return true;
+}
+
+void VirtualTexture::uploadPage(uint64_t page, size_t slot, const std::vector<float>& texels) {
+  size_t slotWidth = pageSize + 2 * pageBorder;
+  glm::uvec2 origin = slotOrigin(slot);
+  atlas->setDataRegion2D(origin.x, origin.y, slotWidth, slotWidth, &texels.front());
+
+  Slot& s = slots[slot];
+  s.page = page;
+  s.occupied = true;
+  s.loading = false;
+  s.lastUsedFrame = frame;
+  residentPages[page] = slot;
+  pageTableDirty = true;
+}
+
+void VirtualTexture::update(size_t maxUploads) {
+  frame++;
+  for (uint64_t page : requestedPages) {
+    auto it = residentPages.find(page);
+    if (it != residentPages.end()) slots[it->second].lastUsedFrame = frame;
+  }
+
+  // Upload loads which have finished
+  size_t nUploads = 0;
+  for (size_t iL = 0; iL < loads.size() && nUploads < maxUploads;) {
+    Load& load = loads[iL];
+    if (load.texels.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      iL++;
+      continue;
+    }
+    uploadPage(load.page, load.slot, load.texels.get());
+    nUploads++;
+    loads.erase(loads.begin() + iL);
+  }
+
+  // Start loads for missing pages, coarsest first. File-backed pages are read on worker threads, other sources are read
+  // right here, within the upload budget.
+  bool onWorkers = source->readOnWorkerThreads();
+  size_t maxInFlight = 2 * workerThreadCount();
+  bool moreToLoad = false;
+  for (uint64_t page : requestedPages) {
+    if (residentPages.find(page) != residentPages.end()) continue;
+    bool alreadyLoading = false;
+    for (const Load& load : loads) {
+      alreadyLoading = alreadyLoading || load.page == page;
+    }
+    if (alreadyLoading) continue;
+
+    if (onWorkers ? loads.size() >= maxInFlight : nUploads >= maxUploads) {
+      moreToLoad = true;
+      break;
+    }
+    size_t slot;
+    if (!findSlot(slot)) break; // the cache is full of pages this view needs
+
+    if (onWorkers) {
+      std::shared_ptr<VirtualTextureSource> loadSource = source;
+      loads.push_back(Load{page, slot, std::async(std::launch::async, [loadSource, page]() {
+                             return generatePage(*loadSource, page);
+                           })});
+    } else {
+      uploadPage(page, slot, generatePage(*source, page));
+      nUploads++;
+    }
+  }
+
+  if (pageTableDirty) {
+    rebuildPageTable();
+  }
+
+  // Keep frames coming until everything has loaded
+  if (moreToLoad || !loads.empty()) {
+    requestRedraw();
+  }
+}
+
+void VirtualTexture::flush() {
+  while (true) {
+    for (Load& load : loads) {
+      load.texels.wait();
+    }
+    size_t nResidentBefore = residentPages.size();
+    update(std::numeric_limits<size_t>::max());
+    if (loads.empty() && residentPages.size() == nResidentBefore) break;
+  }
+}
+
+void VirtualTexture::rebuildPageTable() {
+  glm::uvec2 nCells = levelPages[0];
+
+  // The finest level requested for each region of the texture
+  std::vector<size_t> cellLevel(nCells.x * nCells.y, levelCount - 1);
+  for (uint64_t page : requestedPages) {
+    size_t level, pageX, pageY;
+    unpackPageKey(page, level, pageX, pageY);
+    size_t xEnd = std::min(static_cast<size_t>(pageX + 1) << level, static_cast<size_t>(nCells.x));
+    size_t yEnd = std::min(static_cast<size_t>(pageY + 1) << level, static_cast<size_t>(nCells.y));
+    for (size_t y = pageY << level; y < yEnd; y++) {
+      for (size_t x = pageX << level; x < xEnd; x++) {
+        cellLevel[y * nCells.x + x] = std::min(cellLevel[y * nCells.x + x], level);
+      }
+    }
+  }
+
+  // Point each region at the finest resident page covering it
+  std::vector<float> tableData(4 * nCells.x * nCells.y);
+  for (size_t y = 0; y < nCells.y; y++) {
+    for (size_t x = 0; x < nCells.x; x++) {
+      size_t level = cellLevel[y * nCells.x + x];
+      auto it = residentPages.find(pageKey(level, x >> level, y >> level));
+      while (it == residentPages.end()) { // terminates, the coarsest page is always resident
+        level++;
+        it = residentPages.find(pageKey(level, x >> level, y >> level));
+      }
+      glm::uvec2 origin = slotOrigin(it->second);
+      float* entry = &tableData[4 * (y * nCells.x + x)];
+      entry[0] = static_cast<float>(origin.x);
+      entry[1] = static_cast<float>(origin.y);
+      entry[2] = static_cast<float>(level);
+      entry[3] = 1.;
+    }
+  }
+
+  pageTable->setDataRegion2D(0, 0, nCells.x, nCells.y, &tableData.front());
+  pageTableDirty = false;
+}
+
+void VirtualTexture::setTextures(render::ShaderProgram& program) {
+  program.setTextureFromBuffer("t_vtPageTable", pageTable.get());
+  program.setTextureFromBuffer("t_vtAtlas", atlas.get());
+}
+
+void VirtualTexture::setUniforms(render::ShaderProgram& program) {
+  program.setUniform("u_vtTextureSize",
+                     glm::vec2{static_cast<float>(source->dimX()), static_cast<float>(source->dimY())});
+  program.setUniform("u_vtAtlasSize",
+                     glm::vec2{static_cast<float>(atlas->getSizeX()), static_cast<float>(atlas->getSizeY())});
+  program.setUniform("u_vtPageSize", static_cast<float>(pageSize));
+  program.setUniform("u_vtPageBorder", static_cast<float>(pageBorder));
+}
+
+} // namespace polyscope
@@ -3,9 +3,13 @@
 #include "polyscope/volume_grid.h"
 
 #include "polyscope/pick.h"
+#include "polyscope/slice_plane.h"
 
 #include "imgui.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace polyscope {
 
 // Initialize statics
@@ -27,7 +31,10 @@ VolumeGrid::VolumeGrid(std::string name, glm::uvec3 gridNodeDim_, glm::vec3 boun
       edgeColor(              uniquePrefix() + "edgeColor",         glm::vec3{0., 0., 0.}), 
       material(               uniquePrefix() + "material",          "clay"),
       edgeWidth(              uniquePrefix() + "edgeWidth",         0.f),
-      cubeSizeFactor(         uniquePrefix() + "cubeSizeFactor",    0.f)
+      cubeSizeFactor(         uniquePrefix() + "cubeSizeFactor",    0.f),
+      raycastGridCubes(       uniquePrefix() + "raycastGridCubes",  false),
+      useMipLevels(           uniquePrefix() + "useMipLevels",      true),
+      mipReduction(           uniquePrefix() + "mipReduction",      VolumeGridMipReduction::Mean)
 // clang-format on
 {
   cullWholeElements.setPassive(true);
@@ -96,8 +103,22 @@ void VolumeGrid::buildCustomOptionsUI() {
   // Shrinky effect
   if (ImGui::SliderFloat("Cell Shrink", &cubeSizeFactor.get(), 0.0, 1., "%.3f", ImGuiSliderFlags_Logarithmic)) {
     cubeSizeFactor.manuallyChanged();
+    pick::markPickBufferStale();
     requestRedraw();
   }
+
+  if (ImGui::MenuItem("Ray-cast Cubes", NULL, raycastGridCubes.get())) setRaycastGridCubes(!raycastGridCubes.get());
+
+  if (ImGui::BeginMenu("Downsample While Moving")) {
+    if (ImGui::MenuItem("enabled", NULL, useMipLevels.get())) setUseMipLevels(!useMipLevels.get());
+    if (ImGui::MenuItem("mean", NULL, mipReduction.get() == VolumeGridMipReduction::Mean))
+      setMipReduction(VolumeGridMipReduction::Mean);
+    if (ImGui::MenuItem("min", NULL, mipReduction.get() == VolumeGridMipReduction::Min))
+      setMipReduction(VolumeGridMipReduction::Min);
+    if (ImGui::MenuItem("max", NULL, mipReduction.get() == VolumeGridMipReduction::Max))
+      setMipReduction(VolumeGridMipReduction::Max);
+    ImGui::EndMenu();
+  }
 }
 
 void VolumeGrid::draw() {
@@ -108,6 +129,8 @@ void VolumeGrid::draw() {
     setCullWholeElements(true);
   }
 
+  updateMipLevelTarget();
+
   // If there is no dominant quantity, then this class is responsible for the grid
   if (dominantQuantity == nullptr) {
 
@@ -132,6 +155,11 @@ void VolumeGrid::draw() {
   for (auto& x : floatingQuantities) {
     x.second->draw();
   }
+
+  // Refine once the view settles
+  if (drewCoarserThanIdle) {
+    requestRedraw();
+  }
 }
 
 void VolumeGrid::drawDelayed() {
@@ -183,19 +211,42 @@ std::vector<std::string> VolumeGrid::addGridCubeRules(std::vector<std::string> i
     }
   }
 
-  if (wantsCullPosition()) {
+  if (wantsCullPosition() && !getRaycastGridCubes()) {
+    // (the ray-casting shader always computes its own cull position)
     initRules.push_back("GRIDCUBE_CULLPOS_FROM_CENTER");
   }
 
   return initRules;
 }
 
-void VolumeGrid::setGridCubeUniforms(render::ShaderProgram& p, bool withShade) {
+void VolumeGrid::setGridCubeUniforms(render::ShaderProgram& p, bool withShade, size_t mipLevel) {
 
   p.setUniform("u_boundMin", boundMin);
   p.setUniform("u_boundMax", boundMax);
   p.setUniform("u_cubeSizeFactor", 1.f - cubeSizeFactor.get());
-  p.setUniform("u_gridSpacingReference", gridSpacingReference());
+  p.setUniform("u_gridSpacingReference", gridSpacingReference(mipLevel));
+  if (p.hasUniform("u_nodeValueExtent")) {
+    // (the nodes of a mip level can extend past the bounds, see VolumeGridMipPyramid::levelCellScale())
+    glm::vec3 nodeValueExtent{1.f, 1.f, 1.f};
+    if (mipLevel > 0) {
+      glm::vec3 levelCellDim(VolumeGridMipPyramid::levelCellDim(gridCellDim, mipLevel));
+      nodeValueExtent = levelCellDim * gridSpacingReference(mipLevel);
+    }
+    p.setUniform("u_nodeValueExtent", nodeValueExtent);
+  }
+
+  if (getRaycastGridCubes()) {
+    glm::mat4 P = view::getCameraPerspectiveMatrix();
+    glm::mat4 Pinv = glm::inverse(P);
+    p.setUniform("u_invProjMatrix", glm::value_ptr(Pinv));
+    p.setUniform("u_viewport", render::engine->getCurrentViewport());
+
+    // view coordinates -> world coordinates -> the [0,1]^3 reference cube
+    glm::mat4 worldToReference = glm::scale(glm::mat4(1.), 1.f / (boundMax - boundMin)) *
+                                 glm::translate(glm::mat4(1.), -boundMin);
+    glm::mat4 viewToReference = worldToReference * glm::inverse(getModelView());
+    p.setUniform("u_viewToReference", glm::value_ptr(viewToReference));
+  }
 
   if (withShade) {
 
@@ -211,7 +262,7 @@ void VolumeGrid::ensureGridCubeRenderProgramPrepared() {
   if (program) return;
 
   // clang-format off
-  program = render::engine->requestShader( "GRIDCUBE_PLANE", 
+  program = render::engine->requestShader(getGridCubeShaderName(),
       render::engine->addMaterialRules(material.get(),
         addGridCubeRules(
           {"SHADE_BASECOLOR"}, 
@@ -220,9 +271,7 @@ void VolumeGrid::ensureGridCubeRenderProgramPrepared() {
   );
   // clang-format on
 
-  program->setAttribute("a_referencePosition", gridPlaneReferencePositions.getRenderAttributeBuffer());
-  program->setAttribute("a_referenceNormal", gridPlaneReferenceNormals.getRenderAttributeBuffer());
-  program->setAttribute("a_axisInd", gridPlaneAxisInds.getRenderAttributeBuffer());
+  setGridCubeGeometryAttributes(*program);
 
   render::engine->setMaterial(*program, material.get());
 }
@@ -234,16 +283,14 @@ void VolumeGrid::ensureGridCubePickProgramPrepared() {
 
   // clang-format off
   pickProgram = render::engine->requestShader(
-      "GRIDCUBE_PLANE", 
+      getGridCubeShaderName(),
       addGridCubeRules({"GRIDCUBE_CONSTANT_PICK"}, false), 
       render::ShaderReplacementDefaults::Pick
   );
   // clang-format on
 
 
-  pickProgram->setAttribute("a_referencePosition", gridPlaneReferencePositions.getRenderAttributeBuffer());
-  pickProgram->setAttribute("a_referenceNormal", gridPlaneReferenceNormals.getRenderAttributeBuffer());
-  pickProgram->setAttribute("a_axisInd", gridPlaneAxisInds.getRenderAttributeBuffer());
+  setGridCubeGeometryAttributes(*pickProgram);
 
 
   if (globalPickConstant == INVALID_IND_64) {
@@ -281,6 +328,50 @@ void VolumeGrid::refresh() {
 
 void VolumeGrid::setVolumeGridUniforms(render::ShaderProgram& p) {}
 
+std::string VolumeGrid::getGridCubeShaderName() {
+  return getRaycastGridCubes() ? "GRIDCUBE_RAYCAST" : "GRIDCUBE_PLANE";
+}
+
+void VolumeGrid::setGridCubeGeometryAttributes(render::ShaderProgram& p, size_t mipLevel) {
+  if (getRaycastGridCubes()) {
+    p.setAttribute("a_referencePosition", computeBoundingBoxInteriorTriangles());
+  } else if (mipLevel > 0) {
+    // (the planes for coarse levels are few, so they are not cached)
+    std::vector<glm::vec3> positions, normals;
+    std::vector<int32_t> axisInds;
+    computeGridPlaneGeometry(gridCellDim, VolumeGridMipPyramid::levelCellScale(mipLevel), positions, normals,
+                             axisInds);
+    p.setAttribute("a_referencePosition", positions);
+    p.setAttribute("a_referenceNormal", normals);
+    p.setAttribute("a_axisInd", axisInds);
+  } else {
+    p.setAttribute("a_referencePosition", gridPlaneReferencePositions.getRenderAttributeBuffer());
+    p.setAttribute("a_referenceNormal", gridPlaneReferenceNormals.getRenderAttributeBuffer());
+    p.setAttribute("a_axisInd", gridPlaneAxisInds.getRenderAttributeBuffer());
+  }
+}
+
+std::vector<glm::vec3> VolumeGrid::computeBoundingBoxInteriorTriangles() {
+  // The faces of the [0,1]^3 reference cube, wound to face inward. With backface culling, only the far side of the box
+  // is drawn, which covers every pixel the grid does, even when the camera is inside of it.
+  std::vector<glm::vec3> positions;
+  for (uint32_t d = 0; d < 3; d++) {
+    for (uint32_t side = 0; side < 2; side++) {
+      std::array<glm::vec3, 4> c; // ll, lu, ul, uu, as in computeGridPlaneReferenceGeometry()
+      for (uint32_t j = 0; j < 4; j++) {
+        c[j][d] = side;
+        c[j][(d + 1) % 3] = j % 2;
+        c[j][(d + 2) % 3] = j / 2;
+      }
+      // these corner orders face +d, so flip them on the +d side of the box
+      std::array<uint32_t, 6> order = side == 0 ? std::array<uint32_t, 6>{0, 1, 2, 1, 3, 2}
+                                                : std::array<uint32_t, 6>{0, 2, 1, 1, 2, 3};
+      for (uint32_t j : order) positions.push_back(c[j]);
+    }
+  }
+  return positions;
+}
+
 
 void VolumeGrid::computeGridPlaneReferenceGeometry() {
 
@@ -288,26 +379,42 @@ void VolumeGrid::computeGridPlaneReferenceGeometry() {
   // by computing the data for multiple buffers with one function.
   // For now at least, it will work fine.
 
-  // Geometry is defined in the reference [0,1] cube
+  computeGridPlaneGeometry(gridCellDim, 1, gridPlaneReferencePositions.data, gridPlaneReferenceNormals.data,
+                           gridPlaneAxisInds.data);
+
+  gridPlaneReferencePositions.markHostBufferUpdated();
+  gridPlaneReferenceNormals.markHostBufferUpdated();
+  gridPlaneAxisInds.markHostBufferUpdated();
+}
+
+void VolumeGrid::computeGridPlaneGeometry(glm::uvec3 gridCellDim, uint32_t cellScale, std::vector<glm::vec3>& positions,
+                                          std::vector<glm::vec3>& normals, std::vector<int32_t>& axisInds) {
+
+  // Geometry is defined in the reference [0,1] cube. The planes are placed every cellScale cells, and the last one is
+  // always at the bounds.
+  glm::uvec3 planeCellDim = (gridCellDim + (cellScale - 1)) / cellScale;
+  auto planePos = [&](uint32_t d, uint32_t i) {
+    return static_cast<float>(std::min(i * cellScale, gridCellDim[d])) / gridCellDim[d];
+  };
 
-  gridPlaneReferencePositions.data.clear();
-  gridPlaneReferenceNormals.data.clear();
-  gridPlaneAxisInds.data.clear();
+  positions.clear();
+  normals.clear();
+  axisInds.clear();
 
   auto addPlane = [&](std::array<glm::vec3, 4> corners, glm::vec3 normal, uint32_t axInd) {
     // first triangle
-    gridPlaneReferencePositions.data.push_back(corners[0]);
-    gridPlaneReferencePositions.data.push_back(corners[1]);
-    gridPlaneReferencePositions.data.push_back(corners[2]);
-    for (int32_t j = 0; j < 3; j++) gridPlaneReferenceNormals.data.push_back(normal);
-    for (int32_t j = 0; j < 3; j++) gridPlaneAxisInds.data.push_back(axInd);
+    positions.push_back(corners[0]);
+    positions.push_back(corners[1]);
+    positions.push_back(corners[2]);
+    for (int32_t j = 0; j < 3; j++) normals.push_back(normal);
+    for (int32_t j = 0; j < 3; j++) axisInds.push_back(axInd);
 
     // second triangle
-    gridPlaneReferencePositions.data.push_back(corners[1]);
-    gridPlaneReferencePositions.data.push_back(corners[3]);
-    gridPlaneReferencePositions.data.push_back(corners[2]);
-    for (int32_t j = 0; j < 3; j++) gridPlaneReferenceNormals.data.push_back(normal);
-    for (int32_t j = 0; j < 3; j++) gridPlaneAxisInds.data.push_back(axInd);
+    positions.push_back(corners[1]);
+    positions.push_back(corners[3]);
+    positions.push_back(corners[2]);
+    for (int32_t j = 0; j < 3; j++) normals.push_back(normal);
+    for (int32_t j = 0; j < 3; j++) axisInds.push_back(axInd);
   };
 
   // The planes are intentionally added in order such that the outermost planes come first, and we don't massively
@@ -315,9 +422,9 @@ void VolumeGrid::computeGridPlaneReferenceGeometry() {
 
   // Forward facing planes
   for (uint32_t d = 0; d < 3; d++) { // x/y/z dimension (plane is perpendicular)
-    for (int32_t i = (int32_t)gridCellDim[d] - 1; i >= 0; i--) {
+    for (int32_t i = (int32_t)planeCellDim[d] - 1; i >= 0; i--) {
 
-      float t = (static_cast<float>(i) + 1) / (gridCellDim[d]);
+      float t = planePos(d, i + 1);
 
       // clang-format off
       glm::vec3 ll{0.f, 0.f, 0.f}; ll[(d+1)%3] = 0.f; ll[(d+2)%3] = 0.f; ll[d] = t;
@@ -334,9 +441,9 @@ void VolumeGrid::computeGridPlaneReferenceGeometry() {
 
   // Backward facing planes
   for (uint32_t d = 0; d < 3; d++) { // x/y/z dimension (plane is perpendicular)
-    for (int32_t i = 0; i < (int32_t)gridCellDim[d]; i++) {
+    for (int32_t i = 0; i < (int32_t)planeCellDim[d]; i++) {
 
-      float t = (static_cast<float>(i)) / (gridCellDim[d]);
+      float t = planePos(d, i);
 
       // clang-format off
       glm::vec3 ll{0.f, 0.f, 0.f}; ll[(d+1)%3] = 0.f; ll[(d+2)%3] = 0.f; ll[d] = t;
@@ -350,11 +457,78 @@ void VolumeGrid::computeGridPlaneReferenceGeometry() {
       addPlane({ul, uu, ll, lu}, n, i); // winding is opposite here
     }
   }
+}
 
+// === Mip levels
 
-  gridPlaneReferencePositions.markHostBufferUpdated();
-  gridPlaneReferenceNormals.markHostBufferUpdated();
-  gridPlaneAxisInds.markHostBufferUpdated();
+bool VolumeGrid::wantsMipLevels() { return getUseMipLevels() && nCells() >= options::volumeGridMipMinCells; }
+
+size_t VolumeGrid::getDisplayMipLevel(size_t nLevels) {
+  if (nLevels == 0) return 0;
+  size_t level = std::min(targetMipLevel, nLevels - 1);
+  if (level > std::min(idleMipLevel, nLevels - 1)) {
+    drewCoarserThanIdle = true;
+  }
+  return level;
+}
+
+void VolumeGrid::updateMipLevelTarget() {
+  drewCoarserThanIdle = false;
+  if (!wantsMipLevels()) {
+    targetMipLevel = 0;
+    idleMipLevel = 0;
+    return;
+  }
+
+  // Note the last time the view or a slice plane moved
+  glm::mat4 modelView = getModelView();
+  glm::mat4 projection = view::getCameraPerspectiveMatrix();
+  std::vector<glm::mat4> slicePlaneTransforms;
+  for (std::unique_ptr<SlicePlane>& s : state::slicePlanes) {
+    slicePlaneTransforms.push_back(s->getActive() ? s->getTransform() : glm::mat4(0.));
+  }
+  double now = ImGui::GetTime();
+  if (haveMipViewState && (modelView != lastMipModelView || projection != lastMipProjection ||
+                           slicePlaneTransforms != lastMipSlicePlaneTransforms)) {
+    lastViewChangeTime = now;
+  }
+  haveMipViewState = true;
+  lastMipModelView = modelView;
+  lastMipProjection = projection;
+  lastMipSlicePlaneTransforms = slicePlaneTransforms;
+  bool moving = now - lastViewChangeTime < options::volumeGridRefineDelay;
+
+  // Each level doubles the size of a cell. Pick the finest level whose cells are at least a pixel, or the target size
+  // while moving.
+  auto levelForCellPixels = [&](float targetPixels) {
+    float cellPixels = nearestCellPixelSize();
+    size_t level = 0;
+    while (cellPixels < targetPixels && level < 32) {
+      cellPixels *= 2.f;
+      level++;
+    }
+    return level;
+  };
+  idleMipLevel = levelForCellPixels(1.f);
+  targetMipLevel = moving ? std::max(idleMipLevel, levelForCellPixels(options::volumeGridInteractiveCellPixels))
+                          : idleMipLevel;
+}
+
+float VolumeGrid::nearestCellPixelSize() {
+  glm::mat4 modelView = getModelView();
+  glm::mat4 projection = view::getCameraPerspectiveMatrix();
+
+  // the point of the grid closest to the camera, in object space
+  glm::vec3 cameraPos = glm::vec3(glm::inverse(modelView) * glm::vec4(0., 0., 0., 1.));
+  glm::vec3 nearestPos = glm::clamp(cameraPos, boundMin, boundMax);
+  glm::vec4 clipPos = projection * modelView * glm::vec4(nearestPos, 1.);
+  if (!(clipPos.w > 0.)) {
+    return std::numeric_limits<float>::infinity(); // (the camera is inside the grid)
+  }
+
+  float viewScale = glm::length(glm::vec3(modelView[0]));
+  float cellSize = viewScale * minGridSpacing();
+  return cellSize * projection[1][1] * view::bufferHeight / (2.f * clipPos.w);
 }
 
 // === Option getters and setters
@@ -391,11 +565,35 @@ double VolumeGrid::getEdgeWidth() { return edgeWidth.get(); }
 
 VolumeGrid* VolumeGrid::setCubeSizeFactor(double newVal) {
   cubeSizeFactor = newVal;
+  pick::markPickBufferStale();
   requestRedraw();
   return this;
 }
 double VolumeGrid::getCubeSizeFactor() { return cubeSizeFactor.get(); }
 
+VolumeGrid* VolumeGrid::setRaycastGridCubes(bool newVal) {
+  raycastGridCubes = newVal;
+  refresh();
+  requestRedraw();
+  return this;
+}
+bool VolumeGrid::getRaycastGridCubes() { return raycastGridCubes.get(); }
+
+VolumeGrid* VolumeGrid::setUseMipLevels(bool newVal) {
+  useMipLevels = newVal;
+  requestRedraw();
+  return this;
+}
+bool VolumeGrid::getUseMipLevels() { return useMipLevels.get(); }
+
+VolumeGrid* VolumeGrid::setMipReduction(VolumeGridMipReduction newVal) {
+  mipReduction = newVal;
+  refresh(); // (the quantities re-upload their levels)
+  requestRedraw();
+  return this;
+}
+VolumeGridMipReduction VolumeGrid::getMipReduction() { return mipReduction.get(); }
+
 // === Register functions
 
 
@@ -554,4 +752,29 @@ VolumeGrid* registerVolumeGrid(std::string name, uint64_t gridNodeDim, glm::vec3
 void VolumeGridQuantity::buildNodeInfoGUI(size_t vInd) {}
 void VolumeGridQuantity::buildCellInfoGUI(size_t vInd) {}
 
+VolumeGridMipPyramid& VolumeGridQuantity::getMipPyramid() { return mipPyramid; }
+
+bool VolumeGridQuantity::updateMipPyramid(render::ManagedBuffer<float>& values, bool nodeValues) {
+  if (!parent.wantsMipLevels() || mipPyramid.isCurrent(values.getDataVersion())) return false;
+  mipPyramid.build(values.getPopulatedHostBufferRef(), parent.getGridCellDim(), nodeValues, values.getDataVersion());
+  mipTextures.clear();
+  return true;
+}
+
+size_t VolumeGridQuantity::getDisplayMipLevel() {
+  if (!parent.wantsMipLevels()) return 0;
+  return parent.getDisplayMipLevel(mipPyramid.nLevels());
+}
+
+std::shared_ptr<render::TextureBuffer> VolumeGridQuantity::getMipTexture(size_t iLevel) {
+  if (mipTextures.size() <= iLevel) mipTextures.resize(iLevel + 1);
+  if (!mipTextures[iLevel]) {
+    const VolumeGridMipPyramid::Level& level = mipPyramid.getLevel(iLevel);
+    const std::vector<float>& levelValues = level.getValues(parent.getMipReduction());
+    mipTextures[iLevel] = render::engine->generateTextureBuffer(TextureFormat::R32F, level.valueDim.x, level.valueDim.y,
+                                                                level.valueDim.z, &levelValues.front());
+  }
+  return mipTextures[iLevel];
+}
+
 } // namespace polyscope
@@ -0,0 +1,230 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope/volume_grid_mip.h"
+
+#include "polyscope/messages.h"
+#include "polyscope/parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+
+namespace polyscope {
+
+namespace {
+
+// Stop coarsening once the longest axis has this many cells
+const uint32_t coarsestCellDim = 2;
+
+// Rows of the coarse level handled by each worker
+const size_t rowsPerChunk = 16;
+
+// A fine entry which contributes to a coarse one along one axis, with its weight for the mean
+struct AxisTap {
+  uint32_t fineInd;
+  float weight;
+};
+
+glm::uvec3 coarsenCellDim(glm::uvec3 cellDim) { return (cellDim + 1u) / 2u; }
+
+glm::uvec3 valueDimForCellDim(glm::uvec3 cellDim, bool nodeValues) { return nodeValues ? cellDim + 1u : cellDim; }
+
+std::vector<std::vector<AxisTap>> computeAxisTaps(uint32_t fineValueDim, uint32_t coarseValueDim, bool nodeValues) {
+  std::vector<std::vector<AxisTap>> taps(coarseValueDim);
+  for (uint32_t c = 0; c < coarseValueDim; c++) {
+    if (nodeValues) {
+      // tent filter around the fine node at 2c (which may be one past the end, if the fine axis has an odd number of
+      // cells)
+      const std::array<float, 3> weights{0.25f, 0.5f, 0.25f};
+      for (uint32_t j = 0; j < 3; j++) {
+        int64_t f = 2 * static_cast<int64_t>(c) + j - 1;
+        if (f < 0 || f >= fineValueDim) continue;
+        taps[c].push_back(AxisTap{static_cast<uint32_t>(f), weights[j]});
+      }
+    } else {
+      for (uint32_t f = 2 * c; f < std::min(2 * c + 2, fineValueDim); f++) {
+        taps[c].push_back(AxisTap{f, 1.f});
+      }
+    }
+  }
+  return taps;
+}
+
+// Reduce the (min, max, mean) arrays of a finer level to the next coarser one
+VolumeGridMipPyramid::Level reduceLevel(const std::vector<float>& fineMin, const std::vector<float>& fineMax,
+                                        const std::vector<float>& fineMean, glm::uvec3 fineCellDim, bool nodeValues) {
+
+  VolumeGridMipPyramid::Level level;
+  level.cellDim = coarsenCellDim(fineCellDim);
+  level.valueDim = valueDimForCellDim(level.cellDim, nodeValues);
+  glm::uvec3 fineDim = valueDimForCellDim(fineCellDim, nodeValues);
+  glm::uvec3 dim = level.valueDim;
+
+  std::array<std::vector<std::vector<AxisTap>>, 3> taps;
+  for (int d = 0; d < 3; d++) {
+    taps[d] = computeAxisTaps(fineDim[d], dim[d], nodeValues);
+  }
+
+  size_t nValues = static_cast<size_t>(dim.x) * dim.y * dim.z;
+  level.minValues.resize(nValues);
+  level.maxValues.resize(nValues);
+  level.meanValues.resize(nValues);
+
+  size_t nRows = static_cast<size_t>(dim.y) * dim.z;
+  parallelForChunks(nRows, rowsPerChunk, [&](size_t iStart, size_t iEnd, size_t /* iChunk */) {
+    for (size_t iRow = iStart; iRow < iEnd; iRow++) {
+      uint32_t y = iRow % dim.y;
+      uint32_t z = iRow / dim.y;
+      for (uint32_t x = 0; x < dim.x; x++) {
+
+        float vMin = std::numeric_limits<float>::infinity();
+        float vMax = -std::numeric_limits<float>::infinity();
+        float sum = 0.;
+        float weightSum = 0.;
+        for (const AxisTap& tZ : taps[2][z]) {
+          for (const AxisTap& tY : taps[1][y]) {
+            size_t rowStart = (static_cast<size_t>(fineDim.y) * tZ.fineInd + tY.fineInd) * fineDim.x;
+            for (const AxisTap& tX : taps[0][x]) {
+              size_t iFine = rowStart + tX.fineInd;
+              float w = tZ.weight * tY.weight * tX.weight;
+              vMin = std::min(vMin, fineMin[iFine]);
+              vMax = std::max(vMax, fineMax[iFine]);
+              sum += w * fineMean[iFine];
+              weightSum += w;
+            }
+          }
+        }
+
+        size_t i = iRow * dim.x + x;
+        level.minValues[i] = vMin;
+        level.maxValues[i] = vMax;
+        level.meanValues[i] = sum / weightSum;
+      }
+    }
+  });
+
+  return level;
+}
+
+} // namespace
+
+const std::vector<float>& VolumeGridMipPyramid::Level::getValues(VolumeGridMipReduction reduction) const {
+  switch (reduction) {
+  case VolumeGridMipReduction::Mean:
+    return meanValues;
+  case VolumeGridMipReduction::Min:
+    return minValues;
+  case VolumeGridMipReduction::Max:
+    return maxValues;
+  }
+  return meanValues;
+}
+
+VolumeGridMipPyramid::~VolumeGridMipPyramid() {
+  // (the futures from std::async block on destruction anyway, this is just explicit about it)
+  latestGeneration->fetch_add(1);
+  waitForAllBuilds();
+}
+
+void VolumeGridMipPyramid::build(std::vector<float> values, glm::uvec3 gridCellDim, bool nodeValues, uint64_t key) {
+  glm::uvec3 valueDim = valueDimForCellDim(gridCellDim, nodeValues);
+  if (values.size() != static_cast<size_t>(valueDim.x) * valueDim.y * valueDim.z) {
+    exception("volume grid mip pyramid: got " + std::to_string(values.size()) + " values for a grid of " +
+              std::to_string(valueDim.x) + "x" + std::to_string(valueDim.y) + "x" + std::to_string(valueDim.z));
+  }
+
+  // (builds which are still running are left to stop on their own, see collectBuilds())
+  collectBuilds(false);
+  uint64_t generation = latestGeneration->fetch_add(1) + 1;
+  built.reset();
+  currentKey = key;
+  haveKey = true;
+  std::shared_ptr<std::atomic<uint64_t>> latest = latestGeneration;
+  pendingBuilds.emplace_back(
+      generation, std::async(
+                      std::launch::async,
+                      [latest, generation](std::vector<float> values, glm::uvec3 gridCellDim, bool nodeValues) {
+                        std::function<bool()> superseded = [&]() { return latest->load() != generation; };
+                        std::vector<Level> levels = computeLevels(values, gridCellDim, nodeValues, superseded);
+                        return superseded() ? nullptr : std::make_shared<std::vector<Level>>(std::move(levels));
+                      },
+                      std::move(values), gridCellDim, nodeValues));
+}
+
+bool VolumeGridMipPyramid::isCurrent(uint64_t key) const { return haveKey && key == currentKey; }
+
+void VolumeGridMipPyramid::clear() {
+  latestGeneration->fetch_add(1);
+  waitForAllBuilds();
+  built.reset();
+  currentKey = 0;
+  haveKey = false;
+}
+
+void VolumeGridMipPyramid::collectBuilds(bool waitForBuild) {
+  uint64_t latest = latestGeneration->load();
+  for (size_t i = 0; i < pendingBuilds.size();) {
+    PendingBuild& pending = pendingBuilds[i];
+    bool isLatest = pending.first == latest;
+    if ((waitForBuild && isLatest) || pending.second.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+      std::shared_ptr<std::vector<Level>> result = pending.second.get();
+      if (isLatest) built = result; // (results of older generations are dropped)
+      pendingBuilds.erase(pendingBuilds.begin() + i);
+    } else {
+      i++;
+    }
+  }
+}
+
+void VolumeGridMipPyramid::waitForAllBuilds() {
+  for (PendingBuild& pending : pendingBuilds) pending.second.wait();
+  pendingBuilds.clear();
+}
+
+bool VolumeGridMipPyramid::isReady(bool waitForBuild) {
+  // Pick up the result of the background build, if there is one
+  collectBuilds(waitForBuild);
+  return static_cast<bool>(built);
+}
+
+size_t VolumeGridMipPyramid::nLevels() {
+  if (!isReady()) return 1;
+  return built->size() + 1;
+}
+
+const VolumeGridMipPyramid::Level& VolumeGridMipPyramid::getLevel(size_t iLevel) {
+  if (iLevel == 0 || iLevel >= nLevels()) {
+    exception("volume grid mip level " + std::to_string(iLevel) + " is not available");
+  }
+  return (*built)[iLevel - 1];
+}
+
+glm::uvec3 VolumeGridMipPyramid::levelCellDim(glm::uvec3 gridCellDim, size_t iLevel) {
+  glm::uvec3 cellDim = gridCellDim;
+  for (size_t i = 0; i < iLevel; i++) {
+    cellDim = coarsenCellDim(cellDim);
+  }
+  return cellDim;
+}
+
+std::vector<VolumeGridMipPyramid::Level> VolumeGridMipPyramid::computeLevels(const std::vector<float>& values,
+                                                                             glm::uvec3 gridCellDim, bool nodeValues,
+                                                                             std::function<bool()> stop) {
+  std::vector<Level> levels;
+  glm::uvec3 cellDim = gridCellDim;
+  while (std::max(cellDim.x, std::max(cellDim.y, cellDim.z)) > coarsestCellDim) {
+    if (stop && stop()) break;
+    if (levels.empty()) {
+      levels.push_back(reduceLevel(values, values, values, cellDim, nodeValues));
+    } else {
+      const Level& prev = levels.back();
+      Level next = reduceLevel(prev.minValues, prev.maxValues, prev.meanValues, cellDim, nodeValues);
+      levels.push_back(std::move(next));
+    }
+    cellDim = levels.back().cellDim;
+  }
+  return levels;
+}
+
+} // namespace polyscope
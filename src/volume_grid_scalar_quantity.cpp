@@ -6,6 +6,24 @@
 
 namespace polyscope {
 
+namespace {
+
+// Extract the level set of node values on a grid, in world coordinates
+MC::mcMesh extractIsosurfaceMesh(std::vector<float>& nodeValues, glm::uvec3 nodeDim, float isoLevel,
+                                 glm::vec3 gridSpacing, glm::vec3 boundMin) {
+  MC::mcMesh isosurfaceMesh;
+  MC::marching_cube(&nodeValues.front(), isoLevel, nodeDim.x, nodeDim.y, nodeDim.z, isosurfaceMesh);
+
+  // Transform the result to be aligned with our volume's spatial layout
+  for (auto& p : isosurfaceMesh.vertices) {
+    // swizzle to account for change of coordinate/buffer ordering in the MC lib
+    p = glm::vec3{p.z, p.y, p.x} * gridSpacing + boundMin;
+  }
+  return isosurfaceMesh;
+}
+
+} // namespace
+
 // ========================================================
 // ==========            Node Scalar             ==========
 // ========================================================
@@ -20,6 +38,7 @@ VolumeGridNodeScalarQuantity::VolumeGridNodeScalarQuantity(std::string name, Vol
       slicePlanesAffectIsosurface(uniquePrefix() + "slicePlanesAffectIsosurface", false) {
 
   values.setTextureSize(parent.getGridNodeDim().x, parent.getGridNodeDim().y, parent.getGridNodeDim().z);
+  updateMipPyramid(values, true);
 }
 
 
@@ -89,55 +108,68 @@ std::string VolumeGridNodeScalarQuantity::niceName() { return name + " (node sca
 bool VolumeGridNodeScalarQuantity::isDrawingGridcubes() { return isEnabled() && getGridcubeVizEnabled(); }
 
 void VolumeGridNodeScalarQuantity::refresh() {
-  gridcubeProgram.reset();
-  isosurfaceProgram.reset();
+  gridcubePrograms.clear();
+  isosurfacePrograms.clear();
+  mipTextures.clear();
 }
 
 void VolumeGridNodeScalarQuantity::draw() {
   if (!isEnabled()) return;
 
+  // Large grids are drawn from a coarser copy of the values while the view moves
+  if (updateMipPyramid(values, true)) {
+    gridcubePrograms.resize(std::min<size_t>(gridcubePrograms.size(), 1));
+    isosurfacePrograms.resize(std::min<size_t>(isosurfacePrograms.size(), 1));
+  }
+  size_t mipLevel = getDisplayMipLevel();
+
   // Draw the point viz
   if (gridcubeVizEnabled.get()) {
-    if (gridcubeProgram == nullptr) {
-      createGridcubeProgram();
+    if (gridcubePrograms.size() <= mipLevel) gridcubePrograms.resize(mipLevel + 1);
+    if (gridcubePrograms[mipLevel] == nullptr) {
+      createGridcubeProgram(mipLevel);
     }
+    render::ShaderProgram& gridcubeProgram = *gridcubePrograms[mipLevel];
 
     // Set program uniforms
-    parent.setStructureUniforms(*gridcubeProgram);
-    parent.setGridCubeUniforms(*gridcubeProgram);
-    setScalarUniforms(*gridcubeProgram);
-    render::engine->setMaterialUniforms(*gridcubeProgram, parent.getMaterial());
+    parent.setStructureUniforms(gridcubeProgram);
+    parent.setGridCubeUniforms(gridcubeProgram, true, mipLevel);
+    setScalarUniforms(gridcubeProgram);
+    render::engine->setMaterialUniforms(gridcubeProgram, parent.getMaterial());
 
     // Draw the actual grid
     render::engine->setBackfaceCull(true);
-    gridcubeProgram->draw();
+    gridcubeProgram.draw();
   }
 
   // Draw the isosurface program
   if (isosurfaceVizEnabled.get()) {
-    if (isosurfaceProgram == nullptr) {
-      createIsosurfaceProgram();
+    if (isosurfacePrograms.size() <= mipLevel) isosurfacePrograms.resize(mipLevel + 1);
+    if (isosurfacePrograms[mipLevel] == nullptr) {
+      createIsosurfaceProgram(mipLevel);
     }
-    parent.setStructureUniforms(*isosurfaceProgram);
-    // setScalarUniforms(*isosurfaceProgram);
-    render::engine->setMaterialUniforms(*isosurfaceProgram, parent.getMaterial());
-    isosurfaceProgram->setUniform("u_baseColor", getIsosurfaceColor());
+    render::ShaderProgram& isosurfaceProgram = *isosurfacePrograms[mipLevel];
+
+    parent.setStructureUniforms(isosurfaceProgram);
+    // setScalarUniforms(isosurfaceProgram);
+    render::engine->setMaterialUniforms(isosurfaceProgram, parent.getMaterial());
+    isosurfaceProgram.setUniform("u_baseColor", getIsosurfaceColor());
 
     glm::mat4 P = view::getCameraPerspectiveMatrix();
     glm::mat4 Pinv = glm::inverse(P);
-    isosurfaceProgram->setUniform("u_invProjMatrix", glm::value_ptr(Pinv));
-    isosurfaceProgram->setUniform("u_viewport", render::engine->getCurrentViewport());
+    isosurfaceProgram.setUniform("u_invProjMatrix", glm::value_ptr(Pinv));
+    isosurfaceProgram.setUniform("u_viewport", render::engine->getCurrentViewport());
 
     render::engine->setBackfaceCull(false);
-    isosurfaceProgram->draw();
+    isosurfaceProgram.draw();
   }
 }
 
-void VolumeGridNodeScalarQuantity::createGridcubeProgram() {
+void VolumeGridNodeScalarQuantity::createGridcubeProgram(size_t mipLevel) {
 
 
   // clang-format off
-  gridcubeProgram = render::engine->requestShader( "GRIDCUBE_PLANE", 
+  std::shared_ptr<render::ShaderProgram> gridcubeProgram = render::engine->requestShader(parent.getGridCubeShaderName(),
       render::engine->addMaterialRules(parent.getMaterial(),
         parent.addGridCubeRules(
           addScalarRules(
@@ -148,31 +180,37 @@ void VolumeGridNodeScalarQuantity::createGridcubeProgram() {
     );
   // clang-format on
 
-  gridcubeProgram->setAttribute("a_referencePosition", parent.gridPlaneReferencePositions.getRenderAttributeBuffer());
-  gridcubeProgram->setAttribute("a_referenceNormal", parent.gridPlaneReferenceNormals.getRenderAttributeBuffer());
-  gridcubeProgram->setAttribute("a_axisInd", parent.gridPlaneAxisInds.getRenderAttributeBuffer());
+  parent.setGridCubeGeometryAttributes(*gridcubeProgram, mipLevel);
 
   gridcubeProgram->setTextureFromColormap("t_colormap", cMap.get());
   render::engine->setMaterial(*gridcubeProgram, parent.getMaterial());
 
-  gridcubeProgram->setTextureFromBuffer("t_value", values.getRenderTextureBuffer().get());
-  values.getRenderTextureBuffer().get()->setFilterMode(FilterMode::Linear);
-}
+  std::shared_ptr<render::TextureBuffer> valueTexture =
+      mipLevel == 0 ? values.getRenderTextureBuffer() : getMipTexture(mipLevel);
+  gridcubeProgram->setTextureFromBuffer("t_value", valueTexture.get());
+  valueTexture->setFilterMode(FilterMode::Linear);
 
-void VolumeGridNodeScalarQuantity::createIsosurfaceProgram() {
+  gridcubePrograms[mipLevel] = gridcubeProgram;
+}
 
-  values.ensureHostBufferPopulated();
+void VolumeGridNodeScalarQuantity::createIsosurfaceProgram(size_t mipLevel) {
 
-  // Extract the isosurface from the level set of the scalar field
+  // Extract the isosurface from the level set of the scalar field (coarse levels use the mean values, so the surface
+  // stays in place)
   MC::mcMesh isosurfaceMesh;
-  MC::marching_cube(&values.data.front(), isosurfaceLevel.get(), parent.getGridNodeDim().x, parent.getGridNodeDim().y,
-                    parent.getGridNodeDim().z, isosurfaceMesh);
-
-  // Transform the result to be aligned with our volume's spatial layout
-  glm::vec3 scale = parent.gridSpacing();
-  for (auto& p : isosurfaceMesh.vertices) {
-    // swizzle to account for change of coordinate/buffer ordering in the MC lib
-    p = glm::vec3{p.z, p.y, p.x} * scale + parent.getBoundMin();
+  if (mipLevel == 0) {
+    isosurfaceMesh = extractIsosurfaceMesh(values.getPopulatedHostBufferRef(), parent.getGridNodeDim(),
+                                           isosurfaceLevel.get(), parent.gridSpacing(), parent.getBoundMin());
+  } else {
+    const VolumeGridMipPyramid::Level& level = mipPyramid.getLevel(mipLevel);
+    std::vector<float> levelValues = level.meanValues;
+    isosurfaceMesh = extractIsosurfaceMesh(levelValues, level.valueDim, isosurfaceLevel.get(),
+                                           parent.gridSpacing(mipLevel), parent.getBoundMin());
+
+    // The last nodes along an axis may lie past the bounds, keep the surface inside of them
+    for (glm::vec3& v : isosurfaceMesh.vertices) {
+      v = glm::clamp(v, parent.getBoundMin(), parent.getBoundMax());
+    }
   }
 
   std::vector<std::string> isoProgramRules{"SHADE_BASECOLOR", "PROJ_AND_INV_PROJ_MAT",
@@ -184,7 +222,7 @@ void VolumeGridNodeScalarQuantity::createIsosurfaceProgram() {
 
   // Create a render program to draw it
   // clang-format off
-  isosurfaceProgram = render::engine->requestShader("SIMPLE_MESH",
+  std::shared_ptr<render::ShaderProgram> isosurfaceProgram = render::engine->requestShader("SIMPLE_MESH",
       render::engine->addMaterialRules(parent.getMaterial(), 
         parent.addStructureRules(
           isoProgramRules
@@ -204,6 +242,8 @@ void VolumeGridNodeScalarQuantity::createIsosurfaceProgram() {
 
 
   render::engine->setMaterial(*isosurfaceProgram, parent.getMaterial());
+
+  isosurfacePrograms[mipLevel] = isosurfaceProgram;
 }
 
 SurfaceMesh* VolumeGridNodeScalarQuantity::registerIsosurfaceAsMesh(std::string structureName) {
@@ -213,15 +253,9 @@ SurfaceMesh* VolumeGridNodeScalarQuantity::registerIsosurfaceAsMesh(std::string
     structureName = parent.name + " - " + name + " - isosurface";
   }
 
-  // extract the mesh
-  MC::mcMesh isosurfaceMesh;
-  MC::marching_cube(&values.data.front(), isosurfaceLevel.get(), parent.getGridNodeDim().x, parent.getGridNodeDim().y,
-                    parent.getGridNodeDim().z, isosurfaceMesh);
-  glm::vec3 scale = parent.gridSpacing();
-  for (auto& p : isosurfaceMesh.vertices) {
-    // swizzle to account for change of coordinate/buffer ordering in the MC lib
-    p = glm::vec3{p.z, p.y, p.x} * scale + parent.getBoundMin();
-  }
+  // extract the mesh (always at full resolution)
+  MC::mcMesh isosurfaceMesh = extractIsosurfaceMesh(values.getPopulatedHostBufferRef(), parent.getGridNodeDim(),
+                                                    isosurfaceLevel.get(), parent.gridSpacing(), parent.getBoundMin());
 
   return registerSurfaceMesh(structureName, isosurfaceMesh.vertices,
                              std::make_tuple(isosurfaceMesh.indices.data(), isosurfaceMesh.indices.size() / 3, 3));
@@ -252,7 +286,7 @@ bool VolumeGridNodeScalarQuantity::getIsosurfaceVizEnabled() { return isosurface
 
 VolumeGridNodeScalarQuantity* VolumeGridNodeScalarQuantity::setIsosurfaceLevel(float val) {
   isosurfaceLevel = val;
-  isosurfaceProgram.reset(); // delete the program so it gets recreated with the new value
+  isosurfacePrograms.clear(); // delete the programs so they get recreated with the new value
   requestRedraw();
   return this;
 }
@@ -267,7 +301,7 @@ glm::vec3 VolumeGridNodeScalarQuantity::getIsosurfaceColor() { return isosurface
 
 VolumeGridNodeScalarQuantity* VolumeGridNodeScalarQuantity::setSlicePlanesAffectIsosurface(bool val) {
   slicePlanesAffectIsosurface = val;
-  isosurfaceProgram.reset(); // delete the program so it gets recreated with the new value
+  isosurfacePrograms.clear(); // delete the programs so they get recreated with the new value
   requestRedraw();
   return this;
 }
@@ -283,6 +317,7 @@ VolumeGridCellScalarQuantity::VolumeGridCellScalarQuantity(std::string name, Vol
       gridcubeVizEnabled(parent.uniquePrefix() + "#" + name + "#gridcubeVizEnabled", true) {
 
   values.setTextureSize(parent.getGridCellDim().x, parent.getGridCellDim().y, parent.getGridCellDim().z);
+  updateMipPyramid(values, false);
 }
 
 
@@ -321,34 +356,45 @@ std::string VolumeGridCellScalarQuantity::niceName() { return name + " (cell sca
 
 bool VolumeGridCellScalarQuantity::isDrawingGridcubes() { return isEnabled() && getGridcubeVizEnabled(); }
 
-void VolumeGridCellScalarQuantity::refresh() { gridcubeProgram.reset(); }
+void VolumeGridCellScalarQuantity::refresh() {
+  gridcubePrograms.clear();
+  mipTextures.clear();
+}
 
 void VolumeGridCellScalarQuantity::draw() {
   if (!isEnabled()) return;
 
+  // Large grids are drawn from a coarser copy of the values while the view moves
+  if (updateMipPyramid(values, false)) {
+    gridcubePrograms.resize(std::min<size_t>(gridcubePrograms.size(), 1));
+  }
+  size_t mipLevel = getDisplayMipLevel();
+
   // Draw the point viz
   if (gridcubeVizEnabled.get()) {
-    if (gridcubeProgram == nullptr) {
-      createGridcubeProgram();
+    if (gridcubePrograms.size() <= mipLevel) gridcubePrograms.resize(mipLevel + 1);
+    if (gridcubePrograms[mipLevel] == nullptr) {
+      createGridcubeProgram(mipLevel);
     }
+    render::ShaderProgram& gridcubeProgram = *gridcubePrograms[mipLevel];
 
     // Set program uniforms
-    parent.setStructureUniforms(*gridcubeProgram);
-    parent.setGridCubeUniforms(*gridcubeProgram);
-    setScalarUniforms(*gridcubeProgram);
-    render::engine->setMaterialUniforms(*gridcubeProgram, parent.getMaterial());
+    parent.setStructureUniforms(gridcubeProgram);
+    parent.setGridCubeUniforms(gridcubeProgram, true, mipLevel);
+    setScalarUniforms(gridcubeProgram);
+    render::engine->setMaterialUniforms(gridcubeProgram, parent.getMaterial());
 
     // Draw the actual grid
     render::engine->setBackfaceCull(true);
-    gridcubeProgram->draw();
+    gridcubeProgram.draw();
   }
 }
 
-void VolumeGridCellScalarQuantity::createGridcubeProgram() {
+void VolumeGridCellScalarQuantity::createGridcubeProgram(size_t mipLevel) {
 
 
   // clang-format off
-  gridcubeProgram = render::engine->requestShader("GRIDCUBE_PLANE", 
+  std::shared_ptr<render::ShaderProgram> gridcubeProgram = render::engine->requestShader(parent.getGridCubeShaderName(),
       render::engine->addMaterialRules(parent.getMaterial(),
         parent.addGridCubeRules(
           addScalarRules(
@@ -359,15 +405,17 @@ void VolumeGridCellScalarQuantity::createGridcubeProgram() {
   );
   // clang-format on
 
-  gridcubeProgram->setAttribute("a_referencePosition", parent.gridPlaneReferencePositions.getRenderAttributeBuffer());
-  gridcubeProgram->setAttribute("a_referenceNormal", parent.gridPlaneReferenceNormals.getRenderAttributeBuffer());
-  gridcubeProgram->setAttribute("a_axisInd", parent.gridPlaneAxisInds.getRenderAttributeBuffer());
+  parent.setGridCubeGeometryAttributes(*gridcubeProgram, mipLevel);
 
   gridcubeProgram->setTextureFromColormap("t_colormap", cMap.get());
   render::engine->setMaterial(*gridcubeProgram, parent.getMaterial());
 
-  gridcubeProgram->setTextureFromBuffer("t_value", values.getRenderTextureBuffer().get());
-  values.getRenderTextureBuffer().get()->setFilterMode(FilterMode::Linear);
+  std::shared_ptr<render::TextureBuffer> valueTexture =
+      mipLevel == 0 ? values.getRenderTextureBuffer() : getMipTexture(mipLevel);
+  gridcubeProgram->setTextureFromBuffer("t_value", valueTexture.get());
+  valueTexture->setFilterMode(FilterMode::Linear);
+
+  gridcubePrograms[mipLevel] = gridcubeProgram;
 }
 
 void VolumeGridCellScalarQuantity::buildCellInfoGUI(size_t ind) {
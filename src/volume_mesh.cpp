@@ -4,8 +4,10 @@
 
 #include "polyscope/color_management.h"
 #include "polyscope/combining_hash_functions.h"
+#include "polyscope/parallel.h"
 #include "polyscope/pick.h"
 #include "polyscope/polyscope.h"
+#include "polyscope/reductions.h"
 #include "polyscope/render/engine.h"
 #include "polyscope/utilities.h"
 #include "polyscope/volume_mesh_quantity.h"
@@ -19,6 +21,11 @@
 
 namespace polyscope {
 
+namespace {
+// Don't bother spinning up threads to process fewer cells than this
+const size_t connectivityMinChunkSize = 1 << 14;
+} // namespace
+
 // Initialize statics
 const std::string VolumeMesh::structureTypeName = "Volume Mesh";
 
@@ -111,8 +118,7 @@ triangleFaceInds(       this, uniquePrefix() + "triangleFaceInds",    triangleFa
 triangleCellInds(       this, uniquePrefix() + "triangleCellInds",    triangleCellIndsData),
 
 // internal triangle data for rendering
-baryCoord(              this, uniquePrefix() + "baryCoord",           baryCoordData),
-edgeIsReal(             this, uniquePrefix() + "edgeIsReal",          edgeIsRealData),
+edgeIsRealMask(         this, uniquePrefix() + "edgeIsRealMask",      edgeIsRealMaskData),
 faceType(               this, uniquePrefix() + "faceType",            faceTypeData),
 
 // other internally-computed geometry
@@ -225,123 +231,135 @@ void VolumeMesh::computeTets() {
   // https://www.researchgate.net/profile/Julien-Dompierre/publication/221561839_How_to_Subdivide_Pyramids_Prisms_and_Hexahedra_into_Tetrahedra/links/0912f509c0b7294059000000/How-to-Subdivide-Pyramids-Prisms-and-Hexahedra-into-Tetrahedra.pdf?origin=publication_detail
   // It's a bit hard to look at but it works
   // Uses vertex numberings to ensure consistent diagonals between faces, and keeps tet counts to 5 or 6 per hex
-  size_t tetCount = 0;
+  //
+  // Ranges of cells are split in parallel: first count the tets in each range, then each range fills its own slice of
+  // the tet array, so the tets are in the same order as the cells.
+  size_t nChunks = parallelChunkCount(nCells(), connectivityMinChunkSize);
+  std::vector<size_t> chunkTetStart(nChunks + 1, 0);
+
   // Get number of tets first
-  for (size_t iC = 0; iC < nCells(); iC++) {
-    switch (cellType(iC)) {
-    case VolumeCellType::HEX: {
-      std::array<size_t, 8> sortedNumbering;
-      std::iota(sortedNumbering.begin(), sortedNumbering.end(), 0);
-      std::sort(sortedNumbering.begin(), sortedNumbering.end(),
-                [this, iC](size_t a, size_t b) -> bool { return cells[iC][a] < cells[iC][b]; });
-      std::array<size_t, 8> rotatedNumbering;
-      std::copy(rotationMap[sortedNumbering[0]].begin(), rotationMap[sortedNumbering[0]].end(),
-                rotatedNumbering.begin());
-      size_t diagCount = 0;
-      auto checkDiagonal = [this, rotatedNumbering, iC](size_t a1, size_t a2, size_t b1, size_t b2) {
-        return (cells[iC][rotatedNumbering[a1]] < cells[iC][rotatedNumbering[b1]] &&
-                cells[iC][rotatedNumbering[a1]] < cells[iC][rotatedNumbering[b2]]) ||
-               (cells[iC][rotatedNumbering[a2]] < cells[iC][rotatedNumbering[b1]] &&
-                cells[iC][rotatedNumbering[a2]] < cells[iC][rotatedNumbering[b2]]);
-      };
-      if (checkDiagonal(1, 7, 2, 5)) {
-        diagCount++;
-      }
-      if (checkDiagonal(3, 7, 2, 6)) {
-        diagCount++;
-      }
-      if (checkDiagonal(4, 7, 5, 6)) {
-        diagCount++;
+  parallelForChunks(nCells(), connectivityMinChunkSize, [&](size_t iCellStart, size_t iCellEnd, size_t iChunk) {
+    size_t tetCount = 0;
+    for (size_t iC = iCellStart; iC < iCellEnd; iC++) {
+      switch (cellType(iC)) {
+      case VolumeCellType::HEX: {
+        std::array<size_t, 8> sortedNumbering;
+        std::iota(sortedNumbering.begin(), sortedNumbering.end(), 0);
+        std::sort(sortedNumbering.begin(), sortedNumbering.end(),
+                  [this, iC](size_t a, size_t b) -> bool { return cells[iC][a] < cells[iC][b]; });
+        std::array<size_t, 8> rotatedNumbering;
+        std::copy(rotationMap[sortedNumbering[0]].begin(), rotationMap[sortedNumbering[0]].end(),
+                  rotatedNumbering.begin());
+        size_t diagCount = 0;
+        auto checkDiagonal = [this, rotatedNumbering, iC](size_t a1, size_t a2, size_t b1, size_t b2) {
+          return (cells[iC][rotatedNumbering[a1]] < cells[iC][rotatedNumbering[b1]] &&
+                  cells[iC][rotatedNumbering[a1]] < cells[iC][rotatedNumbering[b2]]) ||
+                 (cells[iC][rotatedNumbering[a2]] < cells[iC][rotatedNumbering[b1]] &&
+                  cells[iC][rotatedNumbering[a2]] < cells[iC][rotatedNumbering[b2]]);
+        };
+        if (checkDiagonal(1, 7, 2, 5)) {
+          diagCount++;
+        }
+        if (checkDiagonal(3, 7, 2, 6)) {
+          diagCount++;
+        }
+        if (checkDiagonal(4, 7, 5, 6)) {
+          diagCount++;
+        }
+        if (diagCount == 0) {
+          tetCount += 5;
+        } else {
+          tetCount += 6;
+        }
+        break;
       }
-      if (diagCount == 0) {
-        tetCount += 5;
-      } else {
-        tetCount += 6;
+      case VolumeCellType::TET:
+        tetCount += 1;
+        break;
       }
-      break;
-    }
-    case VolumeCellType::TET:
-      tetCount += 1;
-      break;
     }
+    chunkTetStart[iChunk + 1] = tetCount;
+  });
+  for (size_t iChunk = 0; iChunk < nChunks; iChunk++) {
+    chunkTetStart[iChunk + 1] += chunkTetStart[iChunk];
   }
-  // Mark each edge as real or not (in the original mesh)
-  std::vector<std::array<bool, 6>> realEdges;
+
   // Each hex can make up to 6 tets
-  tets.resize(tetCount);
-  realEdges.resize(tetCount);
-  size_t tetIdx = 0;
-  for (size_t iC = 0; iC < nCells(); iC++) {
-    switch (cellType(iC)) {
-    case VolumeCellType::HEX: {
-      std::array<size_t, 8> sortedNumbering;
-      std::iota(sortedNumbering.begin(), sortedNumbering.end(), 0);
-      std::sort(sortedNumbering.begin(), sortedNumbering.end(),
-                [this, iC](size_t a, size_t b) -> bool { return cells[iC][a] < cells[iC][b]; });
-      std::array<size_t, 8> rotatedNumbering;
-      std::copy(rotationMap[sortedNumbering[0]].begin(), rotationMap[sortedNumbering[0]].end(),
-                rotatedNumbering.begin());
-      size_t n = 0;
-      size_t diagCount = 0;
-      // Diagonal exists on the pair of vertices which contain the minimum vertex number
-      auto checkDiagonal = [this, rotatedNumbering, iC](size_t a1, size_t a2, size_t b1, size_t b2) {
-        return (cells[iC][rotatedNumbering[a1]] < cells[iC][rotatedNumbering[b1]] &&
-                cells[iC][rotatedNumbering[a1]] < cells[iC][rotatedNumbering[b2]]) ||
-               (cells[iC][rotatedNumbering[a2]] < cells[iC][rotatedNumbering[b1]] &&
-                cells[iC][rotatedNumbering[a2]] < cells[iC][rotatedNumbering[b2]]);
-      };
-      // Minimum vertex will always have 3 diagonals, check other three faces
-      if (checkDiagonal(1, 7, 2, 5)) {
-        n += 4;
-        diagCount++;
-      }
-      if (checkDiagonal(3, 7, 2, 6)) {
-        n += 2;
-        diagCount++;
-      }
-      if (checkDiagonal(4, 7, 5, 6)) {
-        n += 1;
-        diagCount++;
-      }
-      // Rotate by 120 or 240 degrees depending on diagonal positions
-      if (n == 1 || n == 6) {
-        size_t temp = rotatedNumbering[1];
-        rotatedNumbering[1] = rotatedNumbering[4];
-        rotatedNumbering[4] = rotatedNumbering[3];
-        rotatedNumbering[3] = temp;
-        temp = rotatedNumbering[5];
-        rotatedNumbering[5] = rotatedNumbering[6];
-        rotatedNumbering[6] = rotatedNumbering[2];
-        rotatedNumbering[2] = temp;
-      } else if (n == 2 || n == 5) {
-        size_t temp = rotatedNumbering[1];
-        rotatedNumbering[1] = rotatedNumbering[3];
-        rotatedNumbering[3] = rotatedNumbering[4];
-        rotatedNumbering[4] = temp;
-        temp = rotatedNumbering[5];
-        rotatedNumbering[5] = rotatedNumbering[2];
-        rotatedNumbering[2] = rotatedNumbering[6];
-        rotatedNumbering[6] = temp;
-      }
+  tets.resize(chunkTetStart[nChunks]);
+  parallelForChunks(nCells(), connectivityMinChunkSize, [&](size_t iCellStart, size_t iCellEnd, size_t iChunk) {
+    size_t tetIdx = chunkTetStart[iChunk];
+    for (size_t iC = iCellStart; iC < iCellEnd; iC++) {
+      switch (cellType(iC)) {
+      case VolumeCellType::HEX: {
+        std::array<size_t, 8> sortedNumbering;
+        std::iota(sortedNumbering.begin(), sortedNumbering.end(), 0);
+        std::sort(sortedNumbering.begin(), sortedNumbering.end(),
+                  [this, iC](size_t a, size_t b) -> bool { return cells[iC][a] < cells[iC][b]; });
+        std::array<size_t, 8> rotatedNumbering;
+        std::copy(rotationMap[sortedNumbering[0]].begin(), rotationMap[sortedNumbering[0]].end(),
+                  rotatedNumbering.begin());
+        size_t n = 0;
+        size_t diagCount = 0;
+        // Diagonal exists on the pair of vertices which contain the minimum vertex number
+        auto checkDiagonal = [this, rotatedNumbering, iC](size_t a1, size_t a2, size_t b1, size_t b2) {
+          return (cells[iC][rotatedNumbering[a1]] < cells[iC][rotatedNumbering[b1]] &&
+                  cells[iC][rotatedNumbering[a1]] < cells[iC][rotatedNumbering[b2]]) ||
+                 (cells[iC][rotatedNumbering[a2]] < cells[iC][rotatedNumbering[b1]] &&
+                  cells[iC][rotatedNumbering[a2]] < cells[iC][rotatedNumbering[b2]]);
+        };
+        // Minimum vertex will always have 3 diagonals, check other three faces
+        if (checkDiagonal(1, 7, 2, 5)) {
+          n += 4;
+          diagCount++;
+        }
+        if (checkDiagonal(3, 7, 2, 6)) {
+          n += 2;
+          diagCount++;
+        }
+        if (checkDiagonal(4, 7, 5, 6)) {
+          n += 1;
+          diagCount++;
+        }
+        // Rotate by 120 or 240 degrees depending on diagonal positions
+        if (n == 1 || n == 6) {
+          size_t temp = rotatedNumbering[1];
+          rotatedNumbering[1] = rotatedNumbering[4];
+          rotatedNumbering[4] = rotatedNumbering[3];
+          rotatedNumbering[3] = temp;
+          temp = rotatedNumbering[5];
+          rotatedNumbering[5] = rotatedNumbering[6];
+          rotatedNumbering[6] = rotatedNumbering[2];
+          rotatedNumbering[2] = temp;
+        } else if (n == 2 || n == 5) {
+          size_t temp = rotatedNumbering[1];
+          rotatedNumbering[1] = rotatedNumbering[3];
+          rotatedNumbering[3] = rotatedNumbering[4];
+          rotatedNumbering[4] = temp;
+          temp = rotatedNumbering[5];
+          rotatedNumbering[5] = rotatedNumbering[2];
+          rotatedNumbering[2] = rotatedNumbering[6];
+          rotatedNumbering[6] = temp;
+        }
 
-      // Map final tets according to diagonalMap and the number of diagonals not incident to V_0
-      std::array<std::array<size_t, 4>, 6> tetMap = diagonalMap[diagCount];
-      for (size_t k = 0; k < (diagCount == 0 ? 5 : 6); k++) {
+        // Map final tets according to diagonalMap and the number of diagonals not incident to V_0
+        std::array<std::array<size_t, 4>, 6> tetMap = diagonalMap[diagCount];
+        for (size_t k = 0; k < (diagCount == 0 ? 5 : 6); k++) {
+          for (size_t i = 0; i < 4; i++) {
+            tets[tetIdx][i] = cells[iC][rotatedNumbering[tetMap[k][i]]];
+          }
+          tetIdx++;
+        }
+        break;
+      }
+      case VolumeCellType::TET:
         for (size_t i = 0; i < 4; i++) {
-          tets[tetIdx][i] = cells[iC][rotatedNumbering[tetMap[k][i]]];
+          tets[tetIdx][i] = cells[iC][i];
         }
         tetIdx++;
+        break;
       }
-      break;
-    }
-    case VolumeCellType::TET:
-      for (size_t i = 0; i < 4; i++) {
-        tets[tetIdx][i] = cells[iC][i];
-      }
-      tetIdx++;
-      break;
     }
-  }
+  });
 }
 
 void VolumeMesh::ensureHaveTets() {
@@ -502,6 +520,67 @@ void VolumeMesh::prepare() {
   render::engine->setMaterial(*program, getMaterial());
 }
 
+template <typename Func>
+void VolumeMesh::forEachFaceTriangle(Func&& func) {
+
+  // Cells are processed in parallel ranges. To know where each range's triangles go, first count the faces in every
+  // range, then (with the face indices known) its exterior and interior triangles, and sum over the ranges before it.
+  size_t nChunks = parallelChunkCount(nCells(), connectivityMinChunkSize);
+  std::vector<size_t> chunkFaceStart(nChunks + 1, 0);
+  std::vector<size_t> chunkExteriorStart(nChunks + 1, 0);
+  std::vector<size_t> chunkInteriorStart(nChunks + 1, 0);
+  auto prefixSum = [&](std::vector<size_t>& counts) {
+    for (size_t iChunk = 0; iChunk < nChunks; iChunk++) counts[iChunk + 1] += counts[iChunk];
+  };
+
+  parallelForChunks(nCells(), connectivityMinChunkSize, [&](size_t iCellStart, size_t iCellEnd, size_t iChunk) {
+    size_t nFaces = 0;
+    for (size_t iC = iCellStart; iC < iCellEnd; iC++) nFaces += cellStencil(cellType(iC)).size();
+    chunkFaceStart[iChunk + 1] = nFaces;
+  });
+  prefixSum(chunkFaceStart);
+
+  parallelForChunks(nCells(), connectivityMinChunkSize, [&](size_t iCellStart, size_t iCellEnd, size_t iChunk) {
+    size_t iF = chunkFaceStart[iChunk];
+    size_t nExterior = 0;
+    size_t nInterior = 0;
+    for (size_t iC = iCellStart; iC < iCellEnd; iC++) {
+      for (const std::vector<std::array<size_t, 3>>& face : cellStencil(cellType(iC))) {
+        (faceIsInterior[iF] ? nInterior : nExterior) += face.size();
+        iF++;
+      }
+    }
+    chunkExteriorStart[iChunk + 1] = nExterior;
+    chunkInteriorStart[iChunk + 1] = nInterior;
+  });
+  prefixSum(chunkExteriorStart);
+  prefixSum(chunkInteriorStart);
+
+  parallelForChunks(nCells(), connectivityMinChunkSize, [&](size_t iCellStart, size_t iCellEnd, size_t iChunk) {
+    size_t iF = chunkFaceStart[iChunk];
+    size_t iFront = chunkExteriorStart[iChunk];
+    size_t iBack = nFacesTriangulation() - 1 - chunkInteriorStart[iChunk];
+    for (size_t iC = iCellStart; iC < iCellEnd; iC++) {
+      for (const std::vector<std::array<size_t, 3>>& face : cellStencil(cellType(iC))) {
+        for (size_t j = 0; j < face.size(); j++) {
+          // Exterior faces go at the front of the draw buffer, and interior faces at the back, in reverse
+          // (see note in computeConnectivityData())
+          size_t iData;
+          if (faceIsInterior[iF]) {
+            iData = iBack;
+            iBack--;
+          } else {
+            iData = iFront;
+            iFront++;
+          }
+          func(iC, iF, face, j, iData);
+        }
+        iF++;
+      }
+    }
+  });
+}
+
 void VolumeMesh::preparePick() {
 
   // Create a new program
@@ -525,56 +604,25 @@ void VolumeMesh::preparePick() {
   size_t cellGlobalPickIndStart = pickStart + nVertices();
 
   // == Fill buffers
+  // (in the same order as computeConnectivityData(), exterior faces first)
 
-  std::vector<std::array<glm::vec3, 3>> vertexColors, edgeColors, halfedgeColors, cornerColors;
-  std::vector<glm::vec3> faceColor;
-
-  // Reserve space
-  vertexColors.resize(3 * nFacesTriangulation());
-  edgeColors.resize(3 * nFacesTriangulation());
-  halfedgeColors.resize(3 * nFacesTriangulation());
-  cornerColors.resize(3 * nFacesTriangulation());
-  faceColor.resize(3 * nFacesTriangulation());
+  std::vector<std::array<glm::vec3, 3>> vertexColors(3 * nFacesTriangulation());
+  std::vector<glm::vec3> faceColor(3 * nFacesTriangulation());
 
-  size_t iFront = 0;
-  size_t iBack = nFacesTriangulation() - 1;
-  size_t iF = 0;
-  for (size_t iC = 0; iC < nCells(); iC++) {
+  forEachFaceTriangle([&](size_t iC, size_t iF, const std::vector<std::array<size_t, 3>>& face, size_t j,
+                          size_t iData) {
     const std::array<uint32_t, 8>& cell = cells[iC];
-    VolumeCellType cellT = cellType(iC);
+    const std::array<size_t, 3>& tri = face[j];
 
     glm::vec3 cellColor = pick::indToVec(cellGlobalPickIndStart + iC);
-    std::array<glm::vec3, 3> cellColorArr{cellColor, cellColor, cellColor};
-
-    for (const std::vector<std::array<size_t, 3>>& face : cellStencil(cellT)) {
-
-      // Emit the actual face in the triangulation
-      for (size_t j = 0; j < face.size(); j++) {
-        const std::array<size_t, 3>& tri = face[j];
-
-        std::array<glm::vec3, 3> vColor;
-        for (int k = 0; k < 3; k++) {
-          vColor[k] = pick::indToVec(static_cast<size_t>(cell[tri[k]]) + pickStart);
-        }
-
-        // Push exterior faces to the front of the draw buffer, and interior faces to the back.
-        // (see note above)
-        size_t iData;
-        if (faceIsInterior[iF]) {
-          iData = iBack;
-          iBack--;
-        } else {
-          iData = iFront;
-          iFront++;
-        }
-
-        for (int k = 0; k < 3; k++) faceColor[3 * iData + k] = cellColor;
-        for (int k = 0; k < 3; k++) vertexColors[3 * iData + k] = vColor;
-      }
-
-      iF++;
+    std::array<glm::vec3, 3> vColor;
+    for (int k = 0; k < 3; k++) {
+      vColor[k] = pick::indToVec(static_cast<size_t>(cell[tri[k]]) + pickStart);
     }
-  }
+
+    for (int k = 0; k < 3; k++) faceColor[3 * iData + k] = cellColor;
+    for (int k = 0; k < 3; k++) vertexColors[3 * iData + k] = vColor;
+  });
 
   // === Store data in buffers
 
@@ -625,16 +673,12 @@ void VolumeMesh::fillGeometryBuffers(render::ShaderProgram& p) {
 
   p.setAttribute("a_vertexNormals", faceNormals.getIndexedRenderAttributeBuffer(triangleFaceInds));
 
-  bool wantsBary = p.hasAttribute("a_barycoord");
-  bool wantsEdge = (getEdgeWidth() > 0);
+  bool wantsEdge = p.hasAttribute("a_edgeIsRealMask");
   bool wantsAttrCullPosition = wantsCullPosition();
   bool wantsFaceType = p.hasAttribute("a_faceColorType");
 
-  if (wantsBary) {
-    p.setAttribute("a_barycoord", baryCoord.getRenderAttributeBuffer());
-  }
   if (wantsEdge) {
-    p.setAttribute("a_edgeIsReal", edgeIsReal.getRenderAttributeBuffer());
+    p.setAttribute("a_edgeIsRealMask", edgeIsRealMask.getRenderAttributeBuffer());
   }
   if (wantsAttrCullPosition) {
     p.setAttribute("a_cullPos", cellCenters.getIndexedRenderAttributeBuffer(triangleCellInds));
@@ -663,67 +707,35 @@ void VolumeMesh::computeConnectivityData() {
   triangleCellInds.data.resize(3 * nFacesTriangulation());
   triangleCellInds.data.clear();
   triangleCellInds.data.resize(3 * nFacesTriangulation());
-  baryCoord.data.clear();
-  baryCoord.data.resize(3 * nFacesTriangulation());
-  edgeIsReal.data.clear();
-  edgeIsReal.data.resize(3 * nFacesTriangulation());
+  edgeIsRealMask.data.clear();
+  edgeIsRealMask.data.resize(3 * nFacesTriangulation());
   faceType.data.clear();
   faceType.data.resize(nFaces());
 
-  size_t iF = 0;
-  size_t iFront = 0;
-  size_t iBack = nFacesTriangulation() - 1;
-  for (size_t iC = 0; iC < nCells(); iC++) {
+  forEachFaceTriangle([&](size_t iC, size_t iF, const std::vector<std::array<size_t, 3>>& face, size_t j,
+                          size_t iData) {
     const std::array<uint32_t, 8>& cell = cells[iC];
-    VolumeCellType cellT = cellType(iC);
-
-    // Loop over all faces of the cell
-    for (const std::vector<std::array<size_t, 3>>& face : cellStencil(cellT)) {
-
-      // Loop over the face's triangulation
-      for (size_t j = 0; j < face.size(); j++) {
-        const std::array<size_t, 3>& tri = face[j];
-
-        // Enumerate exterior faces in the front of the draw buffer, and interior faces in the back.
-        // (see note above)
-        size_t iData;
-        if (faceIsInterior[iF]) {
-          iData = iBack;
-          iBack--;
-        } else {
-          iData = iFront;
-          iFront++;
-        }
-
-        for (size_t k = 0; k < 3; k++) {
-          triangleVertexInds.data[3 * iData + k] = cell[tri[k]];
-        }
-        for (size_t k = 0; k < 3; k++) triangleFaceInds.data[3 * iData + k] = iF;
-        for (size_t k = 0; k < 3; k++) triangleCellInds.data[3 * iData + k] = iC;
-
-        baryCoord.data[3 * iData + 0] = glm::vec3{1., 0., 0.};
-        baryCoord.data[3 * iData + 1] = glm::vec3{0., 1., 0.};
-        baryCoord.data[3 * iData + 2] = glm::vec3{0., 0., 1.};
+    const std::array<size_t, 3>& tri = face[j];
 
-        glm::vec3 edgeRealV{0., 1., 0.};
-        if (j == 0) edgeRealV.x = 1.;
-        if (j + 1 == face.size()) edgeRealV.z = 1.;
-        for (int k = 0; k < 3; k++) edgeIsReal.data[3 * iData + k] = edgeRealV;
-      }
+    for (size_t k = 0; k < 3; k++) {
+      triangleVertexInds.data[3 * iData + k] = cell[tri[k]];
+    }
+    for (size_t k = 0; k < 3; k++) triangleFaceInds.data[3 * iData + k] = iF;
+    for (size_t k = 0; k < 3; k++) triangleCellInds.data[3 * iData + k] = iC;
 
-      float faceTypeFloat = faceIsInterior[iF] ? 1. : 0.;
-      for (int k = 0; k < 3; k++) faceType.data[iF] = faceTypeFloat;
+    uint32_t edgeRealBits = 2;
+    if (j == 0) edgeRealBits |= 1;
+    if (j + 1 == face.size()) edgeRealBits |= 4;
+    for (int k = 0; k < 3; k++) edgeIsRealMask.data[3 * iData + k] = static_cast<float>(edgeRealBits);
 
-      iF++;
-    }
-  }
+    if (j == 0) faceType.data[iF] = faceIsInterior[iF] ? 1. : 0.;
+  });
 
   triangleVertexInds.markHostBufferUpdated();
   triangleFaceInds.markHostBufferUpdated();
   triangleCellInds.markHostBufferUpdated();
   triangleCellInds.markHostBufferUpdated();
-  baryCoord.markHostBufferUpdated();
-  edgeIsReal.markHostBufferUpdated();
+  edgeIsRealMask.markHostBufferUpdated();
   faceType.markHostBufferUpdated();
 }
 
@@ -798,6 +810,43 @@ void VolumeMesh::computeCellCenters() {
   cellCenters.markHostBufferUpdated();
 }
 
+bool VolumeMesh::queryRay(glm::vec3 rayOrigin, glm::vec3 rayDir, bool waitForBuild, RayHit& hitOut) {
+
+  // Rebuild the acceleration structure if the geometry changed. Only exterior faces can be hit (they come first in the
+  // triangle buffers), the ray stops at the boundary of the mesh.
+  vertexPositions.ensureHostBufferPopulated();
+  triangleVertexInds.ensureHostBufferPopulated();
+  triangleFaceInds.ensureHostBufferPopulated();
+  triangleCellInds.ensureHostBufferPopulated();
+  std::vector<uint64_t> key{vertexPositions.getDataVersion(), triangleVertexInds.getDataVersion()};
+  if (!rayQueryAccel.isCurrent(key)) {
+    RayQueryGeometry geom;
+    geom.positions = vertexPositions.data;
+    size_t nTri = triangleVertexInds.data.size() / 3;
+    for (size_t iT = 0; iT < nTri && !faceIsInterior[triangleFaceInds.data[3 * iT]]; iT++) {
+      geom.triangles.push_back(std::array<uint32_t, 3>{triangleVertexInds.data[3 * iT + 0],
+                                                        triangleVertexInds.data[3 * iT + 1],
+                                                        triangleVertexInds.data[3 * iT + 2]});
+    }
+    rayQueryAccel.setGeometry(std::move(geom), key);
+  }
+
+  RayQueryAccel::Hit primHit;
+  if (!queryRayAccel(rayOrigin, rayDir, waitForBuild, primHit, hitOut)) return false;
+
+  // Like the pick buffer, report a vertex for hits close to a corner, and otherwise the cell. Cells come after
+  // vertices in the pick indexing.
+  const float vertRadius = 0.2;
+  for (int j = 0; j < 3; j++) {
+    if (primHit.bary[j] > 1.f - vertRadius) {
+      hitOut.localIndex = triangleVertexInds.data[3 * primHit.index + j];
+      return true;
+    }
+  }
+  hitOut.localIndex = nVertices() + triangleCellInds.data[3 * primHit.index];
+  return true;
+}
+
 void VolumeMesh::buildPickUI(size_t localPickID) {
 
   // Selection type
@@ -937,6 +986,12 @@ void VolumeMesh::recomputeGeometryIfPopulated() {
   cellCenters.recomputeIfPopulated();
 }
 
+void VolumeMesh::sharedBufferUpdated(const std::string& bufferName) {
+  if (bufferName == vertexPositions.name) {
+    geometryChanged();
+  }
+}
+
 VolumeCellType VolumeMesh::cellType(size_t i) const {
   bool isHex = cells[i][4] < INVALID_IND_32;
   if (isHex) {
@@ -950,22 +1005,7 @@ void VolumeMesh::updateObjectSpaceBounds() {
 
   vertexPositions.ensureHostBufferPopulated();
 
-  // bounding box
-  glm::vec3 min = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
-  glm::vec3 max = -glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
-  for (const glm::vec3& p : vertexPositions.data) {
-    min = componentwiseMin(min, p);
-    max = componentwiseMax(max, p);
-  }
-  objectSpaceBoundingBox = std::make_tuple(min, max);
-
-  // length scale, as twice the radius from the center of the bounding box
-  glm::vec3 center = 0.5f * (min + max);
-  float lengthScale = 0.0;
-  for (const glm::vec3& p : vertexPositions.data) {
-    lengthScale = std::max(lengthScale, glm::length2(p - center));
-  }
-  objectSpaceLengthScale = 2 * std::sqrt(lengthScale);
+  computeBoundingBoxAndLengthScale(vertexPositions.data, objectSpaceBoundingBox, objectSpaceLengthScale);
 }
 
 std::string VolumeMesh::typeName() { return structureTypeName; }
@@ -13,6 +13,7 @@
 #include "polyscope/pick.h"
 #include "polyscope/point_cloud.h"
 #include "polyscope/polyscope.h"
+#include "polyscope/reductions.h"
 #include "polyscope/simple_triangle_mesh.h"
 #include "polyscope/surface_mesh.h"
 #include "polyscope/types.h"
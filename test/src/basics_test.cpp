@@ -3,6 +3,7 @@
 #include "polyscope_test.h"
 
 #include "polyscope/curve_network.h"
+#include "polyscope/frame_pacer.h"
 #include "polyscope/pick.h"
 #include "polyscope/point_cloud.h"
 #include "polyscope/polyscope.h"
@@ -33,6 +34,48 @@ TEST_F(PolyscopeTest, FrameTick) {
   }
 }
 
+TEST_F(PolyscopeTest, FramePacerRefreshesPerFrame) {
+  EXPECT_EQ(polyscope::frame_pacer::refreshesPerFrame(60., 60.), 1u);
+  EXPECT_EQ(polyscope::frame_pacer::refreshesPerFrame(60., 120.), 2u);
+  EXPECT_EQ(polyscope::frame_pacer::refreshesPerFrame(60., 144.), 3u); // 2 refreshes would be 72 fps
+  EXPECT_EQ(polyscope::frame_pacer::refreshesPerFrame(30., 59.94), 2u);
+  EXPECT_EQ(polyscope::frame_pacer::refreshesPerFrame(120., 60.), 1u);
+}
+
+TEST_F(PolyscopeTest, FrameTickPaced) {
+  int oldMaxFPS = polyscope::options::maxFPS;
+  polyscope::options::maxFPS = 50;
+  polyscope::options::paceFrameTick = true;
+
+  int idleCalls = 0;
+  size_t idleID = polyscope::frame_pacer::addIdleCallback([&](double secondsAvailable) {
+    EXPECT_GT(secondsAvailable, 0.);
+    idleCalls++;
+    return false;
+  });
+
+  polyscope::frameTick();
+  polyscope::frame_pacer::resetFrameStats();
+  for (int i = 0; i < 5; i++) {
+    polyscope::frameTick();
+  }
+
+  polyscope::frame_pacer::FrameStats stats = polyscope::frame_pacer::getFrameStats();
+  EXPECT_EQ(stats.nFrames, 5u);
+  EXPECT_GE(stats.averageFrameSeconds, 0.9 * 0.95 / 50.);
+  EXPECT_GE(stats.maxFrameSeconds, stats.lastFrameSeconds);
+  EXPECT_GT(idleCalls, 0);
+
+  // removed callbacks are no longer called
+  polyscope::frame_pacer::removeIdleCallback(idleID);
+  int idleCallsBefore = idleCalls;
+  polyscope::frameTick();
+  EXPECT_EQ(idleCalls, idleCallsBefore);
+
+  polyscope::options::paceFrameTick = false;
+  polyscope::options::maxFPS = oldMaxFPS;
+}
+
 TEST_F(PolyscopeTest, FrameTickWithImgui) {
 
   auto showCallback = [&]() { ImGui::Button("do something"); };
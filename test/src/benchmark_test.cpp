@@ -0,0 +1,228 @@
+// Copyright 2017-2023, Nicholas Sharp and the Polyscope contributors. https://polyscope.run
+
+#include "polyscope_test.h"
+
+#include "polyscope/benchmark.h"
+#include "polyscope/scene_statistics.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ============================================================
+// =============== Microbenchmarks
+// ============================================================
+
+// These are disabled by default, since they are slow and only report timings. Run them with
+//   ./bin/polyscope-test --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+// (ideally in a release build).
+
+namespace {
+
+// Run func() several times, and print the best wall-clock time
+void reportBenchmark(std::string name, size_t nTrials, std::function<void()> func) {
+  double bestMs = std::numeric_limits<double>::infinity();
+  for (size_t iTrial = 0; iTrial < nTrials; iTrial++) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    bestMs = std::min(bestMs, std::chrono::duration<double, std::milli>(end - start).count());
+  }
+  std::cout << "[benchmark] " << name << ": " << bestMs << " ms" << std::endl;
+}
+
+std::vector<glm::vec3> randomPoints(size_t n) {
+  std::vector<glm::vec3> points(n);
+  for (size_t i = 0; i < n; i++) {
+    points[i] = glm::vec3{polyscope::randomUnit(), polyscope::randomUnit(), polyscope::randomUnit()};
+  }
+  return points;
+}
+
+} // namespace
+
+TEST_F(PolyscopeTest, DISABLED_BenchmarkBoundsReductions) {
+  const size_t N = 20000000;
+  std::vector<glm::vec3> points = randomPoints(N);
+  size_t nTrials = 5;
+
+  // Baseline: the simple loops that the structures used previously
+  float sink = 0.;
+  reportBenchmark("bounding box + length scale, simple loop (20M)", nTrials, [&]() {
+    glm::vec3 min = glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
+    glm::vec3 max = -glm::vec3{1, 1, 1} * std::numeric_limits<float>::infinity();
+    for (const glm::vec3& p : points) {
+      min = polyscope::componentwiseMin(min, p);
+      max = polyscope::componentwiseMax(max, p);
+    }
+    glm::vec3 center = 0.5f * (min + max);
+    float lengthScale = 0.0;
+    for (const glm::vec3& p : points) {
+      lengthScale = std::max(lengthScale, glm::length2(p - center));
+    }
+    sink += lengthScale;
+  });
+
+  int oldMaxThreads = polyscope::options::maxWorkerThreads;
+
+  polyscope::options::maxWorkerThreads = 1;
+  reportBenchmark("bounding box + length scale, SIMD single thread (20M)", nTrials, [&]() {
+    std::tuple<glm::vec3, glm::vec3> bbox;
+    float lengthScale;
+    polyscope::computeBoundingBoxAndLengthScale(points, bbox, lengthScale);
+    sink += lengthScale;
+  });
+
+  polyscope::options::maxWorkerThreads = -1;
+  reportBenchmark("bounding box + length scale, SIMD all threads (20M)", nTrials, [&]() {
+    std::tuple<glm::vec3, glm::vec3> bbox;
+    float lengthScale;
+    polyscope::computeBoundingBoxAndLengthScale(points, bbox, lengthScale);
+    sink += lengthScale;
+  });
+
+  reportBenchmark("max vector norm, simple loop (20M)", nTrials, [&]() {
+    float maxLength = 0.;
+    for (const glm::vec3& vec : points) {
+      maxLength = std::max(maxLength, glm::length(vec));
+    }
+    sink += maxLength;
+  });
+
+  reportBenchmark("max vector norm, SIMD all threads (20M)", nTrials,
+                  [&]() { sink += polyscope::computeMaxNorm(points); });
+
+  polyscope::options::maxWorkerThreads = oldMaxThreads;
+  EXPECT_GT(sink, 0.);
+}
+
+TEST_F(PolyscopeTest, DISABLED_BenchmarkRegisterPointCloud) {
+  const size_t N = 5000000;
+  std::vector<glm::vec3> points = randomPoints(N);
+
+  reportBenchmark("register point cloud (5M)", 3, [&]() { polyscope::registerPointCloud("bench points", points); });
+  reportBenchmark("update point cloud positions (5M)", 3, [&]() {
+    polyscope::getPointCloud("bench points")->updatePointPositions(points);
+  });
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, DISABLED_BenchmarkImpostorDepthPrepass) {
+  // A dense cloud of large spheres, with many layers of overdraw at each pixel. Only meaningful with a real rendering
+  // backend, e.g. run with backend=openGL3_glfw
+  const size_t N = 2000000;
+  std::vector<glm::vec3> points = randomPoints(N);
+  polyscope::PointCloud* psPoints = polyscope::registerPointCloud("bench points", points);
+  psPoints->setPointRenderMode(polyscope::PointRenderMode::Sphere);
+  psPoints->setPointRadius(0.01);
+  polyscope::show(3); // (creates the programs and buffers)
+
+  psPoints->setDepthPrepass(false);
+  reportBenchmark("dense sphere point cloud, 20 frames (2M)", 3, [&]() { polyscope::show(20); });
+
+  psPoints->setDepthPrepass(true);
+  polyscope::show(3);
+  reportBenchmark("dense sphere point cloud with depth pre-pass, 20 frames (2M)", 3, [&]() { polyscope::show(20); });
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, DISABLED_BenchmarkCameraPathReplay) {
+  // Orbit a large point cloud, and write the full report. Only meaningful with a real rendering backend, e.g. run with
+  // backend=openGL3_glfw or backend=openGL3_egl
+  const size_t N = 2000000;
+  std::vector<glm::vec3> points = randomPoints(N);
+  polyscope::registerPointCloud("bench points", points);
+
+  polyscope::benchmark::CameraPath path = polyscope::benchmark::CameraPath::orbitAroundScene();
+  polyscope::benchmark::ReplayResult result = polyscope::benchmark::replayCameraPath(path, 120);
+  polyscope::benchmark::writeReplayReport(result, "camera_path_benchmark.json");
+
+  std::cout << "[benchmark] camera path replay, 120 frames (2M): median " << result.frameTime.medianMs << " ms, p99 "
+            << result.frameTime.p99Ms << " ms" << std::endl;
+  for (const std::pair<std::string, polyscope::benchmark::TimingSummary>& pass : result.passes) {
+    std::cout << "[benchmark]   " << pass.first << ": median " << pass.second.medianMs << " ms" << std::endl;
+  }
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, DISABLED_BenchmarkVolumeMeshPreparation) {
+  // A grid of hexes, which computeTets() splits into 5 or 6 tets each
+  const size_t n = 80;
+  std::vector<glm::vec3> verts;
+  for (size_t k = 0; k <= n; k++) {
+    for (size_t j = 0; j <= n; j++) {
+      for (size_t i = 0; i <= n; i++) {
+        verts.push_back(glm::vec3{i, j, k} / static_cast<float>(n));
+      }
+    }
+  }
+  auto vInd = [&](size_t i, size_t j, size_t k) { return static_cast<uint32_t>((k * (n + 1) + j) * (n + 1) + i); };
+  std::vector<std::array<uint32_t, 8>> cells;
+  for (size_t k = 0; k < n; k++) {
+    for (size_t j = 0; j < n; j++) {
+      for (size_t i = 0; i < n; i++) {
+        cells.push_back({vInd(i, j, k), vInd(i + 1, j, k), vInd(i + 1, j + 1, k), vInd(i, j + 1, k),
+                         vInd(i, j, k + 1), vInd(i + 1, j, k + 1), vInd(i + 1, j + 1, k + 1), vInd(i, j + 1, k + 1)});
+      }
+    }
+  }
+
+  polyscope::VolumeMesh* mesh = nullptr;
+  reportBenchmark("register volume mesh (512k hexes)", 3, [&]() {
+    mesh = polyscope::registerHexMesh("bench hexes", verts, cells);
+  });
+
+  int oldMaxThreads = polyscope::options::maxWorkerThreads;
+  for (int maxThreads : {1, -1}) {
+    polyscope::options::maxWorkerThreads = maxThreads;
+    std::string threads = maxThreads == 1 ? "single thread" : "all threads";
+    reportBenchmark("volume mesh connectivity, " + threads + " (512k hexes)", 3,
+                    [&]() { mesh->computeConnectivityData(); });
+    reportBenchmark("volume mesh tets, " + threads + " (512k hexes)", 3, [&]() { mesh->computeTets(); });
+    reportBenchmark("volume mesh pick buffers, " + threads + " (512k hexes)", 3, [&]() {
+      mesh->refresh();
+      mesh->drawPick();
+    });
+  }
+  polyscope::options::maxWorkerThreads = oldMaxThreads;
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, DISABLED_BenchmarkSceneStatistics) {
+  // 8 point clouds of 1M points, each with a scalar quantity
+  const size_t nClouds = 8;
+  const size_t n = 1000000;
+  std::vector<glm::vec3> points = randomPoints(n);
+  std::vector<float> vals(n);
+  for (size_t i = 0; i < n; i++) vals[i] = polyscope::randomReal(-1., 1.);
+  for (size_t iCloud = 0; iCloud < nClouds; iCloud++) {
+    polyscope::PointCloud* cloud = polyscope::registerPointCloud("bench cloud " + std::to_string(iCloud), points);
+    cloud->addScalarQuantity("vals", vals);
+  }
+
+  polyscope::scene_statistics::ScalarStatisticsQuery query;
+  query.percentiles = {1., 50., 99.};
+  query.thresholds = {0.5};
+
+  int oldMaxThreads = polyscope::options::maxWorkerThreads;
+  for (int maxThreads : {1, -1}) {
+    polyscope::options::maxWorkerThreads = maxThreads;
+    std::string threads = maxThreads == 1 ? "single thread" : "all threads";
+    reportBenchmark("scene statistics, first query, " + threads + " (8M values)", 3, [&]() {
+      polyscope::scene_statistics::clearCache();
+      polyscope::scene_statistics::computeScalarStatistics(query);
+    });
+  }
+  polyscope::options::maxWorkerThreads = oldMaxThreads;
+  reportBenchmark("scene statistics, cached query (8M values)", 10,
+                  [&]() { polyscope::scene_statistics::computeScalarStatistics(query); });
+
+  polyscope::scene_statistics::clearCache();
+  polyscope::removeAllStructures();
+}
@@ -26,6 +26,14 @@ TEST_F(PolyscopeTest, CurveNetworkAppearance) {
   EXPECT_EQ(psCurve->getMaterial(), "wax");
   polyscope::show(3);
 
+  // Depth pre-pass for the nodes, also with a quantity doing the shading
+  psCurve->setDepthPrepass(true);
+  EXPECT_TRUE(psCurve->getDepthPrepass());
+  polyscope::show(3);
+  std::vector<glm::vec3> vColors(psCurve->nNodes(), glm::vec3{.2, .3, .4});
+  psCurve->addNodeColorQuantity("vcolor", vColors)->setEnabled(true);
+  polyscope::show(3);
+
   polyscope::removeAllStructures();
 }
 
@@ -106,6 +114,109 @@ TEST_F(PolyscopeTest, CurveNetworkScalarRadius) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, CurveNetworkElementMask) {
+  auto psCurve = registerCurveNetwork();
+  psCurve->setNodeMask({0, 1}, polyscope::ElementMaskMode::Highlight);
+  psCurve->setEdgeMask({0}, polyscope::ElementMaskMode::Outline);
+  polyscope::show(3);
+
+  psCurve->setEdgeMask({1}, polyscope::ElementMaskMode::Hide);
+  psCurve->clearNodeMask();
+  polyscope::show(3);
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, CurveNetworkLevelOfDetail) {
+  // A finely sampled helix, plus a straight branch off its middle
+  std::vector<glm::vec3> nodes;
+  std::vector<std::array<size_t, 2>> edges;
+  size_t nHelix = 2000;
+  for (size_t i = 0; i < nHelix; i++) {
+    float t = 0.01f * i;
+    nodes.push_back(glm::vec3{std::cos(t), std::sin(t), 0.02f * t});
+    if (i > 0) edges.push_back({i - 1, i});
+  }
+  size_t branchRoot = nHelix / 2;
+  glm::vec3 branchDir{nodes[branchRoot].x, nodes[branchRoot].y, 0.};
+  for (size_t i = 0; i < 10; i++) {
+    nodes.push_back(nodes[branchRoot] + 0.1f * (i + 1) * branchDir);
+    edges.push_back({i == 0 ? branchRoot : nodes.size() - 2, nodes.size() - 1});
+  }
+
+  // The hierarchy itself
+  std::vector<uint32_t> tails, tips;
+  for (const std::array<size_t, 2>& e : edges) {
+    tails.push_back(e[0]);
+    tips.push_back(e[1]);
+  }
+  polyscope::CurveNetworkLOD lod;
+  lod.build(nodes, tails, tips, 7);
+  EXPECT_TRUE(lod.isCurrent(7));
+  EXPECT_FALSE(lod.isCurrent(8));
+  ASSERT_GT(lod.nLevels(), 2u);
+  EXPECT_EQ(lod.levelForError(0.), 0u);
+  EXPECT_EQ(lod.levelForError(1e6), lod.nLevels() - 1);
+  for (size_t iLevel = 1; iLevel < lod.nLevels(); iLevel++) {
+    const polyscope::CurveNetworkLOD::Level& level = lod.getLevel(iLevel);
+    size_t prevEdges = iLevel == 1 ? edges.size() : lod.getLevel(iLevel - 1).edgeTailInds.size();
+    EXPECT_LT(level.edgeTailInds.size(), prevEdges);
+    EXPECT_EQ(level.edgeTipInds.size(), level.edgeTailInds.size());
+    EXPECT_EQ(level.edgeInds.size(), level.edgeTailInds.size());
+  }
+  // the straight branch needs a single edge, and the spheres along it are hidden by its edges
+  const polyscope::CurveNetworkLOD::Level& coarsest = lod.getLevel(lod.nLevels() - 1);
+  EXPECT_NE(std::find(coarsest.edgeTailInds.begin(), coarsest.edgeTailInds.end(), branchRoot),
+            coarsest.edgeTailInds.end());
+  EXPECT_NE(std::find(coarsest.edgeTipInds.begin(), coarsest.edgeTipInds.end(), nodes.size() - 1),
+            coarsest.edgeTipInds.end());
+  const std::vector<uint32_t>& fullNodes = lod.getLevel(0).nodeInds;
+  EXPECT_EQ(std::find(fullNodes.begin(), fullNodes.end(), nHelix + 4), fullNodes.end());
+  EXPECT_NE(std::find(fullNodes.begin(), fullNodes.end(), nodes.size() - 1), fullNodes.end());
+
+  // Drawing with it, from near and far, with quantities
+  size_t oldMinEdges = polyscope::options::curveNetworkLODMinEdges;
+  polyscope::options::curveNetworkLODMinEdges = 0;
+  auto psCurve = polyscope::registerCurveNetwork("lod", nodes, edges);
+  EXPECT_TRUE(psCurve->usesLevelOfDetail());
+  std::vector<double> nodeVals(psCurve->nNodes(), 0.5);
+  std::vector<double> edgeVals(psCurve->nEdges(), 0.5);
+  psCurve->addNodeScalarQuantity("nodeVals", nodeVals)->setEnabled(true);
+  polyscope::show(3); // (starts building the levels in the background)
+  EXPECT_TRUE(psCurve->isLevelOfDetailReady(true));
+  psCurve->addEdgeScalarQuantity("edgeVals", edgeVals)->setEnabled(true);
+  polyscope::view::lookAt(glm::vec3{0., 0., 1000.}, glm::vec3{0., 0., 0.});
+  polyscope::show(3);
+  size_t farLevel = psCurve->getCurrentLODLevel();
+  EXPECT_GT(farLevel, 0u);
+  polyscope::view::lookAt(glm::vec3{0., 0., 3.}, glm::vec3{0., 0., 0.});
+  polyscope::show(3);
+  EXPECT_LT(psCurve->getCurrentLODLevel(), farLevel);
+
+  // New positions are simplified again in the background, drawing with the old levels meanwhile
+  for (glm::vec3& p : nodes) p *= 2.f;
+  psCurve->updateNodePositions(nodes);
+  polyscope::show(3);
+  EXPECT_TRUE(psCurve->isLevelOfDetailReady(true));
+  polyscope::show(3);
+
+  // Element masks use full detail
+  psCurve->setEdgeMask({0}, polyscope::ElementMaskMode::Highlight);
+  EXPECT_FALSE(psCurve->usesLevelOfDetail());
+  polyscope::show(3);
+  EXPECT_EQ(psCurve->getCurrentLODLevel(), 0u);
+  psCurve->clearEdgeMask();
+
+  psCurve->setLevelOfDetail(false);
+  EXPECT_FALSE(psCurve->usesLevelOfDetail());
+  polyscope::show(3);
+  EXPECT_EQ(psCurve->getCurrentLODLevel(), 0u);
+
+  polyscope::options::curveNetworkLODMinEdges = oldMinEdges;
+  polyscope::view::resetCameraToHomeView();
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, CurveNetworkVertexVector) {
   auto psCurve = registerCurveNetwork();
   std::vector<glm::vec3> vals(psCurve->nNodes(), {1., 2., 3.});
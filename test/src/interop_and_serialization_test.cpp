@@ -33,3 +33,54 @@ TEST_F(PolyscopeTest, ManagedBufferAccess) {
 
   polyscope::removeAllStructures();
 }
+
+TEST_F(PolyscopeTest, ManagedBufferExternalStorage) {
+
+  // register point cloud
+  auto psPoints = registerPointCloud("test_cloud1");
+  size_t nPts = psPoints->nPoints();
+  polyscope::show(3);
+
+  // drive the positions from a (fake, in the mock backend) external device buffer
+  polyscope::render::ManagedBuffer<glm::vec3>& bufferPos = psPoints->getManagedBuffer<glm::vec3>("points");
+  bufferPos.setExternalRenderAttributeBuffer(7, nPts);
+  EXPECT_EQ(bufferPos.size(), nPts);
+  polyscope::show(3);
+
+  // host values get read back from the device on demand
+  bufferPos.getValue(0);
+  EXPECT_EQ(bufferPos.getPopulatedHostBufferRef().size(), nPts);
+  polyscope::show(3);
+
+  // indexed views of device-only data are gathered from the device values
+  polyscope::SurfaceMesh* psMesh = registerTriangleMesh();
+  polyscope::show(3);
+  polyscope::render::ManagedBuffer<glm::vec3>& meshPos = psMesh->vertexPositions;
+  meshPos.setExternalRenderAttributeBuffer(9, psMesh->nVertices());
+  std::vector<glm::vec3> devicePos(psMesh->nVertices());
+  for (size_t i = 0; i < devicePos.size(); i++) devicePos[i] = glm::vec3{i, 2. * i, -1.};
+  meshPos.getRenderAttributeBuffer()->setData(devicePos);
+  meshPos.markRenderAttributeBufferUpdated();
+  polyscope::render::ManagedBuffer<uint32_t>& inds = psMesh->triangleVertexInds;
+  std::shared_ptr<polyscope::render::AttributeBuffer> view = meshPos.getIndexedRenderAttributeBuffer(inds);
+  const std::vector<uint32_t>& indsData = inds.getPopulatedHostBufferRef();
+  std::vector<glm::vec3> gathered = view->getDataRange_vec3(0, indsData.size());
+  ASSERT_EQ(gathered.size(), indsData.size());
+  for (size_t i = 0; i < indsData.size(); i++) {
+    EXPECT_EQ(gathered[i], devicePos[indsData[i]]);
+  }
+  polyscope::show(3);
+
+  // same for a texture
+  size_t dimX = 300;
+  size_t dimY = 200;
+  std::vector<std::array<float, 3>> valsRGB(dimX * dimY, std::array<float, 3>{0.44, 0.55, 0.66});
+  polyscope::ColorImageQuantity* im =
+      polyscope::addColorImageQuantity("im color", dimX, dimY, valsRGB, polyscope::ImageOrigin::UpperLeft);
+  im->setEnabled(true);
+  polyscope::render::ManagedBuffer<glm::vec4>& bufferColor = im->getManagedBuffer<glm::vec4>("colors");
+  bufferColor.setExternalRenderTextureBuffer(8);
+  polyscope::show(3);
+
+  polyscope::removeAllStructures();
+}
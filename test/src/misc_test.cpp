@@ -2,6 +2,21 @@
 
 #include "polyscope_test.h"
 
+#include "polyscope/affine_remapper.h"
+#include "polyscope/benchmark.h"
+#include "polyscope/histogram.h"
+#include "polyscope/region_selection.h"
+#include "polyscope/scene_statistics.h"
+
+#include <cstdio>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
 // ============================================================
 // =============== Scalar Quantity Tests
 // ============================================================
@@ -41,3 +56,400 @@ TEST_F(PolyscopeTest, FlatMaterialTest) {
 
   polyscope::removeAllStructures();
 }
+
+// ============================================================
+// =============== Reductions tests
+// ============================================================
+
+TEST_F(PolyscopeTest, ReductionsMatchSimpleLoops) {
+
+  // enough entries to exercise the SIMD loops, their remainders, and several worker chunks
+  for (size_t n : {0, 1, 5, 8, 1000, 1000003}) {
+    std::vector<glm::vec3> points(n);
+    std::vector<glm::vec2> vecs2(n);
+    for (size_t i = 0; i < n; i++) {
+      points[i] =
+          glm::vec3{polyscope::randomReal(-3., 2.), polyscope::randomReal(-1., 4.), polyscope::randomReal(0., 1.)};
+      vecs2[i] = glm::vec2{polyscope::randomReal(-1., 1.), polyscope::randomReal(-1., 1.)};
+    }
+    // NaNs should be ignored, both in the SIMD loops and in their scalar remainders
+    if (n > 5) points[3].y = std::numeric_limits<float>::quiet_NaN();
+    if (n >= 5 && n % 4 != 0) {
+      points[n - 1].x = std::numeric_limits<float>::quiet_NaN();
+      vecs2[n - 1].y = std::numeric_limits<float>::quiet_NaN();
+    }
+
+    glm::vec3 expectMin{std::numeric_limits<float>::infinity()};
+    glm::vec3 expectMax{-std::numeric_limits<float>::infinity()};
+    for (const glm::vec3& p : points) {
+      expectMin = polyscope::componentwiseMin(expectMin, p);
+      expectMax = polyscope::componentwiseMax(expectMax, p);
+    }
+    glm::vec3 center{0.5, 1., -2.};
+    float expectDist = 0.;
+    float expectNorm2 = 0.;
+    for (const glm::vec3& p : points) expectDist = std::max(expectDist, glm::length(p - center));
+    for (const glm::vec2& v : vecs2) expectNorm2 = std::max(expectNorm2, glm::length(v));
+
+    std::tuple<glm::vec3, glm::vec3> bbox = polyscope::computeBoundingBox(points);
+    EXPECT_EQ(std::get<0>(bbox), expectMin);
+    EXPECT_EQ(std::get<1>(bbox), expectMax);
+    EXPECT_NEAR(polyscope::computeMaxDistance(points, center), expectDist, 1e-5);
+    EXPECT_NEAR(polyscope::computeMaxNorm(vecs2), expectNorm2, 1e-5);
+  }
+}
+
+// ============================================================
+// =============== Compute tier tests
+// ============================================================
+
+namespace {
+
+// The gathered per-corner positions of a mesh should match gathering them on the host
+void checkMeshCornerPositions(polyscope::SurfaceMesh* psMesh) {
+  polyscope::render::ManagedBuffer<uint32_t>& inds = psMesh->triangleVertexInds;
+  std::shared_ptr<polyscope::render::AttributeBuffer> view =
+      psMesh->vertexPositions.getIndexedRenderAttributeBuffer(inds);
+  const std::vector<uint32_t>& indsData = inds.getPopulatedHostBufferRef();
+  std::vector<glm::vec3> gathered = view->getDataRange_vec3(0, indsData.size());
+  for (size_t i = 0; i < indsData.size(); i++) {
+    EXPECT_EQ(gathered[i], psMesh->vertexPositions.getPopulatedHostBufferRef()[indsData[i]]);
+  }
+}
+
+} // namespace
+
+// The device results should match the host versions (skipped if the backend has no compute tier)
+TEST_F(PolyscopeTest, ComputeTierMatchesHost) {
+  polyscope::render::Engine& engine = *polyscope::render::engine;
+  if (!engine.computeTierAvailable()) GTEST_SKIP() << "the render backend has no compute tier";
+
+  size_t n = 100003;
+  std::vector<float> values(n);
+  for (size_t i = 0; i < n; i++) values[i] = polyscope::randomReal(-2., 5.);
+  values[3] = std::numeric_limits<float>::quiet_NaN();  // skipped by both
+  values[10] = std::numeric_limits<float>::infinity(); // counted in the last bin, but not in the range
+  std::shared_ptr<polyscope::render::AttributeBuffer> buffer =
+      engine.generateAttributeBuffer(polyscope::RenderDataType::Float);
+  buffer->setData(values);
+
+  float minVal, maxVal;
+  ASSERT_TRUE(engine.computeRange(*buffer, minVal, maxVal));
+  std::pair<float, float> hostRange = polyscope::computeFiniteRange(values);
+  EXPECT_EQ(minVal, hostRange.first);
+  EXPECT_EQ(maxVal, hostRange.second);
+
+  // (the device bins in float, so a value right on a bin edge could land on the other side)
+  size_t nBins = 51;
+  std::vector<uint32_t> counts;
+  ASSERT_TRUE(engine.computeHistogram(*buffer, minVal, maxVal, nBins, counts));
+  std::vector<double> hostCounts = polyscope::computeHistogramCounts(values, minVal, maxVal, nBins);
+  ASSERT_EQ(counts.size(), nBins);
+  double total = 0.;
+  for (size_t iBin = 0; iBin < nBins; iBin++) {
+    EXPECT_NEAR(counts[iBin], hostCounts[iBin], 2.);
+    total += counts[iBin];
+  }
+  EXPECT_EQ(total, n - 1);
+
+  std::vector<glm::vec3> source(1000);
+  for (glm::vec3& p : source) p = glm::vec3{polyscope::randomUnit(), polyscope::randomUnit(), polyscope::randomUnit()};
+  std::vector<uint32_t> inds(5000);
+  for (uint32_t& i : inds) i = polyscope::randomInt(0, static_cast<int>(source.size()) - 1);
+  std::shared_ptr<polyscope::render::AttributeBuffer> sourceBuffer =
+      engine.generateAttributeBuffer(polyscope::RenderDataType::Vector3Float);
+  std::shared_ptr<polyscope::render::AttributeBuffer> indsBuffer =
+      engine.generateAttributeBuffer(polyscope::RenderDataType::UInt);
+  std::shared_ptr<polyscope::render::AttributeBuffer> targetBuffer =
+      engine.generateAttributeBuffer(polyscope::RenderDataType::Vector3Float);
+  inds.back() = static_cast<uint32_t>(source.size()); // out of range, gathers zeros
+  sourceBuffer->setData(source);
+  indsBuffer->setData(inds);
+  ASSERT_TRUE(engine.computeGather(*sourceBuffer, *indsBuffer, *targetBuffer));
+  ASSERT_EQ(targetBuffer->getDataSize(), static_cast<int64_t>(inds.size()));
+  std::vector<glm::vec3> gathered = targetBuffer->getDataRange_vec3(0, inds.size());
+  for (size_t i = 0; i + 1 < inds.size(); i++) {
+    EXPECT_EQ(gathered[i], source[inds[i]]);
+  }
+  EXPECT_EQ(gathered.back(), glm::vec3(0.));
+
+  // The same through the users of the compute tier
+  polyscope::SurfaceMesh* psMesh = registerTriangleMesh();
+  std::vector<double> vScalar(psMesh->nVertices());
+  for (double& v : vScalar) v = polyscope::randomReal(-1., 3.);
+  polyscope::SurfaceVertexScalarQuantity* q = psMesh->addVertexScalarQuantity("vScalar", vScalar);
+  q->setEnabled(true);
+  polyscope::show(3); // (creates the device buffers)
+  polyscope::Histogram deviceHist, hostHist;
+  deviceHist.buildHistogram(q->values);
+  hostHist.buildHistogram(q->values.getPopulatedHostBufferRef());
+  EXPECT_EQ(deviceHist.getDataRange(), hostHist.getDataRange());
+  q->setRangeUpdate(polyscope::ScalarRangeUpdate::Fit);
+  for (double& v : vScalar) v = polyscope::randomReal(-4., 6.);
+  q->updateData(vScalar); // (the range is reduced on the device)
+  std::pair<float, float> updatedRange = polyscope::computeFiniteRange(q->values.getPopulatedHostBufferRef());
+  EXPECT_EQ(q->getDataRange(), polyscope::robustifyMinMax<double>(updatedRange.first, updatedRange.second, 1e-5));
+  checkMeshCornerPositions(psMesh);
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, ComputeTierFallback) {
+  polyscope::options::enableComputeTier = false;
+  polyscope::render::Engine& engine = *polyscope::render::engine;
+  EXPECT_FALSE(engine.computeTierAvailable());
+
+  std::vector<float> values = {1., 2., 3.};
+  std::vector<uint32_t> inds = {2, 0};
+  std::shared_ptr<polyscope::render::AttributeBuffer> buffer =
+      engine.generateAttributeBuffer(polyscope::RenderDataType::Float);
+  std::shared_ptr<polyscope::render::AttributeBuffer> indsBuffer =
+      engine.generateAttributeBuffer(polyscope::RenderDataType::UInt);
+  std::shared_ptr<polyscope::render::AttributeBuffer> targetBuffer =
+      engine.generateAttributeBuffer(polyscope::RenderDataType::Float);
+  buffer->setData(values);
+  indsBuffer->setData(inds);
+  float minVal, maxVal;
+  std::vector<uint32_t> counts;
+  EXPECT_FALSE(engine.computeRange(*buffer, minVal, maxVal));
+  EXPECT_FALSE(engine.computeHistogram(*buffer, 1., 3., 10, counts));
+  EXPECT_FALSE(engine.computeGather(*buffer, *indsBuffer, *targetBuffer));
+
+  // Everything which would use it falls back on the host
+  polyscope::SurfaceMesh* psMesh = registerTriangleMesh();
+  std::vector<double> vScalar(psMesh->nVertices());
+  for (double& v : vScalar) v = polyscope::randomReal(-1., 3.);
+  polyscope::SurfaceVertexScalarQuantity* q = psMesh->addVertexScalarQuantity("vScalar", vScalar);
+  q->setEnabled(true);
+  polyscope::show(3);
+  polyscope::Histogram hist;
+  hist.buildHistogram(q->values);
+  std::pair<float, float> hostRange = polyscope::computeFiniteRange(q->values.getPopulatedHostBufferRef());
+  EXPECT_EQ(hist.getDataRange(), polyscope::robustifyMinMax<double>(hostRange.first, hostRange.second));
+  checkMeshCornerPositions(psMesh);
+
+  polyscope::options::enableComputeTier = true;
+  polyscope::removeAllStructures();
+}
+
+// ============================================================
+// =============== Scene statistics tests
+// ============================================================
+
+TEST_F(PolyscopeTest, SceneStatistics) {
+  using namespace polyscope::scene_statistics;
+
+  // Two point clouds, with enough points for several worker chunks
+  size_t n = 300001;
+  std::vector<glm::vec3> points(n, glm::vec3{0., 0., 0.});
+  std::vector<float> valsA(n), valsB(n);
+  for (size_t i = 0; i < n; i++) {
+    points[i] = glm::vec3{polyscope::randomUnit(), polyscope::randomUnit(), polyscope::randomUnit()};
+    valsA[i] = polyscope::randomReal(-1., 1.);
+    valsB[i] = polyscope::randomReal(0., 3.);
+  }
+  valsA[7] = std::numeric_limits<float>::quiet_NaN(); // should be ignored
+  polyscope::PointCloud* cloudA = polyscope::registerPointCloud("statsA", points);
+  polyscope::PointCloud* cloudB = polyscope::registerPointCloud("statsB", points);
+  cloudA->addScalarQuantity("vals", valsA);
+  polyscope::PointCloudScalarQuantity* qB = cloudB->addScalarQuantity("vals", valsB);
+
+  // Reference values
+  std::vector<float> all;
+  for (float v : valsA) {
+    if (std::isfinite(v)) all.push_back(v);
+  }
+  all.insert(all.end(), valsB.begin(), valsB.end());
+  std::sort(all.begin(), all.end());
+  auto percentile = [&](double p) {
+    double pos = p / 100. * (all.size() - 1);
+    size_t i = static_cast<size_t>(pos);
+    return i + 1 < all.size() ? all[i] + (pos - i) * (all[i + 1] - all[i]) : all[i];
+  };
+
+  ScalarStatisticsQuery query;
+  query.quantityName = "vals";
+  query.percentiles = {0., 25., 50., 99., 100.};
+  query.thresholds = {0.5, 5.};
+  size_t buildsBefore = getCacheBuildCount();
+  ScalarStatistics stats = computeScalarStatistics(query);
+  EXPECT_EQ(stats.nValues, all.size());
+  EXPECT_EQ(stats.min, all.front());
+  EXPECT_EQ(stats.max, all.back());
+  for (size_t i = 0; i < query.percentiles.size(); i++) {
+    EXPECT_NEAR(stats.percentiles[i], percentile(query.percentiles[i]), 1e-5);
+  }
+  EXPECT_EQ(stats.nAboveThresholds[0], static_cast<size_t>(all.end() - std::upper_bound(all.begin(), all.end(), 0.5f)));
+  EXPECT_EQ(stats.nAboveThresholds[1], 0u);
+  EXPECT_EQ(getCacheBuildCount(), buildsBefore + 2);
+
+  // Repeated queries come from the cache, updated data does not
+  std::vector<std::pair<polyscope::Quantity*, ScalarStatistics>> perQ = computeScalarStatisticsPerQuantity(query);
+  ASSERT_EQ(perQ.size(), 2u);
+  EXPECT_EQ(perQ[0].second.nValues + perQ[1].second.nValues, all.size());
+  EXPECT_EQ(getCacheBuildCount(), buildsBefore + 2);
+  std::vector<float> shifted = valsB;
+  for (float& v : shifted) v += 10.;
+  qB->updateData(shifted);
+  stats = computeScalarStatistics(query);
+  EXPECT_EQ(getCacheBuildCount(), buildsBefore + 3);
+  EXPECT_EQ(stats.nAboveThresholds[1], n);
+
+  // Visible elements: not hidden by a mask, on enabled structures
+  query.filter = polyscope::ElementFilter::Visible;
+  cloudA->setPointMask({0, 1, 2}, polyscope::ElementMaskMode::Hide);
+  cloudB->setEnabled(false);
+  stats = computeScalarStatistics(query);
+  EXPECT_EQ(stats.nValues, n - 4);
+  cloudB->setEnabled(true);
+
+  // Selected elements
+  query.filter = polyscope::ElementFilter::Selected;
+  polyscope::region_selection::setSelection({{cloudA, {3, 4, 5, 7}}});
+  stats = computeScalarStatistics(query);
+  EXPECT_EQ(stats.nValues, 3u);
+  EXPECT_EQ(stats.min, std::min(valsA[3], std::min(valsA[4], valsA[5])));
+  polyscope::region_selection::clearSelection();
+  stats = computeScalarStatistics(query);
+  EXPECT_EQ(stats.nValues, 0u);
+  EXPECT_TRUE(std::isnan(stats.percentiles[0]));
+
+  // Removed structures leave the cache
+  polyscope::removeAllStructures();
+  computeScalarStatistics(query);
+  EXPECT_EQ(getCacheValueCount(), 0u);
+}
+
+// ============================================================
+// =============== Camera path replay tests
+// ============================================================
+
+TEST_F(PolyscopeTest, CameraPathJson) {
+  polyscope::registerPointCloud("test1", getPoints());
+  polyscope::benchmark::CameraPath path = polyscope::benchmark::CameraPath::orbitAroundScene(5);
+  EXPECT_EQ(path.nKeyframes(), 5u);
+
+  polyscope::benchmark::CameraPath reloaded = polyscope::benchmark::CameraPath::fromJson(path.toJson());
+  EXPECT_EQ(reloaded.nKeyframes(), 5u);
+  EXPECT_EQ(reloaded.toJson(), path.toJson());
+
+  // the current view is accepted as a keyframe
+  reloaded.addKeyframeFromJson(polyscope::view::getViewAsJson());
+  EXPECT_EQ(reloaded.nKeyframes(), 6u);
+  EXPECT_THROW(reloaded.addKeyframeFromJson("{\"fov\": 45.0}"), std::runtime_error);
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, CameraPathReplay) {
+  polyscope::registerPointCloud("test1", getPoints());
+  std::string initialView = polyscope::view::getViewAsJson();
+
+  polyscope::benchmark::CameraPath path = polyscope::benchmark::CameraPath::orbitAroundScene(4);
+  bool oldVSync = polyscope::options::enableVSync;
+  polyscope::options::enableVSync = true;
+  polyscope::benchmark::ReplayResult result = polyscope::benchmark::replayCameraPath(path, 10, 2);
+  EXPECT_TRUE(polyscope::options::enableVSync); // turned off while replaying, then restored
+  polyscope::options::enableVSync = oldVSync;
+  EXPECT_EQ(result.nFrames, 10u);
+  EXPECT_EQ(result.frameMs.size(), 10u);
+  EXPECT_LE(result.frameTime.minMs, result.frameTime.medianMs);
+  EXPECT_LE(result.frameTime.medianMs, result.frameTime.p99Ms);
+  EXPECT_LE(result.frameTime.p99Ms, result.frameTime.maxMs);
+
+  // every frame redraws the scene
+  bool haveScenePass = false;
+  for (const std::pair<std::string, polyscope::benchmark::TimingSummary>& pass : result.passes) {
+    if (pass.first == "scene") haveScenePass = true;
+  }
+  EXPECT_TRUE(haveScenePass);
+
+  EXPECT_EQ(polyscope::view::getViewAsJson(), initialView);
+  polyscope::benchmark::writeReplayReport(result, "test_camera_path_replay.json");
+  std::remove("test_camera_path_replay.json");
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, SummarizeTimings) {
+  std::vector<double> times;
+  for (int i = 100; i >= 1; i--) times.push_back(i);
+  polyscope::benchmark::TimingSummary s = polyscope::benchmark::summarizeTimings(times);
+  EXPECT_EQ(s.minMs, 1.);
+  EXPECT_EQ(s.medianMs, 50.5);
+  EXPECT_EQ(s.p99Ms, 99.);
+  EXPECT_EQ(s.maxMs, 100.);
+  EXPECT_EQ(s.meanMs, 50.5);
+}
+
+// ============================================================
+// =============== Remote view tests
+// ============================================================
+
+#ifndef _WIN32
+
+namespace {
+
+int connectToLocalPort(int port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+  timeval timeout{2, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  return fd;
+}
+
+// Read until the string contains `terminator`, the connection closes, or we time out
+std::string readUntil(int fd, std::string terminator) {
+  std::string result;
+  char buff[4096];
+  while (result.find(terminator) == std::string::npos) {
+    ssize_t n = recv(fd, buff, sizeof(buff), 0);
+    if (n <= 0) break;
+    result.append(buff, n);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_F(PolyscopeTest, RemoteView) {
+  int port = polyscope::remote::start(0);
+  EXPECT_TRUE(polyscope::remote::isRunning());
+
+  { // the client page
+    int fd = connectToLocalPort(port);
+    std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+    std::string response = readUntil(fd, "</html>");
+    EXPECT_NE(response.find("200 OK"), std::string::npos);
+    EXPECT_NE(response.find("<canvas"), std::string::npos);
+    close(fd);
+  }
+
+  { // connect a websocket (the key and expected answer are the example from RFC 6455) and get a frame
+    int fd = connectToLocalPort(port);
+    std::string request = "GET /ws HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                          "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+    std::string response = readUntil(fd, "\r\n\r\n");
+    EXPECT_NE(response.find("101 Switching Protocols"), std::string::npos);
+    EXPECT_NE(response.find("s3pPLMBiTxaQ9kYGzzhZRbK+xOo="), std::string::npos);
+    EXPECT_EQ(polyscope::remote::clientCount(), 1);
+
+    polyscope::show(3);
+
+    unsigned char header = 0;
+    EXPECT_EQ(recv(fd, &header, 1, 0), 1);
+    EXPECT_EQ(header, 0x82); // a complete binary message
+    close(fd);
+  }
+
+  polyscope::remote::stop();
+  EXPECT_FALSE(polyscope::remote::isRunning());
+}
+
+#endif
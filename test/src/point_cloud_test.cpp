@@ -7,6 +7,7 @@
 #include "polyscope/pick.h"
 #include "polyscope/point_cloud.h"
 #include "polyscope/polyscope.h"
+#include "polyscope/region_selection.h"
 #include "polyscope/surface_mesh.h"
 #include "polyscope/volume_mesh.h"
 
@@ -62,6 +63,39 @@ TEST_F(PolyscopeTest, PointCloudAppearance) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, PointCloudPixelMode) {
+  auto psPoints = registerPointCloud();
+  psPoints->setPointRenderMode(polyscope::PointRenderMode::Pixel);
+  EXPECT_EQ(psPoints->getPointRenderMode(), polyscope::PointRenderMode::Pixel);
+  polyscope::show(3);
+
+  // Splats, with quantities
+  psPoints->setPointPixelSize(4.);
+  EXPECT_EQ(psPoints->getPointPixelSize(), 4.);
+  std::vector<double> vScalar(psPoints->nPoints(), 7.);
+  auto q1 = psPoints->addScalarQuantity("vScalar", vScalar);
+  q1->setEnabled(true);
+  polyscope::show(3);
+
+  std::vector<glm::vec3> vColors(psPoints->nPoints(), glm::vec3{.2, .3, .4});
+  auto q2 = psPoints->addColorQuantity("vcolor", vColors);
+  q2->setEnabled(true);
+  polyscope::show(3);
+
+  // The radius quantity is ignored in pixel mode
+  psPoints->setPointRadiusQuantity(q1);
+  polyscope::show(3);
+
+  polyscope::pick::evaluatePickQuery(77, 88);
+
+  // Eye-dome lighting
+  polyscope::options::eyeDomeLighting = true;
+  polyscope::show(3);
+  polyscope::options::eyeDomeLighting = false;
+
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, PointCloudPick) {
   auto psPoints = registerPointCloud();
 
@@ -74,6 +108,245 @@ TEST_F(PolyscopeTest, PointCloudPick) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, PointCloudHover) {
+  auto psPoints = registerPointCloud();
+  std::vector<double> vScalar(psPoints->nPoints(), 7.);
+  auto q = psPoints->addScalarQuantity("vScalar", vScalar);
+  q->setEnabled(true);
+  polyscope::options::enableHoverHighlight = true;
+  polyscope::show(3);
+
+  // (the mock backend never reads back a real element, so check the kept pick buffer which the highlight draws from)
+  polyscope::pick::updateHover(glm::vec2{77., 88.});
+  polyscope::pick::updateHover(glm::vec2{78., 88.});
+  EXPECT_TRUE(polyscope::pick::pickBufferIsCurrent());
+
+  // Redraws and changes which don't affect picking keep it
+  polyscope::requestRedraw();
+  q->updateData(vScalar);
+  psPoints->setPointColor(glm::vec3{1., 0., 0.});
+  EXPECT_TRUE(polyscope::pick::pickBufferIsCurrent());
+  polyscope::show(3);
+  EXPECT_TRUE(polyscope::pick::pickBufferIsCurrent());
+
+  // Changes to geometry, size, visibility, and transforms don't
+  psPoints->updatePointPositions(getPoints());
+  EXPECT_FALSE(polyscope::pick::pickBufferIsCurrent());
+  polyscope::pick::updateHover(glm::vec2{77., 88.});
+  psPoints->setPointRadius(0.1);
+  EXPECT_FALSE(polyscope::pick::pickBufferIsCurrent());
+  polyscope::pick::updateHover(glm::vec2{77., 88.});
+  psPoints->setEnabled(false);
+  EXPECT_FALSE(polyscope::pick::pickBufferIsCurrent());
+  psPoints->setEnabled(true);
+  polyscope::pick::updateHover(glm::vec2{77., 88.});
+  psPoints->translate(glm::vec3{1., 0., 0.});
+  EXPECT_FALSE(polyscope::pick::pickBufferIsCurrent());
+  polyscope::pick::updateHover(glm::vec2{77., 88.});
+  EXPECT_TRUE(polyscope::pick::pickBufferIsCurrent());
+
+  polyscope::pick::resetHover();
+  polyscope::options::enableHoverHighlight = false;
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, PointCloudElementMask) {
+  std::vector<glm::vec3> points(20000);
+  for (size_t i = 0; i < points.size(); i++) points[i] = glm::vec3{float(i % 100), float(i / 100), 0.f};
+  auto psPoints = polyscope::registerPointCloud("mask points", points);
+
+  psPoints->setPointMask({0, 5, 17}, polyscope::ElementMaskMode::Highlight);
+  EXPECT_EQ(psPoints->getPointMask().get(5), polyscope::ElementMaskMode::Highlight);
+  polyscope::show(3);
+  EXPECT_EQ(psPoints->getPointMask().getLastUploadBytes(), points.size()); // first upload sends everything
+
+  // Changing a few points only sends the bytes around them
+  psPoints->setPointMask({5}, polyscope::ElementMaskMode::Outline);
+  psPoints->setPointMask({15000}, polyscope::ElementMaskMode::Hide);
+  polyscope::show(3);
+  EXPECT_EQ(psPoints->getPointMask().getLastUploadBytes(), 2);
+
+  psPoints->setPointRenderMode(polyscope::PointRenderMode::Quad);
+  polyscope::show(3);
+  psPoints->setPointRenderMode(polyscope::PointRenderMode::Sphere);
+
+  EXPECT_THROW(psPoints->setPointMask({points.size()}, polyscope::ElementMaskMode::Hide), std::runtime_error);
+
+  psPoints->clearPointMask();
+  EXPECT_FALSE(psPoints->getPointMask().isActive());
+  polyscope::show(3);
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, PointCloudRayQuery) {
+  std::vector<glm::vec3> points{{0., 0., 0.}, {1., 0., 0.}, {0., 0., 5.}};
+  auto psPoints = polyscope::registerPointCloud("ray points", points);
+  psPoints->setPointRadius(0.1, false);
+
+  polyscope::RayHit hit = polyscope::pick::queryRay(glm::vec3{1., 0., 10.}, glm::vec3{0., 0., -1.});
+  EXPECT_EQ(hit.structure, psPoints);
+  EXPECT_EQ(hit.localIndex, 1);
+  EXPECT_NEAR(hit.t, 9.9, 1e-4);
+  EXPECT_NEAR(hit.position.z, 0.1, 1e-4);
+
+  // Changing the data updates the query
+  points[1] = glm::vec3{2., 0., 0.};
+  psPoints->updatePointPositions(points);
+  hit = polyscope::pick::queryRay(glm::vec3{1., 0., 10.}, glm::vec3{0., 0., -1.});
+  EXPECT_FALSE(hit.hit());
+
+  // The ray is cast in world space
+  psPoints->setPosition(glm::vec3{0., 1., 0.});
+  hit = polyscope::pick::queryRay(glm::vec3{0., 1., 10.}, glm::vec3{0., 0., -1.});
+  EXPECT_EQ(hit.localIndex, 2);
+
+  // Disabled structures are not hit
+  psPoints->setEnabled(false);
+  hit = polyscope::pick::queryRay(glm::vec3{0., 1., 10.}, glm::vec3{0., 0., -1.});
+  EXPECT_FALSE(hit.hit());
+
+  // Use ray queries for regular picking, looking straight down at point 2 (in front of point 0)
+  psPoints->setEnabled(true);
+  polyscope::options::pickWithRayQueries = true;
+  polyscope::view::lookAt(glm::vec3{0., 1., 15.}, glm::vec3{0., 1., 5.});
+  std::pair<polyscope::Structure*, size_t> pickResult =
+      polyscope::pick::evaluatePickQuery(polyscope::view::bufferWidth / 2, polyscope::view::bufferHeight / 2);
+  EXPECT_EQ(pickResult.first, psPoints);
+  EXPECT_EQ(pickResult.second, 2);
+  glm::vec2 screenCenter{polyscope::view::windowWidth / 2., polyscope::view::windowHeight / 2.};
+  glm::vec3 worldPos = polyscope::view::screenCoordsToWorldPosition(screenCenter);
+  EXPECT_NEAR(worldPos.z, 5.1, 1e-3);
+  polyscope::options::pickWithRayQueries = false;
+
+  // Updating the data again while a build is running supersedes it, the query sees the latest positions
+  points[2] = glm::vec3{0., 0., 7.};
+  psPoints->updatePointPositions(points);
+  polyscope::pick::queryRay(glm::vec3{0., 1., 10.}, glm::vec3{0., 0., -1.}, false); // starts a build, doesn't wait
+  points[2] = glm::vec3{0., 0., 6.};
+  psPoints->updatePointPositions(points);
+  hit = polyscope::pick::queryRay(glm::vec3{0., 1., 10.}, glm::vec3{0., 0., -1.});
+  EXPECT_EQ(hit.localIndex, 2);
+  EXPECT_NEAR(hit.position.z, 6.1, 1e-4);
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, PointCloudReorderForLocality) {
+  polyscope::options::reorderForLocality = true;
+
+  // Points along a line, given out of order
+  std::vector<size_t> perm{3, 0, 4, 1, 2};
+  std::vector<glm::vec3> points;
+  for (size_t i : perm) points.push_back(glm::vec3{static_cast<float>(i), 0., 0.});
+  auto psPoints = polyscope::registerPointCloud("reordered", points);
+  psPoints->setPointRadius(0.1, false);
+  psPoints->drawOrder.ensureHostBufferPopulated();
+  EXPECT_EQ(psPoints->drawOrder.data, std::vector<uint32_t>({1, 3, 4, 0, 2}));
+
+  // Data still refers to the points in the order they were given
+  EXPECT_EQ(psPoints->getPointPosition(0), points[0]);
+  std::vector<double> vScalar{0., 1., 2., 3., 4.};
+  auto q1 = psPoints->addScalarQuantity("vScalar", vScalar);
+  q1->setEnabled(true);
+  psPoints->setPointRadiusQuantity(q1);
+  polyscope::show(3);
+  auto q2 = psPoints->addColorQuantity("vColor", points);
+  q2->setEnabled(true);
+  polyscope::show(3);
+  polyscope::pick::evaluatePickQuery(77, 88);
+  psPoints->clearPointRadiusQuantity();
+
+  polyscope::RayHit hit = polyscope::pick::queryRay(glm::vec3{3., 0., 10.}, glm::vec3{0., 0., -1.});
+  EXPECT_EQ(hit.localIndex, 0);
+
+  polyscope::options::reorderForLocality = false;
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, PointCloudDepthPrepass) {
+  auto psPoints = registerPointCloud();
+  psPoints->setDepthPrepass(true);
+  EXPECT_TRUE(psPoints->getDepthPrepass());
+  polyscope::show(3);
+
+  // Shading from a quantity
+  std::vector<double> vScalar(psPoints->nPoints(), 7.);
+  auto q1 = psPoints->addScalarQuantity("vScalar", vScalar);
+  q1->setEnabled(true);
+  psPoints->setPointRadiusQuantity(q1);
+  polyscope::show(3);
+
+  // Not used for transparent or quad points
+  psPoints->setTransparencyQuantity(q1);
+  polyscope::show(3);
+  psPoints->clearTransparencyQuantity();
+  psPoints->setPointRenderMode(polyscope::PointRenderMode::Quad);
+  polyscope::show(3);
+
+  // Enabled globally
+  psPoints->setDepthPrepass(false);
+  psPoints->setPointRenderMode(polyscope::PointRenderMode::Sphere);
+  polyscope::options::impostorDepthPrepass = true;
+  polyscope::show(3);
+  polyscope::options::impostorDepthPrepass = false;
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, PointCloudRegionSelection) {
+  std::vector<glm::vec3> points;
+  for (size_t i = 0; i < 2000; i++) {
+    points.push_back(glm::vec3{polyscope::randomUnit(), polyscope::randomUnit(), polyscope::randomUnit()} - 0.5f);
+  }
+  auto psPoints = polyscope::registerPointCloud("region points", points);
+  polyscope::view::lookAt(glm::vec3{0.3, 0.5, 2.}, glm::vec3{0., 0., 0.});
+
+  // Compare against projecting every point
+  auto bruteForce = [&](const polyscope::ScreenRegion& region) {
+    glm::mat4 objToClip = polyscope::view::getCameraPerspectiveMatrix() * psPoints->getModelView();
+    std::vector<size_t> inds;
+    for (size_t i = 0; i < points.size(); i++) {
+      glm::vec4 clip = objToClip * glm::vec4(points[i], 1.);
+      glm::vec3 ndc = glm::vec3(clip) / clip.w;
+      glm::vec2 screen{(0.5f * ndc.x + 0.5f) * polyscope::view::windowWidth,
+                       (0.5f - 0.5f * ndc.y) * polyscope::view::windowHeight};
+      if (region.contains(screen)) inds.push_back(i);
+    }
+    return inds;
+  };
+
+  float w = polyscope::view::windowWidth;
+  float h = polyscope::view::windowHeight;
+  polyscope::ScreenRegion box = polyscope::ScreenRegion::box({0.6 * w, 0.2 * h}, {0.3 * w, 0.7 * h});
+  std::vector<size_t> boxInds = psPoints->selectPointsInScreenRegion(box);
+  EXPECT_FALSE(boxInds.empty());
+  EXPECT_EQ(boxInds, bruteForce(box));
+
+  polyscope::ScreenRegion lasso =
+      polyscope::ScreenRegion::lasso({{0.5 * w, 0.1 * h}, {0.8 * w, 0.9 * h}, {0.5 * w, 0.6 * h}, {0.2 * w, 0.9 * h}});
+  EXPECT_EQ(psPoints->selectPointsInScreenRegion(lasso), bruteForce(lasso));
+
+  // Moving the camera or the points changes the result
+  psPoints->setPosition(glm::vec3{0.2, 0., 0.});
+  EXPECT_EQ(psPoints->selectPointsInScreenRegion(box), bruteForce(box));
+  points[boxInds[0]] = glm::vec3{5., 5., 0.};
+  psPoints->updatePointPositions(points);
+  EXPECT_EQ(psPoints->selectPointsInScreenRegion(box), bruteForce(box));
+
+  // Scene-wide selection, which uses local pick indices
+  polyscope::region_selection::setMode(polyscope::region_selection::RegionSelectionMode::Box);
+  polyscope::show(3);
+  std::vector<std::pair<polyscope::Structure*, std::vector<size_t>>> sel =
+      polyscope::region_selection::selectInScreenRegion(box);
+  ASSERT_EQ(sel.size(), 1);
+  EXPECT_EQ(sel[0].first, psPoints);
+  EXPECT_EQ(sel[0].second, bruteForce(box));
+  polyscope::region_selection::setMode(polyscope::region_selection::RegionSelectionMode::Off);
+
+  polyscope::removeAllStructures();
+}
+
 
 TEST_F(PolyscopeTest, PointCloudColor) {
   auto psPoints = registerPointCloud();
@@ -112,6 +385,60 @@ TEST_F(PolyscopeTest, PointCloudScalar) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, PointCloudScalarRangeUpdate) {
+  auto psPoints = registerPointCloud();
+
+  std::vector<double> vScalar(psPoints->nPoints(), 0.);
+  for (size_t i = 0; i < vScalar.size(); i++) vScalar[i] = i;
+  auto q1 = psPoints->addScalarQuantity("vScalar", vScalar);
+  q1->setEnabled(true);
+  polyscope::show(3);
+
+  // Off: the ranges stay those of the original values
+  std::vector<double> vScalar2 = vScalar;
+  for (double& v : vScalar2) v += 5.;
+  q1->updateData(vScalar2);
+  EXPECT_EQ(q1->getDataRange(), std::make_pair(0., 3.));
+
+  // Fixed: the data range follows, the colormap range does not
+  q1->setMapRange({1., 2.});
+  q1->setRangeUpdate(polyscope::ScalarRangeUpdate::Fixed);
+  q1->updateData(vScalar2);
+  EXPECT_EQ(q1->getDataRange(), std::make_pair(5., 8.));
+  EXPECT_EQ(q1->getMapRange(), std::make_pair(1., 2.));
+
+  // Expand only
+  q1->setRangeUpdate(polyscope::ScalarRangeUpdate::ExpandOnly);
+  q1->updateData(vScalar2);
+  EXPECT_EQ(q1->getMapRange(), std::make_pair(1., 8.));
+
+  // Fit, on a worker thread, over a window of the last two updates (the NaN is ignored)
+  q1->setRangeUpdate(polyscope::ScalarRangeUpdate::Fit);
+  q1->setRangeUpdateAsync(true);
+  q1->setRangeUpdateWindow(2);
+  std::vector<double> vScalar3 = vScalar;
+  vScalar3[0] = std::numeric_limits<double>::quiet_NaN();
+  vScalar3[1] = 20.;
+  q1->updateData(vScalar3);
+  polyscope::show(3);
+  EXPECT_EQ(q1->getMapRange(), std::make_pair(2., 20.));
+  q1->updateData(vScalar);
+  EXPECT_EQ(q1->getMapRange(), std::make_pair(0., 20.));
+  q1->updateData(vScalar);
+  EXPECT_EQ(q1->getMapRange(), std::make_pair(0., 3.));
+  polyscope::show(3);
+
+  // An update which is superseded before its range is in is dropped, without waiting for it
+  std::vector<double> vScalar4 = vScalar;
+  vScalar4[1] = 50.;
+  q1->updateData(vScalar4);
+  q1->updateData(vScalar);
+  EXPECT_EQ(q1->getMapRange(), std::make_pair(0., 3.));
+  polyscope::show(3);
+
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, PointCloudVector) {
   auto psPoints = registerPointCloud();
 
@@ -153,6 +480,113 @@ TEST_F(PolyscopeTest, PointCloudParam) {
 }
 
 
+TEST_F(PolyscopeTest, PointCloudDeferredUploads) {
+  auto psPointsA = registerPointCloud("test1");
+  auto psPointsB = registerPointCloud("test2");
+  std::vector<double> vScalar(psPointsA->nPoints(), 7.);
+  auto qA = psPointsA->addScalarQuantity("vScalar", vScalar);
+  qA->setEnabled(true);
+  polyscope::show(3); // (creates the device buffers)
+
+  polyscope::options::deferDeviceUploads = true;
+  polyscope::options::maxUploadBytesPerFrame = 1;
+  polyscope::render::UploadScheduler& scheduler = polyscope::render::engine->uploadScheduler;
+
+  std::vector<glm::vec3> points = getPoints();
+  points[0].x += 1.;
+  psPointsA->updatePointPositions(points);
+  qA->updateData(vScalar);
+  psPointsB->updatePointPositions(points);
+  EXPECT_TRUE(scheduler.isPending(&psPointsA->points));
+  EXPECT_TRUE(scheduler.isPending(&qA->values));
+  EXPECT_TRUE(scheduler.isPending(&psPointsB->points));
+
+  // Over budget, one structure gets updated per frame, all at once. Visible structures go first.
+  psPointsA->setEnabled(false);
+  polyscope::render::engine->serviceDeferredUploads();
+  EXPECT_TRUE(scheduler.isPending(&psPointsA->points));
+  EXPECT_TRUE(scheduler.isPending(&qA->values));
+  EXPECT_FALSE(scheduler.isPending(&psPointsB->points));
+  polyscope::render::engine->serviceDeferredUploads();
+  EXPECT_TRUE(scheduler.empty());
+
+  // Rendering drains the queue
+  psPointsA->setEnabled(true);
+  psPointsA->updatePointPositions(points);
+  polyscope::show(3);
+  EXPECT_TRUE(scheduler.empty());
+
+  polyscope::options::deferDeviceUploads = false;
+  polyscope::options::maxUploadBytesPerFrame = 64 << 20;
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, PointCloudHistogramWithPendingUpload) {
+  auto psPoints = registerPointCloud();
+  std::vector<double> vScalar(psPoints->nPoints(), 7.);
+  vScalar[0] = 0.;
+  auto q = psPoints->addScalarQuantity("vScalar", vScalar);
+  q->setEnabled(true);
+  polyscope::show(3); // (creates the device buffers)
+
+  polyscope::options::deferDeviceUploads = true;
+  for (double& v : vScalar) v += 10.;
+  q->updateData(vScalar);
+  EXPECT_TRUE(q->values.hasPendingDeferredUpload());
+
+  // The device still has the old values, the histogram must see the new ones
+  polyscope::Histogram hist;
+  hist.buildHistogram(q->values);
+  EXPECT_NEAR(hist.getDataRange().first, 10., 1e-5);
+  EXPECT_NEAR(hist.getDataRange().second, 17., 1e-5);
+
+  polyscope::render::engine->serviceDeferredUploads();
+  EXPECT_FALSE(q->values.hasPendingDeferredUpload());
+  hist.buildHistogram(q->values);
+  EXPECT_NEAR(hist.getDataRange().first, 10., 1e-5);
+  EXPECT_NEAR(hist.getDataRange().second, 17., 1e-5);
+
+  polyscope::options::deferDeviceUploads = false;
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, PointCloudSharedPositions) {
+  polyscope::SurfaceMesh* psMesh = registerTriangleMesh("mesh");
+  polyscope::PointCloud* psPoints = polyscope::registerPointCloud("mesh vertices", psMesh->vertexPositions);
+  std::vector<std::array<size_t, 2>> edges = {{0, 1}, {1, 2}, {2, 0}, {0, 3}};
+  polyscope::CurveNetwork* psCurve = polyscope::registerCurveNetwork("mesh edges", psMesh->vertexPositions, edges);
+  polyscope::show(3);
+
+  // one copy of the positions, on the host and on the device
+  EXPECT_TRUE(psPoints->points.isSharing());
+  EXPECT_TRUE(psCurve->nodePositions.isSharing());
+  EXPECT_EQ(psMesh->vertexPositions.sharingBufferCount(), 2u);
+  EXPECT_EQ(psPoints->nPoints(), psMesh->nVertices());
+  EXPECT_EQ(psPoints->points.getRenderAttributeBuffer(), psMesh->vertexPositions.getRenderAttributeBuffer());
+
+  // updates through any of the structures are seen by all of them
+  std::vector<glm::vec3> newPositions = getPoints();
+  newPositions[0] = glm::vec3{2., 0., 0.};
+  psMesh->updateVertexPositions(newPositions);
+  EXPECT_EQ(psPoints->getPointPosition(0), glm::vec3(2., 0., 0.));
+  polyscope::show(3);
+
+  newPositions[1] = glm::vec3{0., 3., 0.};
+  psPoints->updatePointPositions(newPositions);
+  EXPECT_EQ(psMesh->vertexPositions.getValue(1), glm::vec3(0., 3., 0.));
+  EXPECT_EQ(psCurve->nodePositions.getValue(1), glm::vec3(0., 3., 0.));
+  polyscope::show(3);
+
+  // the positions outlive the structure they came from
+  polyscope::removeStructure(psMesh);
+  EXPECT_FALSE(psPoints->points.isSharing());
+  EXPECT_TRUE(psCurve->nodePositions.isSharing());
+  EXPECT_EQ(psPoints->getPointPosition(1), glm::vec3(0., 3., 0.));
+  polyscope::show(3);
+
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, PointCloudScalarRadius) {
   auto psPoints = registerPointCloud();
   std::vector<double> vScalar(psPoints->nPoints(), 7.);
@@ -2,6 +2,10 @@
 
 #include "polyscope_test.h"
 
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
 // ============================================================
 // =============== Surface mesh tests
 // ============================================================
@@ -80,6 +84,110 @@ TEST_F(PolyscopeTest, SurfaceMeshPolygon) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, SurfaceMeshTrianglesAndCSR) {
+  std::vector<glm::vec3> points;
+  std::vector<std::vector<size_t>> faces;
+  std::tie(points, faces) = getTriangleMesh();
+
+  // Triangle array input gives the same mesh as the nested list
+  std::vector<std::array<size_t, 3>> triangles;
+  for (const std::vector<size_t>& f : faces) triangles.push_back({f[0], f[1], f[2]});
+  auto psNested = polyscope::registerSurfaceMesh("nested", points, faces);
+  auto psTri = polyscope::registerSurfaceMeshTriangles("triangles", points, triangles);
+  EXPECT_EQ(psTri->nFaces(), psNested->nFaces());
+  EXPECT_EQ(psTri->faceIndsStart, psNested->faceIndsStart);
+  EXPECT_EQ(psTri->triangleVertexInds.data, psNested->triangleVertexInds.data);
+  EXPECT_EQ(psTri->triangleFaceInds.data, psNested->triangleFaceInds.data);
+  EXPECT_TRUE(psTri->facesAreAllTriangles);
+
+  // Polygons in compressed-row form
+  std::vector<uint32_t> entries{0, 1, 2, 3, 0, 2, 1};
+  std::vector<uint32_t> starts{0, 4, 6}; // doesn't cover all entries
+  EXPECT_THROW(polyscope::registerSurfaceMeshCSR("csr", points, entries, starts), std::runtime_error);
+  starts = {0, 4, 7};
+  auto psCSR = polyscope::registerSurfaceMeshCSR("csr", points, entries, starts);
+  EXPECT_EQ(psCSR->nFaces(), 2);
+  EXPECT_EQ(psCSR->nFacesTriangulation(), 3);
+  EXPECT_FALSE(psCSR->facesAreAllTriangles);
+  psCSR->edgeIsRealMask.ensureHostBufferPopulated();
+  EXPECT_EQ(psCSR->edgeIsRealMask.data, std::vector<float>({3, 3, 3, 6, 6, 6, 7, 7, 7}));
+  psCSR->setEdgeWidth(1.);
+  polyscope::show(3);
+
+  // Offsets which decrease, or faces with fewer than 3 vertices, are caught by the bulk validation
+  starts = {0, 5, 4, 7};
+  EXPECT_THROW(polyscope::registerSurfaceMeshCSR("bad", points, entries, starts), std::runtime_error);
+  starts = {0, 2, 7};
+  EXPECT_THROW(polyscope::registerSurfaceMeshCSR("bad", points, entries, starts), std::runtime_error);
+
+  // Indices out of range are caught by the bulk validation
+  triangles[0][1] = 77;
+  EXPECT_THROW(polyscope::registerSurfaceMeshTriangles("bad", points, triangles), std::runtime_error);
+
+  polyscope::removeAllStructures();
+}
+
+TEST_F(PolyscopeTest, SurfaceMeshReorderForLocality) {
+  // A grid of triangles
+  size_t n = 6;
+  std::vector<glm::vec3> points;
+  std::vector<std::vector<size_t>> faces;
+  for (size_t i = 0; i < n; i++) {
+    for (size_t j = 0; j < n; j++) {
+      points.push_back(glm::vec3{static_cast<float>(i), static_cast<float>(j), static_cast<float>(std::sin(i + j))});
+    }
+  }
+  for (size_t i = 0; i + 1 < n; i++) {
+    for (size_t j = 0; j + 1 < n; j++) {
+      size_t a = i * n + j;
+      faces.push_back({a, a + n + 1, a + 1});
+      faces.push_back({a, a + n, a + n + 1});
+    }
+  }
+  auto psPlain = polyscope::registerSurfaceMesh("plain", points, faces);
+  polyscope::options::reorderForLocality = true;
+  auto psMesh = polyscope::registerSurfaceMesh("reordered", points, faces);
+  polyscope::options::reorderForLocality = false;
+
+  // The triangulation is a permutation of the faces
+  ASSERT_EQ(psMesh->faceDrawOrder.size(), faces.size());
+  for (size_t i = 0; i < faces.size(); i++) {
+    size_t iF = psMesh->faceDrawOrder[i];
+    EXPECT_EQ(psMesh->faceTriangleInd(iF), i);
+    EXPECT_EQ(psMesh->triangleFaceInds.data[3 * i], iF);
+    for (size_t k = 0; k < 3; k++) EXPECT_EQ(psMesh->triangleVertexInds.data[3 * i + k], faces[iF][k]);
+  }
+
+  // Edges are still numbered in the original face order
+  psPlain->triangleAllEdgeInds.ensureHostBufferPopulated();
+  psMesh->triangleAllEdgeInds.ensureHostBufferPopulated();
+  EXPECT_EQ(psMesh->nEdges(), psPlain->nEdges());
+  for (size_t iF = 0; iF < faces.size(); iF++) {
+    for (size_t k = 0; k < 9; k++) {
+      EXPECT_EQ(psMesh->triangleAllEdgeInds.data[9 * psMesh->faceTriangleInd(iF) + k],
+                psPlain->triangleAllEdgeInds.data[9 * iF + k]);
+    }
+  }
+
+  // Quantities and picking
+  std::vector<double> fScalar(faces.size(), 1.);
+  psMesh->addFaceScalarQuantity("fScalar", fScalar)->setEnabled(true);
+  std::vector<double> eScalar(psMesh->nEdges(), 2.);
+  psMesh->addEdgeScalarQuantity("eScalar", eScalar)->setEnabled(true);
+  psMesh->setEdgeWidth(1.);
+  polyscope::show(3);
+  polyscope::pick::evaluatePickQuery(77, 88);
+
+  // Polygon meshes are left in order
+  polyscope::options::reorderForLocality = true;
+  std::vector<std::vector<size_t>> polyFaces{{0, 1, n + 1, n}, {1, 2, n + 2}};
+  auto psPoly = polyscope::registerSurfaceMesh("polygons", points, polyFaces);
+  polyscope::options::reorderForLocality = false;
+  EXPECT_TRUE(psPoly->faceDrawOrder.empty());
+
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, SurfaceMeshAppearance) {
   auto psMesh = registerTriangleMesh();
 
@@ -121,6 +229,27 @@ TEST_F(PolyscopeTest, SurfaceMeshPick) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, SurfaceMeshRayQuery) {
+  std::vector<glm::vec3> points{{0., 0., 0.}, {1., 0., 0.}, {0., 1., 0.}};
+  std::vector<std::vector<size_t>> faces{{0, 1, 2}};
+  auto psMesh = polyscope::registerSurfaceMesh("ray mesh", points, faces);
+
+  // Face indices come after vertices
+  polyscope::RayHit hit = polyscope::pick::queryRay(glm::vec3{0.25, 0.25, 1.}, glm::vec3{0., 0., -2.});
+  EXPECT_EQ(hit.structure, psMesh);
+  EXPECT_EQ(hit.localIndex, 3);
+  EXPECT_NEAR(hit.t, 0.5, 1e-5);
+
+  // Hits near a corner report the vertex
+  hit = polyscope::pick::queryRay(glm::vec3{0.95, 0.02, 1.}, glm::vec3{0., 0., -1.});
+  EXPECT_EQ(hit.localIndex, 1);
+
+  hit = polyscope::pick::queryRay(glm::vec3{2., 2., 1.}, glm::vec3{0., 0., -1.});
+  EXPECT_FALSE(hit.hit());
+
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, SurfaceMeshMark) {
   auto psMesh = registerTriangleMesh();
 
@@ -148,6 +277,27 @@ TEST_F(PolyscopeTest, SurfaceMeshMark) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, SurfaceMeshFaceMask) {
+  auto psMesh = registerTriangleMesh();
+  psMesh->setFaceMask({0}, polyscope::ElementMaskMode::Outline);
+  psMesh->setFaceMask({1}, polyscope::ElementMaskMode::Hide);
+  polyscope::show(3);
+  psMesh->clearFaceMask();
+  polyscope::show(3);
+
+  // Polygon faces mask all of the triangles they are drawn with
+  std::vector<glm::vec3> points{{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {2, 0, 0}};
+  std::vector<std::vector<size_t>> faces{{1, 4, 2}, {0, 1, 2, 3}};
+  auto psPoly = polyscope::registerSurfaceMesh("mask poly", points, faces);
+  psPoly->setFaceMask({1}, polyscope::ElementMaskMode::Highlight);
+  EXPECT_EQ(psPoly->getFaceMask().get(0), polyscope::ElementMaskMode::None);
+  EXPECT_EQ(psPoly->getFaceMask().get(1), polyscope::ElementMaskMode::Highlight);
+  EXPECT_EQ(psPoly->getFaceMask().get(2), polyscope::ElementMaskMode::Highlight);
+  polyscope::show(3);
+
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, SurfaceMeshBackface) {
   auto psMesh = registerTriangleMesh();
 
@@ -307,6 +457,84 @@ TEST_F(PolyscopeTest, SurfaceMeshScalarTexture) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, SurfaceMeshVirtualTexture) {
+  auto psMesh = registerTriangleMesh();
+
+  std::vector<glm::vec2> vals(psMesh->nCorners());
+  for (size_t i = 0; i < vals.size(); i++) {
+    vals[i] = glm::vec2{std::fmod(0.37 * i, 1.), std::fmod(0.61 * i, 1.)};
+  }
+  auto qParam = psMesh->addParameterizationQuantity("param", vals);
+
+  // Lower the threshold so these small textures are drawn with virtual texturing
+  size_t oldThreshold = polyscope::options::virtualTextureThreshold;
+  polyscope::options::virtualTextureThreshold = 64;
+
+  size_t dimX = 300;
+  size_t dimY = 200;
+  std::vector<glm::vec3> colorsTex(dimX * dimY, glm::vec3{.2, .3, .4});
+  polyscope::SurfaceTextureColorQuantity* qColor =
+      psMesh->addTextureColorQuantity("tColor", *qParam, dimX, dimY, colorsTex, polyscope::ImageOrigin::UpperLeft);
+  qColor->setEnabled(true);
+  EXPECT_TRUE(qColor->usesVirtualTexture());
+  polyscope::show(3);
+  ASSERT_NE(qColor->getVirtualTexture(), nullptr);
+  EXPECT_EQ(qColor->getVirtualTexture()->nLevels(), 3);
+  qColor->getVirtualTexture()->flush();
+  EXPECT_GE(qColor->getVirtualTexture()->nResidentPages(), 1);
+  EXPECT_EQ(qColor->getVirtualTexture()->nLoadingPages(), 0);
+
+  // Updating the data starts over with the new values
+  qColor->updateData(colorsTex);
+  polyscope::show(3);
+  ASSERT_NE(qColor->getVirtualTexture(), nullptr);
+
+  std::vector<float> valuesTex(dimX * dimY, 0.77);
+  polyscope::SurfaceTextureScalarQuantity* qScalar =
+      psMesh->addTextureScalarQuantity("tScalar", *qParam, dimX, dimY, valuesTex, polyscope::ImageOrigin::LowerLeft);
+  qScalar->setEnabled(true);
+  polyscope::show(3);
+  ASSERT_NE(qScalar->getVirtualTexture(), nullptr);
+
+  // Raising the threshold goes back to regular textures
+  polyscope::options::virtualTextureThreshold = oldThreshold;
+  EXPECT_FALSE(qScalar->usesVirtualTexture());
+  polyscope::show(3);
+  EXPECT_EQ(qScalar->getVirtualTexture(), nullptr);
+
+#ifndef _WIN32
+  // Colors from a memory-mapped file are always virtual
+  std::string filename = "test_virtual_texture.bin";
+  std::ofstream outFile(filename, std::ios::binary);
+  outFile.write(reinterpret_cast<const char*>(&colorsTex.front()), colorsTex.size() * sizeof(glm::vec3));
+  outFile.close();
+  polyscope::SurfaceTextureColorQuantity* qFile = psMesh->addTextureColorQuantityFromFile(
+      "tFile", *qParam, dimX, dimY, filename, polyscope::ImageOrigin::UpperLeft);
+  qFile->setEnabled(true);
+  EXPECT_TRUE(qFile->usesVirtualTexture());
+  polyscope::show(3);
+  ASSERT_NE(qFile->getVirtualTexture(), nullptr);
+  qFile->getVirtualTexture()->flush();
+  EXPECT_EQ(qFile->getVirtualTexture()->nLoadingPages(), 0);
+#endif
+
+  // Screenshots load every page the view needs before capturing
+  polyscope::options::virtualTextureThreshold = 64;
+  polyscope::SurfaceTextureColorQuantity* qShot =
+      psMesh->addTextureColorQuantity("tShot", *qParam, dimX, dimY, colorsTex, polyscope::ImageOrigin::UpperLeft);
+  qShot->setEnabled(true);
+  polyscope::screenshotToBuffer(false);
+  ASSERT_NE(qShot->getVirtualTexture(), nullptr);
+  EXPECT_EQ(qShot->getVirtualTexture()->nLoadingPages(), 0);
+  EXPECT_GE(qShot->getVirtualTexture()->nResidentPages(), qShot->getVirtualTexture()->nRequestedPages());
+  polyscope::options::virtualTextureThreshold = oldThreshold;
+
+  polyscope::removeAllStructures();
+#ifndef _WIN32
+  std::remove(filename.c_str());
+#endif
+}
+
 TEST_F(PolyscopeTest, SurfaceMeshScalarTransparency) {
 
   auto psMesh = registerTriangleMesh();
@@ -81,6 +81,47 @@ TEST_F(PolyscopeTest, VolumeGridSlicePlane) {
   polyscope::removeAllStructures();
 }
 
+TEST_F(PolyscopeTest, VolumeGridRaycast) {
+  
+  // these are node dim
+  uint32_t dimX = 8;
+  uint32_t dimY = 10;
+  uint32_t dimZ = 12;
+  glm::vec3 bound_low{-3., -3., -3.};
+  glm::vec3 bound_high{3., 3., 3.};
+
+  polyscope::VolumeGrid* psGrid = polyscope::registerVolumeGrid("test grid", {dimX, dimY, dimZ}, bound_low, bound_high);
+  psGrid->setRaycastGridCubes(true);
+  EXPECT_TRUE(psGrid->getRaycastGridCubes());
+  polyscope::show(3);
+
+  // options which change the programs
+  psGrid->setEdgeWidth(0.5);
+  psGrid->setCubeSizeFactor(0.5);
+  polyscope::show(3);
+
+  // picking
+  polyscope::pick::evaluatePickQuery(77, 88);
+
+  // with a slice plane
+  polyscope::SlicePlane* p = polyscope::addSceneSlicePlane();
+  polyscope::show(3);
+
+  // quantities
+  std::vector<double> nodeScalar(psGrid->nNodes(), 3.0f);
+  psGrid->addNodeScalarQuantity("node scalar", nodeScalar)->setEnabled(true);
+  polyscope::show(3);
+  std::vector<double> cellScalar(psGrid->nCells(), 3.0f);
+  psGrid->addCellScalarQuantity("cell scalar", cellScalar)->setEnabled(true);
+  polyscope::show(3);
+
+  psGrid->setRaycastGridCubes(false);
+  polyscope::show(3);
+
+  polyscope::removeLastSceneSlicePlane();
+  polyscope::removeAllStructures();
+}
+
 TEST_F(PolyscopeTest, VolumeGridScalar) {
   
   // these are node dim
@@ -180,3 +221,124 @@ TEST_F(PolyscopeTest, VolumeGridScalarIsosurfaceAndOpts) {
   polyscope::removeLastSceneSlicePlane();
   polyscope::removeAllStructures();
 }
+
+TEST(VolumeGridMipPyramidTest, CellLevels) {
+
+  // 5x4x3 cells, valued by their flat index
+  glm::uvec3 cellDim{5, 4, 3};
+  std::vector<float> values(5 * 4 * 3);
+  for (size_t i = 0; i < values.size(); i++) values[i] = i;
+
+  std::vector<polyscope::VolumeGridMipPyramid::Level> levels =
+      polyscope::VolumeGridMipPyramid::computeLevels(values, cellDim, false);
+  ASSERT_EQ(levels.size(), 2);
+  EXPECT_EQ(levels[0].cellDim, glm::uvec3(3, 2, 2));
+  EXPECT_EQ(levels[1].cellDim, glm::uvec3(2, 1, 1));
+  EXPECT_EQ(polyscope::VolumeGridMipPyramid::levelCellDim(cellDim, 2), glm::uvec3(2, 1, 1));
+  EXPECT_EQ(polyscope::VolumeGridMipPyramid::levelCellScale(2), 4u); // (so the last cells extend past the grid)
+
+  // a full 2x2x2 block
+  EXPECT_EQ(levels[0].minValues[0], 0.);
+  EXPECT_EQ(levels[0].maxValues[0], 26.);
+  EXPECT_EQ(levels[0].meanValues[0], 13.);
+
+  // a block cut off by the end of the x and z axes
+  EXPECT_EQ(levels[0].minValues[11], 54.);
+  EXPECT_EQ(levels[0].maxValues[11], 59.);
+  EXPECT_EQ(levels[0].meanValues[11], 56.5);
+
+  // the next level reduces the min and max of the previous one
+  EXPECT_EQ(levels[1].minValues[1], 4.);
+  EXPECT_EQ(levels[1].maxValues[1], 59.);
+  EXPECT_EQ(&levels[1].getValues(polyscope::VolumeGridMipReduction::Max), &levels[1].maxValues);
+}
+
+TEST(VolumeGridMipPyramidTest, NodeLevels) {
+
+  // 4x4x4 nodes, valued by their x index
+  glm::uvec3 cellDim{3, 3, 3};
+  std::vector<float> values(4 * 4 * 4);
+  for (size_t i = 0; i < values.size(); i++) values[i] = i % 4;
+
+  std::vector<polyscope::VolumeGridMipPyramid::Level> levels =
+      polyscope::VolumeGridMipPyramid::computeLevels(values, cellDim, true);
+  ASSERT_EQ(levels.size(), 1);
+  EXPECT_EQ(levels[0].valueDim, glm::uvec3(3, 3, 3));
+
+  // tent filter around fine node 2
+  EXPECT_EQ(levels[0].minValues[1], 1.);
+  EXPECT_EQ(levels[0].maxValues[1], 3.);
+  EXPECT_EQ(levels[0].meanValues[1], 2.);
+
+  // the last coarse node is past the end of the fine grid, and only sees its neighbor
+  EXPECT_EQ(levels[0].meanValues[2], 3.);
+}
+
+TEST(VolumeGridMipPyramidTest, SupersededBuild) {
+  glm::uvec3 cellDim{16, 16, 16};
+  polyscope::VolumeGridMipPyramid pyramid;
+  pyramid.build(std::vector<float>(16 * 16 * 16, 1.f), cellDim, false, 1);
+  pyramid.build(std::vector<float>(16 * 16 * 16, 2.f), cellDim, false, 2);
+  EXPECT_FALSE(pyramid.isCurrent(1));
+  EXPECT_TRUE(pyramid.isCurrent(2));
+
+  // only the result of the latest build is used
+  ASSERT_TRUE(pyramid.isReady(true));
+  EXPECT_EQ(pyramid.getLevel(1).meanValues[0], 2.f);
+}
+
+TEST_F(PolyscopeTest, VolumeGridMipLevels) {
+
+  // always use the pyramid, and always consider it coarse enough to draw from while moving
+  size_t prevMinCells = polyscope::options::volumeGridMipMinCells;
+  float prevCellPixels = polyscope::options::volumeGridInteractiveCellPixels;
+  polyscope::options::volumeGridMipMinCells = 0;
+  polyscope::options::volumeGridInteractiveCellPixels = 1e6;
+
+  uint32_t dimX = 8;
+  uint32_t dimY = 10;
+  uint32_t dimZ = 12;
+  glm::vec3 bound_low{-3., -3., -3.};
+  glm::vec3 bound_high{3., 3., 3.};
+  polyscope::VolumeGrid* psGrid = polyscope::registerVolumeGrid("test grid", {dimX, dimY, dimZ}, bound_low, bound_high);
+
+  auto sphereSDF = [](glm::vec3 p) { return glm::length(p) - 2.f; };
+  polyscope::VolumeGridNodeScalarQuantity* qNode = psGrid->addNodeScalarQuantityFromCallable("node scalar", sphereSDF);
+  qNode->setEnabled(true);
+  qNode->setIsosurfaceVizEnabled(true);
+  EXPECT_TRUE(qNode->getMipPyramid().isReady(true));
+  EXPECT_GT(qNode->getMipPyramid().nLevels(), 1);
+
+  auto orbit = [&]() {
+    for (int i = 0; i < 3; i++) {
+      polyscope::view::lookAt(glm::vec3{10.f, 2.f * i, 5.f}, glm::vec3{0., 0., 0.});
+      polyscope::show(1);
+    }
+  };
+  orbit();
+
+  std::vector<double> cellScalar(psGrid->nCells(), 3.0f);
+  polyscope::VolumeGridCellScalarQuantity* qCell = psGrid->addCellScalarQuantity("cell scalar", cellScalar);
+  qCell->setEnabled(true);
+  qCell->getMipPyramid().isReady(true);
+  orbit();
+
+  // picking is always at full resolution
+  polyscope::pick::evaluatePickQuery(77, 88);
+
+  psGrid->setMipReduction(polyscope::VolumeGridMipReduction::Max);
+  EXPECT_EQ(psGrid->getMipReduction(), polyscope::VolumeGridMipReduction::Max);
+  psGrid->setRaycastGridCubes(true);
+  orbit();
+
+  // new values rebuild the pyramid
+  qCell->updateData(std::vector<double>(psGrid->nCells(), 1.0f));
+  orbit();
+
+  psGrid->setUseMipLevels(false);
+  orbit();
+
+  polyscope::options::volumeGridMipMinCells = prevMinCells;
+  polyscope::options::volumeGridInteractiveCellPixels = prevCellPixels;
+  polyscope::removeAllStructures();
+}
@@ -2,6 +2,8 @@
 
 #include "polyscope_test.h"
 
+#include "polyscope/parallel.h"
+
 // ============================================================
 // =============== Volume mesh tests
 // ============================================================
@@ -79,6 +81,72 @@ TEST_F(PolyscopeTest, VolumeMeshUpdatePositions) {
 }
 
 
+TEST_F(PolyscopeTest, VolumeMeshParallelConnectivity) {
+  // A grid of hexes, large enough to be split in to several ranges of cells
+  const size_t n = 40;
+  std::vector<glm::vec3> verts;
+  for (size_t k = 0; k <= n; k++) {
+    for (size_t j = 0; j <= n; j++) {
+      for (size_t i = 0; i <= n; i++) {
+        verts.push_back(glm::vec3{i, j, k} / static_cast<float>(n));
+      }
+    }
+  }
+  auto vInd = [&](size_t i, size_t j, size_t k) { return static_cast<uint32_t>((k * (n + 1) + j) * (n + 1) + i); };
+  std::vector<std::array<uint32_t, 8>> cells;
+  for (size_t k = 0; k < n; k++) {
+    for (size_t j = 0; j < n; j++) {
+      for (size_t i = 0; i < n; i++) {
+        cells.push_back({vInd(i, j, k), vInd(i + 1, j, k), vInd(i + 1, j + 1, k), vInd(i, j + 1, k),
+                         vInd(i, j, k + 1), vInd(i + 1, j, k + 1), vInd(i + 1, j + 1, k + 1), vInd(i, j + 1, k + 1)});
+      }
+    }
+  }
+
+  int oldMaxThreads = polyscope::options::maxWorkerThreads;
+  polyscope::options::maxWorkerThreads = 1;
+  polyscope::VolumeMesh* psVol = polyscope::registerHexMesh("vol", verts, cells);
+  psVol->computeConnectivityData();
+  psVol->computeTets();
+  std::vector<uint32_t> serialVertexInds = psVol->triangleVertexInds.data;
+  std::vector<uint32_t> serialFaceInds = psVol->triangleFaceInds.data;
+  std::vector<uint32_t> serialCellInds = psVol->triangleCellInds.data;
+  std::vector<float> serialEdgeMask = psVol->edgeIsRealMask.data;
+  std::vector<float> serialFaceType = psVol->faceType.data;
+  std::vector<std::array<uint32_t, 4>> serialTets = psVol->tets;
+
+  // The same buffers, built in several ranges at once (the connectivity is split in ranges of at least 2^14 cells)
+  polyscope::options::maxWorkerThreads = 4;
+  ASSERT_GE(polyscope::parallelChunkCount(psVol->nCells(), 1 << 14), 2u);
+  psVol->computeConnectivityData();
+  psVol->computeTets();
+  EXPECT_EQ(psVol->triangleVertexInds.data, serialVertexInds);
+  EXPECT_EQ(psVol->triangleFaceInds.data, serialFaceInds);
+  EXPECT_EQ(psVol->triangleCellInds.data, serialCellInds);
+  EXPECT_EQ(psVol->edgeIsRealMask.data, serialEdgeMask);
+  EXPECT_EQ(psVol->faceType.data, serialFaceType);
+  EXPECT_EQ(psVol->tets, serialTets);
+
+  // Exterior faces come first in the draw buffers
+  size_t nExteriorTris = 0;
+  bool seenInterior = false;
+  bool exteriorAfterInterior = false;
+  for (size_t iT = 0; iT < psVol->nFacesTriangulation(); iT++) {
+    bool interior = psVol->faceType.data[psVol->triangleFaceInds.data[3 * iT]] == 1.;
+    if (!interior) nExteriorTris++;
+    exteriorAfterInterior = exteriorAfterInterior || (seenInterior && !interior);
+    seenInterior = seenInterior || interior;
+  }
+  EXPECT_FALSE(exteriorAfterInterior);
+  EXPECT_EQ(nExteriorTris, 2 * 6 * n * n); // each boundary quad is split in to two triangles
+
+  polyscope::show(3);
+  polyscope::options::maxWorkerThreads = oldMaxThreads;
+
+  polyscope::removeAllStructures();
+}
+
+
 TEST_F(PolyscopeTest, VolumeMeshAppearance) {
   std::vector<glm::vec3> verts;
   std::vector<std::array<int, 8>> cells;